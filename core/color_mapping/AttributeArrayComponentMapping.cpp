@@ -38,6 +38,7 @@
 #include <core/data_objects/DataObject.h>
 #include <core/color_mapping/ColorMappingRegistry.h>
 #include <core/filters/AttributeArrayModifiedListener.h>
+#include <core/utility/DataArrayRanges.h>
 #include <core/utility/DataExtent.h>
 #include <core/utility/types_utils.h>
 
@@ -341,34 +342,36 @@ std::vector<ValueRange<>> AttributeArrayComponentMapping::updateBounds()
 
     auto bounds = decltype(updateBounds())(static_cast<unsigned>(numDataComponents()));
 
-    for (auto c = 0; c < numDataComponents(); ++c)
+    for (auto visualizedData : m_visualizedData)
     {
-        decltype(bounds)::value_type totalRange;
+        const auto attributeLocation = IndexType_util(scalarsAssociation(*visualizedData));
+        if (attributeLocation == IndexType::invalid)
+        {
+            continue;
+        }
 
-        for (auto visualizedData : m_visualizedData)
+        for (unsigned int i = 0; i < visualizedData->numberOfOutputPorts(); ++i)
         {
-            const auto attributeLocation = IndexType_util(scalarsAssociation(*visualizedData));
-            if (attributeLocation == IndexType::invalid)
+            auto processedDataI = visualizedData->processedOutputDataSet(i);
+            if (!processedDataI)
             {
+                qWarning() << "Pipeline failure in visualization of" << visualizedData->dataObject().name();
                 continue;
             }
-
-            for (unsigned int i = 0; i < visualizedData->numberOfOutputPorts(); ++i)
+            auto dataArray = attributeLocation.extractArray(processedDataI, utf8Name.data());
+            if (!dataArray)
             {
-                auto processedDataI = visualizedData->processedOutputDataSet(i);
-                if (!processedDataI)
-                {
-                    qWarning() << "Pipeline failure in visualization of" << visualizedData->dataObject().name();
-                    continue;
-                }
-                auto dataArray = attributeLocation.extractArray(processedDataI, utf8Name.data());
-                if (!dataArray)
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                decltype(totalRange) range;
-                dataArray->GetRange(range.data(), c);
+            // ranges (and histograms if requested) of all components, computed in a single pass and
+            // cached with the array
+            const auto arrayRanges = DataArrayRanges::of(*dataArray, dataHistogramsRequested());
+            const int numComponents = std::min(numDataComponents(), arrayRanges.numberOfComponents());
+
+            for (int c = 0; c < numComponents; ++c)
+            {
+                const auto & range = arrayRanges.componentRange(c);
 
                 // ignore arrays with invalid data
                 if (range.isEmpty())
@@ -376,16 +379,18 @@ std::vector<ValueRange<>> AttributeArrayComponentMapping::updateBounds()
                     continue;
                 }
 
-                totalRange.add(range);
+                bounds[static_cast<unsigned>(c)].add(range);
+                addDataHistogram(c, arrayRanges.componentHistogram(c));
             }
         }
+    }
 
+    for (auto & totalRange : bounds)
+    {
         if (totalRange.isEmpty())    // invalid data in all arrays on this component
         {
             totalRange[0] = totalRange[1] = 0.0;
         }
-
-        bounds[static_cast<unsigned>(c)] = totalRange;
     }
 
     return bounds;
@@ -47,6 +47,11 @@ ColorMappingData::ColorMappingData(const std::vector<AbstractVisualizedData *> &
     , m_dataMaxValue(numDataComponents, std::numeric_limits<double>::lowest())
     , m_minValue(numDataComponents, std::numeric_limits<double>::max())
     , m_maxValue(numDataComponents, std::numeric_limits<double>::lowest())
+    , m_dataHistograms(numDataComponents)
+    , m_dataHistogramsRequested{ false }
+    , m_providesDataHistograms{ false }
+    , m_lowerAutoPercentile{ 0.0 }
+    , m_upperAutoPercentile{ 100.0 }
     , m_boundsValid{ false }
 {
     for (auto vis : visualizedData)
@@ -326,6 +331,90 @@ void ColorMappingData::setMaxValue(double value, int component)
     minMaxChangedEvent();
 }
 
+const ScalarHistogram & ColorMappingData::dataHistogram(int component) const
+{
+    requestDataHistograms();
+    updateBoundsLocked();
+
+    if (component < 0)
+    {
+        component = m_dataComponent;
+    }
+    return m_dataHistograms[component];
+}
+
+bool ColorMappingData::hasDataHistogram(int component) const
+{
+    return !dataHistogram(component).isEmpty();
+}
+
+bool ColorMappingData::providesDataHistograms() const
+{
+    updateBoundsLocked();
+
+    return m_providesDataHistograms;
+}
+
+void ColorMappingData::setPercentileRange(double lowerPercent, double upperPercent, int component)
+{
+    requestDataHistograms();
+    updateBoundsLocked();
+
+    if (component < 0)
+    {
+        component = m_dataComponent;
+    }
+
+    const auto range = percentileRangeUnlocked(component, lowerPercent, upperPercent);
+    m_minValue[component] = range.min();
+    m_maxValue[component] = range.max();
+
+    minMaxChangedEvent();
+}
+
+double ColorMappingData::lowerAutoPercentile() const
+{
+    return m_lowerAutoPercentile;
+}
+
+double ColorMappingData::upperAutoPercentile() const
+{
+    return m_upperAutoPercentile;
+}
+
+void ColorMappingData::setAutoPercentiles(double lowerPercent, double upperPercent)
+{
+    m_lowerAutoPercentile = std::max(0.0, std::min(lowerPercent, 100.0));
+    m_upperAutoPercentile = std::max(m_lowerAutoPercentile, std::min(upperPercent, 100.0));
+
+    if (m_lowerAutoPercentile > 0.0 || m_upperAutoPercentile < 100.0)
+    {
+        requestDataHistograms();
+    }
+    updateBoundsLocked();
+
+    for (int component = 0; component < m_numDataComponents; ++component)
+    {
+        const auto range = percentileRangeUnlocked(component, m_lowerAutoPercentile, m_upperAutoPercentile);
+        m_minValue[component] = range.min();
+        m_maxValue[component] = range.max();
+    }
+
+    minMaxChangedEvent();
+}
+
+void ColorMappingData::addDataHistogram(int component, const ScalarHistogram & histogram)
+{
+    assert(component >= 0 && component < m_numDataComponents);
+    m_dataHistograms[component].add(histogram);
+    m_providesDataHistograms = true;
+}
+
+bool ColorMappingData::dataHistogramsRequested() const
+{
+    return m_dataHistogramsRequested;
+}
+
 vtkSmartPointer<vtkScalarsToColors> ColorMappingData::createOwnLookupTable()
 {
     assert(false);
@@ -370,10 +459,18 @@ void ColorMappingData::updateBoundsLocked() const
 
     auto & lockedThis = const_cast<ColorMappingData &>(*this);
 
+    // filled by subclasses while updating the bounds
+    lockedThis.m_dataHistograms.assign(m_numDataComponents, ScalarHistogram());
+    lockedThis.m_providesDataHistograms = false;
+
     auto newBounds = lockedThis.updateBounds();
     assert(newBounds.size() == static_cast<size_t>(m_numDataComponents));
 
     bool minMaxChanged = false;
+    bool autoRangeChanged = false;
+    // Percentiles depend on the distribution of the data, which may change without changing
+    // the extreme values.
+    const bool usesAutoPercentiles = m_lowerAutoPercentile > 0.0 || m_upperAutoPercentile < 100.0;
 
     for (int component = 0; component < m_numDataComponents; ++component)
     {
@@ -381,16 +478,27 @@ void ColorMappingData::updateBoundsLocked() const
 
         assert(!valueRange.isEmpty());
 
-        if (lockedThis.m_dataMinValue[component] == valueRange.min()
-            && lockedThis.m_dataMaxValue[component] == valueRange.max())
+        if (lockedThis.m_dataMinValue[component] != valueRange.min()
+            || lockedThis.m_dataMaxValue[component] != valueRange.max())
+        {
+            minMaxChanged = true;
+
+            lockedThis.m_dataMinValue[component] = valueRange.min();
+            lockedThis.m_dataMaxValue[component] = valueRange.max();
+        }
+        else if (!usesAutoPercentiles)
         {
             continue;
         }
 
-        minMaxChanged = true;
-
-        lockedThis.m_minValue[component] = lockedThis.m_dataMinValue[component] = valueRange.min();
-        lockedThis.m_maxValue[component] = lockedThis.m_dataMaxValue[component] = valueRange.max();
+        const auto autoRange = percentileRangeUnlocked(component, m_lowerAutoPercentile, m_upperAutoPercentile);
+        if (lockedThis.m_minValue[component] != autoRange.min()
+            || lockedThis.m_maxValue[component] != autoRange.max())
+        {
+            autoRangeChanged = true;
+            lockedThis.m_minValue[component] = autoRange.min();
+            lockedThis.m_maxValue[component] = autoRange.max();
+        }
     }
 
     lockedThis.m_boundsValid = true;
@@ -406,4 +514,51 @@ void ColorMappingData::updateBoundsLocked() const
         }
         emit lockedThis.dataMinMaxChanged();
     }
+    else if (autoRangeChanged)
+    {
+        lockedThis.minMaxChangedEvent();
+    }
+}
+
+ValueRange<> ColorMappingData::percentileRangeUnlocked(int component,
+    double lowerPercent, double upperPercent) const
+{
+    const auto dataMin = m_dataMinValue[component];
+    const auto dataMax = m_dataMaxValue[component];
+    const auto & histogram = m_dataHistograms[component];
+
+    auto percentileValue = [&] (double percent, double fallback)
+    {
+        if (percent <= 0.0)
+        {
+            return dataMin;
+        }
+        if (percent >= 100.0)
+        {
+            return dataMax;
+        }
+        if (histogram.isEmpty())
+        {
+            return fallback;
+        }
+        return std::min(std::max(dataMin, histogram.percentile(percent)), dataMax);
+    };
+
+    const auto lower = percentileValue(lowerPercent, dataMin);
+    const auto upper = percentileValue(upperPercent, dataMax);
+
+    return ValueRange<>({ std::min(lower, upper), upper });
+}
+
+void ColorMappingData::requestDataHistograms() const
+{
+    if (m_dataHistogramsRequested)
+    {
+        return;
+    }
+
+    const_cast<ColorMappingData *>(this)->m_dataHistogramsRequested = true;
+
+    // Histograms are collected while updating the bounds, so discard bounds computed without them.
+    forceUpdateBoundsLocked();
 }
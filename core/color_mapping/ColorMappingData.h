@@ -28,6 +28,7 @@
 
 #include <core/core_api.h>
 #include <core/utility/DataExtent_fwd.h>
+#include <core/utility/ScalarHistogram.h>
 
 
 class QString;
@@ -119,6 +120,27 @@ public:
     double maxValue(int component = -1) const;
     void setMaxValue(double value, int component = -1);
 
+    /** Approximated distribution of the data values, e.g., for a histogram along the color legend.
+     * Distributions are only collected after they were requested for the first time, by this
+     * function, by percentile ranges, or by non-default auto percentiles. They are collected
+     * together with the data value range, so that further queries don't require another pass over
+     * the data.
+     * @return an empty histogram if the color mapping does not provide value distributions */
+    const ScalarHistogram & dataHistogram(int component = -1) const;
+    bool hasDataHistogram(int component = -1) const;
+    /** Whether the color mapping can provide value distributions, without requesting them. */
+    bool providesDataHistograms() const;
+
+    /** Set min/max values to percentiles of the data values (lowerPercent/upperPercent in [0, 100]).
+     * Falls back to the data range if no data histogram is available. */
+    void setPercentileRange(double lowerPercent, double upperPercent, int component = -1);
+    /** Percentiles that define the min/max values whenever the data range changes.
+     * The default [0, 100] selects the full data range. Setting new percentiles applies them to
+     * all components. */
+    double lowerAutoPercentile() const;
+    double upperAutoPercentile() const;
+    void setAutoPercentiles(double lowerPercent, double upperPercent);
+
 signals:
     void lookupTableChanged();
     void minMaxChanged();
@@ -139,6 +161,12 @@ protected:
     /** Update data bounds
      * @return a vector containing value ranges per component */
     virtual std::vector<ValueRange<>> updateBounds() = 0;
+    /** Subclasses may call this in updateBounds to provide the value distribution of a component.
+     * Histograms added for the same component are combined. Empty histograms may be added if
+     * dataHistogramsRequested() is false, to state that distributions can be provided. */
+    void addDataHistogram(int component, const ScalarHistogram & histogram);
+    /** Whether updateBounds should collect value distributions, e.g., DataArrayRanges histograms */
+    bool dataHistogramsRequested() const;
 
     /** Subclass have to override this if and only if usesOwnLookupTable was set to true in the constructor. */
     virtual vtkSmartPointer<vtkScalarsToColors> createOwnLookupTable();
@@ -151,6 +179,12 @@ protected:
     void forceUpdateBoundsLocked() const;
     void updateBoundsLocked() const;
 
+private:
+    /** Value range between percentiles of the data values, without updating the bounds */
+    ValueRange<> percentileRangeUnlocked(int component, double lowerPercent, double upperPercent) const;
+    /** Collect value distributions from now on, updating the bounds if required. */
+    void requestDataHistograms() const;
+
 protected:
     bool m_isValid;
     std::vector<AbstractVisualizedData *> m_visualizedData;
@@ -170,6 +204,11 @@ private:
     std::vector<double> m_dataMaxValue;
     std::vector<double> m_minValue;
     std::vector<double> m_maxValue;
+    std::vector<ScalarHistogram> m_dataHistograms;
+    bool m_dataHistogramsRequested;
+    bool m_providesDataHistograms;
+    double m_lowerAutoPercentile;
+    double m_upperAutoPercentile;
     bool m_boundsValid;
     mutable std::mutex m_boundsUpdateMutex;
 
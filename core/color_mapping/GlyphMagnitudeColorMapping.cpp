@@ -35,6 +35,7 @@
 #include <core/rendered_data/RenderedData3D.h>
 #include <core/glyph_mapping/GlyphMapping.h>
 #include <core/glyph_mapping/GlyphMappingData.h>
+#include <core/utility/DataArrayRanges.h>
 #include <core/utility/DataExtent.h>
 #include <core/utility/macros.h>
 
@@ -201,9 +202,9 @@ std::vector<ValueRange<>> GlyphMagnitudeColorMapping::updateBounds()
         auto normData = dataSet->GetPointData()->GetScalars();
         assert(normData);
 
-        decltype(totalRange) range;
-        normData->GetRange(range.data());
-        totalRange.add(range);
+        const auto normRanges = DataArrayRanges::of(*normData, dataHistogramsRequested());
+        totalRange.add(normRanges.componentRange(0));
+        addDataHistogram(0, normRanges.componentHistogram(0));
     }
 
     return{ totalRange };
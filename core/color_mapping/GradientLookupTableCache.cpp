@@ -0,0 +1,143 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GradientLookupTableCache.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSize>
+
+
+namespace
+{
+const quint32 l_cacheMagic = 0x47524144; // "GRAD"
+const quint32 l_cacheVersion = 1;
+}
+
+
+bool GradientLookupTableCache::read(const QString & cacheFileName, const QSize & previewSize, Entry & entry)
+{
+    if (cacheFileName.isEmpty())
+    {
+        return false;
+    }
+
+    QFile file(cacheFileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_5);
+
+    quint32 magic, version;
+    qint64 fileSize, lastModified;
+    stream >> magic >> version >> fileSize >> lastModified;
+    if (stream.status() != QDataStream::Ok
+        || magic != l_cacheMagic || version != l_cacheVersion
+        || fileSize != entry.fileSize || lastModified != entry.lastModified.toMSecsSinceEpoch())
+    {
+        return false;
+    }
+
+    quint32 numColors;
+    stream >> numColors;
+    if (stream.status() != QDataStream::Ok || numColors == 0 || numColors > 0xFFFF)
+    {
+        return false;
+    }
+
+    std::vector<unsigned char> colors(static_cast<size_t>(numColors) * 4u);
+    const auto colorsSize = static_cast<int>(colors.size());
+    if (stream.readRawData(reinterpret_cast<char *>(colors.data()), colorsSize) != colorsSize)
+    {
+        return false;
+    }
+
+    qint32 previewWidth, previewHeight;
+    stream >> previewWidth >> previewHeight;
+    if (stream.status() != QDataStream::Ok
+        || previewWidth != previewSize.width() || previewHeight != previewSize.height())
+    {
+        return false;
+    }
+
+    QImage preview(previewWidth, previewHeight, QImage::Format_RGBA8888);
+    const int lineSize = previewWidth * 4;
+    for (int y = 0; y < previewHeight; ++y)
+    {
+        if (stream.readRawData(reinterpret_cast<char *>(preview.scanLine(y)), lineSize) != lineSize)
+        {
+            return false;
+        }
+    }
+
+    // trailing data: not written by this version
+    if (stream.status() != QDataStream::Ok || !stream.atEnd())
+    {
+        return false;
+    }
+
+    entry.colors = std::move(colors);
+    entry.preview = preview;
+
+    return true;
+}
+
+bool GradientLookupTableCache::write(const QString & cacheFileName, const Entry & entry)
+{
+    if (cacheFileName.isEmpty() || !QDir().mkpath(QFileInfo(cacheFileName).absolutePath()))
+    {
+        return false;
+    }
+
+    QSaveFile file(cacheFileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    const auto preview = entry.preview.convertToFormat(QImage::Format_RGBA8888);
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_5);
+
+    stream << l_cacheMagic << l_cacheVersion
+        << entry.fileSize << entry.lastModified.toMSecsSinceEpoch()
+        << static_cast<quint32>(entry.colors.size() / 4u);
+    stream.writeRawData(reinterpret_cast<const char *>(entry.colors.data()), static_cast<int>(entry.colors.size()));
+
+    stream << static_cast<qint32>(preview.width()) << static_cast<qint32>(preview.height());
+    for (int y = 0; y < preview.height(); ++y)
+    {
+        stream.writeRawData(reinterpret_cast<const char *>(preview.constScanLine(y)), preview.width() * 4);
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.commit())
+    {
+        qDebug() << "Could not write gradient cache file" << cacheFileName;
+        return false;
+    }
+
+    return true;
+}
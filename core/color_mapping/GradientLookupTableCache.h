@@ -0,0 +1,67 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QDateTime>
+#include <QImage>
+
+#include <core/core_api.h>
+
+
+class QSize;
+class QString;
+
+
+/**
+ * On-disk cache for the lookup table colors and preview images of gradients.
+ *
+ * A cache file stores the size and modification time of the gradient image file it was generated
+ * from. It is only valid as long as both match the current image file.
+ */
+class CORE_API GradientLookupTableCache
+{
+public:
+    struct Entry
+    {
+        /** Size and last modification of the gradient image file */
+        qint64 fileSize;
+        QDateTime lastModified;
+
+        /** Lookup table colors as RGBA tuples */
+        std::vector<unsigned char> colors;
+        /** Preview image in QImage::Format_RGBA8888 */
+        QImage preview;
+    };
+
+    /**
+     * Read colors and preview from the cache file into entry.
+     * @param entry fileSize and lastModified have to be set to the state of the gradient image file.
+     * @return false if the cache file does not exist, is outdated, corrupt, or contains a preview
+     *  of a different size than previewSize. In this case, entry is not modified.
+     */
+    static bool read(const QString & cacheFileName, const QSize & previewSize, Entry & entry);
+    /** Write the entry to the cache file, replacing an existing file. */
+    static bool write(const QString & cacheFileName, const Entry & entry);
+
+private:
+    GradientLookupTableCache() = delete;
+    ~GradientLookupTableCache() = delete;
+};
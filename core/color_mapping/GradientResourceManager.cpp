@@ -18,10 +18,14 @@
 
 #include "GradientResourceManager.h"
 
+#include <cassert>
+
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
-#include <QPixmap>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QStandardPaths>
 
 #include <vtkLookupTable.h>
 
@@ -34,11 +38,31 @@ namespace
 // Transparent NaN-color currently not correctly supported, thus a=1 for now.
 // Note: VTK interfaces don't allow const parameters in many cases
 /*const*/ double l_defaultNanColor[] = { 1, 1, 1, 1 };
+
+// Input data used for the lookup tables
+const QSize l_gradientLutSize{ 255, 1 };
+
+QString cacheLocation()
+{
+    const auto location = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (location.isEmpty())
+    {
+        return{};
+    }
+
+    return QDir(location).filePath("gradients");
+}
 }
 
-auto GradientResourceManager::gradients() const -> const std::map<QString, const GradientData> &
+const QStringList & GradientResourceManager::gradientNames() const
 {
-    return m_gradients;
+    return m_gradientNames;
+}
+
+QSize GradientResourceManager::previewSize()
+{
+    // Gradient image visible in the UI
+    return{ 200, 20 };
 }
 
 auto GradientResourceManager::gradient(const QString & name) -> const GradientData &
@@ -52,7 +76,16 @@ auto GradientResourceManager::gradient(const QString & name) -> const GradientDa
         return defaultGradient();
     }
 
-    return it->second;
+    return access(it->second);
+}
+
+void GradientResourceManager::preloadGradients()
+{
+    for (auto & it : m_gradients)
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        loadEntry(it.second);
+    }
 }
 
 const QString & GradientResourceManager::defaultGradientName() const
@@ -65,21 +98,27 @@ void GradientResourceManager::setDefaultGradientName(const QString & name)
     m_defaultGradientName = name;
 }
 
-auto GradientResourceManager::defaultGradient() const -> const GradientData &
+auto GradientResourceManager::defaultGradient() -> const GradientData &
 {
     assert(!m_gradients.empty());
 
     auto it = m_gradients.find(defaultGradientName());
     if (it != m_gradients.end())
     {
-        return it->second;
+        return access(it->second);
     }
 
-    return m_gradients.begin()->second;
+    return access(m_gradients.begin()->second);
 }
 
 GradientResourceManager::GradientResourceManager()
-    : m_gradientsDir{ QDir(RuntimeInfo::dataPath()).filePath("gradients") }
+    : GradientResourceManager(QDir(RuntimeInfo::dataPath()).filePath("gradients"), cacheLocation())
+{
+}
+
+GradientResourceManager::GradientResourceManager(const QString & gradientsDir, const QString & cacheDir)
+    : m_gradientsDir{ gradientsDir }
+    , m_cacheDir{ cacheDir }
     , m_defaultGradientName{ "_0012_Blue-Red_copy" }
 {
     loadGradients();
@@ -97,11 +136,7 @@ GradientResourceManager & GradientResourceManager::instance()
 void GradientResourceManager::loadGradients()
 {
     m_gradients.clear();
-
-    // Gradient image visible in the UI
-    const QSize gradientImageSize{ 200, 20 };
-    // Input data used for the
-    const QSize gradientLutSize{ 255, 1 };
+    m_gradientNames.clear();
 
     // navigate to the gradient directory
     QDir dir;
@@ -114,21 +149,24 @@ void GradientResourceManager::loadGradients()
     {
         dir.setFilter(QDir::Files | QDir::Readable | QDir::Hidden);
 
+        const auto supportedFormats = QImageReader::supportedImageFormats();
+
+        // Only check file names here, images are decoded when they are actually needed.
         for (const auto & fileInfo : dir.entryInfoList())
         {
-            QPixmap pixmap;
-            if (!pixmap.load(fileInfo.absoluteFilePath()))
+            if (!supportedFormats.contains(fileInfo.suffix().toLower().toUtf8()))
             {
                 qWarning() << "Unsupported file in gradient directory:" << fileInfo.fileName();
                 continue;
             }
 
-            const auto gradientImageScale = pixmap.scaled(gradientImageSize);
-            const auto gradientLutInput = pixmap.width() <= gradientLutSize.width()
-                ? pixmap : pixmap.scaled(gradientLutSize);
+            GradientEntry entry;
+            entry.filePath = fileInfo.absoluteFilePath();
+            entry.fileSize = fileInfo.size();
+            entry.lastModified = fileInfo.lastModified();
+            entry.isLoaded = false;
 
-            m_gradients.emplace(fileInfo.baseName(),
-                GradientData({ buildLookupTable(gradientLutInput), gradientImageScale }));
+            m_gradients.emplace(fileInfo.baseName(), std::move(entry));
         }
     }
 
@@ -146,7 +184,12 @@ void GradientResourceManager::loadGradients()
         }
 
         m_defaultGradientName = "fallback gradient";
-        m_gradients.emplace(m_defaultGradientName, buildFallbackGradient(gradientImageSize));
+        m_gradients.emplace(m_defaultGradientName, buildFallbackGradient(previewSize()));
+    }
+
+    for (const auto & it : m_gradients)
+    {
+        m_gradientNames << it.first;
     }
 }
 
@@ -155,19 +198,90 @@ const QString & GradientResourceManager::gradientsDir() const
     return m_gradientsDir;
 }
 
-vtkSmartPointer<vtkLookupTable> GradientResourceManager::buildLookupTable(const QPixmap & pixmap)
+const QString & GradientResourceManager::cacheDir() const
 {
-    const auto image = pixmap.toImage();
+    return m_cacheDir;
+}
 
-    // use alpha = 1.0, if the image doesn't have a alpha channel
-    int alphaMask = image.hasAlphaChannel() ? 0x00 : 0xFF;
+auto GradientResourceManager::access(GradientEntry & entry) -> const GradientData &
+{
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+
+    loadEntry(entry);
+
+    // QPixmaps can only be created in the GUI thread, so this is not done in loadEntry.
+    if (entry.data.pixmap.isNull())
+    {
+        entry.data.pixmap = QPixmap::fromImage(entry.preview);
+    }
+
+    return entry.data;
+}
+
+void GradientResourceManager::loadEntry(GradientEntry & entry) const
+{
+    if (entry.isLoaded)
+    {
+        return;
+    }
+
+    entry.isLoaded = true;
+
+    if (!GradientLookupTableCache::read(cacheFilePath(entry), previewSize(), entry))
+    {
+        QImage image;
+        if (!image.load(entry.filePath))
+        {
+            qWarning() << "Unsupported file in gradient directory:" << QFileInfo(entry.filePath).fileName();
+            image = QImage(l_gradientLutSize, QImage::Format_RGBA8888);
+            image.fill(Qt::white);
+        }
+
+        const auto lutInput = image.width() <= l_gradientLutSize.width()
+            ? image : image.scaled(l_gradientLutSize);
+
+        // use alpha = 1.0, if the image doesn't have a alpha channel
+        const int alphaMask = lutInput.hasAlphaChannel() ? 0x00 : 0xFF;
+
+        entry.colors.resize(static_cast<size_t>(lutInput.width()) * 4u);
+        for (int i = 0; i < lutInput.width(); ++i)
+        {
+            const QRgb color = lutInput.pixel(i, 0);
+            auto rgba = &entry.colors[static_cast<size_t>(i) * 4u];
+            rgba[0] = static_cast<unsigned char>(qRed(color));
+            rgba[1] = static_cast<unsigned char>(qGreen(color));
+            rgba[2] = static_cast<unsigned char>(qBlue(color));
+            rgba[3] = static_cast<unsigned char>(alphaMask | qAlpha(color));
+        }
+
+        entry.preview = image.scaled(previewSize()).convertToFormat(QImage::Format_RGBA8888);
+
+        GradientLookupTableCache::write(cacheFilePath(entry), entry);
+    }
+
+    entry.data.lookupTable = buildLookupTable(entry.colors);
+}
+
+QString GradientResourceManager::cacheFilePath(const GradientEntry & entry) const
+{
+    if (m_cacheDir.isEmpty() || entry.filePath.isEmpty())
+    {
+        return{};
+    }
+
+    return QDir(m_cacheDir).filePath(QFileInfo(entry.filePath).fileName() + ".lut");
+}
+
+vtkSmartPointer<vtkLookupTable> GradientResourceManager::buildLookupTable(const std::vector<unsigned char> & colors)
+{
+    const auto numColors = static_cast<vtkIdType>(colors.size() / 4u);
 
     auto lut = vtkSmartPointer<vtkLookupTable>::New();
-    lut->SetNumberOfTableValues(image.width());
-    for (int i = 0; i < image.width(); ++i)
+    lut->SetNumberOfTableValues(numColors);
+    for (vtkIdType i = 0; i < numColors; ++i)
     {
-        QRgb color = image.pixel(i, 0);
-        lut->SetTableValue(i, qRed(color) / 255.0, qGreen(color) / 255.0, qBlue(color) / 255.0, (alphaMask | qAlpha(color)) / 255.0);
+        const auto rgba = &colors[static_cast<size_t>(i) * 4u];
+        lut->SetTableValue(i, rgba[0] / 255.0, rgba[1] / 255.0, rgba[2] / 255.0, rgba[3] / 255.0);
     }
 
     lut->SetNanColor(l_defaultNanColor);
@@ -176,19 +290,22 @@ vtkSmartPointer<vtkLookupTable> GradientResourceManager::buildLookupTable(const
     return lut;
 }
 
-auto GradientResourceManager::buildFallbackGradient(const QSize & pixmapSize) -> GradientData
+auto GradientResourceManager::buildFallbackGradient(const QSize & pixmapSize) -> GradientEntry
 {
-    auto gradientData = GradientData();
+    auto entry = GradientEntry();
+    entry.fileSize = 0;
+    entry.isLoaded = true;
 
-    gradientData.lookupTable = vtkSmartPointer<vtkLookupTable>::New();
-    gradientData.lookupTable->SetNumberOfTableValues(pixmapSize.width());
-    gradientData.lookupTable->Build();
+    auto & lookupTable = entry.data.lookupTable;
+    lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+    lookupTable->SetNumberOfTableValues(pixmapSize.width());
+    lookupTable->Build();
 
     QImage image(pixmapSize, QImage::Format_RGBA8888);
     for (int i = 0; i < pixmapSize.width(); ++i)
     {
         double colorF[4];
-        gradientData.lookupTable->GetTableValue(i, colorF);
+        lookupTable->GetTableValue(i, colorF);
         auto colorUI = vtkColorToQColor(colorF).rgba();
         for (int l = 0; l < pixmapSize.height(); ++l)
         {
@@ -196,10 +313,10 @@ auto GradientResourceManager::buildFallbackGradient(const QSize & pixmapSize) ->
         }
     }
 
-    gradientData.lookupTable->SetNanColor(l_defaultNanColor);
-    gradientData.lookupTable->BuildSpecialColors();
+    lookupTable->SetNanColor(l_defaultNanColor);
+    lookupTable->BuildSpecialColors();
 
-    gradientData.pixmap = QPixmap::fromImage(image);
+    entry.preview = image;
 
-    return gradientData;
+    return entry;
 }
@@ -19,13 +19,17 @@
 #pragma once
 
 #include <map>
+#include <mutex>
+#include <vector>
 
 #include <core/core_api.h>
+#include <core/color_mapping/GradientLookupTableCache.h>
 
 #include <vtkSmartPointer.h>
 
 #include <QPixmap>
 #include <QString>
+#include <QStringList>
 
 
 class vtkLookupTable;
@@ -36,9 +40,24 @@ class CORE_API GradientResourceManager
 public:
     static GradientResourceManager & instance();
 
+    /**
+     * Manage the gradients in gradientsDir, independently of the application wide instance.
+     * @param cacheDir Directory for generated lookup tables. Pass an empty string to disable caching.
+     */
+    GradientResourceManager(const QString & gradientsDir, const QString & cacheDir);
+    ~GradientResourceManager();
+
+    /**
+     * Discover the gradient images in the gradients directory.
+     * Only file names and meta data are read here. Images are decoded and lookup tables are built
+     * when a gradient is requested for the first time, or by preloadGradients().
+     * Must not be called while preloadGradients() is running.
+     */
     void loadGradients();
 
     const QString & gradientsDir() const;
+    /** Directory where generated lookup tables and preview images are cached. Empty if caching is disabled. */
+    const QString & cacheDir() const;
 
     struct GradientData
     {
@@ -46,25 +65,57 @@ public:
         QPixmap pixmap;
     };
 
-    const std::map<QString, const GradientData> & gradients() const;
+    /** Names of all discovered gradients, in alphabetical order */
+    const QStringList & gradientNames() const;
+    /** Size of the gradient preview pixmaps */
+    static QSize previewSize();
+    /**
+     * Access a gradient, loading it if it was not requested before.
+     * Has to be called in the GUI thread, as the preview pixmap is created on first access.
+     */
     const GradientData & gradient(const QString & name);
 
+    /**
+     * Decode all gradients that are not loaded yet, preferably from the on-disk cache.
+     * This does not create pixmaps and is thus safe to call in a background thread.
+     */
+    void preloadGradients();
+
     const QString & defaultGradientName() const;
     void setDefaultGradientName(const QString & name);
-    const GradientData & defaultGradient() const;
+    const GradientData & defaultGradient();
 
+    GradientResourceManager(const GradientResourceManager &) = delete;
     void operator=(const GradientResourceManager &) = delete;
 
 private:
     GradientResourceManager();
-    ~GradientResourceManager();
 
-    static vtkSmartPointer<vtkLookupTable> buildLookupTable(const QPixmap & pixmap);
-    static GradientData buildFallbackGradient(const QSize & pixmapSize);
+    /** The decoded preview is converted to GradientData::pixmap on first access in the GUI thread. */
+    struct GradientEntry : GradientLookupTableCache::Entry
+    {
+        QString filePath;
+
+        bool isLoaded;
+        GradientData data;
+    };
+
+    /** Load the entry if required and create its pixmap. Must be called in the GUI thread. */
+    const GradientData & access(GradientEntry & entry);
+    /** Load the entry from the cache or its image file. The caller has to hold m_loadMutex. */
+    void loadEntry(GradientEntry & entry) const;
+    QString cacheFilePath(const GradientEntry & entry) const;
+
+    static vtkSmartPointer<vtkLookupTable> buildLookupTable(const std::vector<unsigned char> & colors);
+    static GradientEntry buildFallbackGradient(const QSize & pixmapSize);
 
 private:
     const QString m_gradientsDir;
+    const QString m_cacheDir;
 
-    std::map<QString, const GradientData> m_gradients;
+    std::map<QString, GradientEntry> m_gradients;
+    QStringList m_gradientNames;
     QString m_defaultGradientName;
+
+    std::mutex m_loadMutex;
 };
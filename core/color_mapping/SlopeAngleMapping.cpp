@@ -19,28 +19,60 @@
 #include "SlopeAngleMapping.h"
 
 #include <cassert>
-#include <sstream>
 
-#include <vtkAssignAttribute.h>
-#include <vtkArrayCalculator.h>
-#include <vtkMath.h>
+#include <QDebug>
+
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkExecutive.h>
 #include <vtkMapper.h>
-#include <vtkVersionMacros.h>
 
 #include <core/AbstractVisualizedData.h>
+#include <core/CoordinateSystems.h>
 #include <core/types.h>
+#include <core/data_objects/ImageDataObject.h>
 #include <core/data_objects/PolyDataObject.h>
 #include <core/color_mapping/ColorMappingRegistry.h>
-#include <core/filters/ArrayChangeInformationFilter.h>
+#include <core/filters/SlopeAspectFilter.h>
 #include <core/utility/type_traits.h>
+#include <core/utility/DataArrayRanges.h>
 #include <core/utility/DataExtent.h>
 #include <core/utility/macros.h>
+#include <core/utility/types_utils.h>
 
 
 namespace
 {
 const QString l_name = "slope angle mapping";
-const QString l_dataArrayName = "Slope Angle";
+const QString l_dataArrayName = QString::fromUtf8(SlopeAspectFilter::SlopeArrayName());
+
+/**
+ * Restrict slopes to images that may contain elevations: 2D images with single component scalars,
+ * excluding 8 bit types (gray scale pictures, masks) and images in unsupported coordinate systems.
+ */
+bool isImageDEM(AbstractVisualizedData & vis)
+{
+    auto image = dynamic_cast<ImageDataObject *>(&vis.dataObject());
+    if (!image)
+    {
+        return false;
+    }
+
+    auto & scalars = image->scalars();
+    if (scalars.GetNumberOfComponents() != 1 || scalars.GetDataTypeSize() < 2)
+    {
+        return false;
+    }
+
+    int dimensions[3];
+    image->imageData().GetDimensions(dimensions);
+    if (dimensions[2] != 1)
+    {
+        return false;
+    }
+
+    return image->coordinateSystem().type != CoordinateSystemType::other;
+}
 }
 
 const bool SlopeAngleMapping::s_isRegistered = ColorMappingRegistry::instance().registerImplementation(
@@ -60,6 +92,10 @@ std::vector<std::unique_ptr<ColorMappingData>> SlopeAngleMapping::newInstance(co
                 validVisualizations.emplace_back(vis);
             }
         }
+        else if (isImageDEM(*vis))
+        {
+            validVisualizations.emplace_back(vis);
+        }
     }
 
     decltype(newInstance(visualizedData)) result;
@@ -91,15 +127,14 @@ QString SlopeAngleMapping::scalarsName(AbstractVisualizedData & /*vis*/) const
     return l_dataArrayName;
 }
 
-IndexType SlopeAngleMapping::scalarsAssociation(AbstractVisualizedData & /*vis*/) const
+IndexType SlopeAngleMapping::scalarsAssociation(AbstractVisualizedData & vis) const
 {
-    return IndexType::cells;
+    // per point gradients for images, per cell normals for poly data
+    return isImageDEM(vis) ? IndexType::points : IndexType::cells;
 }
 
 vtkSmartPointer<vtkAlgorithm> SlopeAngleMapping::createFilter(AbstractVisualizedData & visualizedData, unsigned int port)
 {
-    static const auto arrayName = scalarsName(visualizedData).toUtf8();
-
     const auto filtersIt = m_filters.find(&visualizedData);
     if (filtersIt != m_filters.end())
     {
@@ -110,38 +145,14 @@ vtkSmartPointer<vtkAlgorithm> SlopeAngleMapping::createFilter(AbstractVisualized
         }
     }
 
-    auto calculator = vtkSmartPointer<vtkArrayCalculator>::New();
-    calculator->SetInputConnection(visualizedData.processedOutputPort(port));
-    calculator->AddScalarVariable("z", "Normals", 2);
-    calculator->SetResultArrayName(arrayName.data());
-#if VTK_CHECK_VERSION(8,1,0)
-    calculator->SetAttributeTypeToCellData();
-#else
-    calculator->SetAttributeModeToUseCellData();
-#endif
-    static const auto fun = "acos(z) * 180 / " + [] () {
-        std::stringstream piStr;
-        piStr.precision(16);
-        piStr << vtkMath::Pi(); 
-        return piStr.str();
-    }();
-    calculator->SetFunction(fun.c_str());
-
-    auto assignAttibute = vtkSmartPointer<vtkAssignAttribute>::New();
-    assignAttibute->SetInputConnection(calculator->GetOutputPort());
-    assignAttibute->Assign(arrayName.data(), vtkDataSetAttributes::SCALARS, vtkAssignAttribute::CELL_DATA);
-
-    auto unitSetter = vtkSmartPointer<ArrayChangeInformationFilter>::New();
-    unitSetter->SetInputConnection(assignAttibute->GetOutputPort());
-    unitSetter->SetAttributeLocation(IndexType::cells);
-    unitSetter->SetAttributeType(vtkDataSetAttributes::SCALARS);
-    unitSetter->EnableRenameOff();
-    unitSetter->EnableSetUnitOn();
-    unitSetter->SetArrayUnit(QString(QChar(0x00B0)).toUtf8().data());   // degree sign
-
-    m_filters[&visualizedData][port] = unitSetter;
-
-    return unitSetter;
+    // Slope angles are cached with the normals/elevations: re-executing the filter, e.g., when
+    // switching between color mappings, does not recompute them.
+    auto slopeAspect = vtkSmartPointer<SlopeAspectFilter>::New();
+    slopeAspect->SetInputConnection(visualizedData.processedOutputPort(port));
+
+    m_filters[&visualizedData][port] = slopeAspect;
+
+    return slopeAspect;
 }
 
 bool SlopeAngleMapping::usesFilter() const
@@ -164,11 +175,51 @@ void SlopeAngleMapping::configureMapper(
 
     mapper->ScalarVisibilityOn();
     mapper->SetColorModeToMapScalars();
-    mapper->SetScalarModeToUseCellFieldData();
+    if (scalarsAssociation(visualizedData) == IndexType::points)
+    {
+        mapper->SetScalarModeToUsePointFieldData();
+    }
+    else
+    {
+        mapper->SetScalarModeToUseCellFieldData();
+    }
     mapper->SelectColorArray(scalarsName(visualizedData).toUtf8().data());
 }
 
 std::vector<ValueRange<>> SlopeAngleMapping::updateBounds()
 {
-    return{ decltype(updateBounds())::value_type({ 0.0, 90.0 }) };
+    decltype(updateBounds())::value_type totalRange;
+
+    for (auto vis : m_visualizedData)
+    {
+        for (unsigned int port = 0; port < vis->numberOfOutputPorts(); ++port)
+        {
+            // access lazily created filters
+            auto filter = createFilter(*vis, port);
+            if (!filter->GetExecutive()->Update())
+            {
+                continue;
+            }
+            auto dataSet = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+            auto slopes = IndexType_util(scalarsAssociation(*vis)).extractArray(dataSet,
+                SlopeAspectFilter::SlopeArrayName());
+            if (!slopes)
+            {
+                qWarning() << "Missing slope angles in" << vis->dataObject().name();
+                continue;
+            }
+
+            // computed along with the slope angles, no additional pass over the data
+            const auto slopeRanges = DataArrayRanges::of(*slopes, dataHistogramsRequested());
+            totalRange.add(slopeRanges.componentRange(0));
+            addDataHistogram(0, slopeRanges.componentHistogram(0));
+        }
+    }
+
+    if (totalRange.isEmpty())
+    {
+        totalRange = ValueRange<>({ 0.0, 90.0 });
+    }
+
+    return{ totalRange };
 }
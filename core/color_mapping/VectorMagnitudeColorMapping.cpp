@@ -22,7 +22,6 @@
 
 #include <QDebug>
 
-#include <vtkAssignAttribute.h>
 #include <vtkCellData.h>
 #include <vtkDataArray.h>
 #include <vtkDataSet.h>
@@ -31,13 +30,13 @@
 #include <vtkMapper.h>
 #include <vtkPassThrough.h>
 #include <vtkPointData.h>
-#include <vtkVectorNorm.h>
 
 #include <core/AbstractVisualizedData.h>
 #include <core/CoordinateSystems.h>
 #include <core/data_objects/DataObject.h>
 #include <core/color_mapping/ColorMappingRegistry.h>
-#include <core/filters/ArrayChangeInformationFilter.h>
+#include <core/filters/VectorMagnitudeFilter.h>
+#include <core/utility/DataArrayRanges.h>
 #include <core/utility/DataExtent.h>
 #include <core/utility/types_utils.h>
 
@@ -76,7 +75,7 @@ std::vector<std::unique_ptr<ColorMappingData>> VectorMagnitudeColorMapping::newI
                 continue;
             }
 
-            // vtkVectorNorm only supports 3-component vectors
+            // only 3-component vectors are considered as vectors with a magnitude
             if (dataArray->GetNumberOfComponents() != 3)
             {
                 continue;
@@ -145,12 +144,10 @@ VectorMagnitudeColorMapping::VectorMagnitudeColorMapping(
     , m_magnitudeArrayName{ dataArrayName + " Magnitude" }
 {
     const auto utf8Name = m_dataArrayName.toUtf8();
-    const auto utf8MagnitudeName = m_magnitudeArrayName.toUtf8();
 
-    // establish pipeline here, so that we have valid data whenever updateBounds() requests norm outputs
-
-    const auto assignLocation = IndexType_util(attributeLocation).toVtkAssignAttribute_AttributeLocation();
-    const auto renameLocation = IndexType_util(attributeLocation);
+    // establish pipeline here, so that we have valid data whenever updateBounds() requests norm outputs.
+    // Magnitudes are cached with the vector arrays, so that visualizations of the same data in
+    // different views share them and (re-)executing the filters does not recompute them.
 
     for (auto vis : visualizedData)
     {
@@ -158,30 +155,12 @@ VectorMagnitudeColorMapping::VectorMagnitudeColorMapping(
 
         for (unsigned int i = 0; i < vis->numberOfOutputPorts(); ++i)
         {
-            auto activeVectors = vtkSmartPointer<vtkAssignAttribute>::New();
-            activeVectors->Assign(utf8Name.data(), vtkDataSetAttributes::VECTORS, assignLocation);
-            activeVectors->SetInputConnection(vis->processedOutputPort(i));
-
-            auto norm = vtkSmartPointer<vtkVectorNorm>::New();
-            if (attributeLocation == IndexType::cells)
-            {
-                norm->SetAttributeModeToUseCellData();
-            }
-            else if (attributeLocation == IndexType::points)
-            {
-                norm->SetAttributeModeToUsePointData();
-            }
-
-            norm->SetInputConnection(activeVectors->GetOutputPort());
-
-            auto setMagnitudeName = vtkSmartPointer<ArrayChangeInformationFilter>::New();
-            setMagnitudeName->SetAttributeLocation(renameLocation);
-            setMagnitudeName->SetAttributeType(vtkDataSetAttributes::SCALARS);
-            setMagnitudeName->EnableRenameOn();
-            setMagnitudeName->SetArrayName(utf8MagnitudeName.data());
-            setMagnitudeName->SetInputConnection(norm->GetOutputPort());
+            auto magnitude = vtkSmartPointer<VectorMagnitudeFilter>::New();
+            magnitude->SetAttributeLocation(attributeLocation);
+            magnitude->SetArrayName(utf8Name.data());
+            magnitude->SetInputConnection(vis->processedOutputPort(i));
 
-            filters.emplace_back(setMagnitudeName);
+            filters.emplace_back(magnitude);
         }
 
         m_filters.emplace(vis, filters);
@@ -209,7 +188,7 @@ IndexType VectorMagnitudeColorMapping::scalarsAssociation(AbstractVisualizedData
 
 vtkSmartPointer<vtkAlgorithm> VectorMagnitudeColorMapping::createFilter(AbstractVisualizedData & visualizedData, unsigned int port)
 {
-    /** vtkVectorNorm sets norm array as current scalars; it doesn't set a name */
+    /** VectorMagnitudeFilter sets the magnitude array as current scalars */
     const auto filtersIt = m_filters.find(&visualizedData);
     if (filtersIt == m_filters.end())
     {
@@ -276,9 +255,10 @@ std::vector<ValueRange<>> VectorMagnitudeColorMapping::updateBounds()
                 continue;
             }
 
-            decltype(totalRange) range;
-            normData->GetRange(range.data());
-            totalRange.add(range);
+            // computed along with the magnitudes, no additional pass over the data
+            const auto normRanges = DataArrayRanges::of(*normData, dataHistogramsRequested());
+            totalRange.add(normRanges.componentRange(0));
+            addDataHistogram(0, normRanges.componentHistogram(0));
         }
     }
 
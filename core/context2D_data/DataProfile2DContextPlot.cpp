@@ -24,6 +24,7 @@
 #include <vtkCellData.h>
 #include <vtkDataSet.h>
 #include <vtkPen.h>
+#include <vtkPlotLine.h>
 #include <vtkPointData.h>
 #include <vtkPointSet.h>
 #include <vtkTable.h>
@@ -34,6 +35,7 @@
 #include <core/context2D_data/PlotPointsAndLine.h>
 #include <core/context2D_data/vtkPlotCollection.h>
 #include <core/data_objects/DataProfile2DDataObject.h>
+#include <core/filters/SwathProfileFilter.h>
 #include <core/reflectionzeug_extension/QStringProperty.h>
 #include <core/utility/DataExtent.h>
 
@@ -41,6 +43,21 @@
 using namespace reflectionzeug;
 
 
+namespace
+{
+
+const std::array<SwathProfileFilter::Statistic, 3> swathPlotStatistics = {
+    SwathProfileFilter::Median, SwathProfileFilter::Minimum, SwathProfileFilter::Maximum };
+
+/** Table columns: position, mean, followed by the other statistics in SwathProfileFilter order */
+int swathPlotColumn(size_t plotIndex)
+{
+    return 1 + static_cast<int>(swathPlotStatistics[plotIndex]);
+}
+
+}
+
+
 DataProfile2DContextPlot::DataProfile2DContextPlot(DataProfile2DDataObject & dataObject)
     : Context2DData(dataObject)
     , m_plotLine{ vtkSmartPointer<PlotPointsAndLine>::New() }
@@ -50,6 +67,16 @@ DataProfile2DContextPlot::DataProfile2DContextPlot(DataProfile2DDataObject & dat
     m_plotLine->SetMarkerStyle(vtkPlotPoints::CIRCLE);
     m_plotLine->GetLinePen()->SetOpacityF(0.25);
 
+    for (size_t i = 0; i < m_swathPlots.size(); ++i)
+    {
+        auto & plot = m_swathPlots[i];
+        plot = vtkSmartPointer<vtkPlotLine>::New();
+        plot->SetMarkerStyle(vtkPlotPoints::NONE);
+        plot->GetPen()->SetLineType(swathPlotStatistics[i] == SwathProfileFilter::Median
+            ? vtkPen::DOT_LINE : vtkPen::DASH_LINE);
+        plot->SetVisible(false);
+    }
+
     connect(&dataObject, &DataObject::dataChanged,
         this, &DataProfile2DContextPlot::updatePlotRedraw);
     connect(&dataObject, &DataProfile2DDataObject::sourceDataChanged,
@@ -189,6 +216,26 @@ std::unique_ptr<PropertyGroup> DataProfile2DContextPlot::createConfigGroup()
             });
     }
 
+    auto swathGroup = root->addGroup("Swath");
+    {
+        swathGroup->addProperty<double>("Width",
+            [this] () { return profileData().swathWidth(); },
+            [this] (const double width) {
+            profileData().setSwathWidth(width);
+        })->setOptions({
+            { "minimum", 0.0 }
+            });
+
+        swathGroup->addProperty<int>("Bins",
+            [this] () { return profileData().numberOfSwathBins(); },
+            [this] (const int numBins) {
+            profileData().setNumberOfSwathBins(numBins);
+        })->setOptions({
+            { "minimum", 1 },
+            { "maximum", 100000 }
+            });
+    }
+
     return root;
 }
 
@@ -200,6 +247,10 @@ void DataProfile2DContextPlot::setColor(const vtkColor3ub & color)
     m_plotLine->GetLinePen()->SetColor(
         color[0], color[1], color[2],
         m_plotLine->GetLinePen()->GetOpacity());
+    for (auto & plot : m_swathPlots)
+    {
+        plot->SetColor(color[0], color[1], color[2], plot->GetPen()->GetOpacity());
+    }
 }
 
 vtkColor3ub DataProfile2DContextPlot::color() const
@@ -243,6 +294,10 @@ vtkSmartPointer<vtkPlotCollection> DataProfile2DContextPlot::fetchPlots()
     updatePlot();
 
     items->AddItem(m_plotLine);
+    for (auto & plot : m_swathPlots)
+    {
+        items->AddItem(plot);
+    }
 
     return items;
 }
@@ -259,6 +314,19 @@ DataBounds DataProfile2DContextPlot::updateVisibleBounds()
     xAxis->GetRange(xRange.data());
     yAxis->GetRange(yRange.data());
 
+    for (size_t i = 0; i < m_swathPlots.size(); ++i)
+    {
+        if (!m_swathPlots[i]->GetVisible())
+        {
+            continue;
+        }
+        auto yStatistic = vtkDataArray::FastDownCast(table->GetColumn(swathPlotColumn(i)));
+        assert(yStatistic);
+        ValueRange<> statisticRange;
+        yStatistic->GetRange(statisticRange.data());
+        yRange.add(statisticRange);
+    }
+
     return DataBounds({ xRange, yRange, ValueRange<>() });
 }
 
@@ -314,6 +382,29 @@ void DataProfile2DContextPlot::updatePlot()
 
     m_plotLine->SetInputData(table, 0, 1);
 
+    // Swath profiles: add all statistics of the bins to the table, plot some of them.
+    const bool isSwath = profileData().isSwathProfile();
+    if (isSwath)
+    {
+        const auto scalarsName = profileData().scalarsName().toStdString();
+        for (int s = SwathProfileFilter::Median; s < SwathProfileFilter::NumberOfStatistics; ++s)
+        {
+            const auto statisticName = SwathProfileFilter::StatisticArrayName(scalarsName,
+                static_cast<SwathProfileFilter::Statistic>(s));
+            auto statistic = profileDataSet->GetPointData()->GetAbstractArray(statisticName.c_str());
+            assert(statistic && statistic->GetNumberOfTuples() == numPoints);
+            table->AddColumn(statistic);
+        }
+        for (size_t i = 0; i < m_swathPlots.size(); ++i)
+        {
+            m_swathPlots[i]->SetInputData(table, 0, swathPlotColumn(i));
+        }
+    }
+    for (auto & plot : m_swathPlots)
+    {
+        plot->SetVisible(isSwath);
+    }
+
     setPlotIsValid(true);
     invalidateVisibleBounds();
 }
@@ -327,4 +418,11 @@ void DataProfile2DContextPlot::updatePlotRedraw()
 void DataProfile2DContextPlot::setPlotIsValid(const bool isValid)
 {
     m_plotLine->SetVisible(isValid);
+    if (!isValid)
+    {
+        for (auto & plot : m_swathPlots)
+        {
+            plot->SetVisible(false);
+        }
+    }
 }
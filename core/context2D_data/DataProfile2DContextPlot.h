@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <array>
+
 #include <QString>
 
 #include <vtkColor.h>
@@ -25,6 +27,8 @@
 #include <core/context2D_data/Context2DData.h>
 
 
+class vtkPlotLine;
+
 class DataProfile2DDataObject;
 class PlotPointsAndLine;
 
@@ -33,6 +37,8 @@ class PlotPointsAndLine;
     Line plot for an image data profile.
 
     This class expects to find its scalars (named by scalarsName parameter in constructor) in the plot lines point data.
+    For swath profiles, the plotted scalars are the mean values per bin. All statistics are added
+    as columns to the plot table, median, minimum and maximum are plotted as additional lines.
 */
 class CORE_API DataProfile2DContextPlot : public Context2DData
 {
@@ -63,6 +69,8 @@ private:
 
 private:
     vtkSmartPointer<PlotPointsAndLine> m_plotLine;
+    /** Median, minimum, and maximum of swath profiles */
+    std::array<vtkSmartPointer<vtkPlotLine>, 3> m_swathPlots;
 
     QString m_title;
 
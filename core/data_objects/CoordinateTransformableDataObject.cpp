@@ -26,6 +26,7 @@
 #include <vtkPassThrough.h>
 
 #include <core/filters/SetCoordinateSystemInformationFilter.h>
+#include <core/utility/PipelineOutputCache.h>
 
 
 CoordinateTransformableDataObject::CoordinateTransformableDataObject(
@@ -234,6 +235,7 @@ vtkAlgorithm * CoordinateTransformableDataObject::transformFilter(const Coordina
 
     if (currentAlgorithm)
     {
+        PipelineOutputCache::instance().access(*currentAlgorithm);
         return currentAlgorithm;
     }
 
@@ -249,6 +251,12 @@ vtkAlgorithm * CoordinateTransformableDataObject::transformFilter(const Coordina
     }
 
     auto newAlgorithm = createTransformPipeline(toSystem, processedOutputPort());
+    if (newAlgorithm)
+    {
+        // Outputs of transform pipelines hold copies of the coordinates. These are released
+        // by the cache if required, and recomputed on the next pipeline update.
+        PipelineOutputCache::instance().add(*newAlgorithm);
+    }
     m_pipelines[toSystem.type][toSystem.geographicSystem][toSystem.globalMetricSystem][toSystem.unitOfMeasurement] = newAlgorithm;
 
     return newAlgorithm;
@@ -113,6 +113,8 @@ private:
      * The pipeline output m_pipelines[type, geoName, metricName, unit] converts the current data
      * set to a representation of in type, using the geographic coordinates geoName, and depending
      * on the type, coordinates in the metricName system.
+     * Outputs of these pipelines are registered in the PipelineOutputCache, which may release them
+     * to meet its memory budget.
      */
     QMap<CoordinateSystemType, QMap<QString, QMap<QString, QMap<QString, vtkSmartPointer<vtkAlgorithm>>>>> m_pipelines;
 
@@ -200,6 +200,11 @@ vtkIdType DataObject::numberOfCells() const
     return d_ptr->m_numberOfCells;
 }
 
+const std::shared_ptr<GridSpacingEstimateCache> & DataObject::gridSpacingEstimates() const
+{
+    return d_ptr->m_gridSpacingEstimates;
+}
+
 QVtkTableModel * DataObject::tableModel()
 {
     if (!d_ptr->m_tableModel)
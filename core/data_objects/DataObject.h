@@ -39,6 +39,7 @@ class vtkInformationIntegerKey;
 
 class Context2DData;
 class DataObjectPrivate;
+class GridSpacingEstimateCache;
 enum class IndexType;
 class QVtkTableModel;
 class RenderedData;
@@ -125,6 +126,9 @@ public:
     vtkIdType numberOfPoints() const;
     vtkIdType numberOfCells() const;
 
+    /** Grid spacing estimates of the (transformed) point coordinates, shared by the line profiles of this data */
+    const std::shared_ptr<GridSpacingEstimateCache> & gridSpacingEstimates() const;
+
     QVtkTableModel * tableModel();
 
     /**
@@ -27,6 +27,8 @@
 #include <vtkPassThrough.h>
 #include <vtkTrivialProducer.h>
 
+#include <core/utility/GridSpacingEstimateCache.h>
+
 
 
 vtkInformationKeyMacro(DataObjectPrivate, DATA_OBJECT, IntegerPointer);
@@ -40,6 +42,7 @@ DataObjectPrivate::DataObjectPrivate(DataObject & dataObject, const QString & na
     , m_bounds{}
     , m_numberOfPoints{ 0 }
     , m_numberOfCells{ 0 }
+    , m_gridSpacingEstimates{ std::make_shared<GridSpacingEstimateCache>() }
     , m_inCopyStructure{ false }
     , q_ptr{ dataObject }
     , m_nextProcessingStepId{ 0 }
@@ -43,6 +43,7 @@ class vtkInformationStringKey;
 class vtkObject;
 
 class DataObject;
+class GridSpacingEstimateCache;
 
 
 class CORE_API DataObjectPrivate
@@ -83,6 +84,8 @@ public:
     vtkIdType m_numberOfPoints;
     vtkIdType m_numberOfCells;
 
+    std::shared_ptr<GridSpacingEstimateCache> m_gridSpacingEstimates;
+
     /** Workaround flag for vtkPolyData::CopyStructure triggering ModifiedEvent after copying
     points, but not after copying cell arrays */
     bool m_inCopyStructure;
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <functional>
 
 #include <QDebug>
 
@@ -29,23 +30,30 @@
 #include <vtkCellCenters.h>
 #include <vtkExecutive.h>
 #include <vtkImageData.h>
-#include <vtkLineSource.h>
+#include <vtkInformationVector.h>
 #include <vtkMath.h>
+#include <vtkObjectFactory.h>
 #include <vtkPassArrays.h>
 #include <vtkPointData.h>
-#include <vtkProbeFilter.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataAlgorithm.h>
 #include <vtkRearrangeFields.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
+#include <vtkTrivialProducer.h>
 #include <vtkWarpScalar.h>
 
 #include <core/data_objects/CoordinateTransformableDataObject.h>
+#include <core/data_objects/DataObject_private.h>
 #include <core/context2D_data/DataProfile2DContextPlot.h>
 #include <core/filters/GeographicTransformationFilter.h>
-#include <core/filters/ImageBlankNonFiniteValuesFilter.h>
+#include <core/filters/ImageLineProbeFilter.h>
 #include <core/filters/LineOnCellsSelector2D.h>
 #include <core/filters/LineOnPointsSelector2D.h>
-#include <core/filters/SetMaskedPointScalarsToNaNFilter.h>
+#include <core/filters/SpaceTimeProfileFilter.h>
+#include <core/filters/SwathProfileFilter.h>
+#include <core/filters/TemporalDataSource.h>
 #include <core/table_model/QVtkTableModelProfileData.h>
 #include <core/utility/DataExtent.h>
 #include <core/utility/macros.h>
@@ -53,6 +61,116 @@
 #include <core/utility/vtkvectorhelper.h>
 
 
+namespace
+{
+
+/** Point clouds with more points estimate their grid spacing from a random sample. */
+const vtkIdType l_gridSpacingSamplingThreshold = 100000;
+
+/** Search upstream for a TemporalDataSource that provides the named temporal point attribute. */
+TemporalDataSource * findTemporalPointDataSource(vtkAlgorithm * algorithm, const char * attributeName)
+{
+    while (algorithm)
+    {
+        if (auto temporalSource = TemporalDataSource::SafeDownCast(algorithm))
+        {
+            if (temporalSource->TemporalAttributeIndex(
+                TemporalDataSource::POINT_DATA, attributeName) >= 0)
+            {
+                return temporalSource;
+            }
+        }
+
+        algorithm = algorithm->GetNumberOfInputPorts() > 0
+            && algorithm->GetNumberOfInputConnections(0) > 0
+            ? algorithm->GetInputAlgorithm(0, 0)
+            : nullptr;
+    }
+
+    return nullptr;
+}
+
+/**
+ * Compute the bounds and value ranges that the profile filters query, so that they are cached
+ * before the profile pipeline executes on a worker thread. The snapshot shares its points and
+ * arrays with the source pipeline, so that querying them there would modify shared caches.
+ */
+void precomputeSnapshotMetaData(vtkDataObject & snapshot, const char * scalarsName, IndexType location)
+{
+    auto dataSet = vtkDataSet::SafeDownCast(&snapshot);
+    if (!dataSet)
+    {
+        return;
+    }
+
+    double bounds[6];
+    dataSet->GetBounds(bounds);
+
+    auto cacheRanges = [] (vtkDataArray & array)
+    {
+        double range[2];
+        for (int c = 0; c < array.GetNumberOfComponents(); ++c)
+        {
+            array.GetRange(range, c);
+        }
+    };
+
+    auto pointSet = vtkPointSet::SafeDownCast(dataSet);
+    if (pointSet && pointSet->GetPoints() && pointSet->GetPoints()->GetData())
+    {
+        cacheRanges(*pointSet->GetPoints()->GetData());
+    }
+
+    if (auto scalars = IndexType_util(location).extractArray(dataSet, scalarsName))
+    {
+        cacheRanges(*scalars);
+    }
+}
+
+/**
+ * Source for the processed output of the profile. It is not connected to the profile pipeline,
+ * but shallow copies the profile pipeline's output when it executes. Thus, updates of downstream
+ * pipelines (e.g., while rendering) only reach the profile pipeline after the source was marked
+ * as modified, which is not the case while computeProfile() runs on a worker thread.
+ */
+class ProfileOutputSource : public vtkPolyDataAlgorithm
+{
+public:
+    vtkTypeMacro(ProfileOutputSource, vtkPolyDataAlgorithm);
+    static ProfileOutputSource * New();
+
+    vtkSmartPointer<vtkAlgorithm> profile;
+
+protected:
+    ProfileOutputSource()
+    {
+        SetNumberOfInputPorts(0);
+    }
+    ~ProfileOutputSource() override = default;
+
+    int RequestData(vtkInformation * /*request*/,
+        vtkInformationVector ** /*inputVector*/,
+        vtkInformationVector * outputVector) override
+    {
+        if (!profile || !profile->GetExecutive()->Update())
+        {
+            return 0;
+        }
+
+        vtkPolyData::GetData(outputVector)->ShallowCopy(profile->GetOutputDataObject(0));
+        return 1;
+    }
+
+private:
+    ProfileOutputSource(const ProfileOutputSource &) = delete;
+    void operator=(const ProfileOutputSource &) = delete;
+};
+
+vtkStandardNewMacro(ProfileOutputSource);
+
+}
+
+
 DataProfile2DDataObject::PreprocessingPipeline::PreprocessingPipeline(
         vtkAlgorithm * head, vtkAlgorithm * tail)
     : head{ head }
@@ -75,12 +193,20 @@ DataProfile2DDataObject::DataProfile2DDataObject(
     , m_scalarsName{ scalarsName }
     , m_scalarsLocation{ scalarsLocation }
     , m_vectorComponent{ vectorComponent }
+    , m_sourceSnapshotMTime{}
     , m_profileLinePoint1{ 0.0, 0.0 }
     , m_profileLinePoint2{ 1.0, 0.0 }
     , m_doTransformPoints{ false }
+    , m_lineProfileOutputPort{ 0 }
+    , m_swathWidth{ 0.0 }
+    , m_numSwathBins{ 100 }
+    , m_samplingResolution{ 1.0 }
     , m_outputTransformation{ vtkSmartPointer<vtkTransformPolyDataFilter>::New() }
     , m_graphLine{ vtkSmartPointer<vtkWarpScalar>::New() }
+    , m_profileOutput{ vtkSmartPointer<ProfileOutputSource>::New() }
 {
+    static_cast<ProfileOutputSource &>(*m_profileOutput).profile = m_graphLine;
+
     // (1) Check if the input DataObject is transformable to a metric coordinate system
 
     if (!dynamic_cast<CoordinateTransformableDataObject *>(&sourceData))
@@ -172,6 +298,11 @@ DataProfile2DDataObject::DataProfile2DDataObject(
         return;
     }
 
+    // The profile pipeline is fed from a shallow copy of the source data, so that it does not share
+    // pipeline objects with other visualizations and can be executed on a worker thread.
+    m_sourceSnapshot = vtkSmartPointer<vtkTrivialProducer>::New();
+    updateSourceSnapshot();
+
     const auto c_scalarsName = scalarsName.toUtf8();
     const auto location = IndexType_util(scalarsLocation);
     auto scalars = location.extractArray(inputData, c_scalarsName.data());
@@ -187,7 +318,7 @@ DataProfile2DDataObject::DataProfile2DDataObject(
     filterFields->AddFieldType(vtkDataObject::POINT);
     filterFields->AddFieldType(vtkDataObject::CELL);
     filterFields->AddFieldType(vtkDataObject::FIELD);
-    filterFields->SetInputConnection(m_sourceAlgorithm->GetOutputPort());
+    filterFields->SetInputConnection(m_sourceSnapshot->GetOutputPort());
 
     // Do not discard or distort normal and vector arrays.
     // vtkRearrangeFields will remove the previous attribute assignment, if such exists
@@ -201,7 +332,7 @@ DataProfile2DDataObject::DataProfile2DDataObject(
         vtkAssignAttribute::POINT_DATA);
     assignScalars->SetInputConnection(unassignField->GetOutputPort());
 
-    // After probing, only pass the required scalar array, remove point masks etc.
+    // After selecting cells, only pass the required scalar array
     auto removeAuxArrays = vtkSmartPointer<vtkPassArrays>::New();
     removeAuxArrays->UseFieldTypesOn();
     removeAuxArrays->AddFieldType(vtkDataObject::POINT);
@@ -210,23 +341,13 @@ DataProfile2DDataObject::DataProfile2DDataObject(
 
     if (m_inputIsImage)
     {
-        m_probeLine = vtkSmartPointer<vtkLineSource>::New();
-
-        // In case the image contains NaN's, blank them to be correctly processed by vtkProbeFilter
-        auto blankNaNs = vtkSmartPointer<ImageBlankNonFiniteValuesFilter>::New();
-        blankNaNs->SetInputConnection(assignScalars->GetOutputPort());
-
-        auto imageProbe = vtkSmartPointer<vtkProbeFilter>::New();
-        imageProbe->SetInputConnection(m_probeLine->GetOutputPort());
-        imageProbe->SetSourceConnection(blankNaNs->GetOutputPort());
-
-        // restore NaN values after probing (based on invalid point mask)
-        auto invalidToNaN = vtkSmartPointer<SetMaskedPointScalarsToNaNFilter>::New();
-        invalidToNaN->SetInputConnection(imageProbe->GetOutputPort());
-
-        removeAuxArrays->SetInputConnection(invalidToNaN->GetOutputPort());
+        // Sample directly from the pixel grid, NaNs are propagated by the bilinear interpolation.
+        m_imageLineProbe = vtkSmartPointer<ImageLineProbeFilter>::New();
+        m_imageLineProbe->SetInputArrayToProcess(0, 0, 0,
+            vtkDataObject::FIELD_ASSOCIATION_POINTS, c_scalarsName.data());
+        m_imageLineProbe->SetInputConnection(assignScalars->GetOutputPort());
 
-        m_outputTransformation->SetInputConnection(removeAuxArrays->GetOutputPort());
+        m_outputTransformation->SetInputConnection(m_imageLineProbe->GetOutputPort());
     }
     else if (inputPolyData && inputPolyData->GetPoints() && inputPolyData->GetPoints()->GetNumberOfPoints() > 0)
     {
@@ -256,9 +377,19 @@ DataProfile2DDataObject::DataProfile2DDataObject(
             m_polyPointsSelector->SetSorting(LineOnPointsSelector2D::SortPoints);
             m_polyPointsSelector->PassDistanceToLineOff();
             m_polyPointsSelector->PassPositionOnLineOff();
+            // Share the estimate between all profiles of the data set.
+            m_polyPointsSelector->SetGridSpacingCache(sourceData.gridSpacingEstimates());
+            m_polyPointsSelector->SetSampleGridSpacing(
+                inputPolyData->GetNumberOfPoints() > l_gridSpacingSamplingThreshold);
             m_polyPointsSelector->SetInputConnection(unassignField->GetOutputPort());
 
             m_outputTransformation->SetInputConnection(m_polyPointsSelector->GetOutputPort(1));
+
+            if (scalarsLocation == IndexType::points)
+            {
+                m_temporalDataSource = findTemporalPointDataSource(
+                    m_sourceAlgorithm, c_scalarsName.data());
+            }
         }
         else
         {
@@ -272,6 +403,24 @@ DataProfile2DDataObject::DataProfile2DDataObject(
         return;
     }
 
+    m_lineProfileAlgorithm = m_outputTransformation->GetInputAlgorithm(0, 0, m_lineProfileOutputPort);
+
+    // Swath profiles process all values near the line, located at points or at cell centers.
+    m_swathFilter = vtkSmartPointer<SwathProfileFilter>::New();
+    m_swathFilter->SetComponent(static_cast<int>(vectorComponent));
+    m_swathFilter->SetInputArrayToProcess(0, 0, 0,
+        vtkDataObject::FIELD_ASSOCIATION_POINTS, c_scalarsName.data());
+    if (scalarsLocation == IndexType::points)
+    {
+        m_swathFilter->SetInputConnection(unassignField->GetOutputPort());
+    }
+    else
+    {
+        auto swathCellCenters = vtkSmartPointer<vtkCellCenters>::New();
+        swathCellCenters->SetInputConnection(unassignField->GetOutputPort());
+        m_swathFilter->SetInputConnection(swathCellCenters->GetOutputPort());
+    }
+
     auto assign = vtkSmartPointer<vtkAssignAttribute>::New();
     // output geometry is always points
     assign->Assign(c_scalarsName.data(), vtkDataSetAttributes::SCALARS, vtkAssignAttribute::POINT_DATA);
@@ -282,9 +431,9 @@ DataProfile2DDataObject::DataProfile2DDataObject(
     m_graphLine->SetInputConnection(assign->GetOutputPort());
 
     connect(&sourceData, &DataObject::dataChanged,
-        this, &DataProfile2DDataObject::sourceDataChanged);
+        this, &DataProfile2DDataObject::handleSourceDataChanged);
     connect(&sourceData, &DataObject::attributeArraysChanged,
-        this, &DataProfile2DDataObject::sourceDataChanged);
+        this, &DataProfile2DDataObject::handleSourceDataChanged);
 
     m_isValid = true;
 }
@@ -409,9 +558,133 @@ const CoordinateSystemSpecification & DataProfile2DDataObject::pointsCoordinateS
     return m_profileLinePointsCoordsSpec;
 }
 
+double DataProfile2DDataObject::swathWidth() const
+{
+    return m_swathWidth;
+}
+
+void DataProfile2DDataObject::setSwathWidth(double width)
+{
+    width = std::max(0.0, width);
+    if (!m_isValid || m_swathWidth == width)
+    {
+        return;
+    }
+
+    m_swathWidth = width;
+
+    updateSwathPipeline();
+}
+
+bool DataProfile2DDataObject::isSwathProfile() const
+{
+    return m_swathWidth > 0.0;
+}
+
+int DataProfile2DDataObject::numberOfSwathBins() const
+{
+    return m_swathFilter ? m_numSwathBins : 0;
+}
+
+void DataProfile2DDataObject::setNumberOfSwathBins(int numBins)
+{
+    numBins = std::max(1, numBins);
+    if (!m_isValid || m_numSwathBins == numBins)
+    {
+        return;
+    }
+
+    m_numSwathBins = numBins;
+
+    if (isSwathProfile())
+    {
+        updateSwathPipeline();
+    }
+}
+
+double DataProfile2DDataObject::samplingResolution() const
+{
+    return m_samplingResolution;
+}
+
+void DataProfile2DDataObject::setSamplingResolution(double resolution)
+{
+    resolution = std::max(0.01, std::min(1.0, resolution));
+    if (!m_isValid || m_samplingResolution == resolution)
+    {
+        return;
+    }
+
+    m_samplingResolution = resolution;
+    updateSamplingResolution();
+
+    if (m_imageLineProbe || isSwathProfile())
+    {
+        signal_profileChanged();
+    }
+}
+
+bool DataProfile2DDataObject::computeProfile()
+{
+    if (!m_isValid)
+    {
+        return false;
+    }
+
+    bool deferringEvents = false;
+    {
+        auto lock = dPtr().lockEventDeferrals();
+        deferringEvents = lock.isDeferringEvents();
+    }
+
+    if (deferringEvents)
+    {
+        // Only execute the profile pipeline here. The processed output is updated on request
+        // after the deferred events are executed.
+        return m_graphLine->GetExecutive()->Update() != 0;
+    }
+
+    auto outputPort = processedOutputPort();
+    return outputPort->GetProducer()->GetExecutive()->Update(outputPort->GetIndex()) != 0;
+}
+
+bool DataProfile2DDataObject::supportsSpaceTimeProfile() const
+{
+    return m_isValid && m_temporalDataSource && m_polyPointsSelector;
+}
+
+vtkSmartPointer<vtkImageData> DataProfile2DDataObject::createSpaceTimeProfile(int numDistanceBins)
+{
+    if (!supportsSpaceTimeProfile())
+    {
+        return nullptr;
+    }
+
+    // Reuse the points selected for the line profile, but read all time steps at once.
+    auto spaceTime = vtkSmartPointer<SpaceTimeProfileFilter>::New();
+    spaceTime->SetInputConnection(m_polyPointsSelector->GetInputConnection(0, 0));
+    spaceTime->SetSelectionConnection(m_polyPointsSelector->GetOutputPort(0));
+    spaceTime->SetTemporalDataSource(m_temporalDataSource);
+    spaceTime->SetAttributeName(m_scalarsName.toUtf8().data());
+    spaceTime->SetComponent(static_cast<int>(m_vectorComponent));
+    spaceTime->SetStartPoint(m_polyPointsSelector->GetStartPoint());
+    spaceTime->SetEndPoint(m_polyPointsSelector->GetEndPoint());
+    spaceTime->SetNumberOfBins(numDistanceBins);
+
+    if (!spaceTime->GetExecutive()->Update())
+    {
+        qWarning() << "Error while creating the space-time profile for" << name();
+        return nullptr;
+    }
+
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->ShallowCopy(spaceTime->GetOutput());
+    return image;
+}
+
 vtkAlgorithmOutput * DataProfile2DDataObject::processedOutputPortInternal()
 {
-    return m_graphLine->GetOutputPort();
+    return m_profileOutput->GetOutputPort();
 }
 
 std::unique_ptr<QVtkTableModel> DataProfile2DDataObject::createTableModel()
@@ -497,29 +770,14 @@ void DataProfile2DDataObject::updateLinePoints()
         p2 = m_profileLinePoint2;
     }
 
-    if (!m_sourceAlgorithm->GetExecutive()->Update())
-    {
-        qWarning() << "Error while updating plot source data for" << name();
-        return;
-    }
-
-    auto transformedSourceData = vtkSmartPointer<vtkDataSet>(vtkDataSet::SafeDownCast(
-        m_sourceAlgorithm->GetOutputDataObject(0)));
+    updateSourceSnapshot();
 
     const auto probeVector = p2 - p1;
 
-    if (auto image = vtkImageData::SafeDownCast(transformedSourceData))
+    if (m_imageLineProbe)
     {
-        m_probeLine->SetPoint1(convertTo<3>(p1).GetData());
-        m_probeLine->SetPoint2(convertTo<3>(p2).GetData());
-
-
-        vtkVector3d pointSpacing;
-        image->GetSpacing(pointSpacing.GetData());
-        const auto xyLength = probeVector / convertTo<2>(pointSpacing);
-        const int numProbePoints = static_cast<int>(xyLength.Norm());
-
-        m_probeLine->SetResolution(numProbePoints);
+        m_imageLineProbe->SetStartPoint(p1);
+        m_imageLineProbe->SetEndPoint(p2);
     }
     else if (m_polyCentroidsSelector)
     {
@@ -536,6 +794,9 @@ void DataProfile2DDataObject::updateLinePoints()
         assert(false);
     }
 
+    m_swathFilter->SetStartPoint(p1);
+    m_swathFilter->SetEndPoint(p2);
+
 
     auto m = vtkSmartPointer<vtkTransform>::New();
     m->PostMultiply();
@@ -548,6 +809,109 @@ void DataProfile2DDataObject::updateLinePoints()
 
     m_outputTransformation->SetTransform(m);
 
+    signal_profileChanged();
+}
+
+void DataProfile2DDataObject::updateSamplingResolution()
+{
+    if (m_imageLineProbe)
+    {
+        m_imageLineProbe->SetSamplesPerPixel(m_samplingResolution);
+    }
+
+    if (m_swathFilter)
+    {
+        m_swathFilter->SetNumberOfBins(std::max(1,
+            static_cast<int>(std::ceil(m_numSwathBins * m_samplingResolution))));
+    }
+}
+
+void DataProfile2DDataObject::updateSwathPipeline()
+{
+    {
+        auto lock = dPtr().lockEventDeferrals();
+        if (lock.isDeferringEvents())
+        {
+            // Don't modify the pipeline while the profile is computed. The current settings are
+            // applied when the events are executed.
+            lock.addDeferredEvent("updateSwathPipeline",
+                std::bind(&DataProfile2DDataObject::updateSwathPipeline, this));
+            return;
+        }
+    }
+
+    if (isSwathProfile())
+    {
+        m_swathFilter->SetWidth(m_swathWidth);
+    }
+    updateSamplingResolution();
+
+    auto profilePort = isSwathProfile()
+        ? m_swathFilter->GetOutputPort()
+        : m_lineProfileAlgorithm->GetOutputPort(m_lineProfileOutputPort);
+    if (m_outputTransformation->GetInputConnection(0, 0) != profilePort)
+    {
+        m_outputTransformation->SetInputConnection(profilePort);
+    }
+
+    signal_profileChanged();
+}
+
+void DataProfile2DDataObject::updateSourceSnapshot()
+{
+    if (!m_sourceAlgorithm->GetExecutive()->Update())
+    {
+        qWarning() << "Error while updating plot source data for" << name();
+        return;
+    }
+
+    auto sourceOutput = m_sourceAlgorithm->GetOutputDataObject(0);
+    if (m_sourceSnapshot->GetOutputDataObject(0)
+        && sourceOutput->GetMTime() <= m_sourceSnapshotMTime)
+    {
+        return;
+    }
+
+    auto snapshot = vtkSmartPointer<vtkDataObject>::Take(sourceOutput->NewInstance());
+    snapshot->ShallowCopy(sourceOutput);
+    precomputeSnapshotMetaData(*snapshot, m_scalarsName.toUtf8().data(), m_scalarsLocation);
+    m_sourceSnapshot->SetOutput(snapshot);
+    m_sourceSnapshotMTime = sourceOutput->GetMTime();
+}
+
+void DataProfile2DDataObject::handleSourceDataChanged()
+{
+    {
+        auto lock = dPtr().lockEventDeferrals();
+        if (lock.isDeferringEvents())
+        {
+            // Don't modify the pipeline while the profile is computed.
+            lock.addDeferredEvent("sourceDataChanged",
+                std::bind(&DataProfile2DDataObject::handleSourceDataChanged, this));
+            return;
+        }
+    }
+
+    updateSourceSnapshot();
+    m_profileOutput->Modified();
+
+    emit sourceDataChanged();
+}
+
+void DataProfile2DDataObject::signal_profileChanged()
+{
+    {
+        auto lock = dPtr().lockEventDeferrals();
+        if (lock.isDeferringEvents())
+        {
+            lock.addDeferredEvent("profileChanged",
+                std::bind(&DataProfile2DDataObject::signal_profileChanged, this));
+            return;
+        }
+    }
+
+    m_profileOutput->Modified();
+
     emit dataChanged();
     emit boundsChanged();
 }
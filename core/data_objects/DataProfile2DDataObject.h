@@ -29,18 +29,26 @@
 
 
 class vtkAlgorithm;
-class vtkLineSource;
+class vtkImageData;
 class vtkTransformPolyDataFilter;
+class vtkTrivialProducer;
 class vtkWarpScalar;
 
 enum class IndexType;
+class ImageLineProbeFilter;
 class LineOnCellsSelector2D;
 class LineOnPointsSelector2D;
+class SwathProfileFilter;
+class TemporalDataSource;
 
 
 /**
  * Probes the source data along a line defined by two points on the XY-plane and creates a plot for
  * the interpolated data.
+ *
+ * Alternatively, a swath profile summarizes all source values within a band along the line. The
+ * band is split into bins along the line, and the profile contains the statistics of each bin, see
+ * SwathProfileFilter.
  */
 class CORE_API DataProfile2DDataObject : public DataObject
 {
@@ -114,6 +122,50 @@ public:
     void setPointsCoordinateSystem(const CoordinateSystemSpecification & coordsSpec);
     const CoordinateSystemSpecification & pointsCoordinateSystem() const;
 
+    /**
+     * Width of the band for swath profiles, in the units of the profile's abscissa.
+     * Setting a width above zero switches to a swath profile, zero (default) to a line profile.
+     * While events are deferred (e.g., while computeProfile() runs on a worker thread), changes of
+     * the swath settings are applied to the pipeline when the events are executed.
+     */
+    double swathWidth() const;
+    void setSwathWidth(double width);
+    bool isSwathProfile() const;
+    /** Number of bins along the line for swath profiles. */
+    int numberOfSwathBins() const;
+    void setNumberOfSwathBins(int numBins);
+
+    /**
+     * Relative sampling density of image and swath profiles, in (0, 1]. Lower values compute
+     * decimated profiles, e.g., for previews while interacting. Default: 1 (full resolution)
+     * This must not be changed while computeProfile() runs on another thread.
+     */
+    double samplingResolution() const;
+    void setSamplingResolution(double resolution);
+
+    /**
+     * Execute the profile pipeline for the current settings.
+     * The pipeline is fed from a snapshot of the source data, so that this can be called on a
+     * worker thread, while this object defers its events (see deferEvents()). Deferred
+     * dataChanged() etc. signals are emitted when the results are available. Until then, the
+     * processed output keeps the previous profile, so that its consumers do not execute the
+     * profile pipeline concurrently.
+     */
+    bool computeProfile();
+
+    /**
+     * Whether the profile's scalars are a temporal point attribute (e.g., deformation time series)
+     * that can be exported as space-time profile.
+     */
+    bool supportsSpaceTimeProfile() const;
+    /**
+     * Create a matrix of the profile values for all time steps of the temporal attribute.
+     * The image's x-axis is the distance along the profile line, the y-axis the time step index.
+     * See SpaceTimeProfileFilter for details.
+     * @return nullptr if the profile does not support space-time profiles
+     */
+    vtkSmartPointer<vtkImageData> createSpaceTimeProfile(int numDistanceBins = 100);
+
 signals:
     /**
      * Emitted when the source data values are modified.
@@ -129,6 +181,14 @@ protected:
 private:
     void updateLinePointsTransform();
     void updateLinePoints();
+    void updateSamplingResolution();
+    /** Apply the swath settings to the pipeline, or queue that while deferring events. */
+    void updateSwathPipeline();
+    /** Shallow copy the source algorithm's output, if it was modified. */
+    void updateSourceSnapshot();
+    void handleSourceDataChanged();
+    /** Emit dataChanged() and boundsChanged(), or queue them while deferring events. */
+    void signal_profileChanged();
 
 private:
     bool m_isValid;
@@ -138,6 +198,8 @@ private:
     vtkIdType m_vectorComponent;
 
     vtkSmartPointer<vtkAlgorithm> m_sourceAlgorithm;
+    vtkSmartPointer<vtkTrivialProducer> m_sourceSnapshot;
+    vtkMTimeType m_sourceSnapshotMTime;
 
     vtkVector2d m_profileLinePoint1;
     vtkVector2d m_profileLinePoint2;
@@ -148,14 +210,25 @@ private:
 
     // extraction from vtkImageData
     bool m_inputIsImage;
-    vtkSmartPointer<vtkLineSource> m_probeLine;
+    vtkSmartPointer<ImageLineProbeFilter> m_imageLineProbe;
 
     // extraction from vtkPolyData
     vtkSmartPointer<LineOnCellsSelector2D> m_polyCentroidsSelector;
     vtkSmartPointer<LineOnPointsSelector2D> m_polyPointsSelector;
+    vtkSmartPointer<TemporalDataSource> m_temporalDataSource;
+
+    // line profile output, to switch between line and swath profiles
+    vtkSmartPointer<vtkAlgorithm> m_lineProfileAlgorithm;
+    int m_lineProfileOutputPort;
+    double m_swathWidth;
+    int m_numSwathBins;
+    double m_samplingResolution;
+    vtkSmartPointer<SwathProfileFilter> m_swathFilter;
 
     vtkSmartPointer<vtkTransformPolyDataFilter> m_outputTransformation;
     vtkSmartPointer<vtkWarpScalar> m_graphLine;
+    /** Decouples the processed output from the profile pipeline, see computeProfile() */
+    vtkSmartPointer<vtkAlgorithm> m_profileOutput;
 
 private:
     Q_DISABLE_COPY(DataProfile2DDataObject)
@@ -179,5 +179,9 @@ vtkSmartPointer<vtkAlgorithm> ImageDataObject::createTransformPipeline(
     auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
     filter->SetInputConnection(pipelineUpstream);
     filter->SetTargetCoordinateSystem(toSystem);
+    // Keep the image implicit, but resample it where origin/spacing don't approximate
+    // the transformation well enough. Resampled images provide the ids of this data set, which
+    // are used for picking and selections.
+    filter->SetImageTransform(GeographicTransformationFilter::ImageTransformAutomatic);
     return filter;
 }
@@ -32,6 +32,7 @@
 #include <core/rendered_data/RenderedVectorGrid3D.h>
 #include <core/table_model/QVtkTableModelVectorGrid3D.h>
 #include <core/utility/conversions.h>
+#include <core/utility/DataArrayRanges.h>
 #include <core/utility/DataExtent.h>
 
 
@@ -136,7 +137,7 @@ int VectorGrid3DDataObject::numberOfComponents()
 
 ValueRange<> VectorGrid3DDataObject::scalarRange(int component)
 {
-    return ValueRange<>(dataSet()->GetPointData()->GetScalars()->GetRange(component));
+    return DataArrayRanges::of(*dataSet()->GetPointData()->GetScalars()).range(component);
 }
 
 std::unique_ptr<QVtkTableModel> VectorGrid3DDataObject::createTableModel()
@@ -0,0 +1,584 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DEMRepairFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include <vtkArrayDispatch.h>
+#include <vtkAssume.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+
+vtkStandardNewMacro(DEMRepairFilter);
+
+
+namespace
+{
+
+/** Number of image rows/columns processed per task. */
+const vtkIdType linesPerTask = 64;
+
+enum PixelState : unsigned char
+{
+    Valid = 0,
+    Filled = 1,
+    Unfilled = 2
+};
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, T>::type fromDouble(double value)
+{
+    return static_cast<T>(std::round(value));
+}
+
+template <typename T>
+typename std::enable_if<!std::is_integral<T>::value, T>::type fromDouble(double value)
+{
+    return static_cast<T>(value);
+}
+
+struct RepairWorker
+{
+    vtkIdType nx, ny, nz;
+
+    bool detectNaN;
+    bool detectNoDataValue;
+    double noDataValue;
+    bool detectSpikes;
+    double spikeThreshold;
+
+    DEMRepairFilter::FillStrategy fill;
+    int searchRadius;
+    double inverseDistancePower;
+    int numberOfIterations;
+
+    vtkIdType numberOfUnfilledValues = 0;
+
+    /** Per pixel PixelState; during filling, all invalid values are marked as Filled. */
+    std::vector<unsigned char> state;
+    /** Sorted indices of all invalid values */
+    std::vector<vtkIdType> invalidIds;
+    /** Offsets of each row's values in invalidIds, with an additional entry for the end. */
+    std::vector<vtkIdType> rowOffsets;
+
+    /** Fill the values previously found by detect(), in a copy of the detection input. */
+    template <typename ValueArray>
+    void operator()(ValueArray * values)
+    {
+        VTK_ASSUME(values->GetNumberOfComponents() == 1);
+
+        std::vector<unsigned char> filled;
+        switch (this->fill)
+        {
+        case DEMRepairFilter::FillInverseDistance:
+            this->fillInverseDistance(values, filled);
+            break;
+        case DEMRepairFilter::FillDirectionalMean:
+        case DEMRepairFilter::FillDiffusion:
+            this->fillDirectionalMean(values, filled);
+            break;
+        }
+
+        auto & state = this->state;
+        const auto & ids = this->invalidIds;
+        vtkSMPTools::For(0, static_cast<vtkIdType>(ids.size()),
+            [&state, &ids, &filled] (vtkIdType begin, vtkIdType end)
+        {
+            for (auto c = begin; c < end; ++c)
+            {
+                state[static_cast<size_t>(ids[c])] = filled[c] ? Filled : Unfilled;
+            }
+        });
+
+        this->numberOfUnfilledValues = static_cast<vtkIdType>(
+            std::count(filled.begin(), filled.end(), static_cast<unsigned char>(0)));
+
+        if (this->fill == DEMRepairFilter::FillDiffusion)
+        {
+            this->diffuse(values);
+        }
+    }
+
+    template <typename ValueArray>
+    void detect(ValueArray * values)
+    {
+        VTK_ASSUME(values->GetNumberOfComponents() == 1);
+
+        const auto numRows = this->ny * this->nz;
+        const auto nx = this->nx;
+        const auto numValues = nx * numRows;
+
+        this->state.assign(static_cast<size_t>(numValues), Valid);
+        this->rowOffsets.assign(static_cast<size_t>(numRows + 1), 0);
+
+        const auto isInvalid = [this] (double value)
+        {
+            return (this->detectNaN && std::isnan(value))
+                || (this->detectNoDataValue && value == this->noDataValue)
+                || (this->detectSpikes && value > this->spikeThreshold);
+        };
+
+        auto & state = this->state;
+        auto & rowOffsets = this->rowOffsets;
+
+        vtkSMPTools::For(0, numRows, linesPerTask,
+            [values, nx, &state, &rowOffsets, &isInvalid] (vtkIdType begin, vtkIdType end)
+        {
+            vtkDataArrayAccessor<ValueArray> v(values);
+            for (auto row = begin; row < end; ++row)
+            {
+                vtkIdType count = 0;
+                for (auto id = row * nx; id < (row + 1) * nx; ++id)
+                {
+                    if (isInvalid(static_cast<double>(v.Get(id, 0))))
+                    {
+                        state[static_cast<size_t>(id)] = Filled;
+                        ++count;
+                    }
+                }
+                rowOffsets[static_cast<size_t>(row + 1)] = count;
+            }
+        });
+
+        std::partial_sum(rowOffsets.begin(), rowOffsets.end(), rowOffsets.begin());
+
+        this->invalidIds.resize(static_cast<size_t>(rowOffsets.back()));
+        auto & ids = this->invalidIds;
+
+        vtkSMPTools::For(0, numRows, linesPerTask,
+            [nx, &state, &rowOffsets, &ids] (vtkIdType begin, vtkIdType end)
+        {
+            for (auto row = begin; row < end; ++row)
+            {
+                auto c = rowOffsets[static_cast<size_t>(row)];
+                for (auto id = row * nx; id < (row + 1) * nx; ++id)
+                {
+                    if (state[static_cast<size_t>(id)] != Valid)
+                    {
+                        ids[static_cast<size_t>(c++)] = id;
+                    }
+                }
+            }
+        });
+    }
+
+    /**
+     * Find the nearest valid values along rows and columns in linear passes. Rows are processed
+     * individually, columns in blocks of linesPerTask so that memory is accessed row by row.
+     */
+    template <typename ValueArray>
+    void fillDirectionalMean(ValueArray * values, std::vector<unsigned char> & filled)
+    {
+        const auto nx = this->nx;
+        const auto ny = this->ny;
+        const auto numInvalid = static_cast<vtkIdType>(this->invalidIds.size());
+        const auto & state = this->state;
+        const auto & ids = this->invalidIds;
+        const auto & rowOffsets = this->rowOffsets;
+
+        std::vector<double> sums(static_cast<size_t>(numInvalid), 0.0);
+        std::vector<unsigned char> counts(static_cast<size_t>(numInvalid), 0);
+
+        vtkSMPTools::For(0, ny * this->nz, linesPerTask,
+            [values, nx, &state, &rowOffsets, &sums, &counts] (vtkIdType begin, vtkIdType end)
+        {
+            vtkDataArrayAccessor<ValueArray> v(values);
+            for (auto row = begin; row < end; ++row)
+            {
+                const auto rowStart = row * nx;
+                // left to right
+                auto c = rowOffsets[static_cast<size_t>(row)];
+                bool hasValid = false;
+                double lastValid = 0.0;
+                for (auto id = rowStart; id < rowStart + nx; ++id)
+                {
+                    if (state[static_cast<size_t>(id)] == Valid)
+                    {
+                        hasValid = true;
+                        lastValid = static_cast<double>(v.Get(id, 0));
+                    }
+                    else
+                    {
+                        if (hasValid)
+                        {
+                            sums[static_cast<size_t>(c)] += lastValid;
+                            ++counts[static_cast<size_t>(c)];
+                        }
+                        ++c;
+                    }
+                }
+                // right to left
+                hasValid = false;
+                for (auto id = rowStart + nx - 1; id >= rowStart; --id)
+                {
+                    if (state[static_cast<size_t>(id)] == Valid)
+                    {
+                        hasValid = true;
+                        lastValid = static_cast<double>(v.Get(id, 0));
+                    }
+                    else
+                    {
+                        --c;
+                        if (hasValid)
+                        {
+                            sums[static_cast<size_t>(c)] += lastValid;
+                            ++counts[static_cast<size_t>(c)];
+                        }
+                    }
+                }
+            }
+        });
+
+        const auto blocksPerSlice = (nx + linesPerTask - 1) / linesPerTask;
+
+        vtkSMPTools::For(0, blocksPerSlice * this->nz, 1,
+            [values, nx, ny, blocksPerSlice, &state, &ids, &rowOffsets, &sums, &counts]
+            (vtkIdType begin, vtkIdType end)
+        {
+            vtkDataArrayAccessor<ValueArray> v(values);
+            std::vector<double> lastValid(static_cast<size_t>(linesPerTask));
+            std::vector<unsigned char> hasValid(static_cast<size_t>(linesPerTask));
+
+            for (auto block = begin; block < end; ++block)
+            {
+                const auto z = block / blocksPerSlice;
+                const auto x0 = (block % blocksPerSlice) * linesPerTask;
+                const auto x1 = std::min(nx, x0 + linesPerTask);
+
+                const auto processRow = [&] (vtkIdType y)
+                {
+                    const auto row = z * ny + y;
+                    const auto rowStart = row * nx;
+                    // invalid values of this row within the block, in ascending order
+                    auto c = std::lower_bound(
+                        ids.begin() + rowOffsets[static_cast<size_t>(row)],
+                        ids.begin() + rowOffsets[static_cast<size_t>(row + 1)],
+                        rowStart + x0) - ids.begin();
+
+                    for (auto x = x0; x < x1; ++x)
+                    {
+                        const auto id = rowStart + x;
+                        const auto b = static_cast<size_t>(x - x0);
+                        if (state[static_cast<size_t>(id)] == Valid)
+                        {
+                            hasValid[b] = true;
+                            lastValid[b] = static_cast<double>(v.Get(id, 0));
+                            continue;
+                        }
+                        if (hasValid[b])
+                        {
+                            sums[static_cast<size_t>(c)] += lastValid[b];
+                            ++counts[static_cast<size_t>(c)];
+                        }
+                        ++c;
+                    }
+                };
+
+                // bottom to top
+                std::fill(hasValid.begin(), hasValid.end(), false);
+                for (vtkIdType y = 0; y < ny; ++y)
+                {
+                    processRow(y);
+                }
+                // top to bottom
+                std::fill(hasValid.begin(), hasValid.end(), false);
+                for (auto y = ny - 1; y >= 0; --y)
+                {
+                    processRow(y);
+                }
+            }
+        });
+
+        filled.resize(static_cast<size_t>(numInvalid));
+
+        vtkSMPTools::For(0, numInvalid,
+            [values, &ids, &sums, &counts, &filled] (vtkIdType begin, vtkIdType end)
+        {
+            using ValueType = typename vtkDataArrayAccessor<ValueArray>::APIType;
+            vtkDataArrayAccessor<ValueArray> v(values);
+            for (auto c = begin; c < end; ++c)
+            {
+                const auto count = counts[static_cast<size_t>(c)];
+                filled[static_cast<size_t>(c)] = count > 0;
+                if (count > 0)
+                {
+                    v.Set(ids[static_cast<size_t>(c)], 0,
+                        fromDouble<ValueType>(sums[static_cast<size_t>(c)] / count));
+                }
+            }
+        });
+    }
+
+    template <typename ValueArray>
+    void fillInverseDistance(ValueArray * values, std::vector<unsigned char> & filled)
+    {
+        const auto nx = this->nx;
+        const auto ny = this->ny;
+        const auto r = static_cast<vtkIdType>(this->searchRadius);
+        const auto numInvalid = static_cast<vtkIdType>(this->invalidIds.size());
+        const auto & state = this->state;
+        const auto & ids = this->invalidIds;
+
+        // weights for the offsets within the search radius, 0 outside of the radius
+        const auto windowSize = 2 * r + 1;
+        std::vector<double> weights(static_cast<size_t>(windowSize * windowSize), 0.0);
+        for (auto dy = -r; dy <= r; ++dy)
+        {
+            for (auto dx = -r; dx <= r; ++dx)
+            {
+                const auto distance2 = static_cast<double>(dx * dx + dy * dy);
+                if (distance2 > 0.0 && distance2 <= static_cast<double>(r * r))
+                {
+                    weights[static_cast<size_t>((dy + r) * windowSize + dx + r)] =
+                        std::pow(distance2, -0.5 * this->inverseDistancePower);
+                }
+            }
+        }
+
+        filled.resize(static_cast<size_t>(numInvalid));
+
+        vtkSMPTools::For(0, numInvalid,
+            [values, nx, ny, r, windowSize, &weights, &state, &ids, &filled]
+            (vtkIdType begin, vtkIdType end)
+        {
+            using ValueType = typename vtkDataArrayAccessor<ValueArray>::APIType;
+            vtkDataArrayAccessor<ValueArray> v(values);
+            for (auto c = begin; c < end; ++c)
+            {
+                const auto id = ids[static_cast<size_t>(c)];
+                const auto x = id % nx;
+                const auto y = (id / nx) % ny;
+                const auto sliceStart = id - x - y * nx;
+
+                double weightedSum = 0.0, weightSum = 0.0;
+                for (auto yi = std::max(vtkIdType(0), y - r); yi <= std::min(ny - 1, y + r); ++yi)
+                {
+                    const auto weightsRow = (yi - y + r) * windowSize + r - x;
+                    for (auto xi = std::max(vtkIdType(0), x - r); xi <= std::min(nx - 1, x + r); ++xi)
+                    {
+                        const auto neighbor = sliceStart + yi * nx + xi;
+                        const auto weight = weights[static_cast<size_t>(weightsRow + xi)];
+                        if (weight > 0.0 && state[static_cast<size_t>(neighbor)] == Valid)
+                        {
+                            weightedSum += weight * static_cast<double>(v.Get(neighbor, 0));
+                            weightSum += weight;
+                        }
+                    }
+                }
+
+                filled[static_cast<size_t>(c)] = weightSum > 0.0;
+                if (weightSum > 0.0)
+                {
+                    v.Set(id, 0, fromDouble<ValueType>(weightedSum / weightSum));
+                }
+            }
+        });
+    }
+
+    /**
+     * Red-black Gauss-Seidel iterations of the Laplace equation on the filled values. In each
+     * half step, only values with the same parity are updated, which only depend on values of the
+     * other parity. So, values can be updated in place and in parallel.
+     */
+    template <typename ValueArray>
+    void diffuse(ValueArray * values)
+    {
+        const auto nx = this->nx;
+        const auto ny = this->ny;
+        const auto numInvalid = static_cast<vtkIdType>(this->invalidIds.size());
+        const auto & state = this->state;
+        const auto & ids = this->invalidIds;
+
+        for (int i = 0; i < 2 * this->numberOfIterations; ++i)
+        {
+            const vtkIdType parity = i % 2;
+
+            vtkSMPTools::For(0, numInvalid,
+                [values, nx, ny, parity, &state, &ids] (vtkIdType begin, vtkIdType end)
+            {
+                using ValueType = typename vtkDataArrayAccessor<ValueArray>::APIType;
+                vtkDataArrayAccessor<ValueArray> v(values);
+                for (auto c = begin; c < end; ++c)
+                {
+                    const auto id = ids[static_cast<size_t>(c)];
+                    const auto x = id % nx;
+                    const auto y = (id / nx) % ny;
+                    if ((x + y) % 2 != parity || state[static_cast<size_t>(id)] != Filled)
+                    {
+                        continue;
+                    }
+
+                    double sum = 0.0;
+                    int count = 0;
+                    const auto add = [&] (vtkIdType neighbor)
+                    {
+                        if (state[static_cast<size_t>(neighbor)] != Unfilled)
+                        {
+                            sum += static_cast<double>(v.Get(neighbor, 0));
+                            ++count;
+                        }
+                    };
+                    if (x > 0) add(id - 1);
+                    if (x < nx - 1) add(id + 1);
+                    if (y > 0) add(id - nx);
+                    if (y < ny - 1) add(id + nx);
+
+                    if (count > 0)
+                    {
+                        v.Set(id, 0, fromDouble<ValueType>(sum / count));
+                    }
+                }
+            });
+        }
+    }
+};
+
+struct DetectionWorker
+{
+    RepairWorker & repair;
+
+    template <typename ValueArray>
+    void operator()(ValueArray * values)
+    {
+        this->repair.detect(values);
+    }
+};
+
+}
+
+
+DEMRepairFilter::DEMRepairFilter()
+    : Superclass()
+    , DetectNaN{ true }
+    , DetectNoDataValue{ false }
+    , NoDataValue{ -32768.0 }
+    , DetectSpikes{ false }
+    , SpikeThreshold{ 0.0 }
+    , Fill{ FillDirectionalMean }
+    , SearchRadius{ 8 }
+    , InverseDistancePower{ 2.0 }
+    , NumberOfIterations{ 100 }
+    , NumberOfDetectedValues{ 0 }
+    , NumberOfUnfilledValues{ 0 }
+{
+}
+
+DEMRepairFilter::~DEMRepairFilter() = default;
+
+int DEMRepairFilter::RequestUpdateExtent(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * /*outputVector*/)
+{
+    // Voids are filled from values anywhere in the image, so always request the whole input.
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+
+    return 1;
+}
+
+int DEMRepairFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    auto outInfo = outputVector->GetInformationObject(0);
+
+    auto inImage = vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+    auto outImage = vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    this->NumberOfDetectedValues = 0;
+    this->NumberOfUnfilledValues = 0;
+
+    auto elevations = inImage->GetPointData()->GetScalars();
+    if (!elevations || elevations->GetNumberOfComponents() != 1
+        || elevations->GetNumberOfTuples() != inImage->GetNumberOfPoints())
+    {
+        vtkErrorMacro("Could not find valid elevations in image scalars.");
+        return 0;
+    }
+
+    outImage->CopyStructure(inImage);
+    outImage->GetPointData()->PassData(inImage->GetPointData());
+    outImage->GetCellData()->PassData(inImage->GetCellData());
+
+    // Skip the detection pass entirely if there is nothing to detect.
+    if (!this->DetectNaN && !this->DetectNoDataValue && !this->DetectSpikes)
+    {
+        return 1;
+    }
+
+    int dimensions[3];
+    inImage->GetDimensions(dimensions);
+
+    RepairWorker worker;
+    worker.nx = dimensions[0];
+    worker.ny = dimensions[1];
+    worker.nz = dimensions[2];
+    worker.detectNaN = this->DetectNaN;
+    worker.detectNoDataValue = this->DetectNoDataValue;
+    worker.noDataValue = this->NoDataValue;
+    worker.detectSpikes = this->DetectSpikes;
+    worker.spikeThreshold = this->SpikeThreshold;
+    worker.fill = this->Fill;
+    worker.searchRadius = this->SearchRadius;
+    worker.inverseDistancePower = this->InverseDistancePower;
+    worker.numberOfIterations = this->NumberOfIterations;
+
+    DetectionWorker detection{ worker };
+    if (!vtkArrayDispatch::Dispatch::Execute(elevations, detection))
+    {
+        detection(elevations);
+    }
+
+    this->NumberOfDetectedValues = static_cast<vtkIdType>(worker.invalidIds.size());
+
+    // Pass the input elevations if there is nothing to repair.
+    if (this->NumberOfDetectedValues == 0)
+    {
+        return 1;
+    }
+
+    auto repairedElevations = vtkSmartPointer<vtkDataArray>::Take(elevations->NewInstance());
+    repairedElevations->DeepCopy(elevations);
+    outImage->GetPointData()->SetScalars(repairedElevations);
+
+    if (!vtkArrayDispatch::Dispatch::Execute(repairedElevations.Get(), worker))
+    {
+        worker(repairedElevations.Get());
+    }
+
+    this->NumberOfUnfilledValues = worker.numberOfUnfilledValues;
+
+    return 1;
+}
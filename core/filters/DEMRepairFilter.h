@@ -0,0 +1,132 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkImageAlgorithm.h>
+
+#include <core/core_api.h>
+
+
+/**
+ * Removal of spikes and voids in Digital Elevation Models.
+ *
+ * Elevations are read from the image scalars, which must have a single component. Invalid values
+ * are detected as NaN, as a specific no-data value, and/or as spikes above a threshold. These
+ * values are replaced by interpolating from valid elevations, using one of the FillStrategy
+ * methods. Other point and cell attributes are passed unchanged.
+ *
+ * Detection and filling run in parallel on the image rows and columns and on the detected values,
+ * so that costs mostly depend on the number of invalid values, not on the size of voids.
+ * Values that cannot be filled, because no valid elevation could be found, are passed unchanged.
+ * If no invalid values are detected, or if all detection methods are disabled, the input elevations
+ * are passed without copying.
+ */
+class CORE_API DEMRepairFilter : public vtkImageAlgorithm
+{
+public:
+    vtkTypeMacro(DEMRepairFilter, vtkImageAlgorithm);
+    static DEMRepairFilter * New();
+
+    /** Detect NaN values as voids. Enabled by default. */
+    vtkGetMacro(DetectNaN, bool);
+    vtkSetMacro(DetectNaN, bool);
+    vtkBooleanMacro(DetectNaN, bool);
+
+    /** Detect values equal to NoDataValue as voids. Disabled by default. */
+    vtkGetMacro(DetectNoDataValue, bool);
+    vtkSetMacro(DetectNoDataValue, bool);
+    vtkBooleanMacro(DetectNoDataValue, bool);
+    /** Default: -32768, as used in SRTM data sets. */
+    vtkGetMacro(NoDataValue, double);
+    vtkSetMacro(NoDataValue, double);
+
+    /** Detect values above SpikeThreshold as spikes. Disabled by default. */
+    vtkGetMacro(DetectSpikes, bool);
+    vtkSetMacro(DetectSpikes, bool);
+    vtkBooleanMacro(DetectSpikes, bool);
+    vtkGetMacro(SpikeThreshold, double);
+    vtkSetMacro(SpikeThreshold, double);
+
+    enum FillStrategy
+    {
+        /**
+         * Mean of the nearest valid values to the left, right, top, and bottom of an invalid
+         * value. This is the default.
+         */
+        FillDirectionalMean,
+        /**
+         * Inverse distance weighted mean of all valid values within SearchRadius. Weights are
+         * computed as distance^(-InverseDistancePower).
+         */
+        FillInverseDistance,
+        /**
+         * Starting with the directional mean, iteratively replace invalid values by the mean of
+         * their four neighbors. This results in smooth surfaces across larger voids.
+         */
+        FillDiffusion
+    };
+    vtkGetMacro(Fill, FillStrategy);
+    vtkSetClampMacro(Fill, FillStrategy, FillDirectionalMean, FillDiffusion);
+
+    /** Search radius in pixels for FillInverseDistance. Default: 8 */
+    vtkGetMacro(SearchRadius, int);
+    vtkSetClampMacro(SearchRadius, int, 1, 1024);
+    /** Default: 2 */
+    vtkGetMacro(InverseDistancePower, double);
+    vtkSetClampMacro(InverseDistancePower, double, 0.0, 16.0);
+
+    /** Number of smoothing iterations for FillDiffusion. Default: 100 */
+    vtkGetMacro(NumberOfIterations, int);
+    vtkSetClampMacro(NumberOfIterations, int, 0, VTK_INT_MAX);
+
+    /** Number of invalid values detected in the last update. */
+    vtkGetMacro(NumberOfDetectedValues, vtkIdType);
+    /** Number of detected values that could not be filled in the last update. */
+    vtkGetMacro(NumberOfUnfilledValues, vtkIdType);
+
+protected:
+    DEMRepairFilter();
+    ~DEMRepairFilter() override;
+
+    int RequestUpdateExtent(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    bool DetectNaN;
+    bool DetectNoDataValue;
+    double NoDataValue;
+    bool DetectSpikes;
+    double SpikeThreshold;
+    FillStrategy Fill;
+    int SearchRadius;
+    double InverseDistancePower;
+    int NumberOfIterations;
+
+    vtkIdType NumberOfDetectedValues;
+    vtkIdType NumberOfUnfilledValues;
+
+private:
+    DEMRepairFilter(const DEMRepairFilter &) = delete;
+    void operator=(const DEMRepairFilter &) = delete;
+};
@@ -0,0 +1,386 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DEMShadedColorsFilter.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <vtkArrayDispatch.h>
+#include <vtkAssume.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkVector.h>
+
+#include <core/utility/DataExtent.h>
+#include <core/utility/vtkvectorhelper.h>
+
+
+vtkStandardNewMacro(DEMShadedColorsFilter);
+
+
+namespace
+{
+
+/** Number of image rows processed per task. */
+const vtkIdType rowsPerTask = 16;
+
+/**
+ * Per pixel normal and lightness computation, using the same operations and value types as
+ * DEMImageNormals and DEMShadingFilter.
+ * Normals and lightness are stored in the optional arrays, the lightness is then passed to a
+ * function that applies it to the output.
+ */
+struct ShadingKernel
+{
+    vtkVector3<vtkIdType> dimensions;
+    vtkVector2d xyScale;
+    vtkVector3f toLight;
+    double diffuse;
+    double ambient;
+    /** Optional, must be of the same type as the elevations array. */
+    vtkDataArray * normals = nullptr;
+    /** Optional */
+    vtkFloatArray * lightness = nullptr;
+
+    template <typename ElevationArray, typename ApplyLightness>
+    void operator()(ElevationArray * elevations, ApplyLightness && applyLightness) const
+    {
+        VTK_ASSUME(elevations->GetNumberOfComponents() == 1);
+
+        using NormalValueType = typename vtkDataArrayAccessor<ElevationArray>::APIType;
+
+        const auto dims = this->dimensions;
+        const auto scale = convertTo<NormalValueType>(this->xyScale);
+        const auto l = this->toLight;
+        const auto d = this->diffuse;
+        const auto a = this->ambient;
+        // Normals are undefined for images that are flat in x or y direction.
+        const bool computeNormals = dims[0] > 1 && dims[1] > 1;
+        auto normalsArray = static_cast<ElevationArray *>(this->normals);
+        auto lightnessArray = this->lightness;
+
+        vtkSMPTools::For(0, dims[1] * dims[2], rowsPerTask,
+            [&] (vtkIdType beginRow, vtkIdType endRow)
+        {
+            vtkDataArrayAccessor<ElevationArray> e(elevations);
+            vtkDataArrayAccessor<ElevationArray> n(normalsArray);
+            vtkDataArrayAccessor<vtkFloatArray> lOut(lightnessArray);
+            vtkVector3<NormalValueType> normal(0, 0, 1);
+
+            for (auto row = beginRow; row < endRow; ++row)
+            {
+                const auto y = row % dims[1];
+                const auto rowOffset = row * dims[0];
+                const auto southOffset = y == dims[1] - 1 ? -dims[0] : dims[0];
+
+                for (vtkIdType x = 0; x < dims[0]; ++x)
+                {
+                    const auto idx = rowOffset + x;
+
+                    if (computeNormals)
+                    {
+                        const auto eastOffset = x == dims[0] - 1 ? -1 : 1;
+
+                        const auto e_pos = e.Get(idx, 0);
+                        const auto e_diffEast = e_pos - e.Get(idx + eastOffset, 0);
+                        const auto e_diffSouth = e_pos - e.Get(idx + southOffset, 0);
+
+                        normal = {
+                            static_cast<NormalValueType>(e_diffEast * scale[0]),
+                            static_cast<NormalValueType>(e_diffSouth * scale[1]),
+                            static_cast<NormalValueType>(1.0)
+                        };
+                        normal.Normalize();
+                    }
+
+                    const auto df = std::max(0.0f, convertTo<float>(normal).Dot(l));
+                    const auto lightValue = static_cast<float>(std::min(1.0, a + d * df));
+
+                    if (normalsArray)
+                    {
+                        n.Set(idx, normal.GetData());
+                    }
+                    if (lightnessArray)
+                    {
+                        lOut.Set(idx, 0, lightValue);
+                    }
+
+                    applyLightness(idx, lightValue);
+                }
+            }
+        });
+    }
+};
+
+struct LightnessWorker
+{
+    const ShadingKernel & kernel;
+
+    template <typename ElevationArray>
+    void operator()(ElevationArray * elevations)
+    {
+        assert(kernel.lightness);
+        kernel(elevations, [] (vtkIdType, float) {});
+    }
+};
+
+struct ShadedColorsWorker
+{
+    const ShadingKernel & kernel;
+    /** Instance of the colors array type, thus accessed as ColorArray */
+    vtkDataArray * outputColors;
+
+    template <typename ElevationArray, typename ColorArray>
+    void operator()(ElevationArray * elevations, ColorArray * colors)
+    {
+        auto output = static_cast<ColorArray *>(outputColors);
+
+        VTK_ASSUME(colors->GetNumberOfComponents() == output->GetNumberOfComponents());
+        VTK_ASSUME(elevations->GetNumberOfTuples() == colors->GetNumberOfTuples());
+        VTK_ASSUME(elevations->GetNumberOfTuples() == output->GetNumberOfTuples());
+
+        using OutputValueType = typename vtkDataArrayAccessor<ColorArray>::APIType;
+
+        const int numComponents = std::min(3, colors->GetNumberOfComponents());
+        const bool passAlpha = colors->GetNumberOfComponents() == 4;
+
+        vtkDataArrayAccessor<ColorArray> c(colors);
+        vtkDataArrayAccessor<ColorArray> o(output);
+
+        kernel(elevations, [c, o, numComponents, passAlpha] (vtkIdType tupleIdx, float lightValue) mutable
+        {
+            for (int component = 0; component < numComponents; ++component)
+            {
+                const auto colorComp = static_cast<float>(c.Get(tupleIdx, component));
+                o.Set(tupleIdx, component,
+                    static_cast<OutputValueType>(lightValue * colorComp));
+            }
+            if (passAlpha)
+            {
+                o.Set(tupleIdx, 3,
+                    static_cast<OutputValueType>(c.Get(tupleIdx, 3)));
+            }
+        });
+    }
+};
+
+}
+
+
+DEMShadedColorsFilter::DEMShadedColorsFilter()
+    : Superclass()
+    , CoordinatesUnitScale{ 1000.0 } // coordinate in km by default
+    , ElevationUnitScale{ 1.0 / 100.0 } // Elevations in cm by default
+    , Diffuse{ 1.0 }
+    , Ambient{ 0.2 }
+    , OutputNormals{ false }
+    , OutputLightness{ false }
+{
+}
+
+DEMShadedColorsFilter::~DEMShadedColorsFilter() = default;
+
+int DEMShadedColorsFilter::RequestInformation(vtkInformation * request,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    if (!Superclass::RequestInformation(request, inputVector, outputVector))
+    {
+        return 0;
+    }
+
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    auto outInfo = outputVector->GetInformationObject(0);
+
+    int scalarType = VTK_FLOAT;
+    int numTuples = -1;
+    int numComponents = 1;
+    auto scalarsName = "Lightness";
+
+    auto colorsInfo = this->ColorsArrayName.empty()
+        ? nullptr
+        : vtkDataObject::GetNamedFieldInformation(inInfo,
+            vtkDataObject::FIELD_ASSOCIATION_POINTS, this->ColorsArrayName.c_str());
+    if (colorsInfo)
+    {
+        scalarType = colorsInfo->Get(vtkDataObject::FIELD_ARRAY_TYPE());
+        numTuples = colorsInfo->Get(vtkDataObject::FIELD_NUMBER_OF_TUPLES());
+        numComponents = colorsInfo->Get(vtkDataObject::FIELD_NUMBER_OF_COMPONENTS());
+        scalarsName = "Colors/Shading";
+    }
+    if (numTuples <= 0)
+    {
+        ImageExtent extent;
+
+        if (inInfo->Has(vtkDataObject::DATA_EXTENT()))
+        {
+            inInfo->Get(vtkDataObject::DATA_EXTENT(), extent.data());
+        }
+        else if (inInfo->Has(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()))
+        {
+            inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent.data());
+        }
+
+        if (!extent.isEmpty())
+        {
+            numTuples = static_cast<decltype(numTuples)>(extent.numberOfPoints());
+        }
+    }
+
+    if (numTuples <= 0)
+    {
+        numTuples = -1;
+    }
+    if (scalarType <= 0)
+    {
+        scalarType = VTK_FLOAT;
+    }
+    if (numComponents <= 0)
+    {
+        numComponents = -1;
+    }
+
+    vtkDataObject::SetActiveAttributeInfo(outInfo,
+        vtkImageData::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS, scalarsName,
+        scalarType, numComponents, numTuples);
+
+    return 1;
+}
+
+int DEMShadedColorsFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    auto outInfo = outputVector->GetInformationObject(0);
+
+    auto inImage = vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+    auto outImage = vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    auto elevations = inImage->GetPointData()->GetScalars();
+    if (!elevations || elevations->GetNumberOfComponents() != 1)
+    {
+        vtkErrorMacro("Could not find valid elevations in image scalars.");
+        return 0;
+    }
+
+    vtkDataArray * colors = nullptr;
+    if (!this->ColorsArrayName.empty())
+    {
+        colors = inImage->GetPointData()->GetArray(this->ColorsArrayName.c_str());
+        if (colors && (colors->GetNumberOfComponents() < 1 || colors->GetNumberOfComponents() > 4))
+        {
+            vtkErrorMacro("Array " << this->ColorsArrayName << " does not contain valid color data");
+            return 0;
+        }
+    }
+
+    outImage->CopyStructure(inImage);
+    outImage->GetPointData()->PassData(inImage->GetPointData());
+    outImage->GetCellData()->PassData(inImage->GetCellData());
+
+    const auto numTuples = elevations->GetNumberOfTuples();
+
+    ShadingKernel kernel;
+    inImage->GetDimensions(kernel.dimensions.GetData());
+    vtkVector3d spacing;
+    inImage->GetSpacing(spacing.GetData());
+    kernel.xyScale = this->ElevationUnitScale / (convertTo<2>(spacing) * this->CoordinatesUnitScale);
+    kernel.toLight = convertTo<float>(vtkVector3d(-1, 1, 1).Normalized());  // Light from north west
+    kernel.diffuse = this->Diffuse;
+    kernel.ambient = this->Ambient;
+
+    vtkSmartPointer<vtkDataArray> normals;
+    if (this->OutputNormals)
+    {
+        // Same array type as the elevations, required by ShadingKernel
+        normals.TakeReference(elevations->NewInstance());
+        normals->SetName("Normals");
+        normals->SetNumberOfComponents(3);
+        normals->SetNumberOfTuples(numTuples);
+        kernel.normals = normals;
+    }
+
+    vtkSmartPointer<vtkFloatArray> lightness;
+    if (this->OutputLightness || !colors)
+    {
+        lightness = vtkSmartPointer<vtkFloatArray>::New();
+        lightness->SetName("Lightness");
+        lightness->SetNumberOfTuples(numTuples);
+        kernel.lightness = lightness;
+    }
+
+    vtkSmartPointer<vtkDataArray> output;
+
+    if (colors)
+    {
+        // Same array type as the colors, required by ShadedColorsWorker
+        output.TakeReference(colors->NewInstance());
+        output->SetName("Colors/Shading");
+        output->SetNumberOfComponents(colors->GetNumberOfComponents());
+        output->SetNumberOfTuples(numTuples);
+
+        ShadedColorsWorker worker{ kernel, output.Get() };
+
+        using Dispatcher = vtkArrayDispatch::Dispatch2ByValueType<
+            vtkArrayDispatch::Reals,
+            vtkArrayDispatch::AllTypes>;
+
+        if (!Dispatcher::Execute(elevations, colors, worker))
+        {
+            worker(elevations, colors);
+        }
+    }
+    else
+    {
+        output = lightness;
+
+        LightnessWorker worker{ kernel };
+
+        using Dispatcher = vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>;
+
+        if (!Dispatcher::Execute(elevations, worker))
+        {
+            worker(elevations);
+        }
+    }
+
+    auto & pointData = *outImage->GetPointData();
+    if (normals)
+    {
+        pointData.SetNormals(normals);
+    }
+    if (lightness && lightness != output)
+    {
+        pointData.AddArray(lightness);
+    }
+    pointData.SetScalars(output);
+
+    return 1;
+}
@@ -0,0 +1,98 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkImageAlgorithm.h>
+#include <vtkStdString.h>
+
+#include <core/core_api.h>
+
+
+/**
+ * Shading of DEM colors in a single pass.
+ *
+ * This combines DEMImageNormals, DEMShadingFilter, and DEMApplyShadingToColors: normals are
+ * computed from the elevations (active input scalars), shaded with Lambertian lighting from north
+ * west, and the resulting lightness is multiplied with the colors from ColorsArrayName. The image
+ * is processed in blocks of rows in parallel, without creating full size intermediate arrays.
+ *
+ * The output scalars "Colors/Shading" have the type and number of components of the colors array.
+ * If ColorsArrayName is empty or not found, the output scalars are the lightness values
+ * ("Lightness", float).
+ *
+ * Normals and lightness are only stored in the output if requested with OutputNormals and
+ * OutputLightness.
+ */
+class CORE_API DEMShadedColorsFilter : public vtkImageAlgorithm
+{
+public:
+    static DEMShadedColorsFilter * New();
+    vtkTypeMacro(DEMShadedColorsFilter, vtkImageAlgorithm);
+
+    /** @see DEMImageNormals */
+    vtkGetMacro(CoordinatesUnitScale, double);
+    vtkSetMacro(CoordinatesUnitScale, double);
+    vtkGetMacro(ElevationUnitScale, double);
+    vtkSetMacro(ElevationUnitScale, double);
+
+    /** @see DEMShadingFilter */
+    vtkGetMacro(Diffuse, double);
+    vtkSetClampMacro(Diffuse, double, 0.0, 1.0);
+    vtkGetMacro(Ambient, double);
+    vtkSetClampMacro(Ambient, double, 0.0, 1.0);
+
+    /** Point attribute array containing the colors that are shaded. */
+    vtkGetMacro(ColorsArrayName, vtkStdString);
+    vtkSetMacro(ColorsArrayName, vtkStdString);
+
+    /** Also store the normals ("Normals") in the output. Disabled by default. */
+    vtkGetMacro(OutputNormals, bool);
+    vtkSetMacro(OutputNormals, bool);
+    vtkBooleanMacro(OutputNormals, bool);
+
+    /** Also store the lightness ("Lightness") in the output. Disabled by default. */
+    vtkGetMacro(OutputLightness, bool);
+    vtkSetMacro(OutputLightness, bool);
+    vtkBooleanMacro(OutputLightness, bool);
+
+protected:
+    DEMShadedColorsFilter();
+    ~DEMShadedColorsFilter() override;
+
+    int RequestInformation(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    double CoordinatesUnitScale;
+    double ElevationUnitScale;
+    double Diffuse;
+    double Ambient;
+    vtkStdString ColorsArrayName;
+    bool OutputNormals;
+    bool OutputLightness;
+
+private:
+    DEMShadedColorsFilter(const DEMShadedColorsFilter &) = delete;
+    void operator=(const DEMShadedColorsFilter &) = delete;
+};
@@ -0,0 +1,534 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DEMToAdaptiveTerrainMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <vtkArrayDispatch.h>
+#include <vtkAssume.h>
+#include <vtkCellArray.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+
+vtkStandardNewMacro(DEMToAdaptiveTerrainMesh);
+
+
+namespace
+{
+
+/** Copy elevations into a contiguous array of scaled double values. */
+struct ScaledElevationsWorker
+{
+    double scale;
+    std::vector<double> & heights;
+
+    template <typename ElevationArray>
+    void operator()(ElevationArray * elevations)
+    {
+        VTK_ASSUME(elevations->GetNumberOfComponents() == 1);
+
+        auto & h = this->heights;
+        const auto s = this->scale;
+
+        vtkSMPTools::For(0, elevations->GetNumberOfTuples(),
+            [elevations, &h, s] (vtkIdType begin, vtkIdType end)
+        {
+            vtkDataArrayAccessor<ElevationArray> e(elevations);
+            for (auto i = begin; i < end; ++i)
+            {
+                h[static_cast<size_t>(i)] = s * static_cast<double>(e.Get(i, 0));
+            }
+        });
+    }
+};
+
+/**
+ * Tile-wise RTIN triangulation, following the implicit triangle hierarchy of the "Martini"
+ * algorithm (V. Agafonkin, based on Evans et al. 2001, "Right-triangulated irregular networks").
+ *
+ * Triangles of the hierarchy are identified by their index, the coordinates of their hypotenuse
+ * vertices are precomputed once for all tiles.
+ */
+class TileTriangulator
+{
+public:
+    TileTriangulator(const std::vector<double> & heights, int nx, int ny, int tileSize)
+        : heights{ heights }
+        , nx{ nx }
+        , ny{ ny }
+        , tileSize{ tileSize }
+        , gridSize{ tileSize + 1 }
+        , tilesX{ (nx - 2) / tileSize + 1 }
+        , tilesY{ (ny - 2) / tileSize + 1 }
+        , numTriangles{ tileSize * tileSize * 2 - 2 }
+        , numParentTriangles{ numTriangles - tileSize * tileSize }
+        , coords(static_cast<size_t>(numTriangles) * 4u)
+    {
+        for (int i = 0; i < numTriangles; ++i)
+        {
+            int id = i + 2;
+            int ax = 0, ay = 0, bx = 0, by = 0, cx = 0, cy = 0;
+            if (id & 1)
+            {
+                bx = by = cx = tileSize;    // bottom-left triangle
+            }
+            else
+            {
+                ax = ay = cy = tileSize;    // top-right triangle
+            }
+            while ((id >>= 1) > 1)
+            {
+                const int mx = (ax + bx) >> 1;
+                const int my = (ay + by) >> 1;
+                if (id & 1)
+                {
+                    // left half
+                    bx = ax; by = ay;
+                    ax = cx; ay = cy;
+                }
+                else
+                {
+                    // right half
+                    ax = bx; ay = by;
+                    bx = cx; by = cy;
+                }
+                cx = mx; cy = my;
+            }
+            auto c = &this->coords[static_cast<size_t>(i) * 4u];
+            c[0] = ax; c[1] = ay; c[2] = bx; c[3] = by;
+        }
+    }
+
+    int numberOfTiles() const
+    {
+        return this->tilesX * this->tilesY;
+    }
+
+    /**
+     * Triangulate a tile, appending the triangles as triples of point indices of the full DEM.
+     * @param terrain and errors are reused between tiles to avoid reallocations.
+     */
+    void triangulate(int tileIndex, double maxError, bool flipOrientation,
+        std::vector<double> & terrain, std::vector<double> & errors,
+        std::vector<vtkIdType> & triangles) const
+    {
+        const int T = this->tileSize;
+        const int S = this->gridSize;
+        const int tileX = tileIndex % this->tilesX;
+        const int tileY = tileIndex / this->tilesX;
+        const int x0 = tileX * T;
+        const int y0 = tileY * T;
+        // number of valid cells, less than T for tiles at the upper DEM borders
+        const int w = std::min(T, this->nx - 1 - x0);
+        const int h = std::min(T, this->ny - 1 - y0);
+
+        terrain.resize(static_cast<size_t>(S * S));
+        errors.assign(static_cast<size_t>(S * S), 0.0);
+
+        for (int y = 0; y < S; ++y)
+        {
+            const auto row = static_cast<size_t>(std::min(y0 + y, this->ny - 1)) * this->nx;
+            for (int x = 0; x < S; ++x)
+            {
+                terrain[static_cast<size_t>(y * S + x)] =
+                    this->heights[row + static_cast<size_t>(std::min(x0 + x, this->nx - 1))];
+            }
+        }
+
+        const bool sharedLeft = tileX > 0;
+        const bool sharedRight = tileX < this->tilesX - 1;
+        const bool sharedBottom = tileY > 0;
+        const bool sharedTop = tileY < this->tilesY - 1;
+        const auto infinity = std::numeric_limits<double>::infinity();
+
+        // accumulate errors from the smallest to the largest triangles
+        for (int i = this->numTriangles - 1; i >= 0; --i)
+        {
+            auto c = &this->coords[static_cast<size_t>(i) * 4u];
+            const int ax = c[0], ay = c[1], bx = c[2], by = c[3];
+            const int mx = (ax + bx) >> 1;
+            const int my = (ay + by) >> 1;
+            const int cx = mx + my - ay;
+            const int cy = my + ax - mx;
+            const int middleIndex = my * S + mx;
+
+            const int minX = std::min({ ax, bx, cx }), maxX = std::max({ ax, bx, cx });
+            const int minY = std::min({ ay, by, cy }), maxY = std::max({ ay, by, cy });
+
+            // Always split along edges shared with other tiles and triangles crossing the DEM
+            // border in partial tiles. Triangles completely outside of the DEM are not relevant.
+            const bool onSharedEdge = (mx == 0 && sharedLeft) || (mx == T && sharedRight)
+                || (my == 0 && sharedBottom) || (my == T && sharedTop);
+            const bool crossesBorder = (minX < w && maxX > w) || (minY < h && maxY > h);
+            const bool outside = maxX > w || maxY > h;
+
+            double middleError = 0.0;
+            if (onSharedEdge || crossesBorder)
+            {
+                middleError = infinity;
+            }
+            else if (!outside)
+            {
+                middleError = triangleError(terrain, ax, ay, bx, by, cx, cy);
+            }
+
+            auto & error = errors[middleIndex];
+            error = std::max(error, middleError);
+
+            if (i < this->numParentTriangles)
+            {
+                const int leftChildIndex = ((ay + cy) >> 1) * S + ((ax + cx) >> 1);
+                const int rightChildIndex = ((by + cy) >> 1) * S + ((bx + cx) >> 1);
+                error = std::max({ error, errors[leftChildIndex], errors[rightChildIndex] });
+            }
+        }
+
+        const Extraction extraction{ *this, terrain, errors, maxError, flipOrientation,
+            x0, y0, w, h, triangles };
+        extraction.process(0, 0, T, T, T, 0);
+        extraction.process(T, T, 0, 0, 0, T);
+    }
+
+private:
+    /**
+     * Maximum deviation of the DEM samples covered by a triangle from the triangle's plane.
+     * Returns infinity if any of the samples is NaN, so that these areas are always split down to
+     * the finest level.
+     */
+    double triangleError(const std::vector<double> & terrain,
+        int ax, int ay, int bx, int by, int cx, int cy) const
+    {
+        const int S = this->gridSize;
+        const double za = terrain[ay * S + ax];
+        const double zb = terrain[by * S + bx];
+        const double zc = terrain[cy * S + cx];
+        // twice the signed triangle area, used to compute barycentric coordinates
+        const int area2 = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+        // Compare signs instead of multiplying, as w * area2 overflows int for large tiles.
+        const auto isOutside = [area2] (int w) { return w != 0 && ((w < 0) != (area2 < 0)); };
+
+        double error = 0.0;
+        for (int y = std::min({ ay, by, cy }); y <= std::max({ ay, by, cy }); ++y)
+        {
+            for (int x = std::min({ ax, bx, cx }); x <= std::max({ ax, bx, cx }); ++x)
+            {
+                const int wa = (bx - x) * (cy - y) - (by - y) * (cx - x);
+                const int wb = (cx - x) * (ay - y) - (cy - y) * (ax - x);
+                const int wc = area2 - wa - wb;
+                if (isOutside(wa) || isOutside(wb) || isOutside(wc))
+                {
+                    continue;
+                }
+                const auto interpolated = (wa * za + wb * zb + wc * zc) / area2;
+                const auto deviation = std::abs(interpolated - terrain[y * S + x]);
+                if (std::isnan(deviation))
+                {
+                    return std::numeric_limits<double>::infinity();
+                }
+                error = std::max(error, deviation);
+            }
+        }
+
+        return error;
+    }
+
+    struct Extraction
+    {
+        const TileTriangulator & self;
+        const std::vector<double> & terrain;
+        const std::vector<double> & errors;
+        double maxError;
+        bool flipOrientation;
+        int x0, y0, w, h;
+        std::vector<vtkIdType> & triangles;
+
+        void process(int ax, int ay, int bx, int by, int cx, int cy) const
+        {
+            const int S = self.gridSize;
+            const int mx = (ax + bx) >> 1;
+            const int my = (ay + by) >> 1;
+
+            if (std::abs(ax - cx) + std::abs(ay - cy) > 1 && this->errors[my * S + mx] > this->maxError)
+            {
+                this->process(cx, cy, ax, ay, mx, my);
+                this->process(bx, by, cx, cy, mx, my);
+                return;
+            }
+
+            // skip triangles outside of the DEM and triangles with invalid elevations
+            if (std::max({ ax, bx, cx }) > this->w || std::max({ ay, by, cy }) > this->h
+                || std::isnan(this->terrain[ay * S + ax])
+                || std::isnan(this->terrain[by * S + bx])
+                || std::isnan(this->terrain[cy * S + cx]))
+            {
+                return;
+            }
+
+            // counter-clockwise in world coordinates
+            const bool ccw = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax) > 0;
+            if (ccw == this->flipOrientation)
+            {
+                std::swap(bx, cx);
+                std::swap(by, cy);
+            }
+
+            const auto toGlobal = [this] (int x, int y)
+            {
+                return static_cast<vtkIdType>(this->y0 + y) * self.nx + (this->x0 + x);
+            };
+            this->triangles.push_back(toGlobal(ax, ay));
+            this->triangles.push_back(toGlobal(bx, by));
+            this->triangles.push_back(toGlobal(cx, cy));
+        }
+    };
+
+    const std::vector<double> & heights;
+    const int nx;
+    const int ny;
+    const int tileSize;
+    const int gridSize;
+    const int tilesX;
+    const int tilesY;
+    const int numTriangles;
+    const int numParentTriangles;
+    std::vector<int> coords;
+};
+
+int nextPowerOfTwo(int value)
+{
+    int result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+}
+
+
+DEMToAdaptiveTerrainMesh::DEMToAdaptiveTerrainMesh()
+    : Superclass()
+    , MaximumError{ 0.0 }
+    , ElevationScaleFactor{ 1.0 }
+    , ComputeNormals{ false }
+    , TileSize{ 256 }
+{
+}
+
+DEMToAdaptiveTerrainMesh::~DEMToAdaptiveTerrainMesh() = default;
+
+int DEMToAdaptiveTerrainMesh::FillInputPortInformation(int port, vtkInformation * info)
+{
+    if (port != 0)
+    {
+        return 0;
+    }
+
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+    return 1;
+}
+
+int DEMToAdaptiveTerrainMesh::RequestData(
+    vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto dem = vtkImageData::SafeDownCast(
+        inputVector[0]->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+    auto output = vtkPolyData::SafeDownCast(
+        outputVector->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+
+    if (!dem || !output)
+    {
+        return 0;
+    }
+
+    auto elevations = dem->GetPointData()->GetScalars();
+    if (!elevations || elevations->GetNumberOfComponents() != 1
+        || elevations->GetNumberOfTuples() != dem->GetNumberOfPoints())
+    {
+        vtkWarningMacro("Could not find valid elevations in DEM scalars.");
+        return 0;
+    }
+
+    int dimensions[3];
+    dem->GetDimensions(dimensions);
+    const int nx = dimensions[0];
+    const int ny = dimensions[1];
+
+    if (nx < 2 || ny < 2)
+    {
+        return 1;
+    }
+
+    std::vector<double> heights(static_cast<size_t>(elevations->GetNumberOfTuples()));
+    ScaledElevationsWorker elevationsWorker{ this->ElevationScaleFactor, heights };
+    if (!vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>::Execute(
+        elevations, elevationsWorker))
+    {
+        elevationsWorker(elevations);
+    }
+
+    double origin[3], spacing[3];
+    int extent[6];
+    dem->GetOrigin(origin);
+    dem->GetSpacing(spacing);
+    dem->GetExtent(extent);
+
+    // don't process tiles that are much larger than the DEM
+    const int tileSize = std::min(nextPowerOfTwo(this->TileSize), nextPowerOfTwo(std::max(nx, ny) - 1));
+    const TileTriangulator triangulator(heights, nx, ny, std::max(2, tileSize));
+    const int numTiles = triangulator.numberOfTiles();
+    const auto maxError = this->MaximumError;
+    const bool flipOrientation = spacing[0] * spacing[1] < 0.0;
+
+    std::vector<std::vector<vtkIdType>> tileTriangles(static_cast<size_t>(numTiles));
+
+    vtkSMPTools::For(0, numTiles, 1,
+        [&triangulator, &tileTriangles, maxError, flipOrientation] (int begin, int end)
+    {
+        std::vector<double> terrain, errors;
+        for (int t = begin; t < end; ++t)
+        {
+            triangulator.triangulate(t, maxError, flipOrientation,
+                terrain, errors, tileTriangles[static_cast<size_t>(t)]);
+        }
+    });
+
+    // Merge the tiles, only keeping DEM points that are referenced by triangles.
+    std::vector<vtkIdType> outputPointIds(heights.size(), -1);
+    std::vector<vtkIdType> demPointIds;
+    vtkIdType numTriangles = 0;
+    for (auto & triangles : tileTriangles)
+    {
+        for (auto & demPointId : triangles)
+        {
+            auto & outputId = outputPointIds[static_cast<size_t>(demPointId)];
+            if (outputId == -1)
+            {
+                outputId = static_cast<vtkIdType>(demPointIds.size());
+                demPointIds.push_back(demPointId);
+            }
+            demPointId = outputId;
+        }
+        numTriangles += static_cast<vtkIdType>(triangles.size() / 3);
+    }
+    outputPointIds = {};
+
+    const auto numPoints = static_cast<vtkIdType>(demPointIds.size());
+
+    auto coordinates = vtkSmartPointer<vtkDoubleArray>::New();
+    coordinates->SetNumberOfComponents(3);
+    coordinates->SetNumberOfTuples(numPoints);
+
+    auto outputElevations = vtkSmartPointer<vtkDataArray>::Take(elevations->NewInstance());
+    outputElevations->SetName(elevations->GetName());
+    outputElevations->SetNumberOfTuples(numPoints);
+
+    vtkSmartPointer<vtkFloatArray> normals;
+    if (this->ComputeNormals)
+    {
+        normals = vtkSmartPointer<vtkFloatArray>::New();
+        normals->SetName("Normals");
+        normals->SetNumberOfComponents(3);
+        normals->SetNumberOfTuples(numPoints);
+    }
+
+    vtkSMPTools::For(0, numPoints,
+        [&] (vtkIdType begin, vtkIdType end)
+    {
+        const auto height = [&heights, nx] (int x, int y)
+        {
+            return heights[static_cast<size_t>(y) * nx + static_cast<size_t>(x)];
+        };
+
+        for (auto i = begin; i < end; ++i)
+        {
+            const auto demPointId = demPointIds[static_cast<size_t>(i)];
+            const int x = static_cast<int>(demPointId % nx);
+            const int y = static_cast<int>(demPointId / nx);
+            const auto z = height(x, y);
+
+            coordinates->SetTypedComponent(i, 0, origin[0] + (extent[0] + x) * spacing[0]);
+            coordinates->SetTypedComponent(i, 1, origin[1] + (extent[2] + y) * spacing[1]);
+            coordinates->SetTypedComponent(i, 2, z);
+            outputElevations->SetComponent(i, 0, z);
+
+            if (!normals)
+            {
+                continue;
+            }
+
+            // central differences, one-sided at the DEM borders
+            const int xl = std::max(0, x - 1), xr = std::min(nx - 1, x + 1);
+            const int yb = std::max(0, y - 1), yt = std::min(ny - 1, y + 1);
+            const auto dzdx = (height(xr, y) - height(xl, y)) / ((xr - xl) * spacing[0]);
+            const auto dzdy = (height(x, yt) - height(x, yb)) / ((yt - yb) * spacing[1]);
+            double n[3] = { -dzdx, -dzdy, 1.0 };
+            const auto length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if (std::isfinite(length))
+            {
+                n[0] /= length; n[1] /= length; n[2] /= length;
+            }
+            else
+            {
+                n[0] = 0.0; n[1] = 0.0; n[2] = 1.0;
+            }
+            normals->SetTuple(i, n);
+        }
+    });
+
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->Allocate(polys->EstimateSize(numTriangles, 3));
+    for (const auto & triangles : tileTriangles)
+    {
+        for (size_t t = 0; t < triangles.size(); t += 3)
+        {
+            polys->InsertNextCell(3, &triangles[t]);
+        }
+    }
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(coordinates);
+
+    output->SetPoints(points);
+    output->SetPolys(polys);
+    output->GetPointData()->SetScalars(outputElevations);
+    if (normals)
+    {
+        output->GetPointData()->SetNormals(normals);
+    }
+
+    return 1;
+}
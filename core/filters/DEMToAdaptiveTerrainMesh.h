@@ -0,0 +1,82 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkPolyDataAlgorithm.h>
+
+#include <core/core_api.h>
+
+
+/**
+ * Triangulated terrain from a Digital Elevation Model with bounded vertical error.
+ *
+ * The input image scalars are interpreted as elevations. The DEM is split into square tiles of
+ * TileSize cells that are processed in parallel. Each tile is triangulated as right-triangulated
+ * irregular network (RTIN): triangles are only split, if any DEM sample they cover deviates more
+ * than MaximumError from the triangle. Errors are accumulated from smaller to larger triangles, so
+ * that the resulting mesh does not contain cracks. Edges shared between tiles are kept at full
+ * resolution to connect the tiles.
+ *
+ * Output point coordinates are computed from the image geometry, with elevations multiplied by
+ * ElevationScaleFactor as z coordinates. The scaled elevations are stored as point scalars.
+ * Triangles touching NaN elevations are removed.
+ */
+class CORE_API DEMToAdaptiveTerrainMesh : public vtkPolyDataAlgorithm
+{
+public:
+    vtkTypeMacro(DEMToAdaptiveTerrainMesh, vtkPolyDataAlgorithm);
+    static DEMToAdaptiveTerrainMesh * New();
+
+    /** Maximum vertical deviation of the mesh from the DEM, in scaled elevation units.
+     * Default: 0, which only merges exactly planar areas. */
+    vtkGetMacro(MaximumError, double);
+    vtkSetClampMacro(MaximumError, double, 0.0, VTK_DOUBLE_MAX);
+
+    vtkGetMacro(ElevationScaleFactor, double);
+    vtkSetMacro(ElevationScaleFactor, double);
+
+    /** Compute point normals from the full resolution DEM, for shading. Disabled by default. */
+    vtkGetMacro(ComputeNormals, bool);
+    vtkSetMacro(ComputeNormals, bool);
+    vtkBooleanMacro(ComputeNormals, bool);
+
+    /** Number of cells per tile edge, rounded up to the next power of two. Default: 256 */
+    vtkGetMacro(TileSize, int);
+    vtkSetClampMacro(TileSize, int, 2, 1024);
+
+protected:
+    DEMToAdaptiveTerrainMesh();
+    ~DEMToAdaptiveTerrainMesh() override;
+
+    int FillInputPortInformation(int port, vtkInformation * info) override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    double MaximumError;
+    double ElevationScaleFactor;
+    bool ComputeNormals;
+    int TileSize;
+
+private:
+    DEMToAdaptiveTerrainMesh(const DEMToAdaptiveTerrainMesh &) = delete;
+    void operator=(const DEMToAdaptiveTerrainMesh &) = delete;
+};
@@ -18,17 +18,22 @@
 
 #include "DEMToTopographyMesh.h"
 
+#include <algorithm>
+#include <limits>
+
+#include <vtkArrayDispatch.h>
+#include <vtkAssume.h>
+#include <vtkDataArrayAccessor.h>
 #include <vtkImageData.h>
-#include <vtkImageShiftScale.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
-#include <vtkProbeFilter.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
-#include <vtkTransform.h>
-#include <vtkTransformPolyDataFilter.h>
-#include <vtkWarpScalar.h>
 
 #include <core/utility/DataExtent.h>
 #include <core/utility/vtkvectorhelper.h>
@@ -37,6 +42,104 @@
 vtkStandardNewMacro(DEMToTopographyMesh)
 
 
+namespace
+{
+
+/** Scale/shift the template points and apply bilinearly interpolated DEM elevations. */
+struct TopographyWorker
+{
+    vtkImageData & dem;
+    double radiusScale;
+    vtkVector2d shift;
+    double elevationScale;
+    /** Outputs, of the same array types as the template points and the elevations */
+    vtkDataArray & pointsOnDEM;
+    vtkDataArray & centeredPoints;
+    vtkDataArray & outputElevations;
+
+    template <typename ElevationArray, typename PointArray>
+    void operator()(ElevationArray * elevations, PointArray * templatePoints)
+    {
+        VTK_ASSUME(elevations->GetNumberOfComponents() == 1);
+        VTK_ASSUME(templatePoints->GetNumberOfComponents() == 3);
+
+        using PointValueType = typename vtkDataArrayAccessor<PointArray>::APIType;
+        using ElevationValueType = typename vtkDataArrayAccessor<ElevationArray>::APIType;
+
+        auto outPointsOnDEM = static_cast<PointArray *>(&this->pointsOnDEM);
+        auto outCenteredPoints = static_cast<PointArray *>(&this->centeredPoints);
+        auto outElevations = static_cast<ElevationArray *>(&this->outputElevations);
+
+        int dimensions[3];
+        this->dem.GetDimensions(dimensions);
+        vtkVector3d origin, spacing;
+        this->dem.GetOrigin(origin.GetData());
+        this->dem.GetSpacing(spacing.GetData());
+        ImageExtent extent(this->dem.GetExtent());
+
+        // index space origin, taking the extent offset into account
+        const vtkVector2d indexOrigin(
+            origin[0] + extent[0] * spacing[0],
+            origin[1] + extent[2] * spacing[1]);
+        const auto nx = static_cast<vtkIdType>(dimensions[0]);
+        const auto ny = static_cast<vtkIdType>(dimensions[1]);
+
+        const auto scale = this->radiusScale;
+        const auto s = this->shift;
+        const auto zScale = this->elevationScale;
+
+        vtkSMPTools::For(0, templatePoints->GetNumberOfTuples(),
+            [=] (vtkIdType begin, vtkIdType end)
+        {
+            vtkDataArrayAccessor<ElevationArray> e(elevations);
+            vtkDataArrayAccessor<PointArray> p(templatePoints);
+            vtkDataArrayAccessor<PointArray> onDEM(outPointsOnDEM);
+            vtkDataArrayAccessor<PointArray> centered(outCenteredPoints);
+            vtkDataArrayAccessor<ElevationArray> eOut(outElevations);
+
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto localX = static_cast<double>(p.Get(i, 0)) * scale;
+                const auto localY = static_cast<double>(p.Get(i, 1)) * scale;
+
+                // continuous pixel index, clamped to the DEM
+                const auto fx = std::max(0.0, std::min(static_cast<double>(nx - 1),
+                    (localX + s[0] - indexOrigin[0]) / spacing[0]));
+                const auto fy = std::max(0.0, std::min(static_cast<double>(ny - 1),
+                    (localY + s[1] - indexOrigin[1]) / spacing[1]));
+                const auto x0 = std::min(static_cast<vtkIdType>(fx), std::max(nx - 2, vtkIdType(0)));
+                const auto y0 = std::min(static_cast<vtkIdType>(fy), std::max(ny - 2, vtkIdType(0)));
+                const auto x1 = std::min(x0 + 1, nx - 1);
+                const auto y1 = std::min(y0 + 1, ny - 1);
+                const auto tx = fx - x0;
+                const auto ty = fy - y0;
+
+                const auto e00 = static_cast<double>(e.Get(x0 + y0 * nx, 0));
+                const auto e10 = static_cast<double>(e.Get(x1 + y0 * nx, 0));
+                const auto e01 = static_cast<double>(e.Get(x0 + y1 * nx, 0));
+                const auto e11 = static_cast<double>(e.Get(x1 + y1 * nx, 0));
+
+                const auto elevation = zScale * (
+                    (1.0 - ty) * ((1.0 - tx) * e00 + tx * e10)
+                    + ty * ((1.0 - tx) * e01 + tx * e11));
+
+                const auto z = static_cast<PointValueType>(elevation);
+
+                onDEM.Set(i, 0, static_cast<PointValueType>(localX + s[0]));
+                onDEM.Set(i, 1, static_cast<PointValueType>(localY + s[1]));
+                onDEM.Set(i, 2, z);
+                centered.Set(i, 0, static_cast<PointValueType>(localX));
+                centered.Set(i, 1, static_cast<PointValueType>(localY));
+                centered.Set(i, 2, z);
+                eOut.Set(i, 0, static_cast<ElevationValueType>(elevation));
+            }
+        });
+    }
+};
+
+}
+
+
 DEMToTopographyMesh::DEMToTopographyMesh()
     : Superclass()
     , ElevationScaleFactor{ 1.0 }
@@ -140,15 +243,14 @@ int DEMToTopographyMesh::RequestDataObject(vtkInformation * /*request*/,
     vtkInformationVector ** /*inputVector*/,
     vtkInformationVector * outputVector)
 {
-    this->SetupPipeline();
-
-    this->CenterOutputMeshFilter->UpdateDataObject();
-
-    outputVector->GetInformationObject(0)->Set(vtkDataObject::DATA_OBJECT(),
-        this->CenterOutputMeshFilter->GetOutput());
-
-    outputVector->GetInformationObject(1)->Set(vtkDataObject::DATA_OBJECT(),
-        this->WarpElevation->GetOutput());
+    for (int port = 0; port < this->GetNumberOfOutputPorts(); ++port)
+    {
+        auto outInfo = outputVector->GetInformationObject(port);
+        if (!vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT())))
+        {
+            outInfo->Set(vtkDataObject::DATA_OBJECT(), vtkSmartPointer<vtkPolyData>::New());
+        }
+    }
 
     return 1;
 }
@@ -230,7 +332,7 @@ int DEMToTopographyMesh::RequestInformation(
 int DEMToTopographyMesh::RequestData(
     vtkInformation * /*request*/,
     vtkInformationVector ** inputVector,
-    vtkInformationVector * /*outputVector*/)
+    vtkInformationVector * outputVector)
 {
     auto inDEMInfo = inputVector[0]->GetInformationObject(0);
     auto inMeshInfo = inputVector[1]->GetInformationObject(0);
@@ -238,10 +340,24 @@ int DEMToTopographyMesh::RequestData(
     auto dem = vtkImageData::SafeDownCast(inDEMInfo->Get(vtkDataObject::DATA_OBJECT()));
     auto meshTemplate = vtkPolyData::SafeDownCast(inMeshInfo->Get(vtkDataObject::DATA_OBJECT()));
 
+    auto topography = vtkPolyData::SafeDownCast(
+        outputVector->GetInformationObject(0)->Get(vtkDataObject::DATA_OBJECT()));
+    auto topoMeshOnDEM = vtkPolyData::SafeDownCast(
+        outputVector->GetInformationObject(1)->Get(vtkDataObject::DATA_OBJECT()));
 
-    this->DEMScaleElevationFilter->SetInputData(dem);
-    this->MeshTransformFilter->SetInputData(meshTemplate);
+    if (!dem || !meshTemplate || !meshTemplate->GetPoints())
+    {
+        vtkWarningMacro("Missing input DEM or mesh template.");
+        return 0;
+    }
 
+    auto elevations = dem->GetPointData()->GetScalars();
+    if (!elevations || elevations->GetNumberOfComponents() != 1
+        || elevations->GetNumberOfTuples() != dem->GetNumberOfPoints())
+    {
+        vtkWarningMacro("Could not find valid elevations in DEM scalars.");
+        return 0;
+    }
 
     const auto meshTemplateRadius = ComputeCenteredMeshRadius(*meshTemplate);
     if (meshTemplateRadius <= std::numeric_limits<decltype(meshTemplateRadius)>::epsilon())
@@ -250,22 +366,55 @@ int DEMToTopographyMesh::RequestData(
         return 0;
     }
 
-    const auto radiusScale = this->TopographyRadius / meshTemplateRadius;
+    auto templatePoints = meshTemplate->GetPoints()->GetData();
+    const auto numPoints = templatePoints->GetNumberOfTuples();
 
-    this->DEMScaleElevationFilter->SetScale(this->ElevationScaleFactor);
-
-    this->MeshTransform->Identity();
-    this->MeshTransform->PostMultiply();
-    this->MeshTransform->Scale(radiusScale, radiusScale, 0.0);
-    // assuming the template is already centered around (0,0,z):
-    this->MeshTransform->Translate(convertTo<3>(this->TopographyShiftXY, 0.0).GetData());
+    const auto createArray = [numPoints] (vtkDataArray & prototype)
+    {
+        auto array = vtkSmartPointer<vtkDataArray>::Take(prototype.NewInstance());
+        array->SetName(prototype.GetName());
+        array->SetNumberOfComponents(prototype.GetNumberOfComponents());
+        array->SetNumberOfTuples(numPoints);
+        return array;
+    };
+
+    auto pointsOnDEM = createArray(*templatePoints);
+    auto centeredPoints = createArray(*templatePoints);
+    auto outputElevations = createArray(*elevations);
+
+    TopographyWorker worker{
+        *dem,
+        this->TopographyRadius / meshTemplateRadius,
+        this->TopographyShiftXY,
+        this->ElevationScaleFactor,
+        *pointsOnDEM,
+        *centeredPoints,
+        *outputElevations
+    };
+
+    using Dispatcher = vtkArrayDispatch::Dispatch2ByValueType<
+        vtkArrayDispatch::Reals,
+        vtkArrayDispatch::Reals>;
+
+    if (!Dispatcher::Execute(elevations, templatePoints, worker))
+    {
+        worker(elevations, templatePoints);
+    }
 
-    this->CenterOutputMeshTransform->Identity();
-    this->CenterOutputMeshTransform->Translate(convertTo<3>(-this->TopographyShiftXY, 0.0).GetData());
+    const auto setupOutput = [meshTemplate, &outputElevations] (vtkPolyData & output, vtkDataArray & coordinates)
+    {
+        output.Initialize();
+        output.CopyStructure(meshTemplate);
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetData(&coordinates);
+        output.SetPoints(points);
+        output.GetPointData()->SetScalars(outputElevations);
+    };
 
-    return this->CenterOutputMeshFilter->GetExecutive()->Update();
+    setupOutput(*topoMeshOnDEM, *pointsOnDEM);
+    setupOutput(*topography, *centeredPoints);
 
-    // output's are already mapped to the internal filters' outputs
+    return 1;
 }
 
 double DEMToTopographyMesh::ComputeCenteredMeshRadius(vtkPolyData & mesh)
@@ -286,32 +435,6 @@ double DEMToTopographyMesh::ComputeCenteredMeshRadius(vtkPolyData & mesh)
     return maxDistance;
 }
 
-void DEMToTopographyMesh::SetupPipeline()
-{
-    if (this->MeshTransform)
-    {
-        return;
-    }
-
-    this->DEMScaleElevationFilter = vtkSmartPointer<vtkImageShiftScale>::New();
-
-    this->MeshTransform = vtkSmartPointer<vtkTransform>::New();
-    this->MeshTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-    this->MeshTransformFilter->SetTransform(this->MeshTransform);
-
-    auto probe = vtkSmartPointer<vtkProbeFilter>::New();
-    probe->SetInputConnection(this->MeshTransformFilter->GetOutputPort());
-    probe->SetSourceConnection(this->DEMScaleElevationFilter->GetOutputPort());
-
-    this->WarpElevation = vtkSmartPointer<vtkWarpScalar>::New();
-    this->WarpElevation->SetInputConnection(probe->GetOutputPort());
-
-    this->CenterOutputMeshTransform = vtkSmartPointer<vtkTransform>::New();
-    this->CenterOutputMeshFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-    this->CenterOutputMeshFilter->SetTransform(this->CenterOutputMeshTransform);
-    this->CenterOutputMeshFilter->SetInputConnection(this->WarpElevation->GetOutputPort());
-}
-
 void DEMToTopographyMesh::SetInputDEM(vtkImageData * dem)
 {
     this->SetInputDataInternal(0, dem);
@@ -19,7 +19,6 @@
 #pragma once
 
 #include <vtkAlgorithm.h>
-#include <vtkSmartPointer.h>
 #include <vtkVector.h>
 
 #include <core/core_api.h>
@@ -27,11 +26,7 @@
 
 
 class vtkImageData;
-class vtkImageShiftScale;
 class vtkPolyData;
-class vtkTransform;
-class vtkTransformPolyDataFilter;
-class vtkWarpScalar;
 
 
 /** Apply elevations from a Digital Elevation Model to a polygonal mesh, 
@@ -49,6 +44,11 @@ The transformation process is as follows:
     - Shift and scale the mesh template on the DEM
     - Apply DEM's values to mesh point elevations (output port 1)
     - Center the output mesh on the origin (x=0, y=0) (output port 0)
+
+All steps are done in a single parallel pass over the mesh points. Elevations are bilinearly
+interpolated from the DEM scalars, using the image's index space directly. Mesh points outside of
+the DEM are clamped to the DEM border. The scaled elevations are stored as point scalars in both
+outputs.
 */
 class CORE_API DEMToTopographyMesh : public vtkAlgorithm
 {
@@ -131,16 +131,6 @@ protected:
     static double ComputeCenteredMeshRadius(vtkPolyData & mesh);
 
 private:
-    void SetupPipeline();
-
-private:
-    vtkSmartPointer<vtkImageShiftScale> DEMScaleElevationFilter;
-    vtkSmartPointer<vtkTransform> MeshTransform;
-    vtkSmartPointer<vtkTransformPolyDataFilter> MeshTransformFilter;
-    vtkSmartPointer<vtkWarpScalar> WarpElevation;
-    vtkSmartPointer<vtkTransform> CenterOutputMeshTransform;
-    vtkSmartPointer<vtkTransformPolyDataFilter> CenterOutputMeshFilter;
-
     double ElevationScaleFactor;
     double TopographyRadius;
     vtkVector2d TopographyShiftXY;
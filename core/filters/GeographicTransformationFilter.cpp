@@ -18,9 +18,16 @@
 
 #include "GeographicTransformationFilter.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <vtkArrayDispatch.h>
 #include <vtkAssume.h>
@@ -30,6 +37,7 @@
 #include <vtkDataObject.h>
 #include <vtkDoubleArray.h>
 #include <vtkExecutive.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImageData.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
@@ -38,12 +46,15 @@
 #include <vtkPointData.h>
 #include <vtkPointSet.h>
 #include <vtkSmartPointer.h>
+#include <vtkSMPThreadLocal.h>
 #include <vtkSMPTools.h>
 #include <vtkVector.h>
 
 #include <core/ThirdParty/proj4_include.h>
 
+#include <core/data_objects/DataObject.h>
 #include <core/utility/DataExtent.h>
+#include <core/utility/KruegerTransverseMercator.h>
 #include <core/utility/macros.h>
 #include <core/utility/mathhelper.h>
 #include <core/utility/vtkvectorhelper.h>
@@ -143,17 +154,29 @@ bool utm_isNorthern(const double latitude)
     return latitude > 0.0;
 }
 
+/**
+ * Number of points transformed per parallel work item. PROJ.4 transforms all points
+ * independently, so that splitting the transformation into chunks doesn't alter the results.
+ */
+const vtkIdType proj4TransformGrainSize = 1 << 14;
+
 class Proj4PJ
 {
 public:
-    explicit Proj4PJ(const std::string & stringRepresentation)
+    /**
+     * @param context PROJ.4 thread context for the projection. The default context must only be
+     *  used from a single thread at a time.
+     */
+    explicit Proj4PJ(const std::string & stringRepresentation, projCtx context = nullptr)
         : m_stringRepr{ stringRepresentation }
         , m_pj{ nullptr }
     {
-        m_pj = pj_init_plus(m_stringRepr.c_str());
+        m_pj = context
+            ? pj_init_plus_ctx(context, m_stringRepr.c_str())
+            : pj_init_plus(m_stringRepr.c_str());
         if (!m_pj)
         {
-            m_errorString = pj_strerrno(pj_errno);
+            m_errorString = pj_strerrno(context ? pj_ctx_get_errno(context) : pj_errno);
         }
     }
 
@@ -179,6 +202,11 @@ public:
         return m_errorString;
     }
 
+    const std::string & definition() const
+    {
+        return m_stringRepr;
+    }
+
     vtkVector3d convertTo(const Proj4PJ & other, vtkVector3d coord, std::string * errorString = nullptr) const
     {
         if (pj_is_latlong(m_pj))
@@ -207,7 +235,14 @@ public:
         return coord;
     }
 
-    void convertTo(const Proj4PJ & other, vtkDataArray & array, std::string * errorString = nullptr) const
+    /**
+     * Transform all coordinates of the array.
+     * @param parallel Transform chunks of the array in parallel. Each thread uses its own PROJ.4
+     *  context and projections, which are initialized from the definitions of this and other.
+     *  Results are identical to the serial transformation.
+     */
+    void convertTo(const Proj4PJ & other, vtkDataArray & array, std::string * errorString = nullptr,
+        bool parallel = true) const
     {
         VTK_ASSUME(array.GetNumberOfComponents() == 3);
 
@@ -229,11 +264,13 @@ public:
             scaleShiftArray(*computeArray, scaleToRadians, vtkVector2d(0.0));
         }
 
-        const int result = pj_transform(m_pj, other.m_pj,
-            computeArray->GetNumberOfTuples(), 3,
-            computeArray->GetPointer(0),
-            computeArray->GetPointer(1),
-            computeArray->GetPointer(2));
+        const int result = parallel
+            ? transformParallel(other, *computeArray)
+            : pj_transform(m_pj, other.m_pj,
+                computeArray->GetNumberOfTuples(), 3,
+                computeArray->GetPointer(0),
+                computeArray->GetPointer(1),
+                computeArray->GetPointer(2));
 
         if (errorString)
         {
@@ -258,7 +295,85 @@ public:
             scaleShiftArray(*computeArray, scaleToDegrees, vtkVector2d(0.0));
         }
 
-        array.DeepCopy(computeArray);
+        if (copyData)
+        {
+            array.DeepCopy(computeArray);
+        }
+    }
+
+private:
+    /** PROJ.4 state that is used by a single thread only. */
+    struct ThreadLocalTransform
+    {
+        ThreadLocalTransform(const std::string & sourceDefinition, const std::string & targetDefinition)
+            : context{ pj_ctx_alloc() }
+            , source{ std::make_unique<Proj4PJ>(sourceDefinition, context) }
+            , target{ std::make_unique<Proj4PJ>(targetDefinition, context) }
+        {
+        }
+        ~ThreadLocalTransform()
+        {
+            // Projections have to be released before their context.
+            source.reset();
+            target.reset();
+            pj_ctx_free(context);
+        }
+
+        projCtx context;
+        std::unique_ptr<Proj4PJ> source;
+        std::unique_ptr<Proj4PJ> target;
+    };
+
+    int transformParallel(const Proj4PJ & other, vtkDoubleArray & coordinates) const
+    {
+        const auto numTuples = coordinates.GetNumberOfTuples();
+        if (numTuples <= proj4TransformGrainSize)
+        {
+            return pj_transform(m_pj, other.m_pj, numTuples, 3,
+                coordinates.GetPointer(0),
+                coordinates.GetPointer(1),
+                coordinates.GetPointer(2));
+        }
+
+        // shared_ptr: vtkSMPThreadLocal requires copyable types
+        vtkSMPThreadLocal<std::shared_ptr<ThreadLocalTransform>> threadTransforms;
+        std::atomic<int> firstError{ 0 };
+        const auto data = coordinates.GetPointer(0);
+        const auto & sourceDefinition = m_stringRepr;
+        const auto & targetDefinition = other.m_stringRepr;
+
+        vtkSMPTools::For(0, numTuples, proj4TransformGrainSize,
+            [&threadTransforms, &firstError, data, &sourceDefinition, &targetDefinition]
+            (vtkIdType begin, vtkIdType end)
+        {
+            auto & transform = threadTransforms.Local();
+            if (!transform)
+            {
+                transform = std::make_shared<ThreadLocalTransform>(sourceDefinition, targetDefinition);
+            }
+
+            int result = 0;
+            if (!transform->source->isValid() || !transform->target->isValid())
+            {
+                result = pj_ctx_get_errno(transform->context);
+                result = result != 0 ? result : -1;
+            }
+            else
+            {
+                const auto chunk = data + begin * 3;
+                result = pj_transform(transform->source->m_pj, transform->target->m_pj,
+                    static_cast<long>(end - begin), 3,
+                    chunk, chunk + 1, chunk + 2);
+            }
+
+            if (result != 0)
+            {
+                int noError = 0;
+                firstError.compare_exchange_strong(noError, result);
+            }
+        });
+
+        return firstError;
     }
 
 private:
@@ -280,19 +395,109 @@ void convertMetricHorizontalUnit(vtkDataSet & dataSet, const QString & inUnit, c
     scaleShiftDataSet(dataSet, scale, vtkVector<double, ModifyComponents>(0.0));
 }
 
+/**
+ * Built-in WGS 84 <-> UTM transformation of coordinate arrays.
+ * Coordinates are processed in blocks, so that the projection runs on contiguous
+ * double precision buffers, independently of the array type and memory layout.
+ */
+struct FastTransverseMercatorWorker
+{
+    const KruegerTransverseMercator & Projection;
+    bool ToUTM;
+    bool Parallel;
+
+    template<typename CoordsArrayType>
+    void operator()(CoordsArrayType * coordinates)
+    {
+        VTK_ASSUME(coordinates->GetNumberOfComponents() == 3);
+        vtkDataArrayAccessor<CoordsArrayType> coords(coordinates);
+        using ValueType = typename vtkDataArrayAccessor<CoordsArrayType>::APIType;
+
+        const auto & projection = this->Projection;
+        const bool toUTM = this->ToUTM;
+
+        auto processRange = [coords, &projection, toUTM] (const vtkIdType begin, const vtkIdType end)
+        {
+            const vtkIdType blockSize = 512;
+            std::array<double, blockSize> x, y;
+            for (vtkIdType blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+            {
+                const auto blockEnd = std::min(end, blockBegin + blockSize);
+                const auto numPoints = static_cast<size_t>(blockEnd - blockBegin);
+                for (size_t i = 0; i < numPoints; ++i)
+                {
+                    x[i] = static_cast<double>(coords.Get(blockBegin + static_cast<vtkIdType>(i), 0));
+                    y[i] = static_cast<double>(coords.Get(blockBegin + static_cast<vtkIdType>(i), 1));
+                }
+                if (toUTM)
+                {
+                    projection.forward(x.data(), y.data(), x.data(), y.data(), numPoints);
+                }
+                else
+                {
+                    projection.inverse(x.data(), y.data(), x.data(), y.data(), numPoints);
+                }
+                for (size_t i = 0; i < numPoints; ++i)
+                {
+                    coords.Set(blockBegin + static_cast<vtkIdType>(i), 0, static_cast<ValueType>(x[i]));
+                    coords.Set(blockBegin + static_cast<vtkIdType>(i), 1, static_cast<ValueType>(y[i]));
+                }
+            }
+        };
+
+        if (this->Parallel)
+        {
+            vtkSMPTools::For(0, coordinates->GetNumberOfTuples(), processRange);
+        }
+        else
+        {
+            processRange(0, coordinates->GetNumberOfTuples());
+        }
+    }
+};
+
+/**
+ * Converts coordinates in a point coordinate array in place.
+ * @return an error message, or an empty string on success.
+ */
+using CoordinateArrayConverter = std::function<std::string(vtkDataArray & coordinates, bool parallel)>;
+
+CoordinateArrayConverter proj4Converter(const Proj4PJ & inSystem, const Proj4PJ & outSystem)
+{
+    return [&inSystem, &outSystem] (vtkDataArray & coordinates, bool parallel)
+    {
+        std::string errorString;
+        inSystem.convertTo(outSystem, coordinates, &errorString, parallel);
+        return errorString;
+    };
+}
+
+CoordinateArrayConverter fastUTMConverter(const KruegerTransverseMercator & projection, bool toUTM)
+{
+    return [&projection, toUTM] (vtkDataArray & coordinates, bool parallel)
+    {
+        FastTransverseMercatorWorker worker{ projection, toUTM, parallel };
+        using Dispatcher = vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>;
+        if (!Dispatcher::Execute(&coordinates, worker))
+        {
+            worker(&coordinates);
+        }
+        return std::string();
+    };
+}
+
 // Converts horizontal coordinate between different systems.
 // It does not modify elevations.
 std::string transformCoodinates(vtkDataSet & dataSet,
-    const Proj4PJ & inSystem,
-    const Proj4PJ & outSystem)
+    const CoordinateArrayConverter & convert,
+    bool parallel)
 {
     std::string errorString;
 
     if (auto pointSet = vtkPointSet::SafeDownCast(&dataSet))
     {
         auto coords = pointSet->GetPoints()->GetData();
-        inSystem.convertTo(outSystem, *coords, &errorString);
-        return errorString;
+        return convert(*coords, parallel);
     }
 
     if (auto image = vtkImageData::SafeDownCast(&dataSet))
@@ -318,7 +523,7 @@ std::string transformCoodinates(vtkDataSet & dataSet,
         const auto northEast = bounds.max();
         fixedPoints->SetTuple(1, southWest.GetData());
         fixedPoints->SetTuple(2, northEast.GetData());
-        inSystem.convertTo(outSystem, *fixedPoints, &errorString);
+        errorString = convert(*fixedPoints, false);
         if (!errorString.empty())
         {
             return errorString;
@@ -344,12 +549,445 @@ std::string transformCoodinates(vtkDataSet & dataSet,
     return errorString;
 }
 
+/**
+ * Bilinear resampling of image point data in the xy-plane. For each target point in the current
+ * block of xy-points, SourceIndices contain the continuous xy-index in the source image.
+ * All z-slices are resampled with the same xy-mapping.
+ */
+struct ImageResampleWorker
+{
+    const double * SourceIndices;   // 2 components per block point
+    vtkIdType BlockBegin;
+    vtkIdType BlockSize;
+    vtkIdType NumXYPoints;
+    std::array<int, 3> Dimensions;  // same for source and target
+    bool Parallel;
+
+    template<typename InArrayType, typename OutArrayType>
+    void operator()(InArrayType * inArray, OutArrayType * outArray)
+    {
+        vtkDataArrayAccessor<InArrayType> in(inArray);
+        vtkDataArrayAccessor<OutArrayType> out(outArray);
+        using ValueType = typename vtkDataArrayAccessor<OutArrayType>::APIType;
+
+        const int numComponents = inArray->GetNumberOfComponents();
+        const auto & dims = this->Dimensions;
+        const auto numXY = this->NumXYPoints;
+        const auto blockBegin = this->BlockBegin;
+        const double * sourceIndices = this->SourceIndices;
+        const bool outIsReal = outArray->GetDataType() == VTK_FLOAT || outArray->GetDataType() == VTK_DOUBLE;
+        const ValueType outsideValue = std::numeric_limits<ValueType>::has_quiet_NaN && outIsReal
+            ? std::numeric_limits<ValueType>::quiet_NaN()
+            : ValueType(0);
+        // Tolerate round-off at the image boundaries.
+        const double epsilon = 1e-6;
+
+        auto processRange = [=] (const vtkIdType begin, const vtkIdType end)
+        {
+            for (vtkIdType p = begin; p < end; ++p)
+            {
+                const double fxRaw = sourceIndices[2 * p];
+                const double fyRaw = sourceIndices[2 * p + 1];
+                const bool inside = fxRaw >= -epsilon && fxRaw <= dims[0] - 1 + epsilon
+                    && fyRaw >= -epsilon && fyRaw <= dims[1] - 1 + epsilon;
+                const double fx = std::max(0.0, std::min(fxRaw, static_cast<double>(dims[0] - 1)));
+                const double fy = std::max(0.0, std::min(fyRaw, static_cast<double>(dims[1] - 1)));
+                const int i0 = inside ? std::min(static_cast<int>(fx), std::max(0, dims[0] - 2)) : 0;
+                const int j0 = inside ? std::min(static_cast<int>(fy), std::max(0, dims[1] - 2)) : 0;
+                const int i1 = std::min(i0 + 1, dims[0] - 1);
+                const int j1 = std::min(j0 + 1, dims[1] - 1);
+                const double tx = fx - i0;
+                const double ty = fy - j0;
+
+                for (int k = 0; k < dims[2]; ++k)
+                {
+                    const vtkIdType targetId = blockBegin + p + k * numXY;
+                    if (!inside)
+                    {
+                        for (int c = 0; c < numComponents; ++c)
+                        {
+                            out.Set(targetId, c, outsideValue);
+                        }
+                        continue;
+                    }
+                    const vtkIdType sliceOffset = k * numXY;
+                    const vtkIdType id00 = sliceOffset + i0 + j0 * dims[0];
+                    const vtkIdType id10 = sliceOffset + i1 + j0 * dims[0];
+                    const vtkIdType id01 = sliceOffset + i0 + j1 * dims[0];
+                    const vtkIdType id11 = sliceOffset + i1 + j1 * dims[0];
+                    for (int c = 0; c < numComponents; ++c)
+                    {
+                        const double v0 = (1.0 - tx) * static_cast<double>(in.Get(id00, c))
+                            + tx * static_cast<double>(in.Get(id10, c));
+                        const double v1 = (1.0 - tx) * static_cast<double>(in.Get(id01, c))
+                            + tx * static_cast<double>(in.Get(id11, c));
+                        out.Set(targetId, c, static_cast<ValueType>((1.0 - ty) * v0 + ty * v1));
+                    }
+                }
+            }
+        };
+
+        if (this->Parallel)
+        {
+            vtkSMPTools::For(0, this->BlockSize, processRange);
+        }
+        else
+        {
+            processRange(0, this->BlockSize);
+        }
+    }
+};
+
+/**
+ * Transform positions of a regular grid of sample points of the image, including the image
+ * boundaries.
+ * @param numSamplesPerAxis Number of samples per xy-axis. Less samples are used for images with
+ *  less points.
+ */
+vtkSmartPointer<vtkDoubleArray> transformImageSamples(vtkImageData & image,
+    const CoordinateArrayConverter & convert, const int numSamplesPerAxis,
+    std::array<int, 2> & sampleDims, std::string & errorString)
+{
+    std::array<int, 3> dims;
+    image.GetDimensions(dims.data());
+    std::array<double, 3> origin, spacing;
+    image.GetOrigin(origin.data());
+    image.GetSpacing(spacing.data());
+
+    auto samples = vtkSmartPointer<vtkDoubleArray>::New();
+    samples->SetNumberOfComponents(3);
+    for (int a = 0; a < 2; ++a)
+    {
+        sampleDims[a] = std::max(1, std::min(dims[a], numSamplesPerAxis));
+    }
+    samples->SetNumberOfTuples(sampleDims[0] * sampleDims[1]);
+    for (int sy = 0; sy < sampleDims[1]; ++sy)
+    {
+        const double j = sampleDims[1] <= 1 ? 0.0
+            : static_cast<double>(sy) * (dims[1] - 1) / (sampleDims[1] - 1);
+        for (int sx = 0; sx < sampleDims[0]; ++sx)
+        {
+            const double i = sampleDims[0] <= 1 ? 0.0
+                : static_cast<double>(sx) * (dims[0] - 1) / (sampleDims[0] - 1);
+            const double point[3] = { origin[0] + i * spacing[0], origin[1] + j * spacing[1], origin[2] };
+            samples->SetTuple(sx + sy * sampleDims[0], point);
+        }
+    }
+
+    errorString = convert(*samples, false);
+    return samples;
+}
+
+/**
+ * Transform image data either by adjusting origin and spacing (affine approximation) or, if the
+ * approximation exceeds the tolerance, by resampling its point data on a regular grid in the target
+ * coordinate system.
+ */
+std::string transformImage(vtkImageData & image,
+    const CoordinateArrayConverter & convert,
+    const CoordinateArrayConverter & convertInverse,
+    const int mode,
+    const double affineTolerance,
+    const bool parallel)
+{
+    ImageExtent extent;
+    image.GetExtent(extent.data());
+    if (extent.isEmpty())
+    {
+        return{};
+    }
+
+    // Geometry of the image in the source system, required to sample the source point data.
+    auto sourceGeometry = vtkSmartPointer<vtkImageData>::New();
+    sourceGeometry->CopyStructure(&image);
+
+    auto errorString = transformCoodinates(image, convert, parallel);
+    if (!errorString.empty()
+        || mode == GeographicTransformationFilter::ImageTransformAffine)
+    {
+        return errorString;
+    }
+
+    std::array<int, 3> dims;
+    image.GetDimensions(dims.data());
+    std::array<double, 3> origin, spacing;
+    image.GetOrigin(origin.data());
+    image.GetSpacing(spacing.data());
+
+    // Compare the exact transformation of sample points with their affine approximation.
+    const int numSamplesPerAxis = 9;
+    std::array<int, 2> sampleDims;
+    auto samples = transformImageSamples(*sourceGeometry, convert, numSamplesPerAxis,
+        sampleDims, errorString);
+    if (!errorString.empty())
+    {
+        return errorString;
+    }
+
+    double maxError = 0.0;
+    DataExtent<double, 2u> exactBounds;
+    for (int sy = 0; sy < sampleDims[1]; ++sy)
+    {
+        const double j = sampleDims[1] <= 1 ? 0.0
+            : static_cast<double>(sy) * (dims[1] - 1) / (sampleDims[1] - 1);
+        for (int sx = 0; sx < sampleDims[0]; ++sx)
+        {
+            const double i = sampleDims[0] <= 1 ? 0.0
+                : static_cast<double>(sx) * (dims[0] - 1) / (sampleDims[0] - 1);
+            const auto exact = vtkVector3d(samples->GetTuple(sx + sy * sampleDims[0]));
+            exactBounds.add(convertTo<2>(exact));
+            const double affine[2] = { origin[0] + i * spacing[0], origin[1] + j * spacing[1] };
+            for (int a = 0; a < 2; ++a)
+            {
+                if (spacing[a] > 0.0)
+                {
+                    maxError = std::max(maxError, std::abs(exact[a] - affine[a]) / spacing[a]);
+                }
+            }
+        }
+    }
+
+    if (mode == GeographicTransformationFilter::ImageTransformAutomatic
+        && maxError <= affineTolerance)
+    {
+        return errorString;
+    }
+
+    // Resample on a regular grid covering the transformed sample points, with the same number of
+    // points as the source image.
+    const auto targetMin = exactBounds.min();
+    const auto targetSize = exactBounds.componentSize();
+    for (int a = 0; a < 2; ++a)
+    {
+        origin[a] = targetMin[a];
+        spacing[a] = dims[a] <= 1 ? spacing[a] : targetSize[a] / (dims[a] - 1);
+    }
+    image.SetOrigin(origin.data());
+    image.SetSpacing(spacing.data());
+
+    std::array<double, 3> sourceOrigin, sourceSpacing;
+    sourceGeometry->GetOrigin(sourceOrigin.data());
+    sourceGeometry->GetSpacing(sourceSpacing.data());
+
+    auto & inPointData = *image.GetPointData();
+    auto outPointData = vtkSmartPointer<vtkPointData>::New();
+    outPointData->CopyAllocate(&inPointData, image.GetNumberOfPoints());
+    std::vector<std::pair<vtkDataArray *, vtkDataArray *>> arrays;
+    for (int a = 0; a < inPointData.GetNumberOfArrays(); ++a)
+    {
+        auto inArray = inPointData.GetArray(a);
+        // CopyAllocate() creates the output arrays in the same order as the input arrays.
+        auto outArray = inArray ? outPointData->GetArray(a) : nullptr;
+        if (!inArray || !outArray)
+        {
+            continue;
+        }
+        outArray->SetNumberOfTuples(image.GetNumberOfPoints());
+        arrays.emplace_back(inArray, outArray);
+    }
+
+    // Transform target positions back into the source system block-wise, so that point coordinates
+    // are never required for the whole image.
+    const vtkIdType blockSize = 1 << 18;
+    auto blockCoords = vtkSmartPointer<vtkDoubleArray>::New();
+    blockCoords->SetNumberOfComponents(3);
+    std::vector<double> sourceIndices;
+    // Tolerate round-off at the image boundaries.
+    const double epsilon = 1e-6;
+    const auto isInside = [&dims, epsilon] (const double * sourceIndex)
+    {
+        return sourceIndex[0] >= -epsilon && sourceIndex[0] <= dims[0] - 1 + epsilon
+            && sourceIndex[1] >= -epsilon && sourceIndex[1] <= dims[1] - 1 + epsilon;
+    };
+
+    // Continuous source xy-indices of the target positions in [begin, end), for rows of rowLength
+    // positions, each shifted by offset in target index space.
+    const auto computeSourceIndices = [&] (const vtkIdType begin, const vtkIdType end,
+        const vtkIdType rowLength, const std::array<double, 2> & offset) -> std::string
+    {
+        const vtkIdType numBlockPositions = end - begin;
+        blockCoords->SetNumberOfTuples(numBlockPositions);
+        for (vtkIdType q = begin; q < end; ++q)
+        {
+            const double point[3] = {
+                origin[0] + ((q % rowLength) + offset[0]) * spacing[0],
+                origin[1] + ((q / rowLength) + offset[1]) * spacing[1],
+                origin[2] };
+            blockCoords->SetTuple(q - begin, point);
+        }
+
+        auto inverseError = convertInverse(*blockCoords, parallel);
+        if (!inverseError.empty())
+        {
+            return inverseError;
+        }
+
+        sourceIndices.resize(static_cast<size_t>(2 * numBlockPositions));
+        for (vtkIdType p = 0; p < numBlockPositions; ++p)
+        {
+            for (int a = 0; a < 2; ++a)
+            {
+                sourceIndices[static_cast<size_t>(2 * p + a)] = sourceSpacing[a] == 0.0 ? 0.0
+                    : (blockCoords->GetComponent(p, a) - sourceOrigin[a]) / sourceSpacing[a];
+            }
+        }
+        return{};
+    };
+
+    // Resampled ids are not related to the ids of the input image. Map each point to the nearest
+    // input point and each cell to the input cell containing its center, so that picked or
+    // selected ids can be related to the input.
+    auto originalPointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    originalPointIds->SetName(GeographicTransformationFilter::OriginalPointIdsArrayName());
+    originalPointIds->SetNumberOfValues(image.GetNumberOfPoints());
+    originalPointIds->GetInformation()->Set(DataObject::ARRAY_IS_AUXILIARY(), 1);
+
+    const vtkIdType numXY = static_cast<vtkIdType>(dims[0]) * dims[1];
+
+    for (vtkIdType blockBegin = 0; blockBegin < numXY; blockBegin += blockSize)
+    {
+        const vtkIdType blockEnd = std::min(numXY, blockBegin + blockSize);
+        const vtkIdType numBlockPoints = blockEnd - blockBegin;
+        errorString = computeSourceIndices(blockBegin, blockEnd, dims[0], { 0.0, 0.0 });
+        if (!errorString.empty())
+        {
+            return errorString;
+        }
+
+        ImageResampleWorker worker{ sourceIndices.data(), blockBegin, numBlockPoints, numXY, dims, parallel };
+        for (auto & inOut : arrays)
+        {
+            if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(inOut.first, inOut.second, worker))
+            {
+                worker(inOut.first, inOut.second);
+            }
+        }
+
+        for (vtkIdType p = 0; p < numBlockPoints; ++p)
+        {
+            const double * sourceIndex = &sourceIndices[static_cast<size_t>(2 * p)];
+            const bool inside = isInside(sourceIndex);
+            const auto i = std::max(0, std::min(dims[0] - 1, static_cast<int>(std::lround(sourceIndex[0]))));
+            const auto j = std::max(0, std::min(dims[1] - 1, static_cast<int>(std::lround(sourceIndex[1]))));
+            for (int k = 0; k < dims[2]; ++k)
+            {
+                originalPointIds->SetValue(blockBegin + p + k * numXY,
+                    inside ? i + static_cast<vtkIdType>(j) * dims[0] + k * numXY : -1);
+            }
+        }
+    }
+
+    const std::array<int, 2> cellDims = { std::max(1, dims[0] - 1), std::max(1, dims[1] - 1) };
+    const vtkIdType numCellsXY = static_cast<vtkIdType>(cellDims[0]) * cellDims[1];
+    const vtkIdType numCellLayers = image.GetNumberOfCells() / numCellsXY;
+    const std::array<double, 2> cellCenterOffset = { dims[0] > 1 ? 0.5 : 0.0, dims[1] > 1 ? 0.5 : 0.0 };
+
+    auto originalCellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    originalCellIds->SetName(GeographicTransformationFilter::OriginalCellIdsArrayName());
+    originalCellIds->SetNumberOfValues(image.GetNumberOfCells());
+    originalCellIds->GetInformation()->Set(DataObject::ARRAY_IS_AUXILIARY(), 1);
+
+    for (vtkIdType blockBegin = 0; blockBegin < numCellsXY; blockBegin += blockSize)
+    {
+        const vtkIdType blockEnd = std::min(numCellsXY, blockBegin + blockSize);
+        errorString = computeSourceIndices(blockBegin, blockEnd, cellDims[0], cellCenterOffset);
+        if (!errorString.empty())
+        {
+            return errorString;
+        }
+
+        for (vtkIdType p = 0; p < blockEnd - blockBegin; ++p)
+        {
+            const double * sourceIndex = &sourceIndices[static_cast<size_t>(2 * p)];
+            const bool inside = isInside(sourceIndex);
+            const auto i = std::max(0, std::min(cellDims[0] - 1, static_cast<int>(std::floor(sourceIndex[0]))));
+            const auto j = std::max(0, std::min(cellDims[1] - 1, static_cast<int>(std::floor(sourceIndex[1]))));
+            for (vtkIdType layer = 0; layer < numCellLayers; ++layer)
+            {
+                originalCellIds->SetValue(blockBegin + p + layer * numCellsXY,
+                    inside ? i + static_cast<vtkIdType>(j) * cellDims[0] + layer * numCellsXY : -1);
+            }
+        }
+    }
+
+    image.GetPointData()->ShallowCopy(outPointData);
+    image.GetPointData()->AddArray(originalPointIds);
+    // Cell attributes are not resampled.
+    image.GetCellData()->Initialize();
+    image.GetCellData()->AddArray(originalCellIds);
+
+    return errorString;
+}
+
 }
 
 
 vtkStandardNewMacro(GeographicTransformationFilter);
 
 
+namespace
+{
+
+GeographicTransformationFilter::ProjectionMethod & defaultProjectionMethod()
+{
+    static GeographicTransformationFilter::ProjectionMethod method =
+        GeographicTransformationFilter::ProjectionExact;
+    return method;
+}
+
+vtkTimeStamp & defaultProjectionMethodMTime()
+{
+    static vtkTimeStamp mTime;
+    return mTime;
+}
+
+}
+
+
+void GeographicTransformationFilter::SetDefaultProjectionMethod(ProjectionMethod method)
+{
+    if (method == ProjectionDefault || method == defaultProjectionMethod())
+    {
+        return;
+    }
+
+    defaultProjectionMethod() = method;
+    defaultProjectionMethodMTime().Modified();
+}
+
+GeographicTransformationFilter::ProjectionMethod GeographicTransformationFilter::GetDefaultProjectionMethod()
+{
+    return defaultProjectionMethod();
+}
+
+GeographicTransformationFilter::ProjectionMethod GeographicTransformationFilter::GetEffectiveProjectionMethod() const
+{
+    return this->Projection == ProjectionDefault
+        ? defaultProjectionMethod()
+        : this->Projection;
+}
+
+vtkMTimeType GeographicTransformationFilter::GetMTime()
+{
+    auto mTime = this->Superclass::GetMTime();
+    if (this->Projection == ProjectionDefault)
+    {
+        mTime = std::max(mTime, defaultProjectionMethodMTime().GetMTime());
+    }
+    return mTime;
+}
+
+const char * GeographicTransformationFilter::OriginalPointIdsArrayName()
+{
+    return "vtkOriginalPointIds";
+}
+
+const char * GeographicTransformationFilter::OriginalCellIdsArrayName()
+{
+    return "vtkOriginalCellIds";
+}
+
+
 bool GeographicTransformationFilter::IsTransformationSupported(
     const ReferencedCoordinateSystemSpecification & sourceSpec,
     const CoordinateSystemSpecification & targetSpec)
@@ -365,6 +1003,10 @@ bool GeographicTransformationFilter::IsTransformationSupported(
 GeographicTransformationFilter::GeographicTransformationFilter()
     : Superclass()
     , OperateInPlace{ false }
+    , ParallelProjection{ true }
+    , Projection{ ProjectionDefault }
+    , ImageTransform{ ImageTransformAffine }
+    , ImageAffineTolerance{ 0.25 }
 {
 }
 
@@ -526,38 +1168,54 @@ int GeographicTransformationFilter::RequestData(
     }
 
     const vtkVector2d & refLatLongWGS84 = this->SourceCoordinateSystem.referencePointLatLong;
+    const int utmZone = utm_getZone(refLatLongWGS84.GetY());
+    const bool utmNorthern = utm_isNorthern(refLatLongWGS84.GetX());
+    const bool useFastProjection = this->GetEffectiveProjectionMethod() == ProjectionFast;
 
     // http://spatialreference.org/ref/epsg/wgs-84/
     static const Proj4PJ pj_longlat_WGS84{ "+proj=longlat +ellps=WGS84 +datum=WGS84 +no_defs" };
-    if (!pj_longlat_WGS84)
+    std::unique_ptr<Proj4PJ> pj_UTM;
+    std::unique_ptr<KruegerTransverseMercator> fastUTM;
+
+    // Acquire reference point in UTM (in meters)
+    vtkVector2d refUTM_m;
+
+    if (useFastProjection)
     {
-        vtkErrorMacro(<< "Invalid geographic coordinate system specified for PROJ.4: "
-            << pj_longlat_WGS84.errorString());
-        return 0;
+        fastUTM = std::make_unique<KruegerTransverseMercator>(utmZone, utmNorthern);
+        fastUTM->forward(refLatLongWGS84.GetY(), refLatLongWGS84.GetX(), refUTM_m[0], refUTM_m[1]);
     }
-    const int utmZone = utm_getZone(refLatLongWGS84.GetY());
-    const Proj4PJ pj_UTM{ "+proj=utm +zone=" + std::to_string(utmZone)
-        + (utm_isNorthern(refLatLongWGS84.GetX()) ? " " : " +south ")
-        + "+ellps=WGS84 +datum=WGS84 +units=m +no_defs" };
-    if (!pj_UTM)
+    else
     {
-        vtkErrorMacro(<< "Invalid projected coordinate system specified for PROJ.4: "
-            << pj_UTM.errorString());
-        return 0;
-    }
-
-    std::string errorString;
+        if (!pj_longlat_WGS84)
+        {
+            vtkErrorMacro(<< "Invalid geographic coordinate system specified for PROJ.4: "
+                << pj_longlat_WGS84.errorString());
+            return 0;
+        }
+        pj_UTM = std::make_unique<Proj4PJ>("+proj=utm +zone=" + std::to_string(utmZone)
+            + (utmNorthern ? " " : " +south ")
+            + "+ellps=WGS84 +datum=WGS84 +units=m +no_defs");
+        if (!*pj_UTM)
+        {
+            vtkErrorMacro(<< "Invalid projected coordinate system specified for PROJ.4: "
+                << pj_UTM->errorString());
+            return 0;
+        }
 
-    // Acquire reference point in UTM (in meters)
-    const vtkVector2d refUTM_m = convertTo<2>(pj_longlat_WGS84.convertTo(
-        pj_UTM, { refLatLongWGS84.GetY(), refLatLongWGS84.GetX(), 0.0 }, &errorString));
+        std::string errorString;
+        refUTM_m = convertTo<2>(pj_longlat_WGS84.convertTo(
+            *pj_UTM, { refLatLongWGS84.GetY(), refLatLongWGS84.GetX(), 0.0 }, &errorString));
 
-    if (!errorString.empty())
-    {
-        vtkErrorMacro(<< "PROJ.4 transformation failed: " << errorString);
-        return 0;
+        if (!errorString.empty())
+        {
+            vtkErrorMacro(<< "PROJ.4 transformation failed: " << errorString);
+            return 0;
+        }
     }
 
+    std::string errorString;
+
     // Projected/metric local<->global transformation -> shift by metric reference point.
     // (This does not change to absolute spatial size of the data set, except for unit changes).
     if (sourceType != CoordinateSystemType::geographic
@@ -594,6 +1252,23 @@ int GeographicTransformationFilter::RequestData(
 
     // In code below here, elevations are just passed through.
 
+    const auto toUTM = useFastProjection
+        ? fastUTMConverter(*fastUTM, true)
+        : proj4Converter(pj_longlat_WGS84, *pj_UTM);
+    const auto fromUTM = useFastProjection
+        ? fastUTMConverter(*fastUTM, false)
+        : proj4Converter(*pj_UTM, pj_longlat_WGS84);
+    auto transform = [this, output] (const CoordinateArrayConverter & convert,
+        const CoordinateArrayConverter & convertInverse)
+    {
+        if (auto image = vtkImageData::SafeDownCast(output))
+        {
+            return transformImage(*image, convert, convertInverse,
+                this->ImageTransform, this->ImageAffineTolerance, this->ParallelProjection);
+        }
+        return transformCoodinates(*output, convert, this->ParallelProjection);
+    };
+
     assert(sourceType == CoordinateSystemType::geographic
         || targetType == CoordinateSystemType::geographic);
 
@@ -601,7 +1276,7 @@ int GeographicTransformationFilter::RequestData(
     if (sourceType == CoordinateSystemType::geographic)
     {
         assert(targetType != CoordinateSystemType::geographic);
-        errorString = transformCoodinates(*output, pj_longlat_WGS84, pj_UTM);
+        errorString = transform(toUTM, fromUTM);
         if (!errorString.empty())
         {
             vtkErrorMacro(<< "Coordinate transformation failed: " << errorString);
@@ -627,17 +1302,19 @@ int GeographicTransformationFilter::RequestData(
     {
         assert(targetType == CoordinateSystemType::geographic);
         // Conversion to geographic coordinates! Make sure source is in global coordinates, in meters.
-        if (targetType == CoordinateSystemType::geographic
-            && sourceType == CoordinateSystemType::metricLocal)
+        const double sourceUnitScale = mathhelper::scaleFactorForMetricUnits(sourceUnit, "m");
+        if (sourceType == CoordinateSystemType::metricLocal || sourceUnitScale != 1.0)
         {
-            const double sourceUnitScale = mathhelper::scaleFactorForMetricUnits(sourceUnit, "m");
+            // Shift the previous (0,0) of local coordinates to the global reference point.
+            const auto shift = sourceType == CoordinateSystemType::metricLocal
+                ? refUTM_m : vtkVector2d{ 0.0, 0.0 };
 
             scaleShiftDataSet(*output,
                 vtkVector2d{ sourceUnitScale, sourceUnitScale },  // Convert to meters.
-                refUTM_m); // Shift the previous (0,0) to the global reference point.
+                shift);
         }
 
-        errorString = transformCoodinates(*output, pj_UTM, pj_longlat_WGS84);
+        errorString = transform(fromUTM, toUTM);
         if (!errorString.empty())
         {
             vtkErrorMacro(<< "Coordinate transformation failed: " << errorString);
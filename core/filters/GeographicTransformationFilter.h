@@ -46,7 +46,9 @@
  *
  * **Input/Output.** This filter supports subclasses of vtkPointSet and vtkImageData as input, and
  * will output a data set of the same data type as the input. Only point coordinates will be
- * modified. All topology and attributes are preserved.
+ * modified. All topology and attributes are preserved. Images remain implicit: origin and spacing
+ * are adjusted where this approximates the transformation well enough, otherwise point attributes
+ * are resampled on a regular grid in the target system (see SetImageTransform()).
  *
  * @see ReferencedCoordinateSystemSpecification, SetCoordinateSystemInformationFilter
  */
@@ -71,6 +73,82 @@ public:
     vtkSetMacro(OperateInPlace, bool);
     vtkBooleanMacro(OperateInPlace, bool);
 
+    /**
+     * Split PROJ.4 transformations of point coordinates into chunks that are transformed in
+     * parallel, each thread using its own PROJ.4 context. Results are identical to the serial
+     * transformation. This is enabled by default.
+     */
+    vtkGetMacro(ParallelProjection, bool);
+    vtkSetMacro(ParallelProjection, bool);
+    vtkBooleanMacro(ParallelProjection, bool);
+
+    enum ProjectionMethod
+    {
+        /** Use the application wide default, see SetDefaultProjectionMethod() */
+        ProjectionDefault,
+        /** Use PROJ.4 for projections between geographic and UTM coordinates. */
+        ProjectionExact,
+        /**
+         * Use the built-in Krüger series implementation for WGS 84 <-> UTM projections.
+         * This is considerably faster and deviates by less than
+         * KruegerTransverseMercator::maximumError() (sub-millimeter) from exact results.
+         * @see KruegerTransverseMercator
+         */
+        ProjectionFast
+    };
+
+    vtkGetMacro(Projection, ProjectionMethod);
+    vtkSetClampMacro(Projection, ProjectionMethod, ProjectionDefault, ProjectionFast);
+    /** @return the projection method used in the next update, resolving ProjectionDefault. */
+    ProjectionMethod GetEffectiveProjectionMethod() const;
+
+    /**
+     * Application wide projection method used by filters set to ProjectionDefault.
+     * Changing this method marks these filters as modified. Initially, this is ProjectionExact.
+     */
+    static void SetDefaultProjectionMethod(ProjectionMethod method);
+    static ProjectionMethod GetDefaultProjectionMethod();
+
+    vtkMTimeType GetMTime() override;
+
+    /** Transformation of vtkImageData inputs between geographic and projected coordinates. */
+    enum ImageTransformMode
+    {
+        /**
+         * Adjust origin and spacing if this approximates the transformation within
+         * ImageAffineTolerance, otherwise resample.
+         */
+        ImageTransformAutomatic,
+        /** Always adjust origin and spacing only. This is the default. */
+        ImageTransformAffine,
+        /**
+         * Always resample point attributes bilinearly on a regular grid that covers the
+         * transformed image. The grid has the same dimensions as the input image. Target points
+         * outside of the source image are set to NaN. Cell attributes are not passed.
+         * Instead, the output provides the ids of the related input points and cells, see
+         * OriginalPointIdsArrayName().
+         */
+        ImageTransformResample
+    };
+    vtkGetMacro(ImageTransform, ImageTransformMode);
+    vtkSetClampMacro(ImageTransform, ImageTransformMode, ImageTransformAutomatic, ImageTransformResample);
+
+    /**
+     * Maximal deviation of the adjusted origin/spacing from the exact transformation, in target
+     * pixels, for ImageTransformAutomatic. The deviation is checked at a grid of sample points.
+     * Default is 0.25.
+     */
+    vtkGetMacro(ImageAffineTolerance, double);
+    vtkSetMacro(ImageAffineTolerance, double);
+
+    /**
+     * Names of the vtkIdTypeArrays that resampled images provide as point and cell attributes.
+     * Points are mapped to the nearest input point, cells to the input cell that contains their
+     * center. Points and cells outside of the input image are mapped to -1.
+     */
+    static const char * OriginalPointIdsArrayName();
+    static const char * OriginalCellIdsArrayName();
+
 protected:
     GeographicTransformationFilter();
     ~GeographicTransformationFilter() override;
@@ -90,6 +168,10 @@ private:
     CoordinateSystemSpecification TargetCoordinateSystem;
     ReferencedCoordinateSystemSpecification ReferencedTargetSpec;
     bool OperateInPlace;
+    bool ParallelProjection;
+    ProjectionMethod Projection;
+    ImageTransformMode ImageTransform;
+    double ImageAffineTolerance;
 
 private:
     GeographicTransformationFilter(const GeographicTransformationFilter &) = delete;
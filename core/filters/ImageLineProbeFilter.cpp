@@ -0,0 +1,259 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImageLineProbeFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <vtkArrayDispatch.h>
+#include <vtkCellArray.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSMPTools.h>
+
+#include <core/utility/vtkvectorhelper.h>
+
+
+vtkStandardNewMacro(ImageLineProbeFilter);
+
+
+namespace
+{
+
+struct BilinearLineSamplingWorker
+{
+    vtkVector2d startPoint;
+    vtkVector2d lineVector;
+    vtkIdType numSamples;
+    // structured index space of the first image slice
+    vtkVector2d origin;
+    vtkVector2d spacing;
+    vtkVector2i minIndex;
+    vtkVector2i dimensions;
+
+    template<typename InArrayT, typename OutArrayT>
+    void operator()(InArrayT * inScalars, OutArrayT * outScalars)
+    {
+        using OutValueType = typename vtkDataArrayAccessor<OutArrayT>::APIType;
+
+        vtkDataArrayAccessor<InArrayT> in(inScalars);
+        vtkDataArrayAccessor<OutArrayT> out(outScalars);
+        const int numComponents = inScalars->GetNumberOfComponents();
+
+        // Tolerate rounding errors for samples exactly on the image border.
+        const double eps = 1e-6;
+
+        vtkSMPTools::For(0, numSamples,
+            [this, &in, &out, numComponents, eps] (vtkIdType begin, vtkIdType end)
+        {
+            for (vtkIdType s = begin; s < end; ++s)
+            {
+                const double t = numSamples > 1
+                    ? static_cast<double>(s) / static_cast<double>(numSamples - 1)
+                    : 0.0;
+
+                // continuous index relative to the image extent
+                double ci[2];
+                bool isInside = true;
+                for (int d = 0; d < 2; ++d)
+                {
+                    ci[d] = (startPoint[d] + t * lineVector[d] - origin[d]) / spacing[d]
+                        - minIndex[d];
+                    isInside = isInside && ci[d] >= -eps && ci[d] <= dimensions[d] - 1 + eps;
+                }
+
+                if (!isInside)
+                {
+                    for (int c = 0; c < numComponents; ++c)
+                    {
+                        out.Set(s, c, std::numeric_limits<OutValueType>::quiet_NaN());
+                    }
+                    continue;
+                }
+
+                int i0[2], i1[2];
+                double f[2];
+                for (int d = 0; d < 2; ++d)
+                {
+                    const double clamped = std::max(0.0, std::min(ci[d], dimensions[d] - 1.0));
+                    i0[d] = std::min(static_cast<int>(clamped), std::max(0, dimensions[d] - 2));
+                    i1[d] = std::min(i0[d] + 1, dimensions[d] - 1);
+                    f[d] = clamped - i0[d];
+                }
+
+                const vtkIdType dimX = dimensions[0];
+                const vtkIdType corners[4] = {
+                    i0[0] + i0[1] * dimX, i1[0] + i0[1] * dimX,
+                    i0[0] + i1[1] * dimX, i1[0] + i1[1] * dimX };
+                const double weights[4] = {
+                    (1.0 - f[0]) * (1.0 - f[1]), f[0] * (1.0 - f[1]),
+                    (1.0 - f[0]) * f[1], f[0] * f[1] };
+
+                for (int c = 0; c < numComponents; ++c)
+                {
+                    double value = 0.0;
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        // Skip pixels that do not contribute, so that NaNs next to the sample
+                        // position are not propagated.
+                        if (weights[k] > 0.0)
+                        {
+                            value += weights[k] * static_cast<double>(in.Get(corners[k], c));
+                        }
+                    }
+                    out.Set(s, c, static_cast<OutValueType>(value));
+                }
+            }
+        });
+    }
+};
+
+}
+
+
+ImageLineProbeFilter::ImageLineProbeFilter()
+    : Superclass()
+    , StartPoint{ 0.0, 0.0 }
+    , EndPoint{ 1.0, 0.0 }
+    , SamplesPerPixel{ 1.0 }
+{
+    this->SetInputArrayToProcess(0, 0, 0,
+        vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
+}
+
+ImageLineProbeFilter::~ImageLineProbeFilter() = default;
+
+vtkIdType ImageLineProbeFilter::ComputeNumberOfSamples(const double spacing[3]) const
+{
+    const auto lineVector = this->EndPoint - this->StartPoint;
+    // Number of pixel rows/columns crossed by the line
+    const double pixelSteps = std::max(
+        std::abs(lineVector[0] / spacing[0]),
+        std::abs(lineVector[1] / spacing[1]));
+    const double numSteps = std::ceil(pixelSteps * this->SamplesPerPixel);
+    if (!std::isfinite(numSteps))
+    {
+        return 1;
+    }
+
+    return std::max(static_cast<vtkIdType>(1), static_cast<vtkIdType>(numSteps)) + 1;
+}
+
+int ImageLineProbeFilter::FillInputPortInformation(int port, vtkInformation * info)
+{
+    if (port == 0)
+    {
+        info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+    }
+
+    return 1;
+}
+
+int ImageLineProbeFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto image = vtkImageData::GetData(inputVector[0]);
+    auto output = vtkPolyData::GetData(outputVector);
+
+    auto scalars = this->GetInputArrayToProcess(0, inputVector);
+    if (!scalars)
+    {
+        vtkErrorMacro(<< "Missing input scalars.");
+        return 0;
+    }
+
+    int extent[6];
+    image->GetExtent(extent);
+    if (extent[1] < extent[0] || extent[3] < extent[2])
+    {
+        vtkErrorMacro(<< "Empty input image.");
+        return 0;
+    }
+
+    double spacing[3], origin[3];
+    image->GetSpacing(spacing);
+    image->GetOrigin(origin);
+
+    BilinearLineSamplingWorker worker;
+    worker.startPoint = this->StartPoint;
+    worker.lineVector = this->EndPoint - this->StartPoint;
+    worker.numSamples = this->ComputeNumberOfSamples(spacing);
+    worker.origin = vtkVector2d(origin[0], origin[1]);
+    worker.spacing = vtkVector2d(spacing[0], spacing[1]);
+    worker.minIndex = vtkVector2i(extent[0], extent[2]);
+    worker.dimensions = vtkVector2i(extent[1] - extent[0] + 1, extent[3] - extent[2] + 1);
+
+    const vtkIdType numSamples = worker.numSamples;
+
+    // Output geometry: equidistant samples connected by a poly line
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numSamples);
+    vtkSMPTools::For(0, numSamples, [&worker, &points] (vtkIdType begin, vtkIdType end)
+    {
+        for (vtkIdType s = begin; s < end; ++s)
+        {
+            const double t = worker.numSamples > 1
+                ? static_cast<double>(s) / static_cast<double>(worker.numSamples - 1)
+                : 0.0;
+            points->SetPoint(s,
+                worker.startPoint[0] + t * worker.lineVector[0],
+                worker.startPoint[1] + t * worker.lineVector[1],
+                0.0);
+        }
+    });
+
+    auto lines = vtkSmartPointer<vtkCellArray>::New();
+    lines->InsertNextCell(static_cast<int>(numSamples));
+    for (vtkIdType s = 0; s < numSamples; ++s)
+    {
+        lines->InsertCellPoint(s);
+    }
+
+    // Floating point types can represent NaN, interpolate everything else to double.
+    const int scalarType = scalars->GetDataType() == VTK_FLOAT ? VTK_FLOAT : VTK_DOUBLE;
+    auto outScalars = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(scalarType));
+    outScalars->SetName(scalars->GetName());
+    outScalars->SetNumberOfComponents(scalars->GetNumberOfComponents());
+    outScalars->SetNumberOfTuples(numSamples);
+
+    using Dispatcher = vtkArrayDispatch::Dispatch2ByValueType<
+        vtkArrayDispatch::AllTypes,
+        vtkArrayDispatch::Reals>;
+
+    if (!Dispatcher::Execute(scalars, outScalars.Get(), worker))
+    {
+        worker(scalars, outScalars.Get());
+    }
+
+    output->SetPoints(points);
+    output->SetLines(lines);
+    output->GetPointData()->SetScalars(outScalars);
+
+    return 1;
+}
@@ -0,0 +1,80 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkVector.h>
+
+#include <core/core_api.h>
+
+
+/**
+ * Samples image scalars along a line segment on the XY-plane by bilinear interpolation.
+ *
+ * The number of samples is derived from the image spacing: the line is stepped so that each pixel
+ * row and column that the line crosses is sampled SamplesPerPixel times. Sample positions are
+ * mapped directly to structured indices, so that no cell location is required, and all samples
+ * are interpolated in parallel. Only the first slice of 3D images is sampled.
+ *
+ * NaN values are propagated: a sample is NaN if any of the pixels contributing to it is NaN.
+ * Samples outside of the image are NaN, too. Floating point scalars keep their type, all other
+ * types are interpolated to double.
+ *
+ * The scalars are selected with SetInputArrayToProcess(0, 0, 0, FIELD_ASSOCIATION_POINTS, name).
+ * The output contains the samples as points and a poly line connecting them, with the interpolated
+ * values as active scalars named as the input scalars.
+ */
+class CORE_API ImageLineProbeFilter : public vtkPolyDataAlgorithm
+{
+public:
+    vtkTypeMacro(ImageLineProbeFilter, vtkPolyDataAlgorithm);
+    static ImageLineProbeFilter * New();
+
+    vtkGetMacro(StartPoint, vtkVector2d);
+    vtkSetMacro(StartPoint, vtkVector2d);
+
+    vtkGetMacro(EndPoint, vtkVector2d);
+    vtkSetMacro(EndPoint, vtkVector2d);
+
+    /** Number of samples per pixel crossed by the line. Default: 1 */
+    vtkGetMacro(SamplesPerPixel, double);
+    vtkSetClampMacro(SamplesPerPixel, double, 0.01, VTK_DOUBLE_MAX);
+
+    /** Number of samples that will be generated for the current line and the given image. */
+    vtkIdType ComputeNumberOfSamples(const double spacing[3]) const;
+
+protected:
+    ImageLineProbeFilter();
+    ~ImageLineProbeFilter() override;
+
+    int FillInputPortInformation(int port, vtkInformation * info) override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    vtkVector2d StartPoint;
+    vtkVector2d EndPoint;
+    double SamplesPerPixel;
+
+public:
+    ImageLineProbeFilter(const ImageLineProbeFilter &) = delete;
+    void operator=(const ImageLineProbeFilter &) = delete;
+};
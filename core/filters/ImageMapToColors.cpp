@@ -20,15 +20,24 @@
 
 #include <cassert>
 
+#include <vtkDataArray.h>
 #include <vtkDataSet.h>
+#include <vtkImageData.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkScalarsToColors.h>
 
 
 vtkStandardNewMacro(ImageMapToColors);
 
+const int ImageMapToColors::NumberOfQuantizedColors;
+
 
 ImageMapToColors::ImageMapToColors()
     : Superclass()
+    , QuantizedMapping{ true }
+    , UseQuantizedColors{ false }
+    , QuantizedInput{ nullptr }
 {
 }
 
@@ -45,5 +54,75 @@ int ImageMapToColors::RequestData(
 
     outData->CopyStructure(inData);
 
-    return this->Superclass::RequestData(request, inputVector, outputVector);
+    UseQuantizedColors = BuildQuantizedColors(inData->GetPointData()->GetScalars());
+
+    const int result = this->Superclass::RequestData(request, inputVector, outputVector);
+
+    UseQuantizedColors = false;
+    QuantizedInput = nullptr;
+
+    return result;
+}
+
+void ImageMapToColors::ThreadedRequestData(
+    vtkInformation * request,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector,
+    vtkImageData *** inData,
+    vtkImageData ** outData,
+    int outExt[6],
+    int id)
+{
+    if (!UseQuantizedColors)
+    {
+        this->Superclass::ThreadedRequestData(request, inputVector, outputVector, inData, outData, outExt, id);
+        return;
+    }
+
+    auto & input = *inData[0][0];
+    auto & output = *outData[0];
+
+    int inExt[6];
+    input.GetExtent(inExt);
+    const vtkIdType inRowSize = inExt[1] - inExt[0] + 1;
+    const vtkIdType inSliceSize = inRowSize * (inExt[3] - inExt[2] + 1);
+
+    const vtkIdType rowLength = outExt[1] - outExt[0] + 1;
+
+    for (int z = outExt[4]; z <= outExt[5]; ++z)
+    {
+        for (int y = outExt[2]; y <= outExt[3]; ++y)
+        {
+            const vtkIdType tupleIndex = (z - inExt[4]) * inSliceSize
+                + (y - inExt[2]) * inRowSize + (outExt[0] - inExt[0]);
+            auto rgba = static_cast<unsigned char *>(output.GetScalarPointer(outExt[0], y, z));
+
+            QuantizedColors.map(*QuantizedInput, this->ActiveComponent, tupleIndex, rowLength, rgba);
+        }
+    }
+}
+
+bool ImageMapToColors::BuildQuantizedColors(vtkDataArray * scalars)
+{
+    if (!this->QuantizedMapping
+        || !this->LookupTable
+        || !scalars
+        || !QuantizedColorTable::isSupported(*scalars)
+        || this->ActiveComponent < 0
+        || this->ActiveComponent >= scalars->GetNumberOfComponents()
+        || this->OutputFormat != VTK_RGBA
+        || this->PassAlphaToOutput)
+    {
+        return false;
+    }
+
+    // Also builds the lookup table, same as in vtkImageMapToColors::RequestData
+    if (!QuantizedColors.build(*this->LookupTable))
+    {
+        return false;
+    }
+
+    QuantizedInput = scalars;
+
+    return true;
 }
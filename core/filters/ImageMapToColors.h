@@ -21,6 +21,7 @@
 #include <vtkImageMapToColors.h>
 
 #include <core/core_api.h>
+#include <core/utility/QuantizedColorTable.h>
 
 
 /**
@@ -31,6 +32,9 @@
  * Output image bounds and spacing remain the same, thus are wrong.
  * This implementation just adds a CopyStructure call in the data request pass.
  *
+ * For the common case of float/double scalars mapped to RGBA by a linear vtkLookupTable, values
+ * are mapped via a QuantizedColorTable instead of the generic vtkScalarsToColors implementation.
+ *
  * NOTE: vtkImageMapToColors "consumes" its input scalars, thus it does not allow to pass-through
  * the original data. At some places that would be required, so an option to pass through the input
  * would be a useful extension. (see RenderedImageData.cpp)
@@ -42,6 +46,13 @@ public:
 
     static ImageMapToColors * New();
 
+    /** Enable mapping via the quantized color table where applicable. This is enabled by default. */
+    vtkBooleanMacro(QuantizedMapping, bool);
+    vtkGetMacro(QuantizedMapping, bool);
+    vtkSetMacro(QuantizedMapping, bool);
+
+    static const int NumberOfQuantizedColors = QuantizedColorTable::NumberOfColors;
+
 protected:
     ImageMapToColors();
     ~ImageMapToColors() override;
@@ -50,6 +61,26 @@ protected:
         vtkInformationVector ** inputVector,
         vtkInformationVector * outputVector) override;
 
+    void ThreadedRequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector,
+        vtkImageData *** inData,
+        vtkImageData ** outData,
+        int outExt[6],
+        int id) override;
+
+private:
+    /** @return whether the quantized mapping is applicable for the current input and settings */
+    bool BuildQuantizedColors(vtkDataArray * scalars);
+
+private:
+    bool QuantizedMapping;
+
+    /** State of the current execution, built before threads are started */
+    bool UseQuantizedColors;
+    vtkDataArray * QuantizedInput;
+    QuantizedColorTable QuantizedColors;
+
 private:
     ImageMapToColors(const ImageMapToColors &) = delete;
     void operator=(const ImageMapToColors &) = delete;
@@ -0,0 +1,597 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImagePyramidFilter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <vtkArrayDispatch.h>
+#include <vtkDataArray.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+
+vtkStandardNewMacro(ImagePyramidFilter);
+
+
+namespace
+{
+
+/** Average 2x2 source pixels per target pixel, for a tile of the target image. */
+struct DownsampleWorker
+{
+    vtkVector2<vtkIdType> sourceDimensions;
+    vtkVector2<vtkIdType> targetDimensions;
+    /** Target tile in index space of the target image, relative to its extent */
+    ImageExtent tile;
+
+    template <typename SourceArray, typename TargetArray>
+    void operator()(SourceArray * source, TargetArray * target)
+    {
+        using ValueType = typename vtkDataArrayAccessor<TargetArray>::APIType;
+
+        const int numComponents = source->GetNumberOfComponents();
+        assert(numComponents == target->GetNumberOfComponents());
+
+        vtkDataArrayAccessor<SourceArray> s(source);
+        vtkDataArrayAccessor<TargetArray> t(target);
+
+        std::vector<double> sums(static_cast<size_t>(numComponents));
+        std::vector<int> counts(static_cast<size_t>(numComponents));
+
+        for (vtkIdType y = tile[2]; y <= tile[3]; ++y)
+        {
+            const auto sourceYMax = std::min(2 * y + 1, sourceDimensions[1] - 1);
+
+            for (vtkIdType x = tile[0]; x <= tile[1]; ++x)
+            {
+                const auto sourceXMax = std::min(2 * x + 1, sourceDimensions[0] - 1);
+
+                std::fill(sums.begin(), sums.end(), 0.0);
+                std::fill(counts.begin(), counts.end(), 0);
+
+                for (auto sy = 2 * y; sy <= sourceYMax; ++sy)
+                {
+                    for (auto sx = 2 * x; sx <= sourceXMax; ++sx)
+                    {
+                        const auto sourceIdx = sx + sy * sourceDimensions[0];
+                        for (int c = 0; c < numComponents; ++c)
+                        {
+                            const auto value = static_cast<double>(s.Get(sourceIdx, c));
+                            if (std::isnan(value))
+                            {
+                                continue;
+                            }
+                            sums[c] += value;
+                            ++counts[c];
+                        }
+                    }
+                }
+
+                const auto targetIdx = x + y * targetDimensions[0];
+                for (int c = 0; c < numComponents; ++c)
+                {
+                    auto mean = counts[c] > 0
+                        ? sums[c] / counts[c]
+                        : std::numeric_limits<double>::quiet_NaN();
+                    if (std::is_integral<ValueType>::value)
+                    {
+                        mean = std::round(mean);
+                    }
+                    t.Set(targetIdx, c, static_cast<ValueType>(mean));
+                }
+            }
+        }
+    }
+};
+
+}
+
+
+ImagePyramidFilter::ImagePyramidFilter()
+    : Superclass()
+    , TileSize{ 256 }
+    , HasViewParameters{ false }
+    , ScreenPixelSize{ 0.0 }
+    , HasVisibleBounds{ false }
+    , VisibleBounds{ 0.0, 0.0, 0.0, 0.0 }
+    , Level{ 0 }
+    , CachedTileSize{ 0 }
+    , CachedInput{ nullptr }
+    , CachedInputMTime{ 0 }
+{
+}
+
+ImagePyramidFilter::~ImagePyramidFilter() = default;
+
+void ImagePyramidFilter::SetViewParameters(double screenPixelSize, const double visibleBounds[4])
+{
+    this->HasViewParameters = true;
+    this->ScreenPixelSize = screenPixelSize;
+    this->HasVisibleBounds = visibleBounds != nullptr;
+    if (visibleBounds)
+    {
+        std::copy(visibleBounds, visibleBounds + 4, this->VisibleBounds);
+    }
+
+    if (this->LevelGeometries.empty())
+    {
+        this->Modified();
+        return;
+    }
+
+    int level;
+    ImageExtent extent;
+    this->ComputeView(level, extent);
+
+    if (level != this->Level || extent != this->OutputExtent)
+    {
+        this->Modified();
+    }
+}
+
+void ImagePyramidFilter::ResetViewParameters()
+{
+    if (!this->HasViewParameters)
+    {
+        return;
+    }
+
+    this->HasViewParameters = false;
+    this->HasVisibleBounds = false;
+    this->Modified();
+}
+
+int ImagePyramidFilter::GetNumberOfLevels() const
+{
+    return static_cast<int>(this->LevelGeometries.size());
+}
+
+bool ImagePyramidFilter::GetWholeBounds(double bounds[6])
+{
+    if (this->LevelGeometries.empty() && this->GetNumberOfInputConnections(0) > 0)
+    {
+        this->UpdateInformation();
+    }
+    if (this->LevelGeometries.empty())
+    {
+        return false;
+    }
+
+    const auto & geometry = this->LevelGeometries.front();
+    for (int i = 0; i < 3; ++i)
+    {
+        const auto b0 = geometry.origin[i] + geometry.extent[2 * i] * geometry.spacing[i];
+        const auto b1 = geometry.origin[i] + geometry.extent[2 * i + 1] * geometry.spacing[i];
+        bounds[2 * i] = std::min(b0, b1);
+        bounds[2 * i + 1] = std::max(b0, b1);
+    }
+
+    return true;
+}
+
+vtkIdType ImagePyramidFilter::ComputeInputPointId(vtkIdType outputPointId) const
+{
+    return this->ComputeInputId(outputPointId, false);
+}
+
+vtkIdType ImagePyramidFilter::ComputeInputCellId(vtkIdType outputCellId) const
+{
+    return this->ComputeInputId(outputCellId, true);
+}
+
+vtkIdType ImagePyramidFilter::ComputeInputId(vtkIdType outputId, bool isCellId) const
+{
+    if (this->LevelGeometries.empty() || outputId < 0)
+    {
+        return -1;
+    }
+
+    const auto & inputExtent = this->LevelGeometries.front().extent;
+    const auto & levelExtent = this->LevelGeometries[static_cast<size_t>(this->Level)].extent;
+    // Number of input pixels per level pixel along x and y
+    const vtkIdType factor = vtkIdType(1) << this->Level;
+
+    vtkIdType outputDims[3], inputDims[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        // Cells of images with flat dimensions have the same index range as points.
+        const vtkIdType cellOffset = isCellId ? 1 : 0;
+        const auto outputSize = static_cast<vtkIdType>(this->OutputExtent[2 * i + 1] - this->OutputExtent[2 * i]) + 1;
+        const auto inputSize = static_cast<vtkIdType>(inputExtent[2 * i + 1] - inputExtent[2 * i]) + 1;
+        outputDims[i] = std::max(vtkIdType(1), outputSize - (outputSize > 1 ? cellOffset : 0));
+        inputDims[i] = std::max(vtkIdType(1), inputSize - (inputSize > 1 ? cellOffset : 0));
+    }
+
+    if (outputId >= outputDims[0] * outputDims[1] * outputDims[2])
+    {
+        return -1;
+    }
+
+    const vtkIdType outputIndex[3] = {
+        outputId % outputDims[0],
+        (outputId / outputDims[0]) % outputDims[1],
+        outputId / (outputDims[0] * outputDims[1]) };
+
+    vtkIdType inputId = 0;
+    vtkIdType stride = 1;
+    for (int i = 0; i < 3; ++i)
+    {
+        // Index relative to the level extent
+        const auto levelIndex = outputIndex[i] + this->OutputExtent[2 * i] - levelExtent[2 * i];
+        auto inputIndex = levelIndex;
+        if (i < 2)
+        {
+            // Level point l is centered between input points l * f and (l + 1) * f - 1, level cell
+            // centers are located in the input cell starting at (l + 1) * f - 1.
+            inputIndex = isCellId
+                ? levelIndex * factor + factor - 1
+                : levelIndex * factor + (factor - 1) / 2;
+        }
+        inputIndex = std::max(vtkIdType(0), std::min(inputDims[i] - 1, inputIndex));
+
+        inputId += inputIndex * stride;
+        stride *= inputDims[i];
+    }
+
+    return inputId;
+}
+
+void ImagePyramidFilter::ReleaseCache()
+{
+    this->Tiles.clear();
+    this->CachedInput = nullptr;
+    this->CachedInputMTime = 0;
+}
+
+int ImagePyramidFilter::RequestInformation(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    auto outInfo = outputVector->GetInformationObject(0);
+
+    LevelGeometry geometry;
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), geometry.extent.data());
+    inInfo->Get(vtkDataObject::ORIGIN(), geometry.origin.GetData());
+    inInfo->Get(vtkDataObject::SPACING(), geometry.spacing.GetData());
+
+    this->LevelGeometries.clear();
+    this->LevelGeometries.push_back(geometry);
+
+    if (!geometry.extent.isEmpty() && geometry.extent[4] == geometry.extent[5])
+    {
+        auto dimensions = geometry.extent.componentSize();
+
+        while (std::max(dimensions[0], dimensions[1]) > this->TileSize)
+        {
+            const auto & previous = this->LevelGeometries.back();
+
+            dimensions[0] = (dimensions[0] + 1) / 2;
+            dimensions[1] = (dimensions[1] + 1) / 2;
+
+            LevelGeometry next;
+            next.extent = ImageExtent({ 0, dimensions[0] - 1, 0, dimensions[1] - 1, 0, 0 });
+            // Level pixel centers are centered between the two first pixels of the previous level.
+            for (int i = 0; i < 3; ++i)
+            {
+                next.origin[i] = previous.origin[i]
+                    + (previous.extent[2 * i] + (i < 2 ? 0.5 : 0.0)) * previous.spacing[i];
+            }
+            next.spacing = vtkVector3d(
+                2.0 * previous.spacing[0], 2.0 * previous.spacing[1], previous.spacing[2]);
+
+            this->LevelGeometries.push_back(next);
+        }
+    }
+
+    this->ComputeView(this->Level, this->OutputExtent);
+
+    const auto & output = this->LevelGeometries[static_cast<size_t>(this->Level)];
+
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), this->OutputExtent.data(), 6);
+    outInfo->Set(vtkDataObject::ORIGIN(), output.origin.GetData(), 3);
+    outInfo->Set(vtkDataObject::SPACING(), output.spacing.GetData(), 3);
+
+    return 1;
+}
+
+int ImagePyramidFilter::RequestUpdateExtent(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * /*outputVector*/)
+{
+    // Output extents refer to the index space of the selected level, so always request the
+    // whole input.
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()), 6);
+
+    return 1;
+}
+
+int ImagePyramidFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    auto outInfo = outputVector->GetInformationObject(0);
+
+    auto inImage = vtkImageData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+    auto outImage = vtkImageData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    if (!inImage || !outImage)
+    {
+        return 0;
+    }
+
+    if (this->CachedInput != inImage
+        || this->CachedInputMTime != inImage->GetMTime()
+        || this->CachedTileSize != this->TileSize
+        || this->Tiles.size() != this->LevelGeometries.size())
+    {
+        this->Tiles.clear();
+        this->Tiles.resize(this->LevelGeometries.size());
+        this->CachedInput = inImage;
+        this->CachedInputMTime = inImage->GetMTime();
+        this->CachedTileSize = this->TileSize;
+    }
+
+    if (this->Level == 0 && this->OutputExtent == ImageExtent(inImage->GetExtent()))
+    {
+        outImage->ShallowCopy(inImage);
+        return 1;
+    }
+
+    this->UpdateTiles(this->Level, this->OutputExtent, *inImage);
+
+    auto & source = this->Level == 0
+        ? *inImage
+        : *this->Tiles[static_cast<size_t>(this->Level)].image;
+    const auto & geometry = this->LevelGeometries[static_cast<size_t>(this->Level)];
+
+    if (this->OutputExtent == geometry.extent)
+    {
+        outImage->ShallowCopy(&source);
+    }
+    else
+    {
+        outImage->SetExtent(this->OutputExtent.data());
+        outImage->SetOrigin(geometry.origin.GetData());
+        outImage->SetSpacing(geometry.spacing.GetData());
+
+        auto outPointData = outImage->GetPointData();
+        outPointData->CopyAllocate(source.GetPointData(), outImage->GetNumberOfPoints());
+        outPointData->CopyStructuredData(source.GetPointData(),
+            source.GetExtent(), this->OutputExtent.data());
+    }
+
+    outImage->GetFieldData()->PassData(inImage->GetFieldData());
+
+    return 1;
+}
+
+void ImagePyramidFilter::ComputeView(int & level, ImageExtent & extent) const
+{
+    assert(!this->LevelGeometries.empty());
+
+    const auto numLevels = static_cast<int>(this->LevelGeometries.size());
+
+    level = 0;
+
+    if (this->HasViewParameters)
+    {
+        const auto pixelSize = [this] (int l)
+        {
+            const auto & spacing = this->LevelGeometries[static_cast<size_t>(l)].spacing;
+            return std::min(std::abs(spacing[0]), std::abs(spacing[1]));
+        };
+
+        while (level + 1 < numLevels && pixelSize(level + 1) <= this->ScreenPixelSize)
+        {
+            ++level;
+        }
+    }
+
+    const auto & geometry = this->LevelGeometries[static_cast<size_t>(level)];
+    extent = geometry.extent;
+
+    // Images that fit into a single tile are never reduced to visible tiles.
+    if (!this->HasViewParameters || !this->HasVisibleBounds || numLevels == 1)
+    {
+        return;
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const auto extentMin = geometry.extent[2 * i];
+        const auto extentMax = geometry.extent[2 * i + 1];
+        const auto numPixels = static_cast<double>(extentMax - extentMin + 1);
+
+        auto b0 = (this->VisibleBounds[2 * i] - geometry.origin[i]) / geometry.spacing[i] - extentMin;
+        auto b1 = (this->VisibleBounds[2 * i + 1] - geometry.origin[i]) / geometry.spacing[i] - extentMin;
+        if (b0 > b1)
+        {
+            std::swap(b0, b1);
+        }
+        b0 = std::max(-1.0, std::min(numPixels, std::floor(b0)));
+        b1 = std::max(-1.0, std::min(numPixels, std::ceil(b1)));
+
+        const auto tileMin = static_cast<int>(std::floor(b0 / this->TileSize)) * this->TileSize;
+        const auto tileMax = (static_cast<int>(std::floor(b1 / this->TileSize)) + 1) * this->TileSize - 1;
+
+        extent[2 * i] = std::max(extentMin, std::min(extentMax, extentMin + tileMin));
+        extent[2 * i + 1] = std::max(extentMin, std::min(extentMax, extentMin + tileMax));
+    }
+}
+
+void ImagePyramidFilter::UpdateTiles(int level, const ImageExtent & region, vtkImageData & input)
+{
+    if (level == 0)
+    {
+        return;
+    }
+
+    auto & tiles = this->InitializeLevel(level, input);
+    const auto & geometry = this->LevelGeometries[static_cast<size_t>(level)];
+    const auto tileSize = this->TileSize;
+
+    // Level extents start at 0 for all levels but the input.
+    const auto tilesX0 = region[0] / tileSize;
+    const auto tilesX1 = region[1] / tileSize;
+    const auto tilesY0 = region[2] / tileSize;
+    const auto tilesY1 = region[3] / tileSize;
+
+    std::vector<int> missingTiles;
+    ImageExtent missingRegion;
+    for (int ty = tilesY0; ty <= tilesY1; ++ty)
+    {
+        for (int tx = tilesX0; tx <= tilesX1; ++tx)
+        {
+            const auto tileIdx = tx + ty * tiles.numTilesX;
+            if (tiles.isTileValid[static_cast<size_t>(tileIdx)])
+            {
+                continue;
+            }
+            missingTiles.push_back(tileIdx);
+            missingRegion.add(ImageExtent({
+                tx * tileSize, (tx + 1) * tileSize - 1,
+                ty * tileSize, (ty + 1) * tileSize - 1,
+                0, 0 }).intersect(geometry.extent));
+        }
+    }
+
+    if (missingTiles.empty())
+    {
+        return;
+    }
+
+    // Make sure the required source region in the previous level is available.
+    const auto & sourceGeometry = this->LevelGeometries[static_cast<size_t>(level - 1)];
+    const auto sourceRegion = ImageExtent({
+        sourceGeometry.extent[0] + 2 * missingRegion[0],
+        sourceGeometry.extent[0] + 2 * missingRegion[1] + 1,
+        sourceGeometry.extent[2] + 2 * missingRegion[2],
+        sourceGeometry.extent[2] + 2 * missingRegion[3] + 1,
+        sourceGeometry.extent[4], sourceGeometry.extent[5] }).intersection(sourceGeometry.extent);
+    this->UpdateTiles(level - 1, sourceRegion, input);
+
+    auto & source = level == 1
+        ? input
+        : *this->Tiles[static_cast<size_t>(level - 1)].image;
+    auto & target = *tiles.image;
+
+    const auto sourceSize = sourceGeometry.extent.componentSize();
+    const auto targetSize = geometry.extent.componentSize();
+
+    vtkSMPTools::For(0, static_cast<vtkIdType>(missingTiles.size()), 1,
+        [&] (vtkIdType begin, vtkIdType end)
+    {
+        DownsampleWorker worker;
+        worker.sourceDimensions = { sourceSize[0], sourceSize[1] };
+        worker.targetDimensions = { targetSize[0], targetSize[1] };
+
+        for (auto i = begin; i < end; ++i)
+        {
+            const auto tileIdx = missingTiles[static_cast<size_t>(i)];
+            const auto tx = tileIdx % tiles.numTilesX;
+            const auto ty = tileIdx / tiles.numTilesX;
+            worker.tile = ImageExtent({
+                tx * tileSize, (tx + 1) * tileSize - 1,
+                ty * tileSize, (ty + 1) * tileSize - 1,
+                0, 0 }).intersect(geometry.extent);
+
+            auto targetPointData = target.GetPointData();
+            for (int a = 0; a < targetPointData->GetNumberOfArrays(); ++a)
+            {
+                auto targetArray = targetPointData->GetArray(a);
+                auto sourceArray = source.GetPointData()->GetArray(targetArray->GetName());
+                assert(sourceArray);
+
+                using Dispatcher = vtkArrayDispatch::Dispatch2SameValueType;
+                if (!Dispatcher::Execute(sourceArray, targetArray, worker))
+                {
+                    worker(sourceArray, targetArray);
+                }
+            }
+
+            tiles.isTileValid[static_cast<size_t>(tileIdx)] = 1;
+        }
+    });
+}
+
+ImagePyramidFilter::LevelTiles & ImagePyramidFilter::InitializeLevel(int level, vtkImageData & input)
+{
+    auto & tiles = this->Tiles[static_cast<size_t>(level)];
+    if (tiles.image)
+    {
+        return tiles;
+    }
+
+    const auto & geometry = this->LevelGeometries[static_cast<size_t>(level)];
+    const auto size = geometry.extent.componentSize();
+
+    tiles.numTilesX = (size[0] + this->TileSize - 1) / this->TileSize;
+    const auto numTilesY = (size[1] + this->TileSize - 1) / this->TileSize;
+    tiles.isTileValid.assign(static_cast<size_t>(tiles.numTilesX * numTilesY), 0);
+
+    tiles.image = vtkSmartPointer<vtkImageData>::New();
+    tiles.image->SetExtent(geometry.extent.data());
+    tiles.image->SetOrigin(geometry.origin.GetData());
+    tiles.image->SetSpacing(geometry.spacing.GetData());
+
+    const auto numPoints = tiles.image->GetNumberOfPoints();
+    auto & inPointData = *input.GetPointData();
+    auto & pointData = *tiles.image->GetPointData();
+
+    // Only numeric point data can be averaged.
+    for (int i = 0; i < inPointData.GetNumberOfArrays(); ++i)
+    {
+        auto inArray = inPointData.GetArray(i);
+        if (!inArray || !inArray->GetName())
+        {
+            continue;
+        }
+
+        auto array = vtkSmartPointer<vtkDataArray>::Take(inArray->NewInstance());
+        array->SetName(inArray->GetName());
+        array->SetNumberOfComponents(inArray->GetNumberOfComponents());
+        array->SetNumberOfTuples(numPoints);
+
+        const auto attribute = inPointData.IsArrayAnAttribute(i);
+        if (attribute >= 0)
+        {
+            pointData.SetAttribute(array, attribute);
+        }
+        else
+        {
+            pointData.AddArray(array);
+        }
+    }
+
+    return tiles;
+}
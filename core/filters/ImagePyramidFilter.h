@@ -0,0 +1,144 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <vtkImageAlgorithm.h>
+#include <vtkSmartPointer.h>
+#include <vtkVector.h>
+
+#include <core/core_api.h>
+#include <core/utility/DataExtent.h>
+
+
+/**
+ * Level of detail pyramid for large 2D images.
+ *
+ * Level 0 is the input image, each further level halves the resolution of the previous one by
+ * averaging 2x2 pixels (ignoring NaNs). Levels are added until the image fits into a single tile.
+ * Levels are divided into tiles of TileSize x TileSize pixels that are computed lazily and in
+ * parallel, when they are first requested. Computed tiles are cached until the input changes.
+ *
+ * The output is the selected level, reduced to the tiles intersecting the visible bounds.
+ * Without view parameters, or for images that fit into a single tile, the input is passed through.
+ * 3D images are always passed through.
+ */
+class CORE_API ImagePyramidFilter : public vtkImageAlgorithm
+{
+public:
+    static ImagePyramidFilter * New();
+    vtkTypeMacro(ImagePyramidFilter, vtkImageAlgorithm);
+
+    /** Edge length of tiles in pixels. Default: 256 */
+    vtkGetMacro(TileSize, int);
+    vtkSetClampMacro(TileSize, int, 2, VTK_INT_MAX);
+
+    /**
+     * Select the output for the current view.
+     * The coarsest level whose pixels are not larger than screenPixelSize (in world coordinates)
+     * is selected, and only tiles intersecting visibleBounds (xMin, xMax, yMin, yMax) are
+     * extracted. visibleBounds may be nullptr to extract all tiles of the level.
+     * The filter is only modified if this changes the selected level or tiles.
+     */
+    void SetViewParameters(double screenPixelSize, const double visibleBounds[4]);
+    /** Pass through the full resolution image. This is the default. */
+    void ResetViewParameters();
+
+    /** Currently selected level. 0 is the full resolution input. */
+    vtkGetMacro(Level, int);
+    /** Number of levels, including the input. Requires updated pipeline information. */
+    int GetNumberOfLevels() const;
+
+    /** Bounds of the full resolution input. Updates the pipeline information if required. */
+    bool GetWholeBounds(double bounds[6]);
+
+    /**
+     * Map point or cell ids of the current output to ids of the full resolution input.
+     * For downsampled levels, the input point or cell closest to the center of the output point
+     * or cell is returned. Ids of filters downstream that preserve the image structure can be
+     * mapped the same way.
+     * @return -1 if the id is not valid for the current output.
+     */
+    vtkIdType ComputeInputPointId(vtkIdType outputPointId) const;
+    vtkIdType ComputeInputCellId(vtkIdType outputCellId) const;
+
+    /** Discard all cached tiles. */
+    void ReleaseCache();
+
+protected:
+    ImagePyramidFilter();
+    ~ImagePyramidFilter() override;
+
+    int RequestInformation(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+    int RequestUpdateExtent(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    struct LevelGeometry
+    {
+        ImageExtent extent;
+        vtkVector3d origin;
+        vtkVector3d spacing;
+    };
+
+    struct LevelTiles
+    {
+        vtkSmartPointer<vtkImageData> image;
+        int numTilesX;
+        /** Per tile flag, stored as char to allow concurrent updates. */
+        std::vector<char> isTileValid;
+    };
+
+    vtkIdType ComputeInputId(vtkIdType outputId, bool isCellId) const;
+    /** Compute level and extent for the current view parameters and LevelGeometries */
+    void ComputeView(int & level, ImageExtent & extent) const;
+    /** Make sure that all tiles of level intersecting region are computed. */
+    void UpdateTiles(int level, const ImageExtent & region, vtkImageData & input);
+    LevelTiles & InitializeLevel(int level, vtkImageData & input);
+
+private:
+    int TileSize;
+
+    bool HasViewParameters;
+    double ScreenPixelSize;
+    bool HasVisibleBounds;
+    double VisibleBounds[4];
+
+    int Level;
+    ImageExtent OutputExtent;
+
+    std::vector<LevelGeometry> LevelGeometries;
+    std::vector<LevelTiles> Tiles;
+    int CachedTileSize;
+    vtkImageData * CachedInput;
+    vtkMTimeType CachedInputMTime;
+
+private:
+    ImagePyramidFilter(const ImagePyramidFilter &) = delete;
+    void operator=(const ImagePyramidFilter &) = delete;
+};
@@ -18,6 +18,7 @@
 
 #include "LineOnCellsSelector2D.h"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <numeric>
@@ -37,9 +38,12 @@
 #include <vtkPolyData.h>
 #include <vtkSelection.h>
 #include <vtkSelectionNode.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkSortDataArray.h>
+#include <vtkUnstructuredGrid.h>
 
+#include <core/utility/UniformGridIndex2D.h>
 #include <core/utility/vtkvectorhelper.h>
 
 
@@ -51,6 +55,8 @@ LineOnCellsSelector2D::LineOnCellsSelector2D()
     , Sorting{ SortMode::SortPoints }
     , PassPositionOnLine{ true }
     , PassDistanceToLine{ true }
+    , InputCellsMTime{}
+    , CellIndex{ std::make_unique<UniformGridIndex2D>() }
 {
     this->SetNumberOfInputPorts(2);
     this->SetNumberOfOutputPorts(2);
@@ -126,6 +132,39 @@ int LineOnCellsSelector2D::RequestData(vtkInformation * /*request*/,
         return 0;
     }
 
+    // Spatial index of the cell bounds for corridor queries
+    const auto cellsMTime = cellInput->GetMTime();
+    if (this->InputCellsMTime < cellsMTime)
+    {
+        this->InputCellsMTime = cellsMTime;
+
+        std::vector<double> cellBounds(static_cast<size_t>(4 * numInputCells));
+        auto fetchCellBounds = [cellInput, &cellBounds] (vtkIdType begin, vtkIdType end)
+        {
+            double bounds[6];
+            for (vtkIdType cellId = begin; cellId < end; ++cellId)
+            {
+                cellInput->GetCellBounds(cellId, bounds);
+                std::copy(bounds, bounds + 4, cellBounds.begin() + 4 * cellId);
+            }
+        };
+
+        // GetCellBounds of poly data and unstructured grids is thread safe after a first call from
+        // a single thread. Other point sets may use internal state (e.g., GetCell), so they are
+        // processed serially.
+        if (vtkPolyData::SafeDownCast(cellInput) || vtkUnstructuredGrid::SafeDownCast(cellInput))
+        {
+            fetchCellBounds(0, 1);
+            vtkSMPTools::For(1, numInputCells, fetchCellBounds);
+        }
+        else
+        {
+            fetchCellBounds(0, numInputCells);
+        }
+
+        this->CellIndex->buildForBoxes(cellBounds);
+    }
+
     const auto & A = this->StartPoint;
     const auto & B = this->EndPoint;
     const auto AB = B - A;
@@ -143,16 +182,28 @@ int LineOnCellsSelector2D::RequestData(vtkInformation * /*request*/,
     };
 
 
-    // compute relative position in half spaces for all points
-    std::vector<double> signedPointDistances(static_cast<size_t>(numInputPoints));
-    auto & cellPointCoords = *cellInput->GetPoints()->GetData();
-    for (vtkIdType i = 0; i < numInputPoints; ++i)
+    // Relevant cells intersect the line and have their centroid within the segment's range on the
+    // line, so that they are located at most one cell size beyond the segment's end points.
+    std::vector<vtkIdType> candidateCells;
+    if (AB.SquaredNorm() > 0.0)
     {
-        signedPointDistances[i] = signedDistanceToLine({
-            cellPointCoords.GetComponent(i, 0),
-            cellPointCoords.GetComponent(i, 1) });
+        const auto & maxCellSize = this->CellIndex->maximumBoxSize();
+        const auto extension = AB.Normalized() * std::sqrt(maxCellSize.Dot(maxCellSize));
+        const vtkVector2d start((A - extension).GetData());
+        const vtkVector2d end((B + extension).GetData());
+        this->CellIndex->queryCorridor(start, end, 0.0, candidateCells);
+        std::sort(candidateCells.begin(), candidateCells.end());
+        candidateCells.erase(std::unique(candidateCells.begin(), candidateCells.end()), candidateCells.end());
     }
 
+    auto & cellPointCoords = *cellInput->GetPoints()->GetData();
+    const auto signedPointDistance = [&cellPointCoords, &signedDistanceToLine] (vtkIdType pointId) -> double
+    {
+        return signedDistanceToLine({
+            cellPointCoords.GetComponent(pointId, 0),
+            cellPointCoords.GetComponent(pointId, 1) });
+    };
+
 
     auto selectedCells = vtkSmartPointer<vtkIdTypeArray>::New();
     selectedCells->SetName("OriginalCellIds");
@@ -178,19 +229,19 @@ int LineOnCellsSelector2D::RequestData(vtkInformation * /*request*/,
 
     auto pointIdList = vtkSmartPointer<vtkIdList>::New();
     auto & centersPointCoords = *centersInput->GetPoints()->GetData();
-    for (vtkIdType cellId = 0; cellId < numInputCells; ++cellId)
+    for (const vtkIdType cellId : candidateCells)
     {
         // check if the line intersects the cell: there must be points on both sides of the line
 
         cellInput->GetCellPoints(cellId, pointIdList);
         vtkIdType pointId = pointIdList->GetId(0);
 
-        bool lastHalfSpace = signedPointDistances[pointId] >= 0;
+        bool lastHalfSpace = signedPointDistance(pointId) >= 0;
         bool pointsInBothHalfSpaces = false;
 
         for (vtkIdType cpId = 1; !pointsInBothHalfSpaces && cpId < pointIdList->GetNumberOfIds(); ++cpId)
         {
-            const bool halfSpace = signedPointDistances[pointIdList->GetId(cpId)] >= 0;
+            const bool halfSpace = signedPointDistance(pointIdList->GetId(cpId)) >= 0;
             pointsInBothHalfSpaces = pointsInBothHalfSpaces || (lastHalfSpace != halfSpace);
             lastHalfSpace = halfSpace;
         }
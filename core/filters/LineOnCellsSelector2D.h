@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <vtkSelectionAlgorithm.h>
 #include <vtkVector.h>
 
@@ -26,6 +28,8 @@
 
 class vtkPolyData;
 
+class UniformGridIndex2D;
+
 
 /**
 * From an input set of cells, extract respective centroids that are located within the range of a
@@ -35,6 +39,9 @@ class vtkPolyData;
 * An input cell is considered in range, if:
 *     * Its centroid projected to the line is locate inside the line segment, and
 *     * There are cell points on both sides of the line (in both half spaces)
+*
+* Cells are looked up in a uniform grid index over their XY bounding boxes, so that only cells
+* near the line are tested for each update. The index is rebuilt when the input cells are modified.
 * 
 * Two outputs are produced:
 *     Port 0: vtkSelection containing relevant cell indices
@@ -105,6 +112,8 @@ private:
     SortMode Sorting;
     bool PassPositionOnLine;
     bool PassDistanceToLine;
+    vtkMTimeType InputCellsMTime;
+    std::unique_ptr<UniformGridIndex2D> CellIndex;
 
 public:
     LineOnCellsSelector2D(const LineOnCellsSelector2D &) = delete;
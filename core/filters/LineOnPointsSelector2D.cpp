@@ -19,9 +19,12 @@
 #include "LineOnPointsSelector2D.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <functional>
 #include <numeric>
+#include <random>
+#include <utility>
 #include <vector>
 
 #include <vtkDemandDrivenPipeline.h>
@@ -37,17 +40,167 @@
 #include <vtkPolyData.h>
 #include <vtkSelection.h>
 #include <vtkSelectionNode.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
 #include <vtkSmartPointer.h>
 #include <vtkSortDataArray.h>
 #include <vtkStaticPointLocator.h>
 
-
+#include <core/utility/GridSpacingEstimateCache.h>
+#include <core/utility/UniformGridIndex2D.h>
 #include <core/utility/vtkvectorhelper.h>
 
 
 vtkStandardNewMacro(LineOnPointsSelector2D);
 
 
+namespace
+{
+
+struct GridSpacingEstimate
+{
+    double spacing;
+    double standardDeviation;
+    double intervalLower;
+    double intervalUpper;
+};
+
+/** Compute the distance to the nearest neighbor for points pointId(i), i in [begin, end).
+  * vtkStaticPointLocator is thread safe for queries, so the points are processed in parallel. */
+template<typename PointIdMapping>
+void nearestNeighborDistances(vtkPoints & points, vtkStaticPointLocator & locator,
+    vtkIdType begin, vtkIdType end, const PointIdMapping & pointId, double * distances)
+{
+    vtkSMPThreadLocalObject<vtkIdList> threadNeighbors;
+
+    vtkSMPTools::For(begin, end, [&] (vtkIdType rangeBegin, vtkIdType rangeEnd)
+    {
+        auto neighbors = threadNeighbors.Local();
+        vtkVector3d point, neighbor;
+        for (vtkIdType i = rangeBegin; i < rangeEnd; ++i)
+        {
+            points.GetPoint(pointId(i), point.GetData());
+            locator.FindClosestNPoints(2, point.GetData(), neighbors);
+            assert(neighbors->GetNumberOfIds() == 2);
+
+            points.GetPoint(neighbors->GetId(1), neighbor.GetData());
+            distances[i] = (point - neighbor).Norm();
+        }
+    });
+}
+
+/** Search for points that have neighbors in an assumed grid.
+  * Distances shouldn't variate too much and the minimum distance should be near the grid spacing,
+  * so the spacing is estimated as the mean of the smaller half of the nearest neighbor distances.
+  * The confidence interval (95%) treats the distances as random sample of the input points.
+  * Note that this reorders the distances. */
+GridSpacingEstimate spacingStatistics(std::vector<double> & distances, bool isSample)
+{
+    const double inv_numDistances = 1.0 / static_cast<double>(distances.size());
+    const double meanDistance = inv_numDistances
+        * std::accumulate(distances.begin(), distances.end(), 0.0);
+
+    GridSpacingEstimate estimate;
+    estimate.standardDeviation = std::sqrt(std::accumulate(
+        distances.begin(), distances.end(), 0.0,
+        [meanDistance, inv_numDistances] (const double lastResult, double d)
+    {
+        d = d - meanDistance;
+        return lastResult + inv_numDistances * d * d;
+    }));
+
+    const size_t numDistancesToConsider = std::max(size_t(1u), distances.size() / 2u);
+    const auto midIt = distances.begin() + numDistancesToConsider;
+    std::nth_element(distances.begin(), midIt, distances.end());
+
+    estimate.spacing = std::accumulate(distances.begin(), midIt, 0.0)
+        / static_cast<double>(numDistancesToConsider);
+    estimate.intervalLower = estimate.intervalUpper = estimate.spacing;
+
+    if (!isSample || numDistancesToConsider < 2u)
+    {
+        return estimate;
+    }
+
+    const double spacing = estimate.spacing;
+    const double variance = std::accumulate(distances.begin(), midIt, 0.0,
+        [spacing] (const double lastResult, double d)
+    {
+        d = d - spacing;
+        return lastResult + d * d;
+    }) / static_cast<double>(numDistancesToConsider - 1u);
+
+    static const double z95 = 1.959964;
+    const double halfWidth = z95 * std::sqrt(variance / static_cast<double>(numDistancesToConsider));
+    estimate.intervalLower = spacing - halfWidth;
+    estimate.intervalUpper = spacing + halfWidth;
+
+    return estimate;
+}
+
+GridSpacingEstimate estimateGridSpacing(vtkPointSet & pointSet,
+    bool sample, vtkIdType initialSampleSize, double relativeError)
+{
+    const vtkIdType numPoints = pointSet.GetNumberOfPoints();
+    if (numPoints < 2)
+    {
+        return { 0.0, 0.0, 0.0, 0.0 };
+    }
+
+    auto & points = *pointSet.GetPoints();
+
+    auto locator = vtkSmartPointer<vtkStaticPointLocator>::New();
+    locator->AutomaticOn();
+    locator->SetDataSet(&pointSet);
+    locator->BuildLocator();
+
+    std::vector<double> distances;
+
+    // Enlarge the sample until the confidence interval is narrow enough. Its width decreases with
+    // the square root of the sample size. Fall back to all points, if the sample gets too large.
+    // The fixed seed keeps estimates reproducible for the same input.
+    std::mt19937 engine(0u);
+    std::uniform_int_distribution<vtkIdType> randomPointId(0, numPoints - 1);
+    std::vector<vtkIdType> sampleIds;
+    vtkIdType sampleSize = initialSampleSize;
+
+    while (sample && 2 * sampleSize <= numPoints)
+    {
+        const auto previousSize = static_cast<vtkIdType>(sampleIds.size());
+        sampleIds.resize(static_cast<size_t>(sampleSize));
+        std::generate(sampleIds.begin() + previousSize, sampleIds.end(),
+            [&engine, &randomPointId] () { return randomPointId(engine); });
+
+        distances.resize(static_cast<size_t>(sampleSize));
+        nearestNeighborDistances(points, *locator, previousSize, sampleSize,
+            [&sampleIds] (vtkIdType i) { return sampleIds[static_cast<size_t>(i)]; },
+            distances.data());
+
+        const auto estimate = spacingStatistics(distances, true);
+        const double halfWidth = 0.5 * (estimate.intervalUpper - estimate.intervalLower);
+        const double allowedHalfWidth = relativeError * estimate.spacing;
+        if (halfWidth <= allowedHalfWidth)
+        {
+            return estimate;
+        }
+
+        const double ratio = halfWidth / allowedHalfWidth;
+        const double requiredSize = std::min(static_cast<double>(numPoints),
+            std::max(1.25, ratio * ratio) * static_cast<double>(sampleSize));
+        sampleSize = static_cast<vtkIdType>(std::ceil(requiredSize));
+    }
+
+    distances.resize(static_cast<size_t>(numPoints));
+    nearestNeighborDistances(points, *locator, 0, numPoints,
+        [] (vtkIdType i) { return i; },
+        distances.data());
+
+    return spacingStatistics(distances, false);
+}
+
+}
+
+
 LineOnPointsSelector2D::LineOnPointsSelector2D()
     : Superclass()
     , Sorting{ SortMode::SortPoints }
@@ -56,6 +209,12 @@ LineOnPointsSelector2D::LineOnPointsSelector2D()
     , InputPointsMTime{}
     , ApproxGridSpacing{ 0.0 }
     , GridSpacingStandardDeviation{ 0.0 }
+    , GridSpacingConfidenceInterval{ 0.0, 0.0 }
+    , SampleGridSpacing{ false }
+    , GridSpacingSampleSize{ 4096 }
+    , GridSpacingRelativeError{ 0.01 }
+    , GridSpacingCache{ std::make_shared<GridSpacingEstimateCache>() }
+    , PointIndex{ std::make_unique<UniformGridIndex2D>() }
 {
     this->SetNumberOfInputPorts(1);
     this->SetNumberOfOutputPorts(2);
@@ -68,6 +227,38 @@ vtkPolyData * LineOnPointsSelector2D::GetExtractedPoints()
     return static_cast<vtkPolyData *>(this->GetOutputDataObject(1));
 }
 
+double LineOnPointsSelector2D::GetApproxGridSpacing() const
+{
+    return this->ApproxGridSpacing;
+}
+
+double LineOnPointsSelector2D::GetGridSpacingStandardDeviation() const
+{
+    return this->GridSpacingStandardDeviation;
+}
+
+vtkVector2d LineOnPointsSelector2D::GetGridSpacingConfidenceInterval() const
+{
+    return this->GridSpacingConfidenceInterval;
+}
+
+const std::shared_ptr<GridSpacingEstimateCache> & LineOnPointsSelector2D::GetGridSpacingCache() const
+{
+    return this->GridSpacingCache;
+}
+
+void LineOnPointsSelector2D::SetGridSpacingCache(std::shared_ptr<GridSpacingEstimateCache> cache)
+{
+    assert(cache);
+    if (this->GridSpacingCache == cache)
+    {
+        return;
+    }
+
+    this->GridSpacingCache = std::move(cache);
+    this->Modified();
+}
+
 int LineOnPointsSelector2D::FillInputPortInformation(int port, vtkInformation * info)
 {
     if (port == 0)
@@ -118,57 +309,16 @@ int LineOnPointsSelector2D::RequestData(vtkInformation * request,
 
     auto & inputPoints = *inputPointSet->GetPoints();
 
+    // Approximate grid spacing, reused while the points don't change
+    this->UpdateGridSpacing(*inputPointSet);
+
     const auto pointsMTime = std::max(inputPointSet->GetMTime(), inputPoints.GetMTime());
 
-    // Approximate grid spacing
+    // Spatial index for corridor queries
     if (this->InputPointsMTime < pointsMTime)
     {
         this->InputPointsMTime = pointsMTime;
-        auto locator = vtkSmartPointer<vtkStaticPointLocator>::New();
-        locator->AutomaticOn();
-        locator->SetDataSet(inputPointSet);
-        locator->BuildLocator();
-
-        auto neighbors = vtkSmartPointer<vtkIdList>::New();
-        neighbors->SetNumberOfIds(2);
-        vtkVector3d point, neighbor;
-        double meanDistance = 0.0;
-        const double inv_numInputPoints = 1.0 / static_cast<double>(numInputPoints);
-
-        auto neighborhoodDistances = std::vector<double>(static_cast<size_t>(numInputPoints));
-
-        auto & points = *inputPointSet->GetPoints();
-        for (vtkIdType i = 0; i < numInputPoints; ++i)
-        {
-            points.GetPoint(i, point.GetData());
-            locator->FindClosestNPoints(2, point.GetData(), neighbors);
-            assert(neighbors->GetNumberOfIds() == 2);
-            assert(point == vtkVector3d(points.GetPoint(neighbors->GetId(0))));
-
-            points.GetPoint(neighbors->GetId(1), neighbor.GetData());
-            const double distance = (point - neighbor).Norm();
-            meanDistance += distance * inv_numInputPoints;
-            neighborhoodDistances[static_cast<size_t>(i)] = distance;
-        }
-
-        this->GridSpacingStandardDeviation = std::sqrt(std::accumulate(
-            neighborhoodDistances.begin(), neighborhoodDistances.end(), 0.0,
-            [meanDistance, inv_numInputPoints] (const double lastResult, double d)
-        {
-            d = d - meanDistance;
-            return lastResult + inv_numInputPoints * d * d;
-        }));
-
-        // Search for points that have neighbors in an assumed grid.
-        // Distances shouldn't variate too much and the minimum distance should be near the
-        // grid spacing.
-
-        const size_t numPointsToConsider = std::max(size_t(1u), neighborhoodDistances.size() / 2u);
-        const auto midIt = neighborhoodDistances.begin() + numPointsToConsider;
-        std::partial_sort(neighborhoodDistances.begin(), midIt, neighborhoodDistances.end());
-
-        this->ApproxGridSpacing = std::accumulate(neighborhoodDistances.begin(), midIt, 0.0)
-            / static_cast<double>(numPointsToConsider);
+        this->PointIndex->buildForPoints(*inputPoints.GetData());
     }
 
 
@@ -189,36 +339,28 @@ int LineOnPointsSelector2D::RequestData(vtkInformation * request,
     };
 
 
-    auto selectedPoints = vtkSmartPointer<vtkIdTypeArray>::New();
-    selectedPoints->SetName("OriginalPointIds");
-
-    const bool computePositionOnLine = generateGeometry
-        && (this->PassPositionOnLine || this->Sorting != SortNone);
-
-    vtkSmartPointer<vtkDoubleArray> positionsOnLine;
-    if (computePositionOnLine)
-    {
-        positionsOnLine = vtkSmartPointer<vtkDoubleArray>::New();
-        positionsOnLine->SetName("PositionOnLine");
-    }
+    const double maxAllowedDistance =
+        0.5 * this->ApproxGridSpacing + this->GridSpacingStandardDeviation;
 
-    vtkSmartPointer<vtkDoubleArray> distancesToLine;
-    if (this->PassDistanceToLine)
+    // Only test points in the grid bins that overlap the line's corridor, in input order.
+    std::vector<vtkIdType> candidateIds;
+    if (AB.SquaredNorm() > 0.0)
     {
-        distancesToLine = vtkSmartPointer<vtkDoubleArray>::New();
-        distancesToLine->SetName("DistanceToLine");
+        this->PointIndex->queryCorridor(A, B, maxAllowedDistance, candidateIds);
+        std::sort(candidateIds.begin(), candidateIds.end());
     }
 
-    const double maxAllowedDistance =
-        0.5 * this->ApproxGridSpacing + this->GridSpacingStandardDeviation;
+    const bool computePositionOnLine = generateGeometry
+        && (this->PassPositionOnLine || this->Sorting != SortNone);
 
-    auto extractedPoints = vtkSmartPointer<vtkPoints>::New();
-    std::vector<vtkIdType> extractedPointIds;
+    std::vector<vtkIdType> selectedIds;
+    std::vector<double> selectedPositions;
+    std::vector<double> selectedDistances;
+    selectedIds.reserve(candidateIds.size());
 
     auto & pointCoords = *inputPoints.GetData();
 
-    auto pointIdList = vtkSmartPointer<vtkIdList>::New();
-    for (vtkIdType pointId = 0; pointId < numInputPoints; ++pointId)
+    for (const auto pointId : candidateIds)
     {
         vtkVector3d point;
         pointCoords.GetTuple(pointId, point.GetData());
@@ -226,7 +368,7 @@ int LineOnPointsSelector2D::RequestData(vtkInformation * request,
 
         const double distance = distanceToLine(point2d);
 
-        if (distance > maxAllowedDistance)
+        if (!(distance <= maxAllowedDistance))
         {
             continue;
         }
@@ -238,24 +380,53 @@ int LineOnPointsSelector2D::RequestData(vtkInformation * request,
             continue;
         }
 
-        selectedPoints->InsertNextValue(pointId);
-        if (generateGeometry)
-        {
-            extractedPoints->InsertNextPoint(point.GetData());
-        }
+        selectedIds.push_back(pointId);
+        selectedPositions.push_back(t);
+        selectedDistances.push_back(distance);
+    }
 
-        if (computePositionOnLine)
-        {
-            positionsOnLine->InsertNextValue(t);
-        }
+    const auto outputNumPoints = static_cast<vtkIdType>(selectedIds.size());
+
+    auto selectedPoints = vtkSmartPointer<vtkIdTypeArray>::New();
+    selectedPoints->SetName("OriginalPointIds");
+    selectedPoints->SetNumberOfValues(outputNumPoints);
+    std::copy(selectedIds.begin(), selectedIds.end(), selectedPoints->GetPointer(0));
+
+    const auto createDoubleArray = [outputNumPoints] (const char * name, const std::vector<double> & values)
+    {
+        auto array = vtkSmartPointer<vtkDoubleArray>::New();
+        array->SetName(name);
+        array->SetNumberOfValues(outputNumPoints);
+        std::copy(values.begin(), values.end(), array->GetPointer(0));
+        return array;
+    };
+
+    vtkSmartPointer<vtkDoubleArray> positionsOnLine;
+    if (computePositionOnLine)
+    {
+        positionsOnLine = createDoubleArray("PositionOnLine", selectedPositions);
+    }
+
+    vtkSmartPointer<vtkDoubleArray> distancesToLine;
+    if (this->PassDistanceToLine)
+    {
+        distancesToLine = createDoubleArray("DistanceToLine", selectedDistances);
+    }
 
-        if (this->PassDistanceToLine)
+    auto extractedPoints = vtkSmartPointer<vtkPoints>::New();
+    std::vector<vtkIdType> extractedPointIds;
+    if (generateGeometry)
+    {
+        extractedPoints->SetDataType(inputPoints.GetDataType());
+        extractedPoints->SetNumberOfPoints(outputNumPoints);
+        for (vtkIdType i = 0; i < outputNumPoints; ++i)
         {
-            distancesToLine->InsertNextValue(distance);
+            extractedPoints->SetPoint(i, pointCoords.GetTuple(selectedIds[static_cast<size_t>(i)]));
         }
-    }
 
-    const vtkIdType outputNumPoints = selectedPoints->GetNumberOfTuples();
+        extractedPointIds.resize(static_cast<size_t>(outputNumPoints));
+        std::iota(extractedPointIds.begin(), extractedPointIds.end(), 0);
+    }
 
     if (generateSelection)
     {
@@ -366,3 +537,36 @@ int LineOnPointsSelector2D::RequestData(vtkInformation * request,
 
     return 1;
 }
+
+void LineOnPointsSelector2D::UpdateGridSpacing(vtkPointSet & pointSet)
+{
+    // The estimate is kept in the cache: the input points may be shared with other pipelines and
+    // threads, so neither their information nor their modification time must be touched here.
+    const auto pointsMTime = pointSet.GetPoints()->GetMTime();
+
+    GridSpacingEstimateCache::Estimate cached;
+    if (this->GridSpacingCache->find(pointsMTime, cached))
+    {
+        const auto & interval = cached.confidenceInterval;
+        const bool isExact = interval[0] == interval[1];
+        const bool isPreciseEnough = this->SampleGridSpacing
+            && 0.5 * (interval[1] - interval[0]) <= this->GridSpacingRelativeError * cached.spacing;
+        if (isExact || isPreciseEnough)
+        {
+            this->ApproxGridSpacing = cached.spacing;
+            this->GridSpacingStandardDeviation = cached.standardDeviation;
+            this->GridSpacingConfidenceInterval = cached.confidenceInterval;
+            return;
+        }
+    }
+
+    const auto estimate = estimateGridSpacing(pointSet,
+        this->SampleGridSpacing, this->GridSpacingSampleSize, this->GridSpacingRelativeError);
+
+    this->ApproxGridSpacing = estimate.spacing;
+    this->GridSpacingStandardDeviation = estimate.standardDeviation;
+    this->GridSpacingConfidenceInterval = vtkVector2d(estimate.intervalLower, estimate.intervalUpper);
+
+    this->GridSpacingCache->store(pointsMTime, { this->ApproxGridSpacing,
+        this->GridSpacingStandardDeviation, this->GridSpacingConfidenceInterval });
+}
@@ -18,14 +18,20 @@
 
 #pragma once
 
+#include <memory>
+
 #include <vtkSelectionAlgorithm.h>
 #include <vtkVector.h>
 
 #include <core/core_api.h>
 
 
+class vtkPointSet;
 class vtkPolyData;
 
+class GridSpacingEstimateCache;
+class UniformGridIndex2D;
+
 
 /**
 * From an input set of points, extract points that are located within the range of a line segment.
@@ -36,6 +42,12 @@ class vtkPolyData;
 *     * Its distance to the line is less than the double approximated grid spacing.
 *
 * The input points are assumed to be approximately aligned on an (incomplete) grid.
+* The grid spacing is estimated from nearest neighbor distances, optionally on a random sample of
+* the input points. The estimate is stored in a GridSpacingEstimateCache, keyed by the modification
+* time of the points. Selectors that share a cache, e.g., profiles of the same data object, reuse
+* the estimate until the points are modified.
+* Points are looked up in a uniform grid index over their XY coordinates, so that only points near
+* the line are tested for each update.
 *
 * Two outputs are produced:
 *     Port 0: vtkSelection containing relevant cell indices
@@ -84,6 +96,33 @@ public:
     vtkSetMacro(PassDistanceToLine, bool);
     vtkBooleanMacro(PassDistanceToLine, bool);
 
+    /** Estimate the grid spacing from a random subset of the input points instead of all points.
+      * The sample starts with GridSpacingSampleSize points and is enlarged until the 95% confidence
+      * interval of the estimate is within GridSpacingRelativeError of the estimated spacing.
+      * Point sets that would require sampling more than half of their points are evaluated
+      * completely. Disabled by default. */
+    vtkGetMacro(SampleGridSpacing, bool);
+    vtkSetMacro(SampleGridSpacing, bool);
+    vtkBooleanMacro(SampleGridSpacing, bool);
+
+    vtkGetMacro(GridSpacingSampleSize, vtkIdType);
+    vtkSetClampMacro(GridSpacingSampleSize, vtkIdType, 16, VTK_ID_MAX);
+
+    vtkGetMacro(GridSpacingRelativeError, double);
+    vtkSetClampMacro(GridSpacingRelativeError, double, 0.0, 1.0);
+
+    /** Cache for grid spacing estimates, to be shared with other selectors on the same points.
+      * Each selector uses its own cache by default. Must not be null. */
+    const std::shared_ptr<GridSpacingEstimateCache> & GetGridSpacingCache() const;
+    void SetGridSpacingCache(std::shared_ptr<GridSpacingEstimateCache> cache);
+
+    /** Grid spacing estimate of the last update. */
+    double GetApproxGridSpacing() const;
+    double GetGridSpacingStandardDeviation() const;
+    /** Bounds of the 95% confidence interval of the grid spacing. Both bounds equal the estimate
+      * if it was computed from all input points. */
+    vtkVector2d GetGridSpacingConfidenceInterval() const;
+
 protected:
     LineOnPointsSelector2D();
     ~LineOnPointsSelector2D() override;
@@ -95,6 +134,9 @@ protected:
         vtkInformationVector ** inputVector,
         vtkInformationVector * outputVector) override;
 
+private:
+    void UpdateGridSpacing(vtkPointSet & pointSet);
+
 private:
     vtkVector2d StartPoint;
     vtkVector2d EndPoint;
@@ -104,6 +146,13 @@ private:
     vtkMTimeType InputPointsMTime;
     double ApproxGridSpacing;
     double GridSpacingStandardDeviation;
+    vtkVector2d GridSpacingConfidenceInterval;
+    bool SampleGridSpacing;
+    vtkIdType GridSpacingSampleSize;
+    double GridSpacingRelativeError;
+    std::shared_ptr<GridSpacingEstimateCache> GridSpacingCache;
+    /** XY index of the input points, rebuilt with the grid spacing when the points change */
+    std::unique_ptr<UniformGridIndex2D> PointIndex;
 
 public:
     LineOnPointsSelector2D(const LineOnPointsSelector2D &) = delete;
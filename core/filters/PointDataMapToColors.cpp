@@ -0,0 +1,154 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PointDataMapToColors.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkScalarsToColors.h>
+#include <vtkSMPTools.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <core/utility/QuantizedColorTable.h>
+
+
+vtkStandardNewMacro(PointDataMapToColors);
+
+
+namespace
+{
+
+/** @return the component that the lookup table maps, or -1 if it does not map a single component */
+int mappedComponent(vtkScalarsToColors & lut, const vtkDataArray & scalars)
+{
+    if (scalars.GetNumberOfComponents() == 1)
+    {
+        return 0;
+    }
+
+    if (lut.GetVectorMode() != vtkScalarsToColors::COMPONENT
+        || lut.GetVectorComponent() >= scalars.GetNumberOfComponents())
+    {
+        return -1;
+    }
+
+    return lut.GetVectorComponent();
+}
+
+}
+
+
+PointDataMapToColors::PointDataMapToColors()
+    : Superclass()
+    , ColorsArrayName{ "Colors" }
+    , QuantizedMapping{ true }
+{
+}
+
+PointDataMapToColors::~PointDataMapToColors() = default;
+
+vtkMTimeType PointDataMapToColors::GetMTime()
+{
+    auto mTime = this->Superclass::GetMTime();
+    if (this->LookupTable)
+    {
+        mTime = std::max(mTime, this->LookupTable->GetMTime());
+    }
+    return mTime;
+}
+
+void PointDataMapToColors::SetLookupTable(vtkScalarsToColors * lookupTable)
+{
+    if (this->LookupTable == lookupTable)
+    {
+        return;
+    }
+
+    this->LookupTable = lookupTable;
+    this->Modified();
+}
+
+vtkScalarsToColors * PointDataMapToColors::GetLookupTable()
+{
+    return this->LookupTable;
+}
+
+int PointDataMapToColors::RequestData(
+    vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto inData = vtkDataSet::SafeDownCast(vtkDataObject::GetData(inputVector[0]));
+    auto outData = vtkDataSet::SafeDownCast(vtkDataObject::GetData(outputVector));
+    assert(inData && outData);
+
+    outData->CopyStructure(inData);
+    outData->GetPointData()->PassData(inData->GetPointData());
+    outData->GetCellData()->PassData(inData->GetCellData());
+
+    auto scalars = this->ScalarsArrayName.empty()
+        ? inData->GetPointData()->GetScalars()
+        : inData->GetPointData()->GetArray(this->ScalarsArrayName.c_str());
+    if (!scalars || !this->LookupTable)
+    {
+        // nothing to do
+        return 1;
+    }
+
+    auto & lut = *this->LookupTable;
+    const int component = mappedComponent(lut, *scalars);
+
+    vtkSmartPointer<vtkUnsignedCharArray> colors;
+
+    QuantizedColorTable colorTable;
+    if (this->QuantizedMapping
+        && component >= 0
+        && QuantizedColorTable::isSupported(*scalars)
+        && colorTable.build(lut))
+    {
+        const vtkIdType numTuples = scalars->GetNumberOfTuples();
+        colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+        colors->SetNumberOfComponents(4);
+        colors->SetNumberOfTuples(numTuples);
+
+        vtkSMPTools::For(0, numTuples,
+            [&colorTable, scalars, component, &colors] (vtkIdType begin, vtkIdType end)
+        {
+            colorTable.map(*scalars, component, begin, end - begin, colors->GetPointer(4 * begin));
+        });
+    }
+    else
+    {
+        // Same as in vtkMapper::MapScalars
+        lut.Build();
+        colors.TakeReference(lut.MapScalars(scalars, VTK_COLOR_MODE_MAP_SCALARS, -1));
+    }
+
+    colors->SetName(this->ColorsArrayName.c_str());
+    outData->GetPointData()->AddArray(colors);
+
+    return 1;
+}
@@ -0,0 +1,84 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkDataSetAlgorithm.h>
+#include <vtkSmartPointer.h>
+#include <vtkStdString.h>
+
+#include <core/core_api.h>
+
+
+class vtkScalarsToColors;
+
+
+/**
+ * Maps point scalars to an RGBA point array, to be rendered by a mapper in direct scalars mode.
+ *
+ * vtkMapper maps scalars through the generic vtkScalarsToColors implementation whenever the lookup
+ * table is modified, e.g., while interactively changing the value range of the color mapping.
+ * For float/double scalars and a linear vtkLookupTable, this filter maps the values in parallel via
+ * a QuantizedColorTable instead. Other scalars are mapped by the lookup table, same as in vtkMapper.
+ *
+ * As in vtkMapper, the component of multi-component scalars is selected by the vector mode and
+ * vector component of the lookup table. Point and cell attributes of the input are passed to the
+ * output.
+ */
+class CORE_API PointDataMapToColors : public vtkDataSetAlgorithm
+{
+public:
+    vtkTypeMacro(PointDataMapToColors, vtkDataSetAlgorithm);
+    static PointDataMapToColors * New();
+
+    vtkMTimeType GetMTime() override;
+
+    void SetLookupTable(vtkScalarsToColors * lookupTable);
+    vtkScalarsToColors * GetLookupTable();
+
+    /** Name of the point array that is mapped to colors. If empty, the active point scalars are mapped. */
+    vtkSetMacro(ScalarsArrayName, const vtkStdString &);
+    vtkGetMacro(ScalarsArrayName, const vtkStdString &);
+
+    /** Name of the unsigned char RGBA point array that is added to the output. Default: "Colors" */
+    vtkSetMacro(ColorsArrayName, const vtkStdString &);
+    vtkGetMacro(ColorsArrayName, const vtkStdString &);
+
+    /** Enable mapping via the quantized color table where applicable. This is enabled by default. */
+    vtkBooleanMacro(QuantizedMapping, bool);
+    vtkGetMacro(QuantizedMapping, bool);
+    vtkSetMacro(QuantizedMapping, bool);
+
+protected:
+    PointDataMapToColors();
+    ~PointDataMapToColors() override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    vtkSmartPointer<vtkScalarsToColors> LookupTable;
+    vtkStdString ScalarsArrayName;
+    vtkStdString ColorsArrayName;
+    bool QuantizedMapping;
+
+private:
+    PointDataMapToColors(const PointDataMapToColors &) = delete;
+    void operator=(const PointDataMapToColors &) = delete;
+};
@@ -0,0 +1,451 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SlopeAspectFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <vtkArrayDispatch.h>
+#include <vtkCellData.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkInformationStringKey.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+#include <core/CoordinateSystems.h>
+#include <core/data_objects/DataObject.h>
+#include <core/utility/DataArrayRanges.h>
+#include <core/utility/DataExtent.h>
+#include <core/utility/mathhelper.h>
+
+
+vtkStandardNewMacro(SlopeAspectFilter);
+
+vtkInformationKeyMacro(SlopeAspectFilter, SLOPE_ASPECT_CACHE, ObjectBase);
+
+
+namespace
+{
+
+/** Holds the results in the information object of the source array */
+class SlopeAspectCache : public vtkObject
+{
+public:
+    vtkTypeMacro(SlopeAspectCache, vtkObject);
+    static SlopeAspectCache * New();
+
+    vtkMTimeType sourceMTime = 0;
+    /**
+     * Horizontal geometry of image DEMs, not used for poly data:
+     * spacing in meters, latitude of the first row and latitude step for geographic images
+     */
+    double geometry[4] = { 0.0, 0.0, 0.0, 0.0 };
+    vtkSmartPointer<vtkFloatArray> slopes;
+    vtkSmartPointer<vtkFloatArray> aspects;
+
+protected:
+    SlopeAspectCache() = default;
+    ~SlopeAspectCache() override = default;
+
+private:
+    SlopeAspectCache(const SlopeAspectCache &) = delete;
+    void operator=(const SlopeAspectCache &) = delete;
+};
+
+vtkStandardNewMacro(SlopeAspectCache);
+
+
+/** Slope and aspect in degrees from the horizontal elevation gradient */
+void slopeAspectFromGradient(double dzdx, double dzdy, float & slope, float & aspect)
+{
+    slope = static_cast<float>(vtkMath::DegreesFromRadians(std::atan(std::sqrt(dzdx * dzdx + dzdy * dzdy))));
+    // downslope direction: negative gradient
+    aspect = (dzdx == 0.0 && dzdy == 0.0) || !std::isfinite(slope)
+        ? std::numeric_limits<float>::quiet_NaN()
+        : static_cast<float>(vtkMath::DegreesFromRadians(std::atan2(-dzdx, -dzdy)));
+    if (aspect < 0.0f)
+    {
+        aspect += 360.0f;
+    }
+}
+
+/** Slope and aspect in degrees from a surface normal */
+void slopeAspectFromNormal(double nx, double ny, double nz, float & slope, float & aspect)
+{
+    const auto length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    if (!(length > 0.0) || !std::isfinite(length))
+    {
+        slope = aspect = std::numeric_limits<float>::quiet_NaN();
+        return;
+    }
+
+    slope = static_cast<float>(vtkMath::DegreesFromRadians(
+        std::acos(std::max(-1.0, std::min(nz / length, 1.0)))));
+    // The horizontal component of an upward normal points downslope.
+    const auto orientation = nz < 0.0 ? -1.0 : 1.0;
+    aspect = (nx == 0.0 && ny == 0.0)
+        ? std::numeric_limits<float>::quiet_NaN()
+        : static_cast<float>(vtkMath::DegreesFromRadians(std::atan2(orientation * nx, orientation * ny)));
+    if (aspect < 0.0f)
+    {
+        aspect += 360.0f;
+    }
+}
+
+
+struct ThreadData
+{
+    ValueRange<> slopeRange;
+    ValueRange<> aspectRange;
+
+    void add(float slope, float aspect)
+    {
+        if (std::isfinite(slope))
+        {
+            slopeRange.add(static_cast<double>(slope));
+        }
+        if (std::isfinite(aspect))
+        {
+            aspectRange.add(static_cast<double>(aspect));
+        }
+    }
+};
+
+/** Base for the workers: allocates the results and merges the ranges of all threads */
+struct SlopeAspectWorkerBase
+{
+    vtkSmartPointer<vtkFloatArray> slopes;
+    vtkSmartPointer<vtkFloatArray> aspects;
+    vtkSMPThreadLocal<ThreadData> threadData;
+
+    void allocate(vtkIdType numTuples)
+    {
+        slopes = vtkSmartPointer<vtkFloatArray>::New();
+        slopes->SetName(SlopeAspectFilter::SlopeArrayName());
+        slopes->SetNumberOfValues(numTuples);
+        aspects = vtkSmartPointer<vtkFloatArray>::New();
+        aspects->SetName(SlopeAspectFilter::AspectArrayName());
+        aspects->SetNumberOfValues(numTuples);
+    }
+
+    /** Store the ranges collected while computing the arrays */
+    void cacheRanges()
+    {
+        ThreadData merged;
+        for (auto it = threadData.begin(); it != threadData.end(); ++it)
+        {
+            merged.slopeRange.add((*it).slopeRange);
+            merged.aspectRange.add((*it).aspectRange);
+        }
+
+        // Both are non-negative, so that the magnitudes equal the values. Histograms are computed
+        // on request only, by DataArrayRanges::of().
+        DataArrayRanges({ merged.slopeRange }, merged.slopeRange).cacheIn(*slopes);
+        DataArrayRanges({ merged.aspectRange }, merged.aspectRange).cacheIn(*aspects);
+    }
+};
+
+/** Length of one degree of latitude, or of longitude at the equator, on the WGS 84 ellipsoid */
+const double l_metersPerDegree = vtkMath::Pi() / 180.0 * 6378137.0;
+
+struct ImageGradientWorker : SlopeAspectWorkerBase
+{
+    int dimensions[2];
+    /** Spacing in meters. For geographic images, the x-spacing applies to the equator. */
+    double spacing[2];
+    bool isGeographic = false;
+    double firstRowLatitude = 0.0;
+    double latitudeStep = 0.0;
+
+    template<typename ArrayT>
+    void operator()(ArrayT * elevations)
+    {
+        const vtkIdType nx = dimensions[0], ny = dimensions[1];
+        allocate(nx * ny);
+
+        vtkDataArrayAccessor<ArrayT> z(elevations);
+        float * const slope = slopes->GetPointer(0);
+        float * const aspect = aspects->GetPointer(0);
+        const double equatorSx = spacing[0], sy = spacing[1];
+        const bool geographic = isGeographic;
+        const double latitude0 = firstRowLatitude, dLatitude = latitudeStep;
+        auto & threads = threadData;
+
+        // Rows are processed in parallel. Central differences, one-sided at the image borders.
+        vtkSMPTools::For(0, ny, [z, slope, aspect, nx, ny, equatorSx, sy, geographic, latitude0, dLatitude, &threads]
+            (vtkIdType beginRow, vtkIdType endRow)
+        {
+            auto & local = threads.Local();
+            for (vtkIdType y = beginRow; y < endRow; ++y)
+            {
+                // Meridians converge towards the poles.
+                const auto sx = geographic
+                    ? equatorSx * std::cos(vtkMath::RadiansFromDegrees(latitude0 + static_cast<double>(y) * dLatitude))
+                    : equatorSx;
+                const auto y0 = std::max(vtkIdType(0), y - 1);
+                const auto y1 = std::min(ny - 1, y + 1);
+                const auto dy = static_cast<double>(y1 - y0) * sy;
+
+                for (vtkIdType x = 0; x < nx; ++x)
+                {
+                    const auto x0 = std::max(vtkIdType(0), x - 1);
+                    const auto x1 = std::min(nx - 1, x + 1);
+                    const auto dx = static_cast<double>(x1 - x0) * sx;
+
+                    const auto dzdx = dx > 0.0
+                        ? (static_cast<double>(z.Get(y * nx + x1, 0)) - static_cast<double>(z.Get(y * nx + x0, 0))) / dx
+                        : 0.0;
+                    const auto dzdy = dy > 0.0
+                        ? (static_cast<double>(z.Get(y1 * nx + x, 0)) - static_cast<double>(z.Get(y0 * nx + x, 0))) / dy
+                        : 0.0;
+
+                    const auto i = y * nx + x;
+                    slopeAspectFromGradient(dzdx, dzdy, slope[i], aspect[i]);
+                    local.add(slope[i], aspect[i]);
+                }
+            }
+        });
+
+        cacheRanges();
+    }
+};
+
+struct CellNormalsWorker : SlopeAspectWorkerBase
+{
+    template<typename ArrayT>
+    void operator()(ArrayT * normals)
+    {
+        const vtkIdType numTuples = normals->GetNumberOfTuples();
+        allocate(numTuples);
+
+        vtkDataArrayAccessor<ArrayT> n(normals);
+        float * const slope = slopes->GetPointer(0);
+        float * const aspect = aspects->GetPointer(0);
+        auto & threads = threadData;
+
+        vtkSMPTools::For(0, numTuples, [n, slope, aspect, &threads] (vtkIdType begin, vtkIdType end)
+        {
+            auto & local = threads.Local();
+            for (vtkIdType i = begin; i < end; ++i)
+            {
+                slopeAspectFromNormal(
+                    static_cast<double>(n.Get(i, 0)),
+                    static_cast<double>(n.Get(i, 1)),
+                    static_cast<double>(n.Get(i, 2)),
+                    slope[i], aspect[i]);
+                local.add(slope[i], aspect[i]);
+            }
+        });
+
+        cacheRanges();
+    }
+};
+
+template<typename Worker>
+void execute(vtkDataArray & sourceArray, Worker & worker)
+{
+    if (!vtkArrayDispatch::Dispatch::Execute(&sourceArray, worker))
+    {
+        worker(&sourceArray);
+    }
+
+    for (auto array : { worker.slopes.Get(), worker.aspects.Get() })
+    {
+        auto & info = *array->GetInformation();
+        info.Set(DataObject::ARRAY_IS_AUXILIARY(), 1);
+        info.Set(vtkDataArray::UNITS_LABEL(), "\xC2\xB0");  // degree sign
+    }
+}
+
+/** @return the cached results for the source array, or a new cache entry to be filled */
+vtkSmartPointer<SlopeAspectCache> cacheFor(vtkDataArray & sourceArray, const double geometry[4], bool & isValid)
+{
+    // Request the information first: creating it modifies the array.
+    auto & info = *sourceArray.GetInformation();
+    const auto sourceMTime = sourceArray.GetMTime();
+
+    vtkSmartPointer<SlopeAspectCache> cache =
+        SlopeAspectCache::SafeDownCast(info.Get(SlopeAspectFilter::SLOPE_ASPECT_CACHE()));
+
+    isValid = cache
+        && cache->sourceMTime == sourceMTime
+        && std::equal(geometry, geometry + 4, cache->geometry)
+        && cache->slopes && cache->aspects;
+
+    if (!isValid)
+    {
+        cache = vtkSmartPointer<SlopeAspectCache>::New();
+        cache->sourceMTime = sourceMTime;
+        std::copy(geometry, geometry + 4, cache->geometry);
+        info.Set(SlopeAspectFilter::SLOPE_ASPECT_CACHE(), cache);
+    }
+
+    return cache;
+}
+
+}
+
+
+SlopeAspectFilter::SlopeAspectFilter() = default;
+
+SlopeAspectFilter::~SlopeAspectFilter() = default;
+
+const char * SlopeAspectFilter::SlopeArrayName()
+{
+    return "Slope Angle";
+}
+
+const char * SlopeAspectFilter::AspectArrayName()
+{
+    return "Slope Aspect";
+}
+
+int SlopeAspectFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto inInfo = inputVector[0]->GetInformationObject(0);
+    auto input = vtkDataSet::GetData(inInfo);
+    auto output = vtkDataSet::GetData(outputVector);
+
+    output->ShallowCopy(input);
+
+    vtkDataSetAttributes * attributes = nullptr;
+    vtkSmartPointer<SlopeAspectCache> cache;
+
+    if (auto image = vtkImageData::SafeDownCast(input))
+    {
+        auto elevations = image->GetPointData()->GetScalars();
+        int dimensions[3];
+        image->GetDimensions(dimensions);
+        if (!elevations || elevations->GetNumberOfComponents() != 1 || dimensions[2] != 1)
+        {
+            vtkWarningMacro(<< "Expected a 2D image with elevations as point scalars");
+            return 1;
+        }
+
+        // Elevations are assumed to be in meters, so that the horizontal spacing has to be
+        // converted to meters as well.
+        auto coordsSpec = CoordinateSystemSpecification::fromInformation(*inInfo);
+        if (!coordsSpec.isValid())
+        {
+            coordsSpec = CoordinateSystemSpecification::fromFieldData(*input->GetFieldData());
+        }
+
+        double geometry[4] = { image->GetSpacing()[0], image->GetSpacing()[1], 0.0, 0.0 };
+        switch (coordsSpec.type.value)
+        {
+        case CoordinateSystemType::geographic:
+        {
+            // x: longitude, y: latitude
+            int extent[6];
+            image->GetExtent(extent);
+            geometry[2] = image->GetOrigin()[1] + extent[2] * geometry[1];
+            geometry[3] = geometry[1];
+            geometry[0] *= l_metersPerDegree;
+            geometry[1] *= l_metersPerDegree;
+            break;
+        }
+        case CoordinateSystemType::metricGlobal:
+        case CoordinateSystemType::metricLocal:
+        {
+            if (!mathhelper::isValidMetricUnit(coordsSpec.unitOfMeasurement))
+            {
+                vtkWarningMacro(<< "Invalid metric unit: " << coordsSpec.unitOfMeasurement.toStdString());
+                return 1;
+            }
+            const auto toMeters = mathhelper::scaleFactorForMetricUnits(coordsSpec.unitOfMeasurement, "m");
+            geometry[0] *= toMeters;
+            geometry[1] *= toMeters;
+            break;
+        }
+        case CoordinateSystemType::other:
+            vtkWarningMacro(<< "Slopes are not supported for the coordinate system of the input image");
+            return 1;
+        case CoordinateSystemType::unspecified:
+            // Assume horizontal coordinates in the same unit as the elevations.
+            break;
+        }
+
+        bool isValid;
+        cache = cacheFor(*elevations, geometry, isValid);
+        if (!isValid)
+        {
+            ImageGradientWorker worker;
+            worker.dimensions[0] = dimensions[0];
+            worker.dimensions[1] = dimensions[1];
+            worker.spacing[0] = geometry[0];
+            worker.spacing[1] = geometry[1];
+            worker.isGeographic = coordsSpec.type == CoordinateSystemType::geographic;
+            worker.firstRowLatitude = geometry[2];
+            worker.latitudeStep = geometry[3];
+            execute(*elevations, worker);
+            cache->slopes = worker.slopes;
+            cache->aspects = worker.aspects;
+        }
+
+        attributes = output->GetPointData();
+    }
+    else if (vtkPolyData::SafeDownCast(input))
+    {
+        auto normals = input->GetCellData()->GetArray("Normals");
+        if (!normals || normals->GetNumberOfComponents() != 3
+            || normals->GetNumberOfTuples() != input->GetNumberOfCells())
+        {
+            vtkWarningMacro(<< "Missing cell normals");
+            return 1;
+        }
+
+        const double noGeometry[4] = { 0.0, 0.0, 0.0, 0.0 };
+        bool isValid;
+        cache = cacheFor(*normals, noGeometry, isValid);
+        if (!isValid)
+        {
+            CellNormalsWorker worker;
+            execute(*normals, worker);
+            cache->slopes = worker.slopes;
+            cache->aspects = worker.aspects;
+        }
+
+        attributes = output->GetCellData();
+    }
+    else
+    {
+        vtkWarningMacro(<< "Unsupported input data type: " << input->GetClassName());
+        return 1;
+    }
+
+    // Don't replace current scalars: image elevations are still required, e.g., for shading.
+    attributes->AddArray(cache->slopes);
+    attributes->AddArray(cache->aspects);
+    attributes->SetActiveScalars(SlopeArrayName());
+
+    return 1;
+}
@@ -0,0 +1,73 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkDataSetAlgorithm.h>
+
+#include <core/core_api.h>
+
+
+class vtkInformationObjectBaseKey;
+
+
+/**
+ * Compute slope angles and aspects of a 2.5D surface, in degrees.
+ *
+ * For images (DEMs), slope and aspect are derived per point from the elevation gradients of the
+ * current point scalars. For poly data, they are derived per cell from the "Normals" cell array.
+ * The aspect is the azimuth of the downslope direction, clockwise from north (+y). It is NaN for
+ * flat surfaces.
+ *
+ * Elevations are assumed to be in meters. The horizontal image spacing is converted to meters
+ * according to the coordinate system of the input, read from the pipeline information or the
+ * field data: metric units are scaled, degrees of geographic images are converted depending on the
+ * latitude of each row. Without coordinate system, the spacing is assumed to be in the unit of the
+ * elevations. Images in other coordinate systems are passed without slopes.
+ *
+ * Both arrays are computed in a single parallel pass. They are cached with the elevation or
+ * normal array and reused as long as the source array (and the image geometry) is not modified,
+ * so that re-executing the filter is cheap and visualizations of the same data share the results.
+ * The value ranges are collected in the same pass and provided via DataArrayRanges.
+ * The result arrays are marked with DataObject::ARRAY_IS_AUXILIARY(). The slope angles are set as
+ * current scalars, the input scalars are still passed to the output.
+ */
+class CORE_API SlopeAspectFilter : public vtkDataSetAlgorithm
+{
+public:
+    vtkTypeMacro(SlopeAspectFilter, vtkDataSetAlgorithm);
+    static SlopeAspectFilter * New();
+
+    static const char * SlopeArrayName();
+    static const char * AspectArrayName();
+
+    /** Cached slope and aspect arrays, stored with the source array */
+    static vtkInformationObjectBaseKey * SLOPE_ASPECT_CACHE();
+
+protected:
+    SlopeAspectFilter();
+    ~SlopeAspectFilter() override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    SlopeAspectFilter(const SlopeAspectFilter &) = delete;
+    void operator=(const SlopeAspectFilter &) = delete;
+};
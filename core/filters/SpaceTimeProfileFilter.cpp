@@ -0,0 +1,277 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpaceTimeProfileFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPointSet.h>
+#include <vtkSelection.h>
+#include <vtkSelectionNode.h>
+#include <vtkSMPTools.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+#include <core/filters/TemporalDataSource.h>
+#include <core/utility/vtkvectorhelper.h>
+
+
+vtkStandardNewMacro(SpaceTimeProfileFilter);
+
+
+SpaceTimeProfileFilter::SpaceTimeProfileFilter()
+    : Superclass()
+    , AttributeName{ nullptr }
+    , Component{ 0 }
+    , StartPoint{ 0.0, 0.0 }
+    , EndPoint{ 1.0, 0.0 }
+    , NumberOfBins{ 100 }
+{
+    this->SetNumberOfInputPorts(2);
+}
+
+SpaceTimeProfileFilter::~SpaceTimeProfileFilter()
+{
+    this->SetAttributeName(nullptr);
+}
+
+vtkMTimeType SpaceTimeProfileFilter::GetMTime()
+{
+    auto mTime = this->Superclass::GetMTime();
+    if (this->TemporalSource)
+    {
+        mTime = std::max(mTime, this->TemporalSource->GetMTime());
+    }
+    return mTime;
+}
+
+void SpaceTimeProfileFilter::SetTemporalDataSource(TemporalDataSource * temporalDataSource)
+{
+    if (this->TemporalSource == temporalDataSource)
+    {
+        return;
+    }
+
+    this->TemporalSource = temporalDataSource;
+    this->Modified();
+}
+
+TemporalDataSource * SpaceTimeProfileFilter::GetTemporalDataSource()
+{
+    return this->TemporalSource;
+}
+
+int SpaceTimeProfileFilter::FillInputPortInformation(int port, vtkInformation * info)
+{
+    if (port == 0)
+    {
+        info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkPointSet");
+    }
+    else
+    {
+        info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkSelection");
+    }
+
+    return 1;
+}
+
+int SpaceTimeProfileFilter::AttributeIndex()
+{
+    if (!this->TemporalSource || !this->AttributeName)
+    {
+        return -1;
+    }
+
+    return this->TemporalSource->TemporalAttributeIndex(TemporalDataSource::POINT_DATA,
+        this->AttributeName);
+}
+
+int SpaceTimeProfileFilter::RequestInformation(vtkInformation * /*request*/,
+    vtkInformationVector ** /*inputVector*/,
+    vtkInformationVector * outputVector)
+{
+    auto outInfo = outputVector->GetInformationObject(0);
+
+    const int attributeIndex = this->AttributeIndex();
+    const int numTimeSteps = attributeIndex < 0 ? 0
+        : this->TemporalSource->GetNumberOfTemporalAttributeTimeSteps(
+            TemporalDataSource::POINT_DATA, attributeIndex);
+
+    const int extent[6] = { 0, this->NumberOfBins - 1, 0, std::max(1, numTimeSteps) - 1, 0, 0 };
+    const double length = (this->EndPoint - this->StartPoint).Norm();
+    const double spacing[3] = { length > 0.0 ? length / this->NumberOfBins : 1.0, 1.0, 1.0 };
+    const double origin[3] = { 0.5 * spacing[0], 0.0, 0.0 };
+
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent, 6);
+    outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+    outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_DOUBLE, 1);
+
+    // The time steps are contained in the output image, it does not depend on the pipeline time.
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+
+    return 1;
+}
+
+int SpaceTimeProfileFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto points = vtkPointSet::GetData(inputVector[0]);
+    auto selection = vtkSelection::GetData(inputVector[1]);
+    auto outInfo = outputVector->GetInformationObject(0);
+    auto output = vtkImageData::GetData(outputVector);
+
+    const int attributeIndex = this->AttributeIndex();
+    if (attributeIndex < 0)
+    {
+        vtkErrorMacro(<< "Temporal point attribute not found: "
+            << (this->AttributeName ? this->AttributeName : "(none)"));
+        return 0;
+    }
+
+    auto & source = *this->TemporalSource;
+    const int numTimeSteps = source.GetNumberOfTemporalAttributeTimeSteps(
+        TemporalDataSource::POINT_DATA, attributeIndex);
+    if (numTimeSteps == 0)
+    {
+        vtkErrorMacro(<< "No time steps defined for attribute " << this->AttributeName);
+        return 0;
+    }
+
+    // Time step values and arrays, in the order of the image rows
+
+    auto timeSteps = vtkSmartPointer<vtkDoubleArray>::New();
+    timeSteps->SetName("TimeSteps");
+    timeSteps->SetNumberOfValues(numTimeSteps);
+    std::vector<vtkDataArray *> timeStepValues(static_cast<size_t>(numTimeSteps));
+    for (int i = 0; i < numTimeSteps; ++i)
+    {
+        timeSteps->SetValue(i, source.GetTemporalAttributeTimeStep(
+            TemporalDataSource::POINT_DATA, attributeIndex, i));
+        auto values = vtkDataArray::SafeDownCast(source.GetTemporalAttributeArray(
+            TemporalDataSource::POINT_DATA, attributeIndex, i));
+        timeStepValues[static_cast<size_t>(i)] =
+            values && values->GetNumberOfComponents() > this->Component ? values : nullptr;
+    }
+
+    // Bins of the selected points along the line
+
+    const int numBins = this->NumberOfBins;
+    const auto & A = this->StartPoint;
+    const auto AB = this->EndPoint - A;
+    const double ABnorm2 = AB.SquaredNorm();
+
+    std::vector<vtkIdType> pointIds;
+    std::vector<int> pointBins;
+    auto node = selection->GetNumberOfNodes() > 0 ? selection->GetNode(0) : nullptr;
+    auto selectedIds = node ? vtkIdTypeArray::SafeDownCast(node->GetSelectionList()) : nullptr;
+    if (selectedIds && ABnorm2 > 0.0)
+    {
+        const vtkIdType numSelected = selectedIds->GetNumberOfValues();
+        pointIds.reserve(static_cast<size_t>(numSelected));
+        pointBins.reserve(static_cast<size_t>(numSelected));
+        for (vtkIdType i = 0; i < numSelected; ++i)
+        {
+            const vtkIdType pointId = selectedIds->GetValue(i);
+            if (pointId < 0 || pointId >= points->GetNumberOfPoints())
+            {
+                continue;
+            }
+            double point[3];
+            points->GetPoint(pointId, point);
+            const double t = (vtkVector2d(point[0], point[1]) - A).Dot(AB) / ABnorm2;
+            if (!(t >= 0.0 && t <= 1.0))
+            {
+                continue;
+            }
+            pointIds.push_back(pointId);
+            pointBins.push_back(std::min(numBins - 1, static_cast<int>(t * numBins)));
+        }
+    }
+
+    // Gather the values of all time steps, rows are processed in parallel.
+
+    int extent[6];
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), extent);
+    output->SetExtent(extent);
+    output->SetSpacing(outInfo->Get(vtkDataObject::SPACING()));
+    output->SetOrigin(outInfo->Get(vtkDataObject::ORIGIN()));
+
+    auto matrix = vtkSmartPointer<vtkDoubleArray>::New();
+    matrix->SetName(this->AttributeName);
+    matrix->SetNumberOfValues(static_cast<vtkIdType>(numBins) * numTimeSteps);
+
+    const int component = this->Component;
+    vtkSMPTools::For(0, numTimeSteps,
+        [&timeStepValues, &pointIds, &pointBins, &matrix, numBins, component] (vtkIdType begin, vtkIdType end)
+    {
+        std::vector<double> sums(static_cast<size_t>(numBins));
+        std::vector<vtkIdType> counts(static_cast<size_t>(numBins));
+        for (vtkIdType row = begin; row < end; ++row)
+        {
+            std::fill(sums.begin(), sums.end(), 0.0);
+            std::fill(counts.begin(), counts.end(), 0);
+
+            if (auto values = timeStepValues[static_cast<size_t>(row)])
+            {
+                const vtkIdType numTuples = values->GetNumberOfTuples();
+                for (size_t i = 0; i < pointIds.size(); ++i)
+                {
+                    if (pointIds[i] >= numTuples)
+                    {
+                        continue;
+                    }
+                    const double value = values->GetComponent(pointIds[i], component);
+                    if (std::isfinite(value))
+                    {
+                        const auto bin = static_cast<size_t>(pointBins[i]);
+                        sums[bin] += value;
+                        ++counts[bin];
+                    }
+                }
+            }
+
+            const vtkIdType rowOffset = row * numBins;
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                const auto b = static_cast<size_t>(bin);
+                matrix->SetValue(rowOffset + bin, counts[b] > 0
+                    ? sums[b] / static_cast<double>(counts[b])
+                    : std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+    });
+
+    output->GetPointData()->SetScalars(matrix);
+    output->GetFieldData()->AddArray(timeSteps);
+
+    return 1;
+}
@@ -0,0 +1,109 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkImageAlgorithm.h>
+#include <vtkSmartPointer.h>
+#include <vtkVector.h>
+
+#include <core/core_api.h>
+
+
+class TemporalDataSource;
+
+
+/**
+ * Distance × time matrix of a temporal point attribute along a profile line.
+ *
+ * Inputs:
+ *     Port 0: vtkPointSet with the points that carry the temporal attribute
+ *     Port 1: vtkSelection with the selected point ids, e.g., from LineOnPointsSelector2D
+ *
+ * The values of all time steps are read directly from the attribute storage of TemporalDataSource
+ * in a single pass, so that the pipeline does not execute once per time step. Selected points are
+ * assigned to NumberOfBins bins along the line between StartPoint and EndPoint, and the mean of
+ * the finite values per bin and time step is stored in the output image. Empty bins are NaN.
+ *
+ * The output image contains the distance along the line on its x-axis (bin centers, in units of
+ * the input coordinates) and the time step index on its y-axis. The time steps are stored in the
+ * field data array "TimeSteps".
+ */
+class CORE_API SpaceTimeProfileFilter : public vtkImageAlgorithm
+{
+public:
+    vtkTypeMacro(SpaceTimeProfileFilter, vtkImageAlgorithm);
+    static SpaceTimeProfileFilter * New();
+
+    vtkMTimeType GetMTime() override;
+
+    void SetSelectionConnection(vtkAlgorithmOutput * algOutput)
+    {
+        this->SetInputConnection(1, algOutput);
+    }
+
+    void SetTemporalDataSource(TemporalDataSource * temporalDataSource);
+    TemporalDataSource * GetTemporalDataSource();
+
+    /** Name of the temporal point attribute in the TemporalDataSource */
+    vtkGetStringMacro(AttributeName);
+    vtkSetStringMacro(AttributeName);
+
+    /** Component of multi-component attributes. Default: 0 */
+    vtkGetMacro(Component, int);
+    vtkSetClampMacro(Component, int, 0, VTK_INT_MAX);
+
+    vtkGetMacro(StartPoint, vtkVector2d);
+    vtkSetMacro(StartPoint, vtkVector2d);
+
+    vtkGetMacro(EndPoint, vtkVector2d);
+    vtkSetMacro(EndPoint, vtkVector2d);
+
+    /** Number of bins along the line, i.e., the image width. Default: 100 */
+    vtkGetMacro(NumberOfBins, int);
+    vtkSetClampMacro(NumberOfBins, int, 1, VTK_INT_MAX);
+
+protected:
+    SpaceTimeProfileFilter();
+    ~SpaceTimeProfileFilter() override;
+
+    int FillInputPortInformation(int port, vtkInformation * info) override;
+
+    int RequestInformation(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    int AttributeIndex();
+
+private:
+    vtkSmartPointer<TemporalDataSource> TemporalSource;
+    char * AttributeName;
+    int Component;
+    vtkVector2d StartPoint;
+    vtkVector2d EndPoint;
+    int NumberOfBins;
+
+public:
+    SpaceTimeProfileFilter(const SpaceTimeProfileFilter &) = delete;
+    void operator=(const SpaceTimeProfileFilter &) = delete;
+};
@@ -0,0 +1,424 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SwathProfileFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+#include <core/utility/UniformGridIndex2D.h>
+#include <core/utility/vtkvectorhelper.h>
+
+
+vtkStandardNewMacro(SwathProfileFilter);
+
+
+namespace
+{
+
+/**
+ * Range of structured indices along dimension d whose coordinates are within [c0, c1].
+ * @return false if the range is empty or outside of the extent
+ */
+bool indexRange(const int extent[6], const double origin[3], const double spacing[3], int d,
+    double c0, double c1, int & first, int & last)
+{
+    const double extentMin = static_cast<double>(extent[2 * d]);
+    const double extentMax = static_cast<double>(extent[2 * d + 1]);
+    if (spacing[d] == 0.0)
+    {
+        first = extent[2 * d];
+        last = extent[2 * d + 1];
+        return first <= last;
+    }
+
+    const double s0 = (c0 - origin[d]) / spacing[d];
+    const double s1 = (c1 - origin[d]) / spacing[d];
+    // Clamp before converting: the swath may be far outside of the image.
+    const double lower = std::max(std::floor(std::min(s0, s1)), extentMin);
+    const double upper = std::min(std::ceil(std::max(s0, s1)), extentMax);
+    if (!(lower <= upper))
+    {
+        return false;
+    }
+
+    first = static_cast<int>(lower);
+    last = static_cast<int>(upper);
+    return true;
+}
+
+/**
+ * Ids of image points within the swath corridor, including points of neighboring columns.
+ * Each row is clipped to the corridor, so that the number of candidates scales with the swath
+ * area rather than with its bounding box.
+ */
+void imageCandidates(vtkImageData & image, const vtkVector2d & A, const vtkVector2d & B,
+    double halfWidth, std::vector<vtkIdType> & ids)
+{
+    int extent[6];
+    double origin[3], spacing[3];
+    image.GetExtent(extent);
+    image.GetOrigin(origin);
+    image.GetSpacing(spacing);
+
+    // Corners of the corridor rectangle, slightly enlarged to be robust against round-off.
+    const auto AB = B - A;
+    const auto length = AB.Norm();
+    const auto margin = 1.e-6 * std::max(length, halfWidth);
+    const auto direction = length > 0.0 ? vtkVector2d(AB[0] / length, AB[1] / length) : vtkVector2d(1.0, 0.0);
+    const auto along = vtkVector2d(direction[0] * margin, direction[1] * margin);
+    const auto w = halfWidth + margin;
+    const auto normal = vtkVector2d(-direction[1] * w, direction[0] * w);
+
+    const vtkVector<double, 2> corners[4] = {
+        A - along + normal,
+        B + along + normal,
+        B + along - normal,
+        A - along - normal
+    };
+
+    double yMin = corners[0][1], yMax = corners[0][1];
+    for (const auto & c : corners)
+    {
+        yMin = std::min(yMin, c[1]);
+        yMax = std::max(yMax, c[1]);
+    }
+
+    int firstRow, lastRow;
+    if (!indexRange(extent, origin, spacing, 1, yMin, yMax, firstRow, lastRow))
+    {
+        return;
+    }
+
+    for (int j = firstRow; j <= lastRow; ++j)
+    {
+        // Horizontal extent of the corridor within the row, extended to the rows next to it:
+        // rows are sampled lines, but neighboring columns are required for round-off.
+        const double y0 = origin[1] + (j - 1) * spacing[1];
+        const double y1 = origin[1] + (j + 1) * spacing[1];
+        const double rowMin = spacing[1] == 0.0 ? yMin : std::min(y0, y1);
+        const double rowMax = spacing[1] == 0.0 ? yMax : std::max(y0, y1);
+
+        double xMin = std::numeric_limits<double>::infinity();
+        double xMax = -std::numeric_limits<double>::infinity();
+        for (int c = 0; c < 4; ++c)
+        {
+            const auto & p = corners[c];
+            const auto & q = corners[(c + 1) % 4];
+            if (p[1] >= rowMin && p[1] <= rowMax)
+            {
+                xMin = std::min(xMin, p[0]);
+                xMax = std::max(xMax, p[0]);
+            }
+            for (const double y : { rowMin, rowMax })
+            {
+                if ((p[1] - y) * (q[1] - y) < 0.0)
+                {
+                    const auto x = p[0] + (y - p[1]) * (q[0] - p[0]) / (q[1] - p[1]);
+                    xMin = std::min(xMin, x);
+                    xMax = std::max(xMax, x);
+                }
+            }
+        }
+
+        int firstColumn, lastColumn;
+        if (xMin > xMax || !indexRange(extent, origin, spacing, 0, xMin, xMax, firstColumn, lastColumn))
+        {
+            continue;
+        }
+
+        for (int k = extent[4]; k <= extent[5]; ++k)
+        {
+            for (int i = firstColumn; i <= lastColumn; ++i)
+            {
+                int ijk[3] = { i, j, k };
+                ids.push_back(image.ComputePointId(ijk));
+            }
+        }
+    }
+}
+
+}
+
+
+SwathProfileFilter::SwathProfileFilter()
+    : Superclass()
+    , StartPoint{ 0.0, 0.0 }
+    , EndPoint{ 1.0, 0.0 }
+    , Width{ 1.0 }
+    , NumberOfBins{ 100 }
+    , Component{ 0 }
+    , InputPointsMTime{}
+    , PointIndex{ std::make_unique<UniformGridIndex2D>() }
+{
+    this->SetInputArrayToProcess(0, 0, 0,
+        vtkDataObject::FIELD_ASSOCIATION_POINTS, vtkDataSetAttributes::SCALARS);
+}
+
+SwathProfileFilter::~SwathProfileFilter() = default;
+
+std::string SwathProfileFilter::StatisticArrayName(const std::string & scalarsName, Statistic statistic)
+{
+    switch (statistic)
+    {
+    case Mean: return scalarsName;
+    case Median: return scalarsName + " (Median)";
+    case Minimum: return scalarsName + " (Minimum)";
+    case Maximum: return scalarsName + " (Maximum)";
+    case StandardDeviation: return scalarsName + " (Standard Deviation)";
+    case Count: return scalarsName + " (Count)";
+    default: return {};
+    }
+}
+
+int SwathProfileFilter::FillInputPortInformation(int port, vtkInformation * info)
+{
+    if (port == 0)
+    {
+        info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+    }
+
+    return 1;
+}
+
+int SwathProfileFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto input = vtkDataSet::GetData(inputVector[0]);
+    auto output = vtkPolyData::GetData(outputVector);
+
+    auto scalars = this->GetInputArrayToProcess(0, inputVector);
+    if (!scalars)
+    {
+        vtkErrorMacro(<< "Missing input scalars.");
+        return 0;
+    }
+    if (this->Component >= scalars->GetNumberOfComponents())
+    {
+        vtkErrorMacro(<< "Invalid component " << this->Component << " requested for scalars with "
+            << scalars->GetNumberOfComponents() << " components.");
+        return 0;
+    }
+
+    const auto & A = this->StartPoint;
+    const auto & B = this->EndPoint;
+    const auto AB = B - A;
+    const double ABnorm2 = AB.SquaredNorm();
+    const double halfWidth = 0.5 * this->Width;
+    const int numBins = this->NumberOfBins;
+    const int component = this->Component;
+
+    // Output geometry: bin centers along the line
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numBins);
+    std::vector<vtkIdType> pointIds(static_cast<size_t>(numBins));
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const double t = (bin + 0.5) / numBins;
+        points->SetPoint(bin, A[0] + t * AB[0], A[1] + t * AB[1], 0.0);
+        pointIds[static_cast<size_t>(bin)] = bin;
+    }
+    auto verts = vtkSmartPointer<vtkCellArray>::New();
+    verts->InsertNextCell(numBins, pointIds.data());
+
+    output->SetPoints(points);
+    output->SetVerts(verts);
+
+
+    // Candidate points: only points near the line need to be classified.
+
+    std::vector<vtkIdType> candidates;
+    const vtkIdType numInputPoints = input->GetNumberOfPoints();
+    if (ABnorm2 > 0.0 && numInputPoints > 0)
+    {
+        if (auto image = vtkImageData::SafeDownCast(input))
+        {
+            imageCandidates(*image, A, B, halfWidth, candidates);
+        }
+        else if (auto pointSet = vtkPointSet::SafeDownCast(input))
+        {
+            const auto pointsMTime = std::max(pointSet->GetMTime(), pointSet->GetPoints()->GetMTime());
+            if (this->InputPointsMTime < pointsMTime)
+            {
+                this->InputPointsMTime = pointsMTime;
+                this->PointIndex->buildForPoints(*pointSet->GetPoints()->GetData());
+            }
+            this->PointIndex->queryCorridor(A, B, halfWidth, candidates);
+        }
+        else
+        {
+            candidates.resize(static_cast<size_t>(numInputPoints));
+            std::iota(candidates.begin(), candidates.end(), vtkIdType(0));
+        }
+    }
+
+
+    // Classify candidates into bins in parallel. Points outside of the band, and non-finite
+    // values are assigned to no bin (-1).
+
+    const auto numCandidates = static_cast<vtkIdType>(candidates.size());
+    std::vector<int> candidateBins(candidates.size());
+    std::vector<double> candidateValues(candidates.size());
+
+    if (numCandidates > 0)
+    {
+        // GetPoint is thread safe after a first call from a single thread.
+        double point[3];
+        input->GetPoint(candidates.front(), point);
+    }
+
+    const auto ABnormal = vtkVector2d(AB[1], -AB[0]).Normalized();
+    vtkSMPTools::For(0, numCandidates,
+        [input, scalars, component, numBins, halfWidth, ABnorm2, A, AB, ABnormal,
+        &candidates, &candidateBins, &candidateValues] (vtkIdType begin, vtkIdType end)
+    {
+        double point[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            const vtkIdType pointId = candidates[static_cast<size_t>(i)];
+            input->GetPoint(pointId, point);
+            const auto AP = vtkVector2d(point[0], point[1]) - A;
+            const double t = AP.Dot(AB) / ABnorm2;
+            const double distance = std::abs(AP.Dot(ABnormal));
+            const double value = scalars->GetComponent(pointId, component);
+
+            int bin = -1;
+            if (t >= 0.0 && t <= 1.0 && distance <= halfWidth && std::isfinite(value))
+            {
+                bin = std::min(numBins - 1, static_cast<int>(t * numBins));
+            }
+            candidateBins[static_cast<size_t>(i)] = bin;
+            candidateValues[static_cast<size_t>(i)] = value;
+        }
+    });
+
+
+    // Group values by bin (counting sort)
+
+    std::vector<vtkIdType> binOffsets(static_cast<size_t>(numBins) + 1u, 0);
+    for (const int bin : candidateBins)
+    {
+        if (bin >= 0)
+        {
+            ++binOffsets[static_cast<size_t>(bin) + 1u];
+        }
+    }
+    for (size_t i = 1; i < binOffsets.size(); ++i)
+    {
+        binOffsets[i] += binOffsets[i - 1];
+    }
+
+    std::vector<double> binnedValues(static_cast<size_t>(binOffsets.back()));
+    {
+        std::vector<vtkIdType> insertPositions(binOffsets.begin(), binOffsets.end() - 1);
+        for (size_t i = 0; i < candidateBins.size(); ++i)
+        {
+            const int bin = candidateBins[i];
+            if (bin >= 0)
+            {
+                binnedValues[static_cast<size_t>(insertPositions[static_cast<size_t>(bin)]++)] = candidateValues[i];
+            }
+        }
+    }
+
+
+    // Statistics per bin
+
+    const std::string scalarsName = scalars->GetName() ? scalars->GetName() : "Scalars";
+    vtkSmartPointer<vtkDoubleArray> statistics[Count];
+    for (int s = 0; s < Count; ++s)
+    {
+        statistics[s] = vtkSmartPointer<vtkDoubleArray>::New();
+        statistics[s]->SetName(StatisticArrayName(scalarsName, static_cast<Statistic>(s)).c_str());
+        statistics[s]->SetNumberOfValues(numBins);
+    }
+    auto counts = vtkSmartPointer<vtkIdTypeArray>::New();
+    counts->SetName(StatisticArrayName(scalarsName, Count).c_str());
+    counts->SetNumberOfValues(numBins);
+
+    vtkSMPTools::For(0, numBins, [&binOffsets, &binnedValues, &statistics, &counts] (vtkIdType begin, vtkIdType end)
+    {
+        for (vtkIdType bin = begin; bin < end; ++bin)
+        {
+            const auto first = binnedValues.begin() + binOffsets[static_cast<size_t>(bin)];
+            const auto last = binnedValues.begin() + binOffsets[static_cast<size_t>(bin) + 1u];
+            const auto count = static_cast<vtkIdType>(last - first);
+            counts->SetValue(bin, count);
+
+            if (count == 0)
+            {
+                for (auto & array : statistics)
+                {
+                    array->SetValue(bin, std::numeric_limits<double>::quiet_NaN());
+                }
+                continue;
+            }
+
+            const auto minMax = std::minmax_element(first, last);
+            const double mean = std::accumulate(first, last, 0.0) / static_cast<double>(count);
+            const double variance = std::accumulate(first, last, 0.0,
+                [mean] (double sum, double value) { return sum + (value - mean) * (value - mean); })
+                / static_cast<double>(count);
+
+            // Median: average of the two center values for even counts
+            const auto center = first + count / 2;
+            std::nth_element(first, center, last);
+            double median = *center;
+            if (count % 2 == 0)
+            {
+                median = 0.5 * (median + *std::max_element(first, center));
+            }
+
+            statistics[Mean]->SetValue(bin, mean);
+            statistics[Median]->SetValue(bin, median);
+            statistics[Minimum]->SetValue(bin, *minMax.first);
+            statistics[Maximum]->SetValue(bin, *minMax.second);
+            statistics[StandardDeviation]->SetValue(bin, std::sqrt(variance));
+        }
+    });
+
+    auto pointData = output->GetPointData();
+    for (int s = 0; s < Count; ++s)
+    {
+        pointData->AddArray(statistics[s]);
+    }
+    pointData->AddArray(counts);
+    pointData->SetActiveScalars(statistics[Mean]->GetName());
+
+    return 1;
+}
@@ -0,0 +1,110 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkVector.h>
+
+#include <core/core_api.h>
+
+
+class UniformGridIndex2D;
+
+
+/**
+ * Swath profile: statistics of the input scalars in a band along a line segment on the XY-plane.
+ *
+ * The band is centered on the line between StartPoint and EndPoint and has the total width Width.
+ * It is split into NumberOfBins bins along the line. Each input point within the band is assigned
+ * to a bin in a single parallel pass, then mean, median, minimum, maximum, standard deviation and
+ * count of the finite values are computed per bin.
+ * Cell attributes can be processed by passing cell centers as input points.
+ *
+ * The scalars are selected with SetInputArrayToProcess(0, 0, 0, FIELD_ASSOCIATION_POINTS, name).
+ * Candidate points of point sets are looked up in a uniform grid index that is rebuilt when the
+ * input points are modified, images are accessed via their structured extent.
+ *
+ * The output contains a point at each bin center on the line, with one point data array per
+ * statistic. The mean is stored as active scalars with the name of the input scalars, see
+ * StatisticArrayName() for the other arrays. Statistics of empty bins are NaN.
+ */
+class CORE_API SwathProfileFilter : public vtkPolyDataAlgorithm
+{
+public:
+    vtkTypeMacro(SwathProfileFilter, vtkPolyDataAlgorithm);
+    static SwathProfileFilter * New();
+
+    vtkGetMacro(StartPoint, vtkVector2d);
+    vtkSetMacro(StartPoint, vtkVector2d);
+
+    vtkGetMacro(EndPoint, vtkVector2d);
+    vtkSetMacro(EndPoint, vtkVector2d);
+
+    /** Total width of the band across the line. Default: 1 */
+    vtkGetMacro(Width, double);
+    vtkSetClampMacro(Width, double, 0.0, VTK_DOUBLE_MAX);
+
+    /** Number of bins along the line. Default: 100 */
+    vtkGetMacro(NumberOfBins, int);
+    vtkSetClampMacro(NumberOfBins, int, 1, VTK_INT_MAX);
+
+    /** Component of multi-component scalars to compute statistics for. Default: 0 */
+    vtkGetMacro(Component, int);
+    vtkSetClampMacro(Component, int, 0, VTK_INT_MAX);
+
+    enum Statistic
+    {
+        Mean,
+        Median,
+        Minimum,
+        Maximum,
+        StandardDeviation,
+        Count,
+        NumberOfStatistics
+    };
+
+    /** Name of the output array of a statistic, for the given input scalars name. */
+    static std::string StatisticArrayName(const std::string & scalarsName, Statistic statistic);
+
+protected:
+    SwathProfileFilter();
+    ~SwathProfileFilter() override;
+
+    int FillInputPortInformation(int port, vtkInformation * info) override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    vtkVector2d StartPoint;
+    vtkVector2d EndPoint;
+    double Width;
+    int NumberOfBins;
+    int Component;
+    vtkMTimeType InputPointsMTime;
+    std::unique_ptr<UniformGridIndex2D> PointIndex;
+
+public:
+    SwathProfileFilter(const SwathProfileFilter &) = delete;
+    void operator=(const SwathProfileFilter &) = delete;
+};
@@ -179,6 +179,40 @@ bool TemporalDataSource::SetTemporalAttributeTimeStep(
     return true;
 }
 
+int TemporalDataSource::GetNumberOfTemporalAttributeTimeSteps(
+    const AttributeLocation attributeLoc,
+    const int temporalAttributeIndex)
+{
+    auto & vectorForAttributeType = temporalData(attributeLoc);
+
+    const auto idx = static_cast<size_t>(temporalAttributeIndex);
+
+    if (temporalAttributeIndex < 0 || idx >= vectorForAttributeType.size())
+    {
+        return 0;
+    }
+
+    return static_cast<int>(vectorForAttributeType[idx].Data.size());
+}
+
+double TemporalDataSource::GetTemporalAttributeTimeStep(
+    const AttributeLocation attributeLoc,
+    const int temporalAttributeIndex,
+    const int timeStepIndex)
+{
+    const auto data = attributeAtTimeStep(attributeLoc, temporalAttributeIndex, timeStepIndex);
+    return data ? data->TimeStep : std::numeric_limits<double>::quiet_NaN();
+}
+
+vtkAbstractArray * TemporalDataSource::GetTemporalAttributeArray(
+    const AttributeLocation attributeLoc,
+    const int temporalAttributeIndex,
+    const int timeStepIndex)
+{
+    const auto data = attributeAtTimeStep(attributeLoc, temporalAttributeIndex, timeStepIndex);
+    return data ? data->Attribute.Get() : nullptr;
+}
+
 int TemporalDataSource::ProcessRequest(
     vtkInformation * request,
     vtkInformationVector ** inputVector,
@@ -356,6 +390,22 @@ auto TemporalDataSource::temporalData(AttributeLocation attributeLoc) -> decltyp
     return this->TemporalData[static_cast<size_t>(attributeLoc)];
 }
 
+auto TemporalDataSource::attributeAtTimeStep(
+    const AttributeLocation attributeLoc,
+    const int temporalAttributeIndex,
+    const int timeStepIndex)
+    -> const AttributeAtTimeStep *
+{
+    const int numTimeSteps = GetNumberOfTemporalAttributeTimeSteps(attributeLoc, temporalAttributeIndex);
+    if (timeStepIndex < 0 || timeStepIndex >= numTimeSteps)
+    {
+        return nullptr;
+    }
+
+    return &temporalData(attributeLoc)[static_cast<size_t>(temporalAttributeIndex)]
+        .Data[static_cast<size_t>(timeStepIndex)];
+}
+
 bool TemporalDataSource::AttributeAtTimeStep::operator<(const AttributeAtTimeStep & other) const
 {
     return this->TimeStep < other.TimeStep;
@@ -81,6 +81,20 @@ public:
         int temporalAttributeIndex,
         vtkAbstractArray * array);
 
+    /** Direct access to the stored time steps of an attribute, e.g., to process all time steps at
+      * once instead of executing the pipeline for each time step. Time steps are sorted.
+      * @return number of time steps, or 0 if the temporalAttributeIndex is out of range. */
+    int GetNumberOfTemporalAttributeTimeSteps(AttributeLocation attributeLoc,
+        int temporalAttributeIndex);
+    /** @return the time step at timeStepIndex, or NaN if an index is out of range. */
+    double GetTemporalAttributeTimeStep(AttributeLocation attributeLoc,
+        int temporalAttributeIndex,
+        int timeStepIndex);
+    /** @return the data at timeStepIndex, or nullptr if an index is out of range. */
+    vtkAbstractArray * GetTemporalAttributeArray(AttributeLocation attributeLoc,
+        int temporalAttributeIndex,
+        int timeStepIndex);
+
 protected:
     TemporalDataSource();
     ~TemporalDataSource() override;
@@ -118,6 +132,8 @@ private:
 
     std::array<std::vector<TemporalAttribute>, static_cast<size_t>(AttributeLocation::NUM_VALUES)> TemporalData;
     decltype(TemporalData)::value_type & temporalData(AttributeLocation attributeLoc);
+    const AttributeAtTimeStep * attributeAtTimeStep(AttributeLocation attributeLoc,
+        int temporalAttributeIndex, int timeStepIndex);
 
 private:
     TemporalDataSource(const TemporalDataSource &) = delete;
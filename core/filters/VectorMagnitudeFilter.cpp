@@ -0,0 +1,193 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VectorMagnitudeFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <vtkAOSDataArrayTemplate.h>
+#include <vtkArrayDispatch.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkDataSet.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkInformation.h>
+#include <vtkInformationIdTypeKey.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkObjectFactory.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+#include <core/utility/DataArrayRanges.h>
+#include <core/utility/DataExtent.h>
+#include <core/utility/types_utils.h>
+
+
+vtkStandardNewMacro(VectorMagnitudeFilter);
+
+vtkInformationKeyMacro(VectorMagnitudeFilter, MAGNITUDES, ObjectBase);
+vtkInformationKeyMacro(VectorMagnitudeFilter, MAGNITUDES_MTIME, IdType);
+
+
+namespace
+{
+
+struct MagnitudeWorker
+{
+    vtkSmartPointer<vtkDataArray> magnitudes;
+    ValueRange<> range;
+
+    struct ThreadData
+    {
+        ValueRange<> range;
+    };
+
+    template<typename VectorArray>
+    void operator()(VectorArray * vectors)
+    {
+        using InputValueType = typename vtkDataArrayAccessor<VectorArray>::APIType;
+        // Single precision magnitudes are sufficient for single precision vectors.
+        using ValueType = typename std::conditional<
+            std::is_same<InputValueType, float>::value, float, double>::type;
+
+        const vtkIdType numTuples = vectors->GetNumberOfTuples();
+        const int numComponents = vectors->GetNumberOfComponents();
+
+        auto magnitudeArray = vtkSmartPointer<vtkAOSDataArrayTemplate<ValueType>>::New();
+        magnitudeArray->SetNumberOfValues(numTuples);
+        ValueType * const m = magnitudeArray->GetPointer(0);
+
+        vtkDataArrayAccessor<VectorArray> v(vectors);
+        vtkSMPThreadLocal<ThreadData> threadData;
+
+        vtkSMPTools::For(0, numTuples,
+            [v, m, numComponents, &threadData] (vtkIdType begin, vtkIdType end)
+        {
+            // Branch-free loop over contiguous output values, to be vectorized by the compiler.
+            for (vtkIdType t = begin; t < end; ++t)
+            {
+                ValueType squaredNorm = 0;
+                for (int c = 0; c < numComponents; ++c)
+                {
+                    const auto value = static_cast<ValueType>(v.Get(t, c));
+                    squaredNorm += value * value;
+                }
+                m[t] = std::sqrt(squaredNorm);
+            }
+
+            // Collect the range while the values are still in the cache.
+            auto & local = threadData.Local();
+            ValueType minValue = std::numeric_limits<ValueType>::max();
+            ValueType maxValue = std::numeric_limits<ValueType>::lowest();
+            for (vtkIdType t = begin; t < end; ++t)
+            {
+                // Magnitudes of vectors with non-finite components are not finite.
+                if (!std::isfinite(m[t]))
+                {
+                    continue;
+                }
+                minValue = std::min(minValue, m[t]);
+                maxValue = std::max(maxValue, m[t]);
+            }
+            if (minValue <= maxValue)
+            {
+                local.range.add(ValueRange<>({
+                    static_cast<double>(minValue), static_cast<double>(maxValue) }));
+            }
+        });
+
+        for (auto it = threadData.begin(); it != threadData.end(); ++it)
+        {
+            range.add((*it).range);
+        }
+
+        magnitudes = magnitudeArray;
+    }
+};
+
+}
+
+
+VectorMagnitudeFilter::VectorMagnitudeFilter()
+    : Superclass()
+    , AttributeLocation{ IndexType::points }
+{
+}
+
+VectorMagnitudeFilter::~VectorMagnitudeFilter() = default;
+
+vtkSmartPointer<vtkDataArray> VectorMagnitudeFilter::Magnitudes(vtkDataArray & vectors)
+{
+    // Request the information first: creating it modifies the array.
+    auto & cache = *vectors.GetInformation();
+    const auto vectorsMTime = static_cast<vtkIdType>(vectors.GetMTime());
+
+    if (cache.Has(MAGNITUDES_MTIME()) && cache.Get(MAGNITUDES_MTIME()) == vectorsMTime)
+    {
+        if (auto cached = vtkDataArray::SafeDownCast(cache.Get(MAGNITUDES())))
+        {
+            return cached;
+        }
+    }
+
+    MagnitudeWorker worker;
+    if (!vtkArrayDispatch::Dispatch::Execute(&vectors, worker))
+    {
+        worker(&vectors);
+    }
+
+    auto & magnitudes = *worker.magnitudes;
+    const auto vectorsName = vectors.GetName();
+    magnitudes.SetName(((vectorsName ? std::string(vectorsName) + " " : std::string())
+        + "Magnitude").c_str());
+
+    // The magnitude of a scalar is the scalar itself. Histograms are computed on request only, by
+    // DataArrayRanges::of().
+    DataArrayRanges({ worker.range }, worker.range).cacheIn(magnitudes);
+
+    cache.Set(MAGNITUDES(), &magnitudes);
+    cache.Set(MAGNITUDES_MTIME(), vectorsMTime);
+
+    return worker.magnitudes;
+}
+
+int VectorMagnitudeFilter::RequestData(vtkInformation * /*request*/,
+    vtkInformationVector ** inputVector,
+    vtkInformationVector * outputVector)
+{
+    auto input = vtkDataSet::GetData(inputVector[0]);
+    auto output = vtkDataSet::GetData(outputVector);
+
+    output->ShallowCopy(input);
+
+    auto attributes = IndexType_util(this->AttributeLocation).extractAttributes(output);
+    auto vectors = attributes ? attributes->GetArray(this->ArrayName.c_str()) : nullptr;
+    if (!vectors)
+    {
+        vtkWarningMacro(<< "Missing vector array: " << this->ArrayName);
+        return 1;
+    }
+
+    attributes->SetScalars(Magnitudes(*vectors));
+
+    return 1;
+}
@@ -0,0 +1,79 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkDataSetAlgorithm.h>
+#include <vtkSmartPointer.h>
+#include <vtkStdString.h>
+
+#include <core/types.h>
+
+
+class vtkDataArray;
+class vtkInformationIdTypeKey;
+class vtkInformationObjectBaseKey;
+
+
+/**
+ * Set the tuple magnitudes of a vector array as current scalars.
+ *
+ * The magnitude array is named "<ArrayName> Magnitude". It is computed only once per vector array
+ * and modification time and cached with the vector array, so that all visualizations of the same
+ * data share the same magnitude array. The value ranges of the magnitudes are computed in the
+ * same pass and provided via DataArrayRanges. Histograms are computed by DataArrayRanges::of() on
+ * request only.
+ */
+class CORE_API VectorMagnitudeFilter : public vtkDataSetAlgorithm
+{
+public:
+    vtkTypeMacro(VectorMagnitudeFilter, vtkDataSetAlgorithm);
+    static VectorMagnitudeFilter * New();
+
+    vtkGetMacro(AttributeLocation, IndexType);
+    /** Set the location where to look for the vector array. This is IndexType::points by default. */
+    vtkSetMacro(AttributeLocation, IndexType);
+
+    vtkGetMacro(ArrayName, vtkStdString);
+    /** Name of the vector array */
+    vtkSetMacro(ArrayName, vtkStdString);
+
+    /** @return the cached magnitudes of vectors, or compute them if required. */
+    static vtkSmartPointer<vtkDataArray> Magnitudes(vtkDataArray & vectors);
+
+    /** Cached magnitude array */
+    static vtkInformationObjectBaseKey * MAGNITUDES();
+    /** Modification time of the vector array when the magnitudes were computed */
+    static vtkInformationIdTypeKey * MAGNITUDES_MTIME();
+
+protected:
+    VectorMagnitudeFilter();
+    ~VectorMagnitudeFilter() override;
+
+    int RequestData(vtkInformation * request,
+        vtkInformationVector ** inputVector,
+        vtkInformationVector * outputVector) override;
+
+private:
+    IndexType AttributeLocation;
+    vtkStdString ArrayName;
+
+private:
+    VectorMagnitudeFilter(const VectorMagnitudeFilter &) = delete;
+    void operator=(const VectorMagnitudeFilter &) = delete;
+};
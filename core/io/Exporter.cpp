@@ -40,6 +40,7 @@
 #include <core/data_objects/PolyDataObject.h>
 #include <core/data_objects/VectorGrid3DDataObject.h>
 #include <core/filters/ImageMapToColors.h>
+#include <core/utility/DataArrayRanges.h>
 #include <core/utility/DataExtent.h>
 
 
@@ -162,12 +163,10 @@ bool Exporter::exportImageFormat(ImageDataObject & image, const QString & fileNa
         lut->SetValueRange(0, 1);
 
         ValueRange<> totalRange;
-            
+        const auto componentRanges = DataArrayRanges::of(*scalars);
         for (int c = 0; c < components; ++c)
         {
-            ValueRange<> range;
-            scalars->GetRange(range.data(), c);
-            totalRange.add(range);
+            totalRange.add(componentRanges.componentRange(c));
         }
 
         toUChar->SetOutputFormat(
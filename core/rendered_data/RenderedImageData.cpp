@@ -23,7 +23,6 @@
 #include <vtkAssignAttribute.h>
 #include <vtkDataSet.h>
 #include <vtkImageSliceMapper.h>
-#include <vtkImageSlice.h>
 #include <vtkImageProperty.h>
 #include <vtkLookupTable.h>
 #include <vtkPointData.h>
@@ -36,11 +35,11 @@
 #include <core/color_mapping/ColorMappingData.h>
 #include <core/data_objects/ImageDataObject.h>
 #include <core/filters/ArrayChangeInformationFilter.h>
-#include <core/filters/DEMApplyShadingToColors.h>
-#include <core/filters/DEMImageNormals.h>
-#include <core/filters/DEMShadingFilter.h>
+#include <core/filters/DEMShadedColorsFilter.h>
 #include <core/filters/ImageMapToColors.h>
+#include <core/filters/ImagePyramidFilter.h>
 #include <core/utility/DataExtent.h>
+#include <core/utility/ImagePyramidSlice.h>
 
 
 using namespace reflectionzeug;
@@ -49,8 +48,9 @@ using namespace reflectionzeug;
 RenderedImageData::RenderedImageData(ImageDataObject & dataObject)
     : RenderedData(ContentType::Rendered2D, dataObject)
     , m_isShadingEnabled{ false }
-    , m_demShading{ vtkSmartPointer<DEMShadingFilter>::New() }
-    , m_mapper{ vtkSmartPointer<vtkImageSliceMapper>::New() } // replace with vtkImageResliceMapper?
+    , m_pyramid{ vtkSmartPointer<ImagePyramidFilter>::New() }
+    , m_demShading{ vtkSmartPointer<DEMShadedColorsFilter>::New() }
+    , m_mapper{ vtkSmartPointer<vtkImageSliceMapper>::New() }
     , m_property{ vtkSmartPointer<vtkImageProperty>::New() }
 {
     m_property->UseLookupTableScalarRangeOn();
@@ -227,7 +227,8 @@ vtkImageSlice * RenderedImageData::slice()
     if (!m_slice)
     {
         configureVisPipeline();
-        m_slice = vtkSmartPointer<vtkImageSlice>::New();
+        m_slice = vtkSmartPointer<ImagePyramidSlice>::New();
+        m_slice->SetPyramid(m_pyramid);
         m_slice->SetMapper(m_mapper);
         m_slice->SetProperty(property());
     }
@@ -321,13 +322,13 @@ void RenderedImageData::initializePipeline()
 
     // Assume immutable scalars name
     const auto scalarsName = imageDataObject().scalars().GetName();
-    const auto mappedColorsName = (QString::fromUtf8(scalarsName) + " (RGBA)").toUtf8();
+    m_mappedColorsName = (QString::fromUtf8(scalarsName) + " (RGBA)").toUtf8();
 
     // vtkImageMapToColors consumes the scalars, but we still need them in downstream filters
     m_copyScalarsFilter = vtkSmartPointer<ArrayChangeInformationFilter>::New();
     m_copyScalarsFilter->PassInputArrayOn();
     m_copyScalarsFilter->EnableRenameOn();
-    m_copyScalarsFilter->SetArrayName(mappedColorsName.data());
+    m_copyScalarsFilter->SetArrayName(m_mappedColorsName.data());
 
     m_imageScalarsToColors = vtkSmartPointer<ImageMapToColors>::New();
     m_imageScalarsToColors->SetInputConnection(m_copyScalarsFilter->GetOutputPort());
@@ -336,18 +337,8 @@ void RenderedImageData::initializePipeline()
     m_assignElevationsForNormalComputation->Assign(scalarsName,
         vtkDataSetAttributes::SCALARS, vtkAssignAttribute::POINT_DATA);
 
-    m_demNormals = vtkSmartPointer<DEMImageNormals>::New();
-    m_demNormals->SetInputConnection(m_assignElevationsForNormalComputation->GetOutputPort());
-
     assert(m_demShading);
-    m_demShading->SetInputConnection(m_demNormals->GetOutputPort());
-
-    m_assignMappedColorsForShading = vtkSmartPointer<vtkAssignAttribute>::New();
-    m_assignMappedColorsForShading->SetInputConnection(m_demShading->GetOutputPort());
-    m_assignMappedColorsForShading->Assign(mappedColorsName.data(),
-        vtkDataSetAttributes::SCALARS, vtkAssignAttribute::POINT_DATA);
-
-    m_applyDEMShading = vtkSmartPointer<DEMApplyShadingToColors>::New();
+    m_demShading->SetInputConnection(m_assignElevationsForNormalComputation->GetOutputPort());
 }
 
 void RenderedImageData::configureVisPipeline()
@@ -359,8 +350,12 @@ void RenderedImageData::configureVisPipeline()
     In the simplest cast, this is the output of dataObject() (which is colorMappingInput()).
     Depending on the configuration, the visualization pipeline is extended by a
     - color mapping filter
+    - level of detail pyramid, configured by the image slice for the current view
     - vtkImageMapToColors, to be able to mix mapped colors with shading
     - shading filter
+    Mapping colors and shading are applied to the selected pyramid level, so that their costs
+    depend on the screen size rather than the image size. Shading of downsampled levels uses
+    their coarser spacing, which matches the rendered resolution.
     */
 
     vtkSmartPointer<vtkAlgorithm> colorMappingFilter;
@@ -386,6 +381,9 @@ void RenderedImageData::configureVisPipeline()
         }
     }
 
+    m_pyramid->SetInputConnection(currentPipelineStep);
+    currentPipelineStep = m_pyramid->GetOutputPort();
+
     if (mapScalarsToColors)
     {
         m_copyScalarsFilter->SetInputConnection(currentPipelineStep);
@@ -399,16 +397,12 @@ void RenderedImageData::configureVisPipeline()
     {
         m_assignElevationsForNormalComputation->SetInputConnection(currentPipelineStep);
 
-        if (mapScalarsToColors)
-        {
-            m_applyDEMShading->SetInputConnection(m_assignMappedColorsForShading->GetOutputPort());
-        }
-        else
-        {
-            m_applyDEMShading->SetInputConnection(m_demShading->GetOutputPort());
-        }
+        // Without mapped colors, the lightness is rendered directly.
+        m_demShading->SetColorsArrayName(mapScalarsToColors
+            ? m_mappedColorsName.data()
+            : "");
 
-        currentPipelineStep = m_applyDEMShading->GetOutputPort();
+        currentPipelineStep = m_demShading->GetOutputPort();
     }
 
     m_mapper->SetInputConnection(currentPipelineStep);
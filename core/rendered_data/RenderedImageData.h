@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <QByteArray>
+
 #include <core/rendered_data/RenderedData.h>
 
 
@@ -29,10 +31,10 @@ class vtkImageSlice;
 class vtkImageSliceMapper;
 
 class ArrayChangeInformationFilter;
-class DEMApplyShadingToColors;
-class DEMImageNormals;
-class DEMShadingFilter;
+class DEMShadedColorsFilter;
 class ImageDataObject;
+class ImagePyramidFilter;
+class ImagePyramidSlice;
 
 
 class CORE_API RenderedImageData : public RenderedData
@@ -84,15 +86,14 @@ private:
     QMetaObject::Connection m_updateComponentConnection;
 
     vtkSmartPointer<vtkAlgorithm> m_colorMappingFilter;
+    vtkSmartPointer<ImagePyramidFilter> m_pyramid;
 
     vtkSmartPointer<vtkAssignAttribute> m_assignElevationsForNormalComputation;
-    vtkSmartPointer<DEMImageNormals> m_demNormals;
-    vtkSmartPointer<DEMShadingFilter> m_demShading;
-    vtkSmartPointer<vtkAssignAttribute> m_assignMappedColorsForShading;
-    vtkSmartPointer<DEMApplyShadingToColors> m_applyDEMShading;
+    vtkSmartPointer<DEMShadedColorsFilter> m_demShading;
+    QByteArray m_mappedColorsName;
 
     vtkSmartPointer<vtkImageSliceMapper> m_mapper;
-    vtkSmartPointer<vtkImageSlice> m_slice;
+    vtkSmartPointer<ImagePyramidSlice> m_slice;
     vtkSmartPointer<vtkImageProperty> m_property;
 
 private:
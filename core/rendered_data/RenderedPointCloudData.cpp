@@ -35,6 +35,7 @@
 #include <core/color_mapping/ColorMapping.h>
 #include <core/data_objects/PointCloudDataObject.h>
 #include <core/color_mapping/ColorMappingData.h>
+#include <core/filters/PointDataMapToColors.h>
 #include <core/utility/DataExtent.h>
 
 
@@ -44,6 +45,8 @@ using namespace reflectionzeug;
 RenderedPointCloudData::RenderedPointCloudData(PointCloudDataObject & dataObject)
     : RenderedData3D(dataObject)
     , m_mapper{ vtkSmartPointer<vtkPolyDataMapper>::New() }
+    , m_pointColors{ vtkSmartPointer<PointDataMapToColors>::New() }
+    , m_usesPointColors{ false }
 {
     setupInformation(*m_mapper->GetInformation(), *this);
 
@@ -187,6 +190,8 @@ void RenderedPointCloudData::scalarsForColorMappingChangedEvent()
 {
     RenderedData3D::scalarsForColorMappingChangedEvent();
 
+    m_usesPointColors = false;
+
     // no mapping yet, so just render the data set
     if (!currentColorMappingData())
     {
@@ -197,6 +202,24 @@ void RenderedPointCloudData::scalarsForColorMappingChangedEvent()
 
     currentColorMappingData()->configureMapper(*this, *m_mapper);
 
+    // Map point scalars to colors in the pipeline, so that the mapper only uploads the colors.
+    const int scalarMode = m_mapper->GetScalarMode();
+    if (m_mapper->GetScalarVisibility()
+        && m_mapper->GetColorMode() == VTK_COLOR_MODE_MAP_SCALARS
+        && (scalarMode == VTK_SCALAR_MODE_USE_POINT_DATA || scalarMode == VTK_SCALAR_MODE_USE_POINT_FIELD_DATA))
+    {
+        m_usesPointColors = true;
+        m_pointColors->SetScalarsArrayName(
+            scalarMode == VTK_SCALAR_MODE_USE_POINT_FIELD_DATA && m_mapper->GetArrayName()
+            ? m_mapper->GetArrayName()
+            : "");
+        m_pointColors->SetLookupTable(currentColorMappingGradient());
+
+        m_mapper->SetColorModeToDirectScalars();
+        m_mapper->SetScalarModeToUsePointFieldData();
+        m_mapper->SelectColorArray(m_pointColors->GetColorsArrayName().c_str());
+    }
+
     vtkSmartPointer<vtkAlgorithm> filter;
 
     if (currentColorMappingData()->usesFilter())
@@ -217,6 +240,7 @@ void RenderedPointCloudData::colorMappingGradientChangedEvent()
     RenderedData3D::colorMappingGradientChangedEvent();
 
     m_mapper->SetLookupTable(currentColorMappingGradient());
+    m_pointColors->SetLookupTable(currentColorMappingGradient());
 }
 
 void RenderedPointCloudData::visibilityChangedEvent(bool visible)
@@ -243,5 +267,13 @@ void RenderedPointCloudData::finalizePipeline()
         m_mapper->ScalarVisibilityOff();
     }
 
-    m_mapper->SetInputConnection(m_colorMappingOutput->GetOutputPort());
+    if (m_usesPointColors)
+    {
+        m_pointColors->SetInputConnection(m_colorMappingOutput->GetOutputPort());
+        m_mapper->SetInputConnection(m_pointColors->GetOutputPort());
+    }
+    else
+    {
+        m_mapper->SetInputConnection(m_colorMappingOutput->GetOutputPort());
+    }
 }
@@ -29,6 +29,7 @@ class vtkPolyData;
 class vtkPolyDataMapper;
 
 class PointCloudDataObject;
+class PointDataMapToColors;
 
 
 class CORE_API RenderedPointCloudData : public RenderedData3D
@@ -65,6 +66,9 @@ private:
     vtkSmartPointer<vtkActor> m_mainActor;
 
     vtkSmartPointer<vtkAlgorithm> m_colorMappingOutput;
+    /** Precomputes point colors for the mapper, if point scalars are mapped to colors */
+    vtkSmartPointer<PointDataMapToColors> m_pointColors;
+    bool m_usesPointColors;
 
 private:
     Q_DISABLE_COPY(RenderedPointCloudData)
@@ -0,0 +1,325 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DataArrayRanges.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <vtkArrayDispatch.h>
+#include <vtkDataArray.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkInformation.h>
+#include <vtkInformationDoubleVectorKey.h>
+#include <vtkInformationIdTypeKey.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkObjectFactory.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+
+vtkInformationKeyMacro(DataArrayRanges, RANGES, DoubleVector);
+vtkInformationKeyMacro(DataArrayRanges, RANGES_MTIME, IdType);
+vtkInformationKeyMacro(DataArrayRanges, HISTOGRAMS, ObjectBase);
+
+
+namespace
+{
+
+/** Holds the histograms in the array's information object */
+class HistogramsCache : public vtkObject
+{
+public:
+    vtkTypeMacro(HistogramsCache, vtkObject);
+    static HistogramsCache * New();
+
+    std::shared_ptr<const std::vector<ScalarHistogram>> histograms;
+
+protected:
+    HistogramsCache() = default;
+    ~HistogramsCache() override = default;
+
+private:
+    HistogramsCache(const HistogramsCache &) = delete;
+    void operator=(const HistogramsCache &) = delete;
+};
+
+vtkStandardNewMacro(HistogramsCache);
+
+/** Min/max pairs of all components, followed by the magnitude */
+using RangeValues = std::vector<double>;
+
+RangeValues emptyRangeValues(int numComponents)
+{
+    RangeValues values(2u * static_cast<size_t>(numComponents + 1));
+    for (size_t i = 0; i < values.size(); i += 2)
+    {
+        values[i] = std::numeric_limits<double>::max();
+        values[i + 1] = std::numeric_limits<double>::lowest();
+    }
+    return values;
+}
+
+struct ComponentRangesWorker
+{
+    struct ThreadData
+    {
+        RangeValues ranges;
+        /** Components followed by the magnitude */
+        std::vector<ScalarHistogram::Accumulator> histograms;
+    };
+
+    bool withHistograms = false;
+    RangeValues ranges;
+    std::vector<ScalarHistogram> histograms;
+
+    template<typename ArrayT>
+    void operator()(ArrayT * array)
+    {
+        const int numComponents = array->GetNumberOfComponents();
+        const auto magnitudeIdx = 2u * static_cast<size_t>(numComponents);
+        const auto magnitudeHistIdx = static_cast<size_t>(numComponents);
+        const auto numHistograms = withHistograms ? static_cast<size_t>(numComponents + 1) : 0u;
+        const bool addToHistograms = withHistograms;
+        vtkDataArrayAccessor<ArrayT> a(array);
+
+        ranges = emptyRangeValues(numComponents);
+        vtkSMPThreadLocal<ThreadData> threadData(ThreadData{ ranges,
+            std::vector<ScalarHistogram::Accumulator>(numHistograms) });
+
+        vtkSMPTools::For(0, array->GetNumberOfTuples(),
+            [a, numComponents, magnitudeIdx, magnitudeHistIdx, addToHistograms, &threadData]
+            (vtkIdType begin, vtkIdType end)
+        {
+            auto & local = threadData.Local();
+            auto & localRanges = local.ranges;
+            auto & localHistograms = local.histograms;
+            for (vtkIdType t = begin; t < end; ++t)
+            {
+                double squaredNorm = 0.0;
+                bool isFinite = true;
+                for (int c = 0; c < numComponents; ++c)
+                {
+                    const auto value = static_cast<double>(a.Get(t, c));
+                    if (!std::isfinite(value))
+                    {
+                        isFinite = false;
+                        continue;
+                    }
+                    const auto i = 2u * static_cast<size_t>(c);
+                    localRanges[i] = std::min(localRanges[i], value);
+                    localRanges[i + 1] = std::max(localRanges[i + 1], value);
+                    if (addToHistograms)
+                    {
+                        localHistograms[static_cast<size_t>(c)].add(value);
+                    }
+                    squaredNorm += value * value;
+                }
+                if (isFinite)
+                {
+                    const double magnitude = std::sqrt(squaredNorm);
+                    localRanges[magnitudeIdx] = std::min(localRanges[magnitudeIdx], magnitude);
+                    localRanges[magnitudeIdx + 1] = std::max(localRanges[magnitudeIdx + 1], magnitude);
+                    if (addToHistograms)
+                    {
+                        localHistograms[magnitudeHistIdx].add(magnitude);
+                    }
+                }
+            }
+        });
+
+        std::vector<ScalarHistogram::Accumulator> mergedHistograms(numHistograms);
+        for (auto it = threadData.begin(); it != threadData.end(); ++it)
+        {
+            const auto & local = *it;
+            for (size_t i = 0; i < ranges.size(); i += 2)
+            {
+                ranges[i] = std::min(ranges[i], local.ranges[i]);
+                ranges[i + 1] = std::max(ranges[i + 1], local.ranges[i + 1]);
+            }
+            for (size_t i = 0; i < mergedHistograms.size(); ++i)
+            {
+                mergedHistograms[i].merge(local.histograms[i]);
+            }
+        }
+
+        histograms.assign(mergedHistograms.begin(), mergedHistograms.end());
+    }
+};
+}
+
+
+DataArrayRanges::DataArrayRanges()
+    : m_componentRanges{}
+    , m_magnitudeRange{}
+    , m_histograms{ std::make_shared<const std::vector<ScalarHistogram>>() }
+{
+}
+
+DataArrayRanges::DataArrayRanges(std::vector<ValueRange<>> componentRanges,
+    const ValueRange<> & magnitudeRange,
+    std::vector<ScalarHistogram> histograms)
+    : m_componentRanges{ std::move(componentRanges) }
+    , m_magnitudeRange{ magnitudeRange }
+    , m_histograms{ std::make_shared<const std::vector<ScalarHistogram>>(std::move(histograms)) }
+{
+    assert(m_histograms->empty() || m_histograms->size() == m_componentRanges.size() + 1u);
+}
+
+DataArrayRanges DataArrayRanges::of(vtkDataArray & dataArray, bool withHistograms)
+{
+    // Request the information first: creating it modifies the array.
+    auto & cache = *dataArray.GetInformation();
+    const auto arrayMTime = static_cast<vtkIdType>(dataArray.GetMTime());
+    const int numComponents = dataArray.GetNumberOfComponents();
+    const int numValues = 2 * (numComponents + 1);
+
+    auto histogramsCache = HistogramsCache::SafeDownCast(cache.Get(HISTOGRAMS()));
+    const bool hasCachedHistograms = histogramsCache && histogramsCache->histograms
+        && !histogramsCache->histograms->empty();
+
+    if (!(cache.Has(RANGES_MTIME())
+        && cache.Get(RANGES_MTIME()) == arrayMTime
+        && cache.Length(RANGES()) == numValues
+        && (hasCachedHistograms || !withHistograms)))
+    {
+        ComponentRangesWorker worker;
+        worker.withHistograms = withHistograms;
+        if (!vtkArrayDispatch::Dispatch::Execute(&dataArray, worker))
+        {
+            worker(&dataArray);
+        }
+        assert(worker.ranges.size() == static_cast<size_t>(numValues));
+
+        std::vector<ValueRange<>> componentRanges(static_cast<size_t>(numComponents));
+        for (size_t c = 0; c < componentRanges.size(); ++c)
+        {
+            componentRanges[c] = ValueRange<>({ worker.ranges[2 * c], worker.ranges[2 * c + 1] });
+        }
+        const auto magnitudeIdx = 2 * componentRanges.size();
+        const DataArrayRanges ranges(std::move(componentRanges),
+            ValueRange<>({ worker.ranges[magnitudeIdx], worker.ranges[magnitudeIdx + 1] }),
+            std::move(worker.histograms));
+        ranges.cacheIn(dataArray);
+
+        return ranges;
+    }
+
+    const double * values = cache.Get(RANGES());
+    DataArrayRanges ranges;
+    ranges.m_componentRanges.resize(static_cast<size_t>(numComponents));
+    for (size_t c = 0; c < ranges.m_componentRanges.size(); ++c)
+    {
+        ranges.m_componentRanges[c] = ValueRange<>({ values[2 * c], values[2 * c + 1] });
+    }
+    const auto magnitudeIdx = 2 * ranges.m_componentRanges.size();
+    ranges.m_magnitudeRange = ValueRange<>({ values[magnitudeIdx], values[magnitudeIdx + 1] });
+    if (hasCachedHistograms)
+    {
+        ranges.m_histograms = histogramsCache->histograms;
+    }
+
+    return ranges;
+}
+
+void DataArrayRanges::cacheIn(vtkDataArray & dataArray) const
+{
+    assert(numberOfComponents() == dataArray.GetNumberOfComponents());
+
+    // Request the information first: creating it modifies the array.
+    auto & cache = *dataArray.GetInformation();
+
+    RangeValues values;
+    values.reserve(2u * (m_componentRanges.size() + 1u));
+    for (const auto & range : m_componentRanges)
+    {
+        values.push_back(range[0]);
+        values.push_back(range[1]);
+    }
+    values.push_back(m_magnitudeRange[0]);
+    values.push_back(m_magnitudeRange[1]);
+
+    cache.Set(RANGES(), values.data(), static_cast<int>(values.size()));
+    if (hasHistograms())
+    {
+        auto histogramsCache = vtkSmartPointer<HistogramsCache>::New();
+        histogramsCache->histograms = m_histograms;
+        cache.Set(HISTOGRAMS(), histogramsCache);
+    }
+    else
+    {
+        cache.Remove(HISTOGRAMS());
+    }
+    cache.Set(RANGES_MTIME(), static_cast<vtkIdType>(dataArray.GetMTime()));
+}
+
+int DataArrayRanges::numberOfComponents() const
+{
+    return static_cast<int>(m_componentRanges.size());
+}
+
+const ValueRange<> & DataArrayRanges::range(int component) const
+{
+    return component < 0 ? magnitudeRange() : componentRange(component);
+}
+
+const ValueRange<> & DataArrayRanges::componentRange(int component) const
+{
+    assert(component >= 0 && component < numberOfComponents());
+    return m_componentRanges[static_cast<size_t>(component)];
+}
+
+const ValueRange<> & DataArrayRanges::magnitudeRange() const
+{
+    return m_magnitudeRange;
+}
+
+bool DataArrayRanges::hasHistograms() const
+{
+    return m_histograms && !m_histograms->empty();
+}
+
+const ScalarHistogram & DataArrayRanges::histogram(int component) const
+{
+    return component < 0 ? magnitudeHistogram() : componentHistogram(component);
+}
+
+const ScalarHistogram & DataArrayRanges::componentHistogram(int component) const
+{
+    assert(component >= 0 && component < numberOfComponents());
+    if (!hasHistograms())
+    {
+        static const ScalarHistogram empty;
+        return empty;
+    }
+    return (*m_histograms)[static_cast<size_t>(component)];
+}
+
+const ScalarHistogram & DataArrayRanges::magnitudeHistogram() const
+{
+    if (!hasHistograms())
+    {
+        static const ScalarHistogram empty;
+        return empty;
+    }
+    return m_histograms->back();
+}
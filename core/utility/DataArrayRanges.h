@@ -0,0 +1,94 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <core/core_api.h>
+#include <core/utility/DataExtent.h>
+#include <core/utility/ScalarHistogram.h>
+
+
+class vtkDataArray;
+class vtkInformationDoubleVectorKey;
+class vtkInformationIdTypeKey;
+class vtkInformationObjectBaseKey;
+
+
+/**
+ * Value ranges and distributions of all components and of the tuple magnitudes of a data array.
+ *
+ * All ranges, and the histograms if requested, are computed in a single parallel pass over the
+ * array and cached in the array's information object. The cache is valid as long as the array is
+ * not modified, so that the ranges can be shared between color mappings, table models etc. without
+ * scanning the array again. Histograms require additional memory (see ScalarHistogram) and are
+ * only computed for callers that need them.
+ *
+ * Only finite values are considered. Ranges of components without finite values are empty. The
+ * magnitude is computed for tuples with finite values in all components.
+ */
+class CORE_API DataArrayRanges
+{
+public:
+    /**
+     * @return the cached ranges of dataArray, or compute them if required.
+     * @param withHistograms Also compute the value distributions, if they are not cached yet.
+     *        Otherwise, the histograms are only available if they were cached before.
+     */
+    static DataArrayRanges of(vtkDataArray & dataArray, bool withHistograms = false);
+
+    DataArrayRanges();
+    /** @param histograms Histograms of all components, followed by the magnitude histogram, or
+     *        empty if no histograms were computed. */
+    DataArrayRanges(std::vector<ValueRange<>> componentRanges, const ValueRange<> & magnitudeRange,
+        std::vector<ScalarHistogram> histograms = {});
+
+    /**
+     * Store ranges that were computed elsewhere, e.g., while generating the array, so that of()
+     * does not need to scan the array again. The cache is discarded when the array is modified.
+     */
+    void cacheIn(vtkDataArray & dataArray) const;
+
+    int numberOfComponents() const;
+    /** @return the range of a component, or of the magnitude for component == -1 (as in VTK) */
+    const ValueRange<> & range(int component) const;
+    const ValueRange<> & componentRange(int component) const;
+    const ValueRange<> & magnitudeRange() const;
+
+    /** Whether the value distributions were computed. Otherwise, all histograms are empty. */
+    bool hasHistograms() const;
+    /** @return the value distribution of a component, or of the magnitude for component == -1 */
+    const ScalarHistogram & histogram(int component) const;
+    const ScalarHistogram & componentHistogram(int component) const;
+    const ScalarHistogram & magnitudeHistogram() const;
+
+    /** Cached ranges: min/max of all components, followed by the magnitude range */
+    static vtkInformationDoubleVectorKey * RANGES();
+    /** Cached histograms of all components, followed by the magnitude histogram, if computed */
+    static vtkInformationObjectBaseKey * HISTOGRAMS();
+    /** Modification time of the array when the ranges were computed */
+    static vtkInformationIdTypeKey * RANGES_MTIME();
+
+private:
+    std::vector<ValueRange<>> m_componentRanges;
+    ValueRange<> m_magnitudeRange;
+    /** Shared with the cache, components followed by the magnitude. Empty if not computed */
+    std::shared_ptr<const std::vector<ScalarHistogram>> m_histograms;
+};
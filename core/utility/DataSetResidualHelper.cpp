@@ -18,6 +18,7 @@
 
 #include "DataSetResidualHelper.h"
 
+#include <array>
 #include <type_traits>
 
 #include <QDebug>
@@ -29,11 +30,13 @@
 #include <vtkDataArrayAccessor.h>
 #include <vtkDataSet.h>
 #include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
 #include <vtkSMPTools.h>
 
 #include <core/data_objects/CoordinateTransformableDataObject.h>
 #include <core/utility/InterpolationHelper.h>
 #include <core/utility/mathhelper.h>
+#include <core/utility/ScalarStatistics.h>
 #include <core/utility/types_utils.h>
 #include <core/utility/vtkvectorhelper.h>
 
@@ -78,18 +81,60 @@ struct ProjectToLineOfSightWorker
     }
 };
 
-struct ResidualWorker
+/**
+ * Fused residual computation: Reads scalar line of sight displacements (1 component) or
+ * displacement vectors (3 components) of observation and model, applies unit scaling and
+ * line of sight projection and writes the residual in a single pass over the input arrays.
+ * This way, projected intermediate arrays are not required for the residual computation.
+ * Statistics of the residual values are collected in the same pass.
+ */
+struct FusedResidualWorker
 {
+    vtkVector3d lineOfSight;
     double observationUnitFactor;
     double modelUnitFactor;
 
     vtkSmartPointer<vtkDataArray> residual;
+    ScalarStatistics statistics;
 
     template<typename Observation_t, typename Model_t>
     void operator()(Observation_t * observation, Model_t * model)
     {
-        VTK_ASSUME(observation->GetNumberOfComponents() == 1);
-        VTK_ASSUME(model->GetNumberOfComponents() == 1);
+        const int oComponents = observation->GetNumberOfComponents();
+        const int mComponents = model->GetNumberOfComponents();
+
+        if (oComponents == 1 && mComponents == 1)
+        {
+            compute<1, 1>(observation, model);
+        }
+        else if (oComponents == 1 && mComponents == 3)
+        {
+            compute<1, 3>(observation, model);
+        }
+        else if (oComponents == 3 && mComponents == 1)
+        {
+            compute<3, 1>(observation, model);
+        }
+        else if (oComponents == 3 && mComponents == 3)
+        {
+            compute<3, 3>(observation, model);
+        }
+        else
+        {
+            residual = nullptr;
+        }
+    }
+
+    /**
+     * Component counts are compile time constants here, so that the inner loops can be unrolled
+     * and vectorized by the compiler.
+     */
+    template<int ObservationComponents, int ModelComponents,
+        typename Observation_t, typename Model_t>
+    void compute(Observation_t * observation, Model_t * model)
+    {
+        VTK_ASSUME(observation->GetNumberOfComponents() == ObservationComponents);
+        VTK_ASSUME(model->GetNumberOfComponents() == ModelComponents);
         VTK_ASSUME(model->GetNumberOfTuples() == observation->GetNumberOfTuples());
 
         using ObservationValue_t = typename vtkDataArrayAccessor<Observation_t>::APIType;
@@ -99,26 +144,50 @@ struct ResidualWorker
         auto res = vtkSmartPointer<vtkAOSDataArrayTemplate<ResidualValue_t>>::New();
         res->SetNumberOfValues(observation->GetNumberOfTuples());
 
+        // Merge unit scale and line of sight projection into per-component weights.
+        const auto los = lineOfSight.Normalized();
+        const auto weights = [&los] (int numComponents, double unitFactor)
+        {
+            std::array<ResidualValue_t, 3> w;
+            for (int c = 0; c < 3; ++c)
+            {
+                w[c] = static_cast<ResidualValue_t>(numComponents == 1
+                    ? (c == 0 ? unitFactor : 0.0)
+                    : los[c] * unitFactor);
+            }
+            return w;
+        };
+        const auto oWeights = weights(ObservationComponents, observationUnitFactor);
+        const auto mWeights = weights(ModelComponents, modelUnitFactor);
+
         vtkDataArrayAccessor<Observation_t> o(observation);
         vtkDataArrayAccessor<Model_t> m(model);
-        vtkDataArrayAccessor<vtkAOSDataArrayTemplate<ResidualValue_t>> r(res);
+        auto r = res->GetPointer(0);
 
-        const auto oUnit = static_cast<ObservationValue_t>(observationUnitFactor);
-        const auto mUnit = static_cast<ModelValue_t>(modelUnitFactor);
+        vtkSMPThreadLocal<ScalarStatistics::Accumulator> threadStatistics;
 
         vtkSMPTools::For(0, res->GetNumberOfValues(),
-            [o, m, r, oUnit, mUnit] (vtkIdType begin, vtkIdType end)
+            [o, m, r, oWeights, mWeights, &threadStatistics] (vtkIdType begin, vtkIdType end)
         {
+            auto & localStatistics = threadStatistics.Local();
             for (vtkIdType i = begin; i < end; ++i)
             {
-                const auto diff = static_cast<ResidualValue_t>(
-                    o.Get(i, 0) * oUnit
-                    - m.Get(i, 0) * mUnit);
-                r.Set(i, 0, diff);
+                ResidualValue_t oLos{}, mLos{};
+                for (int c = 0; c < ObservationComponents; ++c)
+                {
+                    oLos += static_cast<ResidualValue_t>(o.Get(i, c)) * oWeights[c];
+                }
+                for (int c = 0; c < ModelComponents; ++c)
+                {
+                    mLos += static_cast<ResidualValue_t>(m.Get(i, c)) * mWeights[c];
+                }
+                r[i] = oLos - mLos;
+                localStatistics.add(static_cast<double>(r[i]));
             }
         });
 
         residual = res;
+        statistics = ScalarStatistics::merge(threadStatistics.begin(), threadStatistics.end());
     }
 };
 
@@ -148,11 +217,13 @@ DataSetResidualHelper::DataSetResidualHelper()
     , m_modelScalars{}
     , m_residualDataObjectName{ "Residual" }
     , m_residualDataObject{}
+    , m_residualStatistics{}
     , m_geometrySource{ InputData::Observation }
     , m_targetCoordinateSystem{}
     , m_losIncidenceAngleDegrees{ 0.0 }
     , m_losSatelliteHeadingDegrees{ 0.0 }
     , m_projectedAttributeSuffix{ " (projected)" }
+    , m_projectedAttributesEnabled{ false }
 {
 }
 
@@ -264,6 +335,11 @@ const QString & DataSetResidualHelper::residualDataObjectName() const
     return m_residualDataObjectName;
 }
 
+const ScalarStatistics & DataSetResidualHelper::residualStatistics() const
+{
+    return m_residualStatistics;
+}
+
 DataObject * DataSetResidualHelper::residualDataObject()
 {
     return m_residualDataObject.get();
@@ -346,6 +422,16 @@ const QString & DataSetResidualHelper::projectedAttributeNameSuffix() const
     return m_projectedAttributeSuffix;
 }
 
+void DataSetResidualHelper::setProjectedAttributesEnabled(bool enabled)
+{
+    m_projectedAttributesEnabled = enabled;
+}
+
+bool DataSetResidualHelper::projectedAttributesEnabled() const
+{
+    return m_projectedAttributesEnabled;
+}
+
 bool DataSetResidualHelper::isSetupComplete() const
 {
     return m_observationDataObject && m_observationScalars.isComplete()
@@ -473,9 +559,19 @@ bool DataSetResidualHelper::projectDisplacementsToLineOfSight()
 
 bool DataSetResidualHelper::updateResidual()
 {
-    if (!projectDisplacementsToLineOfSight())
+    m_residualStatistics = {};
+
+    if (m_projectedAttributesEnabled)
     {
-        return false;
+        if (!projectDisplacementsToLineOfSight())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        m_observationScalars.projectedName.clear();
+        m_modelScalars.projectedName.clear();
     }
 
     if (!isSetupComplete())
@@ -486,10 +582,16 @@ bool DataSetResidualHelper::updateResidual()
         return false;
     }
 
-    auto observationLosDisp = m_observationScalars.losDisplacements;
-    auto modelLosDisp = m_modelScalars.losDisplacements;
-    assert(observationLosDisp && modelLosDisp);
-
+    // Interpolate and process the source attributes (scalars or displacement vectors) directly.
+    // As the interpolation is linear, this is equivalent to interpolating projected displacements.
+    vtkSmartPointer<vtkDataArray> observationDisp = displacementArray(m_observationDataObject, m_observationScalars);
+    vtkSmartPointer<vtkDataArray> modelDisp = displacementArray(m_modelDataObject, m_modelScalars);
+    if (!observationDisp || !modelDisp)
+    {
+        qWarning() << "Residual: Could not find valid observation/model data for residual computation ("
+            << m_observationScalars.name << ", " << m_modelScalars.name << ")";
+        return false;
+    }
 
     auto transformableObservation = dynamic_cast<CoordinateTransformableDataObject *>(m_observationDataObject);
     auto transformableModel = dynamic_cast<CoordinateTransformableDataObject *>(m_modelDataObject);
@@ -516,22 +618,20 @@ bool DataSetResidualHelper::updateResidual()
     // Use the data sets transformed to the user-selected coordinate system.
     if (m_geometrySource == InputData::Observation)
     {
-        auto attributeName = QString::fromUtf8(modelLosDisp->GetName());
-        modelLosDisp = InterpolationHelper::interpolate(
-            observationDSTransformed, modelDSTransformed, attributeName,
+        modelDisp = InterpolationHelper::interpolate(
+            observationDSTransformed, modelDSTransformed, m_modelScalars.name,
             m_modelScalars.location,
             m_observationScalars.location);
     }
     else
     {
-        auto attributeName = QString::fromUtf8(observationLosDisp->GetName());
-        observationLosDisp = InterpolationHelper::interpolate(
-            modelDSTransformed, observationDSTransformed, attributeName,
+        observationDisp = InterpolationHelper::interpolate(
+            modelDSTransformed, observationDSTransformed, m_observationScalars.name,
             m_observationScalars.location,
             m_modelScalars.location);
     }
 
-    if (!observationLosDisp || !modelLosDisp)
+    if (!observationDisp || !modelDisp)
     {
         qWarning() << "Observation/Model interpolation failed";
 
@@ -539,10 +639,8 @@ bool DataSetResidualHelper::updateResidual()
     }
 
 
-    // expect line of sight displacements, matching to one of the structures here
-    assert(modelLosDisp->GetNumberOfComponents() == 1);
-    assert(observationLosDisp->GetNumberOfComponents() == 1);
-    assert(modelLosDisp->GetNumberOfTuples() == observationLosDisp->GetNumberOfTuples());
+    // expect scalars or displacement vectors, matching to one of the structures here
+    assert(modelDisp->GetNumberOfTuples() == observationDisp->GetNumberOfTuples());
 
 
     // compute the residual data
@@ -553,15 +651,23 @@ bool DataSetResidualHelper::updateResidual()
 
     using ResidualDispatcher = vtkArrayDispatch::Dispatch2ByValueType<
         vtkArrayDispatch::Reals, vtkArrayDispatch::Reals>;
-    ResidualWorker residualWorker;
+    FusedResidualWorker residualWorker;
+    residualWorker.lineOfSight = mathhelper::satelliteAnglesToLOSVector(
+        m_losIncidenceAngleDegrees, m_losSatelliteHeadingDegrees);
     residualWorker.observationUnitFactor = m_observationScalars.scale;
     residualWorker.modelUnitFactor = m_modelScalars.scale;
-    if (!ResidualDispatcher::Execute(observationLosDisp, modelLosDisp, residualWorker))
+    if (!ResidualDispatcher::Execute(observationDisp, modelDisp, residualWorker))
     {
-        residualWorker(observationLosDisp.Get(), modelLosDisp.Get());
+        residualWorker(observationDisp.Get(), modelDisp.Get());
     }
     auto residualData = residualWorker.residual;
+    if (!residualData)
+    {
+        qWarning() << "Residual: Unsupported number of observation/model components";
+        return false;
+    }
     residualData->SetName(m_residualDataObjectName.toUtf8().data());
+    m_residualStatistics = residualWorker.statistics;
 
     auto newResidual = vtkSmartPointer<vtkDataSet>::Take(referenceDataSet.NewInstance());
     newResidual->CopyStructure(&referenceDataSet);
@@ -625,6 +731,25 @@ const QString & DataSetResidualHelper::losModelScalarsName() const
     return m_modelScalars.name;
 }
 
+vtkDataArray * DataSetResidualHelper::displacementArray(
+    DataObject * dataObject, const ScalarDef & scalarDef)
+{
+    auto dataSet = dataObject ? dataObject->processedOutputDataSet() : nullptr;
+    auto array = IndexType_util(scalarDef.location).extractArray(dataSet, scalarDef.name);
+    if (!array)
+    {
+        return nullptr;
+    }
+
+    const auto numComponents = array->GetNumberOfComponents();
+    if (numComponents != 1 && numComponents != 3)
+    {
+        return nullptr;
+    }
+
+    return array;
+}
+
 void DataSetResidualHelper::invalidateResults()
 {
     invalidateResidual();
@@ -637,4 +762,5 @@ void DataSetResidualHelper::invalidateResults()
 void DataSetResidualHelper::invalidateResidual()
 {
     m_residualDataObject = {};
+    m_residualStatistics = {};
 }
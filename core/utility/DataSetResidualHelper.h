@@ -28,6 +28,7 @@
 
 #include <core/types.h>
 #include <core/CoordinateSystems.h>
+#include <core/utility/ScalarStatistics.h>
 
 
 class vtkDataArray;
@@ -61,6 +62,11 @@ public:
 
     DataObject * residualDataObject();
     std::unique_ptr<DataObject> takeResidualDataObject();
+    /**
+     * Statistics of the current residual values, computed in updateResidual().
+     * This is still valid after takeResidualDataObject(), until the residual is invalidated.
+     */
+    const ScalarStatistics & residualStatistics() const;
 
     enum class InputData
     {
@@ -89,6 +95,15 @@ public:
     void setProjectedAttributeNameSuffix(const QString & suffix);
     const QString & projectedAttributeNameSuffix() const;
 
+    /**
+     * Specify whether line of sight projections of displacement vectors are stored in the
+     * observation/model attributes when updating the residual. This is only required if the
+     * projected displacements are visualized. The residual itself is always computed directly from
+     * the displacement vectors. This is disabled by default.
+     */
+    void setProjectedAttributesEnabled(bool enabled);
+    bool projectedAttributesEnabled() const;
+
     bool isSetupComplete() const;
 
     /**
@@ -101,6 +116,9 @@ public:
     /**
      * Compute the residual.
      * This will only have an effect if isSetupComplete() returns true.
+     * Unit scaling, line of sight projection and the residual are computed in a single pass over
+     * the observation and model attributes. Projected attributes are additionally generated only
+     * if projectedAttributesEnabled() is set.
      */
     bool updateResidual();
 
@@ -124,6 +142,12 @@ private:
         vtkSmartPointer<vtkDataArray> losDisplacements;
     };
 
+    /**
+     * Fetch the scalars (1 component) or displacement vectors (3 components) defined by scalarDef.
+     * @return nullptr if the attribute is not available or not supported.
+     */
+    static vtkDataArray * displacementArray(DataObject * dataObject, const ScalarDef & scalarDef);
+
     DataObject * m_observationDataObject;
     ScalarDef m_observationScalars;
     DataObject * m_modelDataObject;
@@ -131,10 +155,12 @@ private:
 
     QString m_residualDataObjectName;
     std::unique_ptr<DataObject> m_residualDataObject;
+    ScalarStatistics m_residualStatistics;
 
     InputData m_geometrySource;
     CoordinateSystemSpecification m_targetCoordinateSystem;
     double m_losIncidenceAngleDegrees;
     double m_losSatelliteHeadingDegrees;
     QString m_projectedAttributeSuffix;
+    bool m_projectedAttributesEnabled;
 };
@@ -18,57 +18,154 @@
 
 #include "GeographicTransformationUtil.h"
 
+#include <algorithm>
 #include <cassert>
-#include <cmath>
-#include <limits>
-#include <numeric>
+#include <string>
 
-#include <vtkDoubleArray.h>
-#include <vtkExecutive.h>
-#include <vtkPolyData.h>
-#include <vtkSmartPointer.h>
+#include <vtkMath.h>
+#include <vtkVector.h>
 
+#include <core/ThirdParty/proj4_include.h>
 #include <core/filters/GeographicTransformationFilter.h>
-#include <core/filters/SetCoordinateSystemInformationFilter.h>
-
-
-GeographicTransformationUtil::GeographicTransformationUtil()
-    : m_coordinates{ vtkSmartPointer<vtkDoubleArray>::New() }
-    , m_dataSet{ vtkSmartPointer<vtkPolyData>::New() }
-    , m_spec{ vtkSmartPointer<SetCoordinateSystemInformationFilter>::New() }
-    , m_transform{ vtkSmartPointer<GeographicTransformationFilter>::New() }
-{
-    m_coordinates->SetNumberOfComponents(3);
-    auto points = vtkSmartPointer<vtkPoints>::New();
-    points->SetData(m_coordinates);
-    m_dataSet->SetPoints(points);
-    m_spec->SetInputData(m_dataSet);
-    m_transform->SetInputConnection(m_spec->GetOutputPort());
-    m_transform->OperateInPlaceOn();
+#include <core/utility/KruegerTransverseMercator.h>
+#include <core/utility/mathhelper.h>
+
+
+namespace
+{
+
+// Same as in GeographicTransformationFilter
+int utm_getZone(const double longitude)
+{
+    return static_cast<int>(1.0 + (longitude + 180.0) / 6.0);
+}
+
+bool utm_isNorthern(const double latitude)
+{
+    return latitude > 0.0;
+}
+
+bool isMetric(const CoordinateSystemType type)
+{
+    return type == CoordinateSystemType::metricGlobal || type == CoordinateSystemType::metricLocal;
+}
+
+}
+
+
+/** PROJ.4 projections with their own context, so that different instances can be used concurrently. */
+struct GeographicTransformationUtil::Proj4State
+{
+    Proj4State(const std::string & utmDefinition)
+        : context{ pj_ctx_alloc() }
+        , geographic{ pj_init_plus_ctx(context, "+proj=longlat +ellps=WGS84 +datum=WGS84 +no_defs") }
+        , utm{ pj_init_plus_ctx(context, utmDefinition.c_str()) }
+    {
+    }
+
+    ~Proj4State()
+    {
+        if (utm)
+        {
+            pj_free(utm);
+        }
+        if (geographic)
+        {
+            pj_free(geographic);
+        }
+        pj_ctx_free(context);
+    }
+
+    bool isValid() const
+    {
+        return geographic && utm;
+    }
+
+    projCtx context;
+    projPJ geographic;
+    projPJ utm;
+
+    Proj4State(const Proj4State &) = delete;
+    void operator=(const Proj4State &) = delete;
+};
+
+/**
+ * Transformation from source to target system, reduced to an optional projection and a scale/shift
+ * operation that is applied before (metric to geographic) or after (geographic to metric) the
+ * projection.
+ */
+struct GeographicTransformationUtil::PreparedState
+{
+    bool isValid = false;
+    GeographicTransformationFilter::ProjectionMethod method =
+        GeographicTransformationFilter::ProjectionExact;
+
+    enum { none, toUTM, fromUTM } projection = none;
+    vtkVector3d scale = vtkVector3d(1.0, 1.0, 1.0);
+    vtkVector3d shift = vtkVector3d(0.0, 0.0, 0.0);
+
+    std::unique_ptr<KruegerTransverseMercator> fastUTM;
+    std::unique_ptr<Proj4State> proj4;
+
+    void scaleShift(vtkVector3d * points, const size_t numPoints) const
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                points[i][c] = points[i][c] * scale[c] + shift[c];
+            }
+        }
+    }
+};
+
+
+GeographicTransformationUtil::GeographicTransformationUtil() = default;
+
+GeographicTransformationUtil::GeographicTransformationUtil(
+    const ReferencedCoordinateSystemSpecification & sourceSpec,
+    const CoordinateSystemSpecification & targetSpec)
+    : m_sourceSpec{ sourceSpec }
+    , m_targetSpec{ targetSpec }
+{
+    prepare();
 }
 
 GeographicTransformationUtil::~GeographicTransformationUtil() = default;
 
+GeographicTransformationUtil::GeographicTransformationUtil(GeographicTransformationUtil && other) = default;
+GeographicTransformationUtil & GeographicTransformationUtil::operator=(GeographicTransformationUtil && other) = default;
+
 void GeographicTransformationUtil::setSourceSystem(
     const ReferencedCoordinateSystemSpecification & sourceSpec)
 {
-    m_spec->SetCoordinateSystemSpec(sourceSpec);
+    if (m_sourceSpec == sourceSpec)
+    {
+        return;
+    }
+    m_sourceSpec = sourceSpec;
+    m_state.reset();
 }
 
 const ReferencedCoordinateSystemSpecification & GeographicTransformationUtil::sourceSystem() const
 {
-    return m_spec->GetCoordinateSystemSpec();
+    return m_sourceSpec;
 }
 
 void GeographicTransformationUtil::setTargetSystem(
     const CoordinateSystemSpecification & targetSpec)
 {
-    m_transform->SetTargetCoordinateSystem(targetSpec);
+    if (m_targetSpec == targetSpec)
+    {
+        return;
+    }
+    m_targetSpec = targetSpec;
+    m_state.reset();
 }
 
 const CoordinateSystemSpecification & GeographicTransformationUtil::targetSystem() const
 {
-    return m_transform->GetTargetCoordinateSystem();
+    return m_targetSpec;
 }
 
 bool GeographicTransformationUtil::isTransformationSupported() const
@@ -78,14 +175,14 @@ bool GeographicTransformationUtil::isTransformationSupported() const
 
 }
 
-bool GeographicTransformationUtil::transformPoints(std::vector<vtkVector3d> & points)
+bool GeographicTransformationUtil::transformPoints(std::vector<vtkVector3d> & points) const
 {
     return GeographicTransformationUtil::transformPoints(points.data(), points.size());
 }
 
-bool GeographicTransformationUtil::transformPoints(vtkVector3d * points, const size_t numPoints)
+bool GeographicTransformationUtil::transformPoints(vtkVector3d * points, const size_t numPoints) const
 {
-    if (!isTransformationSupported())
+    if (!prepare())
     {
         return false;
     }
@@ -95,45 +192,50 @@ bool GeographicTransformationUtil::transformPoints(vtkVector3d * points, const s
         return true;
     }
 
-    if (numPoints > static_cast<size_t>(std::numeric_limits<vtkIdType>::max()) / 3u)
+    if (!points)
     {
-        vtkGenericWarningMacro(
-            << "transformPoints: too many input points (exceeding maximum of vtkIdType)");
         return false;
     }
 
-    if (!points)
+    const auto & state = *m_state;
+    if (state.projection == PreparedState::none)
     {
-        return false;
+        state.scaleShift(points, numPoints);
+        return true;
     }
 
-    struct UnRefPointsRawData
-    {
-        explicit UnRefPointsRawData(GeographicTransformationUtil & util)
-            : util{ util } { }
-        ~UnRefPointsRawData() { util.releasePoints(); }
-        GeographicTransformationUtil & util;
-    } unrefPointsRawDataOnReturn(*this);
+    // Projections may fail for some of the points. Keep the input to restore it in this case.
+    const std::vector<vtkVector3d> sourcePoints(points, points + numPoints);
+    bool success = false;
 
-    auto pointsData = vtkSmartPointer<vtkDoubleArray>::New();
-    setPoints(points, numPoints);
-    if (!m_transform->GetExecutive()->Update())
+    switch (state.projection)
     {
-        return false;
+    case PreparedState::toUTM:
+        success = project(points, numPoints, true);
+        if (success)
+        {
+            state.scaleShift(points, numPoints);
+        }
+        break;
+    case PreparedState::fromUTM:
+        state.scaleShift(points, numPoints);
+        success = project(points, numPoints, false);
+        break;
+    default:
+        assert(false);
     }
-    auto outputDataSet = vtkPolyData::SafeDownCast(m_transform->GetOutput());
-    if (outputDataSet)
+
+    if (!success)
     {
-        assert(outputDataSet->GetPoints() == m_dataSet->GetPoints());
+        std::copy(sourcePoints.begin(), sourcePoints.end(), points);
     }
 
-    return outputDataSet
-        && outputDataSet->GetNumberOfPoints() == static_cast<vtkIdType>(numPoints);
+    return success;
 }
 
 vtkVector3d GeographicTransformationUtil::transformPoint(
     const vtkVector3d & sourcePoint,
-    bool * successPtr)
+    bool * successPtr) const
 {
     if (successPtr)
     {
@@ -150,25 +252,167 @@ vtkVector3d GeographicTransformationUtil::transformPoint(
     return point;
 }
 
-void GeographicTransformationUtil::setPoints(vtkVector3d * points, const vtkIdType numPoints)
+bool GeographicTransformationUtil::prepare() const
 {
-    assert(m_dataSet);
-    assert(points);
-    if (m_dataSet->GetNumberOfVerts() == numPoints)
+    const auto method = GeographicTransformationFilter::GetDefaultProjectionMethod();
+    if (m_state && m_state->method == method)
     {
-        return;
+        return m_state->isValid;
+    }
+
+    m_state = std::make_unique<PreparedState>();
+    auto & state = *m_state;
+    state.method = method;
+
+    if (!isTransformationSupported())
+    {
+        return false;
+    }
+
+    const CoordinateSystemType sourceType = m_sourceSpec.type;
+    const CoordinateSystemType targetType = m_targetSpec.type;
+    const auto & sourceUnit = m_sourceSpec.unitOfMeasurement;
+    const auto & targetUnit = m_targetSpec.unitOfMeasurement;
+
+    if ((isMetric(sourceType) && !mathhelper::isValidMetricUnit(sourceUnit))
+        || (isMetric(targetType) && !mathhelper::isValidMetricUnit(targetUnit)))
+    {
+        return false;
     }
-    m_coordinates->SetArray(points[0].GetData(), 3 * static_cast<vtkIdType>(numPoints), 1);
-    auto ids = std::vector<vtkIdType>(static_cast<size_t>(numPoints));
-    std::iota(ids.begin(), ids.end(), 0);
-    auto verts = vtkSmartPointer<vtkCellArray>::New();
-    const vtkIdType initId = 0;
-    verts->InsertNextCell(1, &initId);
-    m_dataSet->SetVerts(verts);
-    m_dataSet->Modified();
+
+    if (sourceType == targetType)
+    {
+        if (sourceType != CoordinateSystemType::geographic)
+        {
+            // Also scale the elevations to the target unit.
+            const double unitScale = mathhelper::scaleFactorForMetricUnits(sourceUnit, targetUnit);
+            state.scale = vtkVector3d(unitScale, unitScale, unitScale);
+        }
+        state.isValid = true;
+        return true;
+    }
+
+    if (!m_sourceSpec.isReferencePointValid())
+    {
+        return false;
+    }
+
+    const auto & refLatLongWGS84 = m_sourceSpec.referencePointLatLong;
+    const int utmZone = utm_getZone(refLatLongWGS84.GetY());
+    const bool utmNorthern = utm_isNorthern(refLatLongWGS84.GetX());
+
+    state.fastUTM = std::make_unique<KruegerTransverseMercator>(utmZone, utmNorthern);
+    if (method != GeographicTransformationFilter::ProjectionFast)
+    {
+        state.proj4 = std::make_unique<Proj4State>("+proj=utm +zone=" + std::to_string(utmZone)
+            + (utmNorthern ? " " : " +south ")
+            + "+ellps=WGS84 +datum=WGS84 +units=m +no_defs");
+        if (!state.proj4->isValid())
+        {
+            return false;
+        }
+    }
+
+    vtkVector3d refUTM_m{ refLatLongWGS84.GetY(), refLatLongWGS84.GetX(), 0.0 };
+    if (!project(&refUTM_m, 1u, true))
+    {
+        return false;
+    }
+
+    if (isMetric(sourceType) && isMetric(targetType))
+    {
+        const double unitScale = mathhelper::scaleFactorForMetricUnits(sourceUnit, targetUnit);
+        const double targetUnitScale = mathhelper::scaleFactorForMetricUnits("m", targetUnit);
+        const double shiftSign = sourceType == CoordinateSystemType::metricLocal ? 1.0 : -1.0;
+        state.scale = vtkVector3d(unitScale, unitScale, unitScale);
+        state.shift = vtkVector3d(
+            shiftSign * refUTM_m[0] * targetUnitScale,
+            shiftSign * refUTM_m[1] * targetUnitScale,
+            0.0);
+    }
+    else if (sourceType == CoordinateSystemType::geographic)
+    {
+        // Project to global UTM coordinates, then shift to local coordinates and scale to unit.
+        state.projection = PreparedState::toUTM;
+        const double targetUnitScale = mathhelper::scaleFactorForMetricUnits("m", targetUnit);
+        state.scale = vtkVector3d(targetUnitScale, targetUnitScale, 1.0);
+        if (targetType == CoordinateSystemType::metricLocal)
+        {
+            state.shift = vtkVector3d(
+                -refUTM_m[0] * targetUnitScale,
+                -refUTM_m[1] * targetUnitScale,
+                0.0);
+        }
+    }
+    else
+    {
+        // Scale to meters and shift to global coordinates, then project to geographic coordinates.
+        state.projection = PreparedState::fromUTM;
+        const double sourceUnitScale = mathhelper::scaleFactorForMetricUnits(sourceUnit, "m");
+        state.scale = vtkVector3d(sourceUnitScale, sourceUnitScale, 1.0);
+        if (sourceType == CoordinateSystemType::metricLocal)
+        {
+            state.shift = vtkVector3d(refUTM_m[0], refUTM_m[1], 0.0);
+        }
+    }
+
+    state.isValid = true;
+    return true;
 }
 
-void GeographicTransformationUtil::releasePoints()
+bool GeographicTransformationUtil::project(vtkVector3d * points, const size_t numPoints,
+    const bool toUTM) const
 {
-    m_coordinates->SetArray(nullptr, 0, 0);
+    assert(m_state);
+    const auto & state = *m_state;
+
+    if (!state.proj4)
+    {
+        assert(state.fastUTM);
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            auto & p = points[i];
+            if (toUTM)
+            {
+                state.fastUTM->forward(p[0], p[1], p[0], p[1]);
+            }
+            else
+            {
+                state.fastUTM->inverse(p[0], p[1], p[0], p[1]);
+            }
+        }
+        return true;
+    }
+
+    const auto & proj4 = *state.proj4;
+    if (toUTM)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            points[i][0] = vtkMath::RadiansFromDegrees(points[i][0]);
+            points[i][1] = vtkMath::RadiansFromDegrees(points[i][1]);
+        }
+    }
+
+    // Elevations are not modified, so don't pass them to PROJ.4.
+    const int result = pj_transform(
+        toUTM ? proj4.geographic : proj4.utm,
+        toUTM ? proj4.utm : proj4.geographic,
+        static_cast<long>(numPoints), 3,
+        points[0].GetData(), points[0].GetData() + 1, nullptr);
+    if (result != 0)
+    {
+        return false;
+    }
+
+    if (!toUTM)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            points[i][0] = vtkMath::DegreesFromRadians(points[i][0]);
+            points[i][1] = vtkMath::DegreesFromRadians(points[i][1]);
+        }
+    }
+
+    return true;
 }
@@ -18,28 +18,37 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
-#include <vtkSmartPointer.h>
+#include <core/CoordinateSystems.h>
 
-#include <core/CoordinateSystems_fwd.h>
 
-
-class vtkDoubleArray;
-class vtkPolyData;
 class vtkVector3d;
-class GeographicTransformationFilter;
-class SetCoordinateSystemInformationFilter;
-
 
 
-/** Convenience class that simplifies transformation of a raw point vector. */
+/**
+ * Convenience class that simplifies transformation of a raw point vector.
+ *
+ * The projection state (PROJ.4 projections or the fast built-in UTM projection, reference point
+ * shift, unit scales) is prepared once when source and target system are set. Points are then
+ * converted directly, without running a VTK pipeline, so that this class is also suitable for
+ * transforming single points at interactive rates, e.g., for cursor or picking coordinates.
+ *
+ * Results match the ones of GeographicTransformationFilter for the same coordinate systems and
+ * projection method.
+ */
 class CORE_API GeographicTransformationUtil
 {
 public:
     GeographicTransformationUtil();
+    GeographicTransformationUtil(const ReferencedCoordinateSystemSpecification & sourceSpec,
+        const CoordinateSystemSpecification & targetSpec);
     virtual ~GeographicTransformationUtil();
 
+    GeographicTransformationUtil(GeographicTransformationUtil && other);
+    GeographicTransformationUtil & operator=(GeographicTransformationUtil && other);
+
     void setSourceSystem(const ReferencedCoordinateSystemSpecification & sourceSpec);
     const ReferencedCoordinateSystemSpecification & sourceSystem() const;
     void setTargetSystem(const CoordinateSystemSpecification & targetSpec);
@@ -49,13 +58,14 @@ public:
     bool isTransformationSupported() const;
 
     /**
-    * @param points Vector of point coordinates to be transformed in place.
+    * @param points Vector of point coordinates to be transformed in place. The points are not
+    *  modified if the transformation fails.
     * @return true only if the transformation succeeded. It should succeed if
     *  IsConversionSupported() returns true for the coordinate systems and the source point
     *  coordinates are in sensible range.
     */
-    bool transformPoints(std::vector<vtkVector3d> & points);
-    bool transformPoints(vtkVector3d * points, size_t numPoints);
+    bool transformPoints(std::vector<vtkVector3d> & points) const;
+    bool transformPoints(vtkVector3d * points, size_t numPoints) const;
 
     /**
     * Variant of TransformPoints that transforms a single point.
@@ -64,15 +74,22 @@ public:
     *  and the source point coordinates are in sensible range.
     * @return The transformed point.
     */
-    vtkVector3d transformPoint(const vtkVector3d & sourcePoint, bool * successPtr = nullptr);
+    vtkVector3d transformPoint(const vtkVector3d & sourcePoint, bool * successPtr = nullptr) const;
+
+private:
+    /** (Re)initialize the projection state, if the systems or the projection method changed. */
+    bool prepare() const;
+    bool project(vtkVector3d * points, size_t numPoints, bool toUTM) const;
 
 private:
-    void setPoints(vtkVector3d * points, vtkIdType numPoints);
-    void releasePoints();
+    ReferencedCoordinateSystemSpecification m_sourceSpec;
+    CoordinateSystemSpecification m_targetSpec;
+
+    struct Proj4State;
+    struct PreparedState;
+    mutable std::unique_ptr<PreparedState> m_state;
 
 private:
-    vtkSmartPointer<vtkDoubleArray> m_coordinates;
-    vtkSmartPointer<vtkPolyData> m_dataSet;
-    vtkSmartPointer<SetCoordinateSystemInformationFilter> m_spec;
-    vtkSmartPointer<GeographicTransformationFilter> m_transform;
+    GeographicTransformationUtil(const GeographicTransformationUtil &) = delete;
+    void operator=(const GeographicTransformationUtil &) = delete;
 };
@@ -0,0 +1,52 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridSpacingEstimateCache.h"
+
+
+bool GridSpacingEstimateCache::find(vtkMTimeType pointsMTime, Estimate & estimate) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto it = m_estimates.find(pointsMTime);
+    if (it == m_estimates.end())
+    {
+        return false;
+    }
+
+    estimate = it->second;
+    return true;
+}
+
+void GridSpacingEstimateCache::store(vtkMTimeType pointsMTime, const Estimate & estimate)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_estimates[pointsMTime] = estimate;
+
+    // Points with lower modification times are likely outdated.
+    while (m_estimates.size() > maximumSize())
+    {
+        m_estimates.erase(m_estimates.begin());
+    }
+}
+
+size_t GridSpacingEstimateCache::maximumSize()
+{
+    return 4u;
+}
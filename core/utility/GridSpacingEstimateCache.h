@@ -0,0 +1,59 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+
+#include <vtkType.h>
+#include <vtkVector.h>
+
+#include <core/core_api.h>
+
+
+/**
+ * Grid spacing estimates of point coordinates, keyed by the modification time of the points.
+ *
+ * A cache is owned by a data object and shared by all filters that estimate the grid spacing of
+ * its points, e.g., by the LineOnPointsSelector2D of each line profile. It is thread safe, so that
+ * profiles may be computed in worker threads.
+ */
+class CORE_API GridSpacingEstimateCache
+{
+public:
+    struct Estimate
+    {
+        double spacing;
+        double standardDeviation;
+        /** Bounds of the 95% confidence interval, both equal to spacing if all points were evaluated */
+        vtkVector2d confidenceInterval;
+    };
+
+    /** @return whether an estimate for points with the modification time exists */
+    bool find(vtkMTimeType pointsMTime, Estimate & estimate) const;
+    /** Add or replace the estimate. Only the estimates of the most recently modified points are kept. */
+    void store(vtkMTimeType pointsMTime, const Estimate & estimate);
+
+    /** Number of modification times that estimates are kept for, e.g., for different coordinate systems */
+    static size_t maximumSize();
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<vtkMTimeType, Estimate> m_estimates;
+};
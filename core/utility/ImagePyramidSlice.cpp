@@ -0,0 +1,156 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ImagePyramidSlice.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <vtkCamera.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+#include <vtkVector.h>
+
+#include <core/filters/ImagePyramidFilter.h>
+#include <core/utility/DataExtent.h>
+#include <core/utility/vtkvectorhelper.h>
+
+
+vtkStandardNewMacro(ImagePyramidSlice);
+
+
+ImagePyramidSlice::ImagePyramidSlice()
+    : Superclass()
+{
+}
+
+ImagePyramidSlice::~ImagePyramidSlice() = default;
+
+ImagePyramidFilter * ImagePyramidSlice::GetPyramid()
+{
+    return this->Pyramid;
+}
+
+void ImagePyramidSlice::SetPyramid(ImagePyramidFilter * pyramid)
+{
+    if (this->Pyramid == pyramid)
+    {
+        return;
+    }
+
+    this->Pyramid = pyramid;
+    this->Modified();
+}
+
+double * ImagePyramidSlice::GetBounds()
+{
+    DataBounds bounds;
+    if (!this->Pyramid || !this->Pyramid->GetWholeBounds(bounds.data()))
+    {
+        return Superclass::GetBounds();
+    }
+
+    if (this->GetIsIdentity())
+    {
+        std::copy(bounds.data(), bounds.data() + 6, this->Bounds);
+        return this->Bounds;
+    }
+
+    auto matrix = this->GetMatrix();
+    DataBounds transformedBounds;
+    for (int i = 0; i < 8; ++i)
+    {
+        double corner[4] = {
+            bounds[(i & 1) ? 1 : 0],
+            bounds[(i & 2) ? 3 : 2],
+            bounds[(i & 4) ? 5 : 4],
+            1.0 };
+        matrix->MultiplyPoint(corner, corner);
+        transformedBounds.add(vtkVector3d(corner[0] / corner[3], corner[1] / corner[3], corner[2] / corner[3]));
+    }
+
+    std::copy(transformedBounds.data(), transformedBounds.data() + 6, this->Bounds);
+    return this->Bounds;
+}
+
+int ImagePyramidSlice::RenderOpaqueGeometry(vtkViewport * viewport)
+{
+    this->UpdatePyramidView(viewport);
+
+    return Superclass::RenderOpaqueGeometry(viewport);
+}
+
+int ImagePyramidSlice::RenderTranslucentPolygonalGeometry(vtkViewport * viewport)
+{
+    this->UpdatePyramidView(viewport);
+
+    return Superclass::RenderTranslucentPolygonalGeometry(viewport);
+}
+
+void ImagePyramidSlice::UpdatePyramidView(vtkViewport * viewport)
+{
+    auto renderer = vtkRenderer::SafeDownCast(viewport);
+    if (!this->Pyramid || !renderer || !renderer->GetActiveCamera())
+    {
+        return;
+    }
+
+    const auto size = renderer->GetSize();
+    if (size[0] <= 0 || size[1] <= 0)
+    {
+        return;
+    }
+
+    auto & camera = *renderer->GetActiveCamera();
+
+    const auto viewHeight = camera.GetParallelProjection()
+        ? 2.0 * camera.GetParallelScale()
+        : 2.0 * camera.GetDistance()
+            * std::tan(vtkMath::RadiansFromDegrees(0.5 * camera.GetViewAngle()));
+    const auto pixelSize = viewHeight / size[1];
+
+    vtkVector3d directionOfProjection, viewUp, focalPoint;
+    camera.GetDirectionOfProjection(directionOfProjection.GetData());
+    camera.GetViewUp(viewUp.GetData());
+    camera.GetFocalPoint(focalPoint.GetData());
+
+    // Only determine visible tiles when looking (almost) straight at the image plane, and in
+    // the image's coordinate system.
+    if (std::abs(directionOfProjection[2]) < 0.99 || !this->GetIsIdentity())
+    {
+        this->Pyramid->SetViewParameters(pixelSize, nullptr);
+        return;
+    }
+
+    const auto up = viewUp.Normalized() * (0.5 * viewHeight);
+    const auto right = directionOfProjection.Cross(viewUp).Normalized()
+        * (0.5 * viewHeight * size[0] / size[1]);
+
+    DataBounds visibleArea;
+    visibleArea.add(focalPoint + up + right);
+    visibleArea.add(focalPoint + up - right);
+    visibleArea.add(focalPoint - up + right);
+    visibleArea.add(focalPoint - up - right);
+
+    const double visibleBounds[4] = {
+        visibleArea[0], visibleArea[1], visibleArea[2], visibleArea[3] };
+
+    this->Pyramid->SetViewParameters(pixelSize, visibleBounds);
+}
@@ -0,0 +1,67 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vtkImageSlice.h>
+#include <vtkSmartPointer.h>
+
+#include <core/core_api.h>
+
+
+class ImagePyramidFilter;
+
+
+/**
+ * Image slice that configures an ImagePyramidFilter for the viewport it is rendered in.
+ *
+ * Before rendering, the pyramid level is selected based on the screen space size of a pixel at
+ * the camera focal point, and tiles are requested for the area visible from cameras looking along
+ * the z axis. The pyramid output is expected to be the mapper input.
+ * The prop bounds are the bounds of the full resolution image, so that culling and camera resets
+ * are not affected by the currently extracted tiles.
+ */
+class CORE_API ImagePyramidSlice : public vtkImageSlice
+{
+public:
+    vtkTypeMacro(ImagePyramidSlice, vtkImageSlice);
+    static ImagePyramidSlice * New();
+
+    ImagePyramidFilter * GetPyramid();
+    void SetPyramid(ImagePyramidFilter * pyramid);
+
+    using Superclass::GetBounds;
+    double * GetBounds() override;
+
+    int RenderOpaqueGeometry(vtkViewport * viewport) override;
+    int RenderTranslucentPolygonalGeometry(vtkViewport * viewport) override;
+
+protected:
+    ImagePyramidSlice();
+    ~ImagePyramidSlice() override;
+
+private:
+    void UpdatePyramidView(vtkViewport * viewport);
+
+private:
+    vtkSmartPointer<ImagePyramidFilter> Pyramid;
+
+private:
+    ImagePyramidSlice(const ImagePyramidSlice &) = delete;
+    void operator=(const ImagePyramidSlice &) = delete;
+};
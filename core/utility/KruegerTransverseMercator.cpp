@@ -0,0 +1,195 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "KruegerTransverseMercator.h"
+
+#include <cmath>
+
+
+namespace
+{
+
+// WGS 84 ellipsoid and UTM parameters
+const double a = 6378137.0;
+const double f = 1.0 / 298.257223563;
+const double k0 = 0.9996;
+const double falseEasting = 500000.0;
+const double southernFalseNorthing = 10000000.0;
+
+const double e2 = f * (2.0 - f);
+const double e = std::sqrt(e2);
+const double n = f / (2.0 - f);
+const double n2 = n * n;
+const double n3 = n2 * n;
+const double n4 = n3 * n;
+const double n5 = n4 * n;
+const double n6 = n5 * n;
+
+/** Rectifying radius, scaled by k0 */
+const double k0A = k0 * a / (1.0 + n) * (1.0 + n2 / 4.0 + n4 / 64.0 + n6 / 256.0);
+
+const double pi = 3.14159265358979323846;
+const double degToRad = pi / 180.0;
+const double radToDeg = 180.0 / pi;
+
+const int numNewtonIterations = 3;
+
+/** Conformal latitude (as tangent) from geodetic latitude (as tangent) */
+inline double tauPrime(double tau)
+{
+    const double tau1 = std::sqrt(1.0 + tau * tau);
+    const double sigma = std::sinh(e * std::atanh(e * tau / tau1));
+    return tau * std::sqrt(1.0 + sigma * sigma) - sigma * tau1;
+}
+
+/** Inverse of tauPrime, using a fixed number of Newton iterations. */
+inline double tauFromTauPrime(double taup)
+{
+    double tau = taup / (1.0 - e2);
+    for (int i = 0; i < numNewtonIterations; ++i)
+    {
+        const double taupi = tauPrime(tau);
+        const double tau1 = std::sqrt(1.0 + tau * tau);
+        const double dtau = (taup - taupi) / std::sqrt(1.0 + taupi * taupi)
+            * (1.0 + (1.0 - e2) * tau * tau) / ((1.0 - e2) * tau1);
+        tau += dtau;
+    }
+    return tau;
+}
+
+}
+
+
+KruegerTransverseMercator::KruegerTransverseMercator(int utmZone, bool northernHemisphere)
+    : m_utmZone{ utmZone }
+    , m_northern{ northernHemisphere }
+    , m_centralMeridianRad{ (-183.0 + 6.0 * utmZone) * degToRad }
+    , m_falseNorthing{ northernHemisphere ? 0.0 : southernFalseNorthing }
+    , m_alpha{ {
+        n / 2.0 - 2.0 * n2 / 3.0 + 5.0 * n3 / 16.0 + 41.0 * n4 / 180.0 - 127.0 * n5 / 288.0
+            + 7891.0 * n6 / 37800.0,
+        13.0 * n2 / 48.0 - 3.0 * n3 / 5.0 + 557.0 * n4 / 1440.0 + 281.0 * n5 / 630.0
+            - 1983433.0 * n6 / 1935360.0,
+        61.0 * n3 / 240.0 - 103.0 * n4 / 140.0 + 15061.0 * n5 / 26880.0
+            + 167603.0 * n6 / 181440.0,
+        49561.0 * n4 / 161280.0 - 179.0 * n5 / 168.0 + 6601661.0 * n6 / 7257600.0,
+        34729.0 * n5 / 80640.0 - 3418889.0 * n6 / 1995840.0,
+        212378941.0 * n6 / 319334400.0 } }
+    , m_beta{ {
+        n / 2.0 - 2.0 * n2 / 3.0 + 37.0 * n3 / 96.0 - n4 / 360.0 - 81.0 * n5 / 512.0
+            + 96199.0 * n6 / 604800.0,
+        n2 / 48.0 + n3 / 15.0 - 437.0 * n4 / 1440.0 + 46.0 * n5 / 105.0
+            - 1118711.0 * n6 / 3870720.0,
+        17.0 * n3 / 480.0 - 37.0 * n4 / 840.0 - 209.0 * n5 / 4480.0 + 5569.0 * n6 / 90720.0,
+        4397.0 * n4 / 161280.0 - 11.0 * n5 / 504.0 - 830251.0 * n6 / 7257600.0,
+        4583.0 * n5 / 161280.0 - 108847.0 * n6 / 3991680.0,
+        20648693.0 * n6 / 638668800.0 } }
+{
+}
+
+int KruegerTransverseMercator::utmZone() const
+{
+    return m_utmZone;
+}
+
+bool KruegerTransverseMercator::isNorthernHemisphere() const
+{
+    return m_northern;
+}
+
+double KruegerTransverseMercator::maximumError()
+{
+    // Series truncation error is in the nanometer range. This bound includes floating point
+    // round-off of coordinates in the range of UTM coordinates.
+    return 1.e-4;
+}
+
+void KruegerTransverseMercator::forward(double longitude, double latitude,
+    double & easting, double & northing) const
+{
+    forward(&longitude, &latitude, &easting, &northing, 1u);
+}
+
+void KruegerTransverseMercator::inverse(double easting, double northing,
+    double & longitude, double & latitude) const
+{
+    inverse(&easting, &northing, &longitude, &latitude, 1u);
+}
+
+void KruegerTransverseMercator::forward(const double * longitudes, const double * latitudes,
+    double * eastings, double * northings, const size_t numPoints) const
+{
+    const auto alpha = m_alpha;
+    const double lambda0 = m_centralMeridianRad;
+    const double falseNorthing = m_falseNorthing;
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        const double lambda = longitudes[i] * degToRad - lambda0;
+        const double tau = std::tan(latitudes[i] * degToRad);
+        const double taup = tauPrime(tau);
+
+        const double cosLambda = std::cos(lambda);
+        const double xip = std::atan2(taup, cosLambda);
+        const double etap = std::asinh(std::sin(lambda) / std::sqrt(taup * taup + cosLambda * cosLambda));
+
+        double xi = xip;
+        double eta = etap;
+        for (int j = 0; j < 6; ++j)
+        {
+            const double k = 2.0 * (j + 1);
+            xi += alpha[j] * std::sin(k * xip) * std::cosh(k * etap);
+            eta += alpha[j] * std::cos(k * xip) * std::sinh(k * etap);
+        }
+
+        eastings[i] = falseEasting + k0A * eta;
+        northings[i] = falseNorthing + k0A * xi;
+    }
+}
+
+void KruegerTransverseMercator::inverse(const double * eastings, const double * northings,
+    double * longitudes, double * latitudes, const size_t numPoints) const
+{
+    const auto beta = m_beta;
+    const double lambda0 = m_centralMeridianRad;
+    const double falseNorthing = m_falseNorthing;
+
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        const double xi = (northings[i] - falseNorthing) / k0A;
+        const double eta = (eastings[i] - falseEasting) / k0A;
+
+        double xip = xi;
+        double etap = eta;
+        for (int j = 0; j < 6; ++j)
+        {
+            const double k = 2.0 * (j + 1);
+            xip -= beta[j] * std::sin(k * xi) * std::cosh(k * eta);
+            etap -= beta[j] * std::cos(k * xi) * std::sinh(k * eta);
+        }
+
+        const double sinhEtap = std::sinh(etap);
+        const double cosXip = std::cos(xip);
+        const double taup = std::sin(xip) / std::sqrt(sinhEtap * sinhEtap + cosXip * cosXip);
+        const double tau = tauFromTauPrime(taup);
+
+        longitudes[i] = (lambda0 + std::atan2(sinhEtap, cosXip)) * radToDeg;
+        latitudes[i] = std::atan(tau) * radToDeg;
+    }
+}
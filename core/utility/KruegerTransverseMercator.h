@@ -0,0 +1,75 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <core/core_api.h>
+
+
+/**
+ * Closed-form UTM projection of WGS 84 geographic coordinates, based on Krüger's series.
+ *
+ * This implements the 6th order series in the third flattening n, as given by
+ * C. F. F. Karney, "Transverse Mercator with an accuracy of a few nanometers", J. Geodesy 85(8),
+ * 475-485 (2011). The truncation error of the series is below 5 nm within 3900 km from the central
+ * meridian, so that, including floating point round-off, forward and inverse projections are
+ * accurate to well below one millimeter in and around the UTM zone.
+ *
+ * The batch functions process arrays of coordinates with a fixed sequence of operations per
+ * point (no data dependent branches, fixed number of Newton iterations), so that compilers can
+ * vectorize the loops where vectorized math functions are available.
+ *
+ * Geographic coordinates are in degrees, projected coordinates in meters, including the UTM false
+ * easting (500 km) and false northing (10000 km on the southern hemisphere).
+ */
+class CORE_API KruegerTransverseMercator
+{
+public:
+    KruegerTransverseMercator(int utmZone, bool northernHemisphere);
+
+    int utmZone() const;
+    bool isNorthernHemisphere() const;
+
+    /** Documented upper bound of the projection error in meters. */
+    static double maximumError();
+
+    void forward(double longitude, double latitude, double & easting, double & northing) const;
+    void inverse(double easting, double northing, double & longitude, double & latitude) const;
+
+    /**
+     * Batch forward projection.
+     * Input and output arrays may be identical (x/longitude and y/latitude are processed in place).
+     */
+    void forward(const double * longitudes, const double * latitudes,
+        double * eastings, double * northings, size_t numPoints) const;
+    /** Batch inverse projection, see forward() */
+    void inverse(const double * eastings, const double * northings,
+        double * longitudes, double * latitudes, size_t numPoints) const;
+
+private:
+    int m_utmZone;
+    bool m_northern;
+    double m_centralMeridianRad;
+    double m_falseNorthing;
+    std::array<double, 6> m_alpha;
+    std::array<double, 6> m_beta;
+};
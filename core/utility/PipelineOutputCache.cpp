@@ -0,0 +1,384 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PipelineOutputCache.h"
+
+#include <cassert>
+#include <functional>
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QObject>
+#include <QString>
+
+#include <vtkAlgorithm.h>
+#include <vtkCommand.h>
+#include <vtkDataArray.h>
+#include <vtkPoints.h>
+#include <vtkPointSet.h>
+
+
+namespace
+{
+
+/** 1 GiB */
+const std::uint64_t defaultBudgetKiB = 1024u * 1024u;
+
+const QEvent::Type evictionRequestType = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+class EvictionReceiver : public QObject
+{
+public:
+    explicit EvictionReceiver(std::function<void()> evict)
+        : m_evict{ std::move(evict) }
+    {
+    }
+
+    bool event(QEvent * event) override
+    {
+        if (event->type() != evictionRequestType)
+        {
+            return QObject::event(event);
+        }
+
+        m_evict();
+        return true;
+    }
+
+private:
+    std::function<void()> m_evict;
+};
+
+}
+
+
+PipelineOutputCache & PipelineOutputCache::instance()
+{
+    static PipelineOutputCache cache;
+
+    return cache;
+}
+
+PipelineOutputCache::PipelineOutputCache()
+    : m_budgetKiB{ defaultBudgetKiB }
+    , m_memoryKiB{ 0u }
+    , m_hits{ 0u }
+    , m_misses{ 0u }
+    , m_evictions{ 0u }
+    , m_evictionScheduled{ false }
+    , m_evictionSuspensions{ 0u }
+{
+}
+
+PipelineOutputCache::~PipelineOutputCache()
+{
+    for (auto & entry : m_entries)
+    {
+        entry.algorithm->RemoveObserver(entry.endObserverTag);
+        entry.algorithm->RemoveObserver(entry.deleteObserverTag);
+    }
+}
+
+void PipelineOutputCache::setMemoryBudget(const std::uint64_t budgetKiB)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_budgetKiB = budgetKiB;
+    evict(nullptr);
+}
+
+std::uint64_t PipelineOutputCache::memoryBudget() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    return m_budgetKiB;
+}
+
+void PipelineOutputCache::add(vtkAlgorithm & algorithm)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (m_entryLookup.find(&algorithm) != m_entryLookup.end())
+    {
+        return;
+    }
+
+    Entry entry;
+    entry.algorithm = &algorithm;
+    entry.endObserverTag = algorithm.AddObserver(vtkCommand::EndEvent,
+        this, &PipelineOutputCache::algorithmExecuted);
+    entry.deleteObserverTag = algorithm.AddObserver(vtkCommand::DeleteEvent,
+        this, &PipelineOutputCache::algorithmDeleted);
+    entry.memoryKiB = 0u;
+
+    m_entries.push_front(entry);
+    m_entryLookup.emplace(&algorithm, m_entries.begin());
+}
+
+void PipelineOutputCache::remove(vtkAlgorithm & algorithm)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const auto it = m_entryLookup.find(&algorithm);
+    if (it == m_entryLookup.end())
+    {
+        return;
+    }
+
+    auto & entry = *it->second;
+    algorithm.RemoveObserver(entry.endObserverTag);
+    algorithm.RemoveObserver(entry.deleteObserverTag);
+    m_memoryKiB -= entry.memoryKiB;
+    m_entries.erase(it->second);
+    m_entryLookup.erase(it);
+}
+
+void PipelineOutputCache::access(vtkAlgorithm & algorithm)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const auto it = m_entryLookup.find(&algorithm);
+    if (it == m_entryLookup.end())
+    {
+        return;
+    }
+
+    if (isOutputAvailable(algorithm))
+    {
+        ++m_hits;
+    }
+    else
+    {
+        ++m_misses;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+}
+
+PipelineOutputCache::ScopedEvictionSuspension::ScopedEvictionSuspension()
+{
+    auto & cache = PipelineOutputCache::instance();
+    std::lock_guard<std::recursive_mutex> lock(cache.m_mutex);
+    ++cache.m_evictionSuspensions;
+}
+
+PipelineOutputCache::ScopedEvictionSuspension::~ScopedEvictionSuspension()
+{
+    auto & cache = PipelineOutputCache::instance();
+    std::lock_guard<std::recursive_mutex> lock(cache.m_mutex);
+    assert(cache.m_evictionSuspensions > 0u);
+    if (--cache.m_evictionSuspensions == 0u)
+    {
+        cache.scheduleEviction();
+    }
+}
+
+double PipelineOutputCache::Statistics::hitRate() const
+{
+    const auto accesses = hits + misses;
+    return accesses == 0u ? 0.0
+        : static_cast<double>(hits) / static_cast<double>(accesses);
+}
+
+PipelineOutputCache::Statistics PipelineOutputCache::statistics() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    Statistics stats;
+    stats.numAlgorithms = m_entries.size();
+    stats.numCachedOutputs = 0u;
+    for (auto & entry : m_entries)
+    {
+        if (entry.memoryKiB > 0u)
+        {
+            ++stats.numCachedOutputs;
+        }
+    }
+    stats.memoryKiB = m_memoryKiB;
+    stats.budgetKiB = m_budgetKiB;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    return stats;
+}
+
+QString PipelineOutputCache::statisticsString() const
+{
+    const auto stats = statistics();
+    return QString(
+        "Transformed data cache\n"
+        "  Pipelines: %1 (%2 with cached output)\n"
+        "  Memory: %3 MiB of %4 MiB\n"
+        "  Hits: %5, Misses: %6 (hit rate %7%)\n"
+        "  Evictions: %8")
+        .arg(stats.numAlgorithms)
+        .arg(stats.numCachedOutputs)
+        .arg(static_cast<double>(stats.memoryKiB) / 1024.0, 0, 'f', 1)
+        .arg(static_cast<double>(stats.budgetKiB) / 1024.0, 0, 'f', 1)
+        .arg(stats.hits)
+        .arg(stats.misses)
+        .arg(stats.hitRate() * 100.0, 0, 'f', 1)
+        .arg(stats.evictions);
+}
+
+void PipelineOutputCache::resetStatistics()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_hits = 0u;
+    m_misses = 0u;
+    m_evictions = 0u;
+}
+
+void PipelineOutputCache::algorithmExecuted(vtkObject * object, unsigned long, void *)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const auto it = m_entryLookup.find(static_cast<vtkAlgorithm *>(object));
+    if (it == m_entryLookup.end())
+    {
+        return;
+    }
+
+    auto & entry = *it->second;
+    m_memoryKiB -= entry.memoryKiB;
+    entry.memoryKiB = exclusiveOutputMemoryKiB(*entry.algorithm);
+    m_memoryKiB += entry.memoryKiB;
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+    scheduleEviction();
+}
+
+void PipelineOutputCache::algorithmDeleted(vtkObject * object, unsigned long, void *)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    const auto it = m_entryLookup.find(static_cast<vtkAlgorithm *>(object));
+    if (it == m_entryLookup.end())
+    {
+        return;
+    }
+
+    m_memoryKiB -= it->second->memoryKiB;
+    m_entries.erase(it->second);
+    m_entryLookup.erase(it);
+}
+
+void PipelineOutputCache::scheduleEviction()
+{
+    if (m_memoryKiB <= m_budgetKiB || m_evictionScheduled)
+    {
+        return;
+    }
+
+    auto app = QCoreApplication::instance();
+    if (!app)
+    {
+        // No application thread to defer to.
+        evict(m_entries.empty() ? nullptr : &m_entries.front());
+        return;
+    }
+
+    if (!m_evictionReceiver)
+    {
+        m_evictionReceiver = std::make_unique<EvictionReceiver>([this] () { scheduledEviction(); });
+        m_evictionReceiver->moveToThread(app->thread());
+    }
+
+    m_evictionScheduled = true;
+    QCoreApplication::postEvent(m_evictionReceiver.get(), new QEvent(evictionRequestType));
+}
+
+void PipelineOutputCache::scheduledEviction()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_evictionScheduled = false;
+
+    // Keep the output that was computed most recently.
+    evict(m_entries.empty() ? nullptr : &m_entries.front());
+}
+
+void PipelineOutputCache::evict(const Entry * keep)
+{
+    if (m_evictionSuspensions > 0u)
+    {
+        return;
+    }
+
+    for (auto it = m_entries.rbegin(); it != m_entries.rend() && m_memoryKiB > m_budgetKiB; ++it)
+    {
+        auto & entry = *it;
+        if (&entry == keep || entry.memoryKiB == 0u)
+        {
+            continue;
+        }
+
+        if (auto output = entry.algorithm->GetOutputDataObject(0))
+        {
+            // The output information of the executive holds one reference. Further references
+            // belong to consumers that still use the data set.
+            if (output->GetReferenceCount() > 1)
+            {
+                continue;
+            }
+            // Downstream consumers that shallow copied the output share its points instead. The
+            // accounted memory would not be freed by releasing the output in that case.
+            if (auto pointSet = vtkPointSet::SafeDownCast(output))
+            {
+                auto points = pointSet->GetPoints();
+                if (points && (points->GetReferenceCount() > 1
+                    || (points->GetData() && points->GetData()->GetReferenceCount() > 1)))
+                {
+                    continue;
+                }
+            }
+            output->ReleaseData();
+        }
+        m_memoryKiB -= entry.memoryKiB;
+        entry.memoryKiB = 0u;
+        ++m_evictions;
+    }
+}
+
+bool PipelineOutputCache::isOutputAvailable(vtkAlgorithm & algorithm)
+{
+    if (algorithm.GetNumberOfOutputPorts() < 1)
+    {
+        return false;
+    }
+    auto output = algorithm.GetOutputDataObject(0);
+    return output && !output->GetDataReleased() && output->GetUpdateTime() > 0u;
+}
+
+std::uint64_t PipelineOutputCache::exclusiveOutputMemoryKiB(vtkAlgorithm & algorithm)
+{
+    // Only point coordinates are considered here. Attributes are generally passed through, so that
+    // they are shared with the input.
+    auto output = vtkPointSet::SafeDownCast(algorithm.GetOutputDataObject(0));
+    if (!output || !output->GetPoints() || !output->GetPoints()->GetData())
+    {
+        return 0u;
+    }
+    auto outputCoords = output->GetPoints()->GetData();
+
+    for (int port = 0; port < algorithm.GetNumberOfInputPorts(); ++port)
+    {
+        for (int connection = 0; connection < algorithm.GetNumberOfInputConnections(port); ++connection)
+        {
+            auto input = vtkPointSet::SafeDownCast(algorithm.GetInputDataObject(port, connection));
+            if (input && input->GetPoints() && input->GetPoints()->GetData() == outputCoords)
+            {
+                return 0u;
+            }
+        }
+    }
+
+    return outputCoords->GetActualMemorySize();
+}
@@ -0,0 +1,149 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <core/core_api.h>
+
+
+class QObject;
+class QString;
+class vtkAlgorithm;
+class vtkObject;
+
+
+/**
+ * Application wide, memory accounted LRU cache for outputs of registered algorithms.
+ *
+ * Registered algorithms are not owned by the cache. After each execution of a registered
+ * algorithm, the memory exclusively held by its output (e.g., point coordinates that are not
+ * shared with the input) is accounted. When the sum of all accounted outputs exceeds the memory
+ * budget, the outputs of the least recently used algorithms are released (vtkDataObject::ReleaseData).
+ * The algorithms themselves are kept, so that the pipeline recomputes a released output on the
+ * next update.
+ *
+ * Outputs are only released if they are referenced by their pipeline only, so that data sets that
+ * are still used elsewhere are never emptied. As algorithms may execute in worker threads,
+ * releasing outputs is deferred to the thread of the QCoreApplication instance.
+ *
+ * Algorithms are removed automatically when they are deleted.
+ */
+class CORE_API PipelineOutputCache
+{
+public:
+    static PipelineOutputCache & instance();
+
+    /** Memory budget in KiB for all accounted outputs. */
+    void setMemoryBudget(std::uint64_t budgetKiB);
+    std::uint64_t memoryBudget() const;
+
+    /** Register an algorithm. Its output on port 0 is accounted after each execution. */
+    void add(vtkAlgorithm & algorithm);
+    void remove(vtkAlgorithm & algorithm);
+
+    /**
+     * Mark the output of a registered algorithm as recently used. This counts as cache hit if the
+     * output is currently available, and as cache miss if it is not computed yet or released.
+     */
+    void access(vtkAlgorithm & algorithm);
+
+    /**
+     * Suspend releasing outputs while instances exist, e.g., while a worker thread updates
+     * pipelines that read registered outputs. Evictions that were skipped meanwhile are
+     * scheduled when the last suspension ends.
+     */
+    class CORE_API ScopedEvictionSuspension
+    {
+    public:
+        ScopedEvictionSuspension();
+        ~ScopedEvictionSuspension();
+
+        ScopedEvictionSuspension(const ScopedEvictionSuspension &) = delete;
+        void operator=(const ScopedEvictionSuspension &) = delete;
+    };
+
+    struct Statistics
+    {
+        std::uint64_t numAlgorithms;
+        std::uint64_t numCachedOutputs;
+        std::uint64_t memoryKiB;
+        std::uint64_t budgetKiB;
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t evictions;
+
+        /** @return hits / (hits + misses), or 0 if there were no accesses yet. */
+        double hitRate() const;
+    };
+    Statistics statistics() const;
+    /** Human readable summary of statistics() for diagnostic output. */
+    QString statisticsString() const;
+    void resetStatistics();
+
+    void operator=(const PipelineOutputCache &) = delete;
+
+private:
+    PipelineOutputCache();
+    ~PipelineOutputCache();
+
+    struct Entry
+    {
+        vtkAlgorithm * algorithm;
+        unsigned long endObserverTag;
+        unsigned long deleteObserverTag;
+        std::uint64_t memoryKiB;
+    };
+    using EntryList = std::list<Entry>;
+
+    void algorithmExecuted(vtkObject * algorithm, unsigned long, void *);
+    void algorithmDeleted(vtkObject * algorithm, unsigned long, void *);
+
+    /** Request evict() in the application thread, if the budget is exceeded. */
+    void scheduleEviction();
+    void scheduledEviction();
+    /**
+     * Release outputs of least recently used entries, except for keep, until the budget is met.
+     * Outputs whose data set, points or point coordinates are referenced outside of their
+     * pipeline are skipped, as well as all outputs while eviction is suspended.
+     */
+    void evict(const Entry * keep);
+    static bool isOutputAvailable(vtkAlgorithm & algorithm);
+    static std::uint64_t exclusiveOutputMemoryKiB(vtkAlgorithm & algorithm);
+
+private:
+    mutable std::recursive_mutex m_mutex;
+    std::uint64_t m_budgetKiB;
+    std::uint64_t m_memoryKiB;
+    std::uint64_t m_hits;
+    std::uint64_t m_misses;
+    std::uint64_t m_evictions;
+    bool m_evictionScheduled;
+    unsigned int m_evictionSuspensions;
+    /** Receives eviction requests in the application thread */
+    std::unique_ptr<QObject> m_evictionReceiver;
+
+    /** Most recently used entries first. */
+    EntryList m_entries;
+    std::map<vtkAlgorithm *, EntryList::iterator> m_entryLookup;
+};
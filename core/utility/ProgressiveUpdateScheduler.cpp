@@ -0,0 +1,115 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ProgressiveUpdateScheduler.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+ProgressiveUpdateScheduler::ProgressiveUpdateScheduler(
+    std::int64_t previewTimeBudgetMs,
+    double minPreviewResolution)
+    : m_previewTimeBudget{ previewTimeBudgetMs }
+    , m_minPreviewResolution{ minPreviewResolution }
+    , m_interactive{ false }
+    , m_updatePending{ false }
+    , m_updateRunning{ false }
+    , m_runningPreview{ false }
+    , m_previewResolution{ 1.0 }
+{
+    assert(minPreviewResolution > 0.0 && minPreviewResolution <= 1.0);
+}
+
+void ProgressiveUpdateScheduler::setInteractive(bool interactive)
+{
+    m_interactive = interactive;
+}
+
+bool ProgressiveUpdateScheduler::isInteractive() const
+{
+    return m_interactive;
+}
+
+void ProgressiveUpdateScheduler::requestUpdate()
+{
+    m_updatePending = true;
+}
+
+bool ProgressiveUpdateScheduler::startUpdate(double & resolution)
+{
+    // Running updates cannot be interrupted. Their results are replaced as soon as possible by an
+    // update for the latest input, all intermediate requests are dropped.
+    if (!m_updatePending || m_updateRunning)
+    {
+        return false;
+    }
+
+    m_updatePending = false;
+    m_updateRunning = true;
+    m_runningPreview = m_interactive;
+    resolution = m_runningPreview ? m_previewResolution : 1.0;
+
+    return true;
+}
+
+void ProgressiveUpdateScheduler::finishUpdate(std::int64_t elapsedMs)
+{
+    if (!m_updateRunning)
+    {
+        return;
+    }
+
+    m_updateRunning = false;
+
+    // Adapt the preview resolution so that updates keep up with the interaction.
+    if (!m_interactive || !m_runningPreview)
+    {
+        return;
+    }
+
+    if (elapsedMs > m_previewTimeBudget)
+    {
+        m_previewResolution = std::max(m_minPreviewResolution, 0.5 * m_previewResolution);
+    }
+    else if (elapsedMs < m_previewTimeBudget / 4)
+    {
+        m_previewResolution = std::min(1.0, 2.0 * m_previewResolution);
+    }
+}
+
+void ProgressiveUpdateScheduler::reset()
+{
+    m_updatePending = false;
+    m_updateRunning = false;
+}
+
+bool ProgressiveUpdateScheduler::isUpdatePending() const
+{
+    return m_updatePending;
+}
+
+bool ProgressiveUpdateScheduler::isUpdateRunning() const
+{
+    return m_updateRunning;
+}
+
+double ProgressiveUpdateScheduler::previewResolution() const
+{
+    return m_previewResolution;
+}
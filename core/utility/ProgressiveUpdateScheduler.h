@@ -0,0 +1,79 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <core/core_api.h>
+
+
+/**
+ * Scheduling state of progressively computed updates, such as profile previews that follow an
+ * interactively moved line.
+ *
+ * At most one update runs at a time. Updates requested while an update runs are merged, so that
+ * only the latest input state is processed when the running update finished, and all intermediate
+ * states are dropped. During an interaction, updates are computed at a reduced preview resolution
+ * that adapts to keep each update within a time budget. Otherwise, full resolution is used.
+ *
+ * This class only tracks the state; running the updates is up to the caller. It is not thread safe.
+ */
+class CORE_API ProgressiveUpdateScheduler
+{
+public:
+    explicit ProgressiveUpdateScheduler(std::int64_t previewTimeBudgetMs = 30,
+        double minPreviewResolution = 1.0 / 64.0);
+
+    /** Enable decimated previews while an interaction is active. */
+    void setInteractive(bool interactive);
+    bool isInteractive() const;
+
+    /** Record that the input changed and needs to be processed by the next update. */
+    void requestUpdate();
+
+    /**
+     * Start the next update if one was requested and no update is running.
+     * @param resolution is set to the sampling resolution in (0, 1] for the update.
+     * @return true if the caller has to start an update now.
+     */
+    bool startUpdate(double & resolution);
+
+    /**
+     * Notify that the running update finished. Adapts the preview resolution to the time it took.
+     * Calls without a running update (e.g., after reset()) are ignored.
+     */
+    void finishUpdate(std::int64_t elapsedMs);
+
+    /** Drop requested updates and forget about a running one, which the caller waited for. */
+    void reset();
+
+    bool isUpdatePending() const;
+    bool isUpdateRunning() const;
+    double previewResolution() const;
+
+private:
+    const std::int64_t m_previewTimeBudget;
+    const double m_minPreviewResolution;
+
+    bool m_interactive;
+    bool m_updatePending;
+    bool m_updateRunning;
+    bool m_runningPreview;
+    double m_previewResolution;
+};
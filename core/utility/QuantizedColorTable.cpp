@@ -0,0 +1,159 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "QuantizedColorTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkLookupTable.h>
+
+
+const int QuantizedColorTable::NumberOfColors;
+
+
+namespace
+{
+
+const int numColors = QuantizedColorTable::NumberOfColors;
+const int belowRangeIndex = numColors;
+const int aboveRangeIndex = numColors + 1;
+const int nanIndex = numColors + 2;
+
+/** Number of values whose table indices are computed at once, before looking up their colors */
+const int chunkSize = 1024;
+
+template<typename ValueType>
+void mapValues(const ValueType * values, int valueIncrement, vtkIdType count,
+    double minValue, double maxValue, double scale,
+    const uint32_t * colors, unsigned char * rgba)
+{
+    int indices[chunkSize];
+
+    for (vtkIdType chunkBegin = 0; chunkBegin < count; chunkBegin += chunkSize)
+    {
+        const int chunkCount = static_cast<int>(std::min(vtkIdType(chunkSize), count - chunkBegin));
+        const ValueType * chunkValues = values + chunkBegin * valueIncrement;
+
+        // Branch-free index computation, to be vectorized by the compiler.
+        for (int i = 0; i < chunkCount; ++i)
+        {
+            const double value = static_cast<double>(chunkValues[i * valueIncrement]);
+            double f = (value - minValue) * scale;
+            f = f > 0.0 ? f : 0.0;    // also catches NaN
+            f = f < numColors - 1.0 ? f : numColors - 1.0;
+            int index = static_cast<int>(f);
+            index = value < minValue ? belowRangeIndex : index;
+            index = value > maxValue ? aboveRangeIndex : index;
+            index = value != value ? nanIndex : index;
+            indices[i] = index;
+        }
+
+        unsigned char * chunkRGBA = rgba + 4 * chunkBegin;
+        for (int i = 0; i < chunkCount; ++i)
+        {
+            std::memcpy(chunkRGBA + 4 * i, &colors[indices[i]], 4);
+        }
+    }
+}
+
+uint32_t packColor(const unsigned char color[4], double alpha)
+{
+    const unsigned char rgba[4] = {
+        color[0], color[1], color[2],
+        static_cast<unsigned char>(alpha >= 1.0 ? color[3] : color[3] * alpha + 0.5)
+    };
+    uint32_t packed;
+    std::memcpy(&packed, rgba, 4);
+    return packed;
+}
+
+}
+
+
+bool QuantizedColorTable::build(vtkScalarsToColors & lookupTable)
+{
+    m_colors.clear();
+
+    auto lut = vtkLookupTable::SafeDownCast(&lookupTable);
+    if (!lut
+        || lut->GetScale() != VTK_SCALE_LINEAR
+        || lut->GetIndexedLookup())
+    {
+        return false;
+    }
+
+    lut->Build();
+
+    const double minValue = lut->GetRange()[0];
+    const double maxValue = lut->GetRange()[1];
+    if (!(minValue < maxValue) || !std::isfinite(maxValue - minValue))
+    {
+        return false;
+    }
+
+    m_minValue = minValue;
+    m_maxValue = maxValue;
+    m_scale = numColors / (maxValue - minValue);
+
+    const double alpha = lut->GetAlpha();
+    m_colors.resize(static_cast<size_t>(numColors + 3));
+    for (int i = 0; i < numColors; ++i)
+    {
+        // center of the quantization bin
+        const double value = minValue + (i + 0.5) / m_scale;
+        m_colors[static_cast<size_t>(i)] = packColor(lut->MapValue(value), alpha);
+    }
+    m_colors[belowRangeIndex] = packColor(lut->MapValue(std::numeric_limits<double>::lowest()), alpha);
+    m_colors[aboveRangeIndex] = packColor(lut->MapValue(std::numeric_limits<double>::max()), alpha);
+    m_colors[nanIndex] = packColor(lut->MapValue(std::numeric_limits<double>::quiet_NaN()), alpha);
+
+    return true;
+}
+
+bool QuantizedColorTable::isSupported(const vtkDataArray & values)
+{
+    const int dataType = values.GetDataType();
+    return dataType == VTK_FLOAT || dataType == VTK_DOUBLE;
+}
+
+void QuantizedColorTable::map(vtkDataArray & values, int component,
+    vtkIdType firstTuple, vtkIdType numTuples, unsigned char * rgba) const
+{
+    assert(!m_colors.empty() && isSupported(values));
+    assert(component >= 0 && component < values.GetNumberOfComponents());
+
+    const int numComponents = values.GetNumberOfComponents();
+    const vtkIdType valueIndex = firstTuple * numComponents + component;
+
+    if (auto floats = vtkFloatArray::FastDownCast(&values))
+    {
+        mapValues(floats->GetPointer(valueIndex), numComponents, numTuples,
+            m_minValue, m_maxValue, m_scale, m_colors.data(), rgba);
+    }
+    else
+    {
+        mapValues(static_cast<vtkDoubleArray &>(values).GetPointer(valueIndex), numComponents, numTuples,
+            m_minValue, m_maxValue, m_scale, m_colors.data(), rgba);
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vtkType.h>
+
+#include <core/core_api.h>
+
+
+class vtkDataArray;
+class vtkScalarsToColors;
+
+
+/**
+ * Colors of a linear vtkLookupTable, precomputed for a fixed number of quantization bins.
+ *
+ * Mapping float/double values via this table is considerably faster than passing them through the
+ * generic vtkScalarsToColors implementation, e.g., for large images or point clouds while
+ * interactively changing the value range of the color mapping. The table uses more colors than
+ * typical lookup tables, so that results only differ for values very close to the boundaries of
+ * table entries. Values below/above the range and NaNs are mapped to the respective colors of the
+ * lookup table.
+ */
+class CORE_API QuantizedColorTable
+{
+public:
+    static const int NumberOfColors = 4096;
+
+    /**
+     * Build the table for the current state of the lookup table.
+     * @return whether the lookup table is supported: a vtkLookupTable with linear scale, no indexed
+     *  lookup and a finite value range. Otherwise, the table must not be used for mapping.
+     */
+    bool build(vtkScalarsToColors & lookupTable);
+
+    /** @return whether values of the array can be mapped via the table, i.e., float or double values */
+    static bool isSupported(const vtkDataArray & values);
+
+    /**
+     * Map the component of numTuples tuples, starting at firstTuple, to RGBA colors.
+     * The table must be built and the values must be supported. rgba must provide 4 * numTuples values.
+     */
+    void map(vtkDataArray & values, int component, vtkIdType firstTuple, vtkIdType numTuples,
+        unsigned char * rgba) const;
+
+private:
+    double m_minValue = 0.0;
+    double m_maxValue = 0.0;
+    double m_scale = 0.0;
+    /** RGBA colors in table range, followed by the below range, above range and NaN colors */
+    std::vector<uint32_t> m_colors;
+};
@@ -0,0 +1,391 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ScalarHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+
+namespace
+{
+
+/** sign bit + 8 exponent bits + 6 mantissa bits of IEEE 754 single precision values */
+const int numCoarseKeyBits = 15;
+/** Additional mantissa bits per coarse bin */
+const int numFineKeyBits = 8;
+const int keyShift = 32 - numCoarseKeyBits - numFineKeyBits;
+const size_t numFineBins = size_t(1) << numFineKeyBits;
+const uint32_t fineKeyMask = static_cast<uint32_t>(numFineBins - 1u);
+/** 1024 refined coarse bins take 2 MiB */
+const size_t maxNumRefinedBins = 1024;
+
+/** Map floats to unsigned integers with the same ordering. */
+uint32_t orderedBits(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+float fromOrderedBits(uint32_t ordered)
+{
+    const uint32_t bits = (ordered & 0x80000000u) ? (ordered & 0x7FFFFFFFu) : ~ordered;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/** Coarse and fine bin index combined */
+uint32_t binKey(double value)
+{
+    return orderedBits(static_cast<float>(value)) >> keyShift;
+}
+
+double binLowerBound(uint32_t key)
+{
+    return static_cast<double>(fromOrderedBits(key << keyShift));
+}
+
+double binUpperBound(uint32_t key)
+{
+    const uint32_t lowBits = (uint32_t(1) << keyShift) - 1u;
+    return static_cast<double>(fromOrderedBits((key << keyShift) | lowBits));
+}
+
+}
+
+
+ScalarHistogram::Accumulator::Accumulator()
+    : m_count{ 0 }
+    , m_min{ std::numeric_limits<double>::max() }
+    , m_max{ std::numeric_limits<double>::lowest() }
+    , m_bins{}
+    , m_coarseBins{}
+    , m_lastCoarseKey{ 0u }
+    , m_lastFineBins{ nullptr }
+{
+}
+
+ScalarHistogram::Accumulator::Accumulator(const Accumulator & other)
+    : m_count{ other.m_count }
+    , m_min{ other.m_min }
+    , m_max{ other.m_max }
+    , m_bins{ other.m_bins }
+    , m_coarseBins{ other.m_coarseBins }
+    , m_lastCoarseKey{ 0u }
+    , m_lastFineBins{ nullptr }
+{
+}
+
+ScalarHistogram::Accumulator & ScalarHistogram::Accumulator::operator=(const Accumulator & other)
+{
+    m_count = other.m_count;
+    m_min = other.m_min;
+    m_max = other.m_max;
+    m_bins = other.m_bins;
+    m_coarseBins = other.m_coarseBins;
+    // Don't point into the bins of the other accumulator.
+    m_lastCoarseKey = 0u;
+    m_lastFineBins = nullptr;
+
+    return *this;
+}
+
+void ScalarHistogram::Accumulator::add(double value)
+{
+    if (!std::isfinite(value))
+    {
+        return;
+    }
+
+    ++m_count;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+
+    const auto key = binKey(value);
+    const auto coarseKey = key >> numFineKeyBits;
+    if (!m_lastFineBins || coarseKey != m_lastCoarseKey)
+    {
+        auto it = m_bins.find(coarseKey);
+        if (it == m_bins.end())
+        {
+            if (m_bins.size() >= maxNumRefinedBins)
+            {
+                ++m_coarseBins[coarseKey];
+                return;
+            }
+            it = m_bins.emplace(coarseKey, FineBins(numFineBins, 0)).first;
+        }
+        m_lastCoarseKey = coarseKey;
+        m_lastFineBins = &it->second;
+    }
+
+    ++(*m_lastFineBins)[key & fineKeyMask];
+}
+
+void ScalarHistogram::Accumulator::merge(const Accumulator & other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+
+    // Erasing refined bins below invalidates the cached bin.
+    m_lastFineBins = nullptr;
+
+    const auto sum = [] (const FineBins & fineBins)
+    {
+        return std::accumulate(fineBins.begin(), fineBins.end(), vtkIdType(0));
+    };
+
+    for (const auto & otherBins : other.m_bins)
+    {
+        auto it = m_bins.find(otherBins.first);
+        if (it != m_bins.end())
+        {
+            for (size_t i = 0; i < numFineBins; ++i)
+            {
+                it->second[i] += otherBins.second[i];
+            }
+        }
+        else if (m_bins.size() < maxNumRefinedBins && !m_coarseBins.count(otherBins.first))
+        {
+            m_bins.emplace(otherBins.first, otherBins.second);
+        }
+        else
+        {
+            m_coarseBins[otherBins.first] += sum(otherBins.second);
+        }
+    }
+
+    for (const auto & otherBin : other.m_coarseBins)
+    {
+        auto & coarseCount = m_coarseBins[otherBin.first];
+        coarseCount += otherBin.second;
+
+        // Bins that are not refined in the other accumulator cannot be refined here either.
+        auto it = m_bins.find(otherBin.first);
+        if (it != m_bins.end())
+        {
+            coarseCount += sum(it->second);
+            m_bins.erase(it);
+        }
+    }
+}
+
+
+ScalarHistogram::ScalarHistogram()
+    : m_count{ 0 }
+    , m_min{ std::numeric_limits<double>::max() }
+    , m_max{ std::numeric_limits<double>::lowest() }
+    , m_bins{}
+{
+}
+
+ScalarHistogram::ScalarHistogram(const Accumulator & accumulator)
+    : m_count{ accumulator.m_count }
+    , m_min{ accumulator.m_min }
+    , m_max{ accumulator.m_max }
+    , m_bins{}
+{
+    for (const auto & fineBins : accumulator.m_bins)
+    {
+        const auto keyOffset = fineBins.first << numFineKeyBits;
+        for (size_t i = 0; i < numFineBins; ++i)
+        {
+            if (fineBins.second[i] > 0)
+            {
+                const auto key = keyOffset | static_cast<uint32_t>(i);
+                m_bins.push_back({ key, key, fineBins.second[i] });
+            }
+        }
+    }
+
+    for (const auto & coarseBin : accumulator.m_coarseBins)
+    {
+        const auto keyOffset = coarseBin.first << numFineKeyBits;
+        m_bins.push_back({ keyOffset, keyOffset | fineKeyMask, coarseBin.second });
+    }
+
+    std::sort(m_bins.begin(), m_bins.end(), [] (const Bin & lhs, const Bin & rhs)
+    {
+        return lhs.firstKey < rhs.firstKey;
+    });
+}
+
+void ScalarHistogram::add(const ScalarHistogram & other)
+{
+    if (other.isEmpty())
+    {
+        return;
+    }
+
+    m_count += other.m_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+
+    // Merge the sorted bins. Equal bins, and fine bins within a coarse bin of the other histogram,
+    // are combined.
+    decltype(m_bins) merged;
+    merged.reserve(m_bins.size() + other.m_bins.size());
+    const auto append = [&merged] (const Bin & bin)
+    {
+        if (!merged.empty() && bin.firstKey <= merged.back().lastKey)
+        {
+            merged.back().lastKey = std::max(merged.back().lastKey, bin.lastKey);
+            merged.back().count += bin.count;
+            return;
+        }
+        merged.push_back(bin);
+    };
+
+    auto it = m_bins.begin();
+    auto otherIt = other.m_bins.begin();
+    while (it != m_bins.end() || otherIt != other.m_bins.end())
+    {
+        if (otherIt == other.m_bins.end()
+            || (it != m_bins.end() && it->firstKey <= otherIt->firstKey))
+        {
+            append(*it++);
+        }
+        else
+        {
+            append(*otherIt++);
+        }
+    }
+
+    m_bins = std::move(merged);
+}
+
+bool ScalarHistogram::isEmpty() const
+{
+    return m_count == 0;
+}
+
+vtkIdType ScalarHistogram::count() const
+{
+    return m_count;
+}
+
+double ScalarHistogram::minValue() const
+{
+    return isEmpty() ? std::numeric_limits<double>::quiet_NaN() : m_min;
+}
+
+double ScalarHistogram::maxValue() const
+{
+    return isEmpty() ? std::numeric_limits<double>::quiet_NaN() : m_max;
+}
+
+double ScalarHistogram::percentile(double percent) const
+{
+    if (isEmpty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (percent <= 0.0)
+    {
+        return m_min;
+    }
+    if (percent >= 100.0)
+    {
+        return m_max;
+    }
+
+    const auto rank = percent * 0.01 * static_cast<double>(m_count - 1);
+
+    vtkIdType cumulative = 0;
+    for (const auto & bin : m_bins)
+    {
+        if (static_cast<double>(cumulative + bin.count) <= rank)
+        {
+            cumulative += bin.count;
+            continue;
+        }
+
+        // Assume uniformly distributed values within the bin.
+        const auto upper = std::min(m_max, binUpperBound(bin.lastKey));
+        const auto lower = std::min(upper, std::max(m_min, binLowerBound(bin.firstKey)));
+        const auto t = (rank - static_cast<double>(cumulative) + 0.5) / static_cast<double>(bin.count);
+        return lower + (upper - lower) * std::min(1.0, std::max(0.0, t));
+    }
+
+    return m_max;
+}
+
+std::vector<vtkIdType> ScalarHistogram::histogram(int numBins, double lower, double upper) const
+{
+    if (numBins <= 0)
+    {
+        return{};
+    }
+
+    std::vector<vtkIdType> result(static_cast<size_t>(numBins), 0);
+    if (isEmpty() || !(lower <= upper))
+    {
+        return result;
+    }
+
+    const auto range = upper - lower;
+    const auto scale = range > 0.0 ? static_cast<double>(numBins) / range : 0.0;
+
+    for (const auto & bin : m_bins)
+    {
+        const auto binUpper = std::min(m_max, binUpperBound(bin.lastKey));
+        const auto binLower = std::min(binUpper, std::max(m_min, binLowerBound(bin.firstKey)));
+        const auto center = 0.5 * (binLower + binUpper);
+        if (center < lower || center > upper)
+        {
+            continue;
+        }
+        const auto target = static_cast<int>((center - lower) * scale);
+        result[static_cast<size_t>(std::min(numBins - 1, std::max(0, target)))] += bin.count;
+    }
+
+    return result;
+}
+
+std::vector<vtkIdType> ScalarHistogram::histogram(int numBins) const
+{
+    return histogram(numBins, m_min, m_max);
+}
+
+double ScalarHistogram::relativeBinWidth()
+{
+    // Number of mantissa bits used for the bins
+    return std::ldexp(1.0, -(numCoarseKeyBits + numFineKeyBits - 9));
+}
+
+double ScalarHistogram::coarseRelativeBinWidth()
+{
+    return std::ldexp(1.0, -(numCoarseKeyBits - 9));
+}
+
+size_t ScalarHistogram::maxRefinedBins()
+{
+    return maxNumRefinedBins;
+}
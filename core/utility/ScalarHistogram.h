@@ -0,0 +1,131 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <vtkType.h>
+
+#include <core/core_api.h>
+
+
+/**
+ * Approximated distribution of scalar values, built without knowing the value range in advance.
+ *
+ * Values are binned in two levels in the floating point domain. The coarse level is defined by the
+ * sign, the exponent and the upper 6 bits of the mantissa of a value.
+ * Occupied coarse bins are refined by the next 8 bits of the mantissa, so that percentiles have
+ * a relative error below relativeBinWidth() even for data with a narrow value range.
+ *
+ * To bound the memory per accumulator (about 2 MiB), at most maxRefinedBins() coarse bins are
+ * refined. Values in further coarse bins, which only occur for data spanning many orders of
+ * magnitude, are counted in the coarse bins only. For these, the relative error is below
+ * coarseRelativeBinWidth().
+ *
+ * Accumulators are meant to be used per thread, e.g., with vtkSMPThreadLocal, in a loop that
+ * already iterates over the data. The merged histogram only stores occupied bins. Percentiles and
+ * histograms with arbitrary bins are derived from it without accessing the data again.
+ * Non-finite values are ignored.
+ */
+class CORE_API ScalarHistogram
+{
+public:
+    class CORE_API Accumulator
+    {
+    public:
+        Accumulator();
+        Accumulator(const Accumulator & other);
+        Accumulator & operator=(const Accumulator & other);
+
+        void add(double value);
+        void merge(const Accumulator & other);
+
+    private:
+        friend class ScalarHistogram;
+
+        using FineBins = std::vector<vtkIdType>;
+
+        vtkIdType m_count;
+        double m_min;
+        double m_max;
+        /** Fine bins per refined coarse bin */
+        std::unordered_map<uint32_t, FineBins> m_bins;
+        /** Counts of coarse bins that are not refined */
+        std::unordered_map<uint32_t, vtkIdType> m_coarseBins;
+        /** Values are often spatially coherent: cache the last used coarse bin. */
+        uint32_t m_lastCoarseKey;
+        FineBins * m_lastFineBins;
+    };
+
+    ScalarHistogram();
+    explicit ScalarHistogram(const Accumulator & accumulator);
+
+    /** Collect the values of all accumulators, e.g., of all threads. */
+    template<typename AccumulatorIterator>
+    static ScalarHistogram merge(AccumulatorIterator begin, AccumulatorIterator end);
+    /** Add the values of another histogram, e.g., of another data array. */
+    void add(const ScalarHistogram & other);
+
+    bool isEmpty() const;
+    /** Number of finite values */
+    vtkIdType count() const;
+    double minValue() const;
+    double maxValue() const;
+
+    /**
+     * Approximated percentile, with percent in [0, 100].
+     * @return NaN if there are no values.
+     */
+    double percentile(double percent) const;
+
+    /**
+     * Histogram with numBins equally sized bins in [lower, upper], e.g., to be displayed along a
+     * color legend. Values outside of this range are not counted.
+     */
+    std::vector<vtkIdType> histogram(int numBins, double lower, double upper) const;
+    /** Histogram with numBins equally sized bins in [minValue(), maxValue()] */
+    std::vector<vtkIdType> histogram(int numBins) const;
+
+    /** Upper bound of the relative error of percentiles/histogram bin assignments */
+    static double relativeBinWidth();
+    /** Relative error bound for values in coarse bins that are not refined */
+    static double coarseRelativeBinWidth();
+    /** Maximal number of refined coarse bins per accumulator */
+    static size_t maxRefinedBins();
+
+private:
+    /** Range of fine bin keys: a single fine bin, or all fine bins of a coarse bin */
+    struct Bin
+    {
+        uint32_t firstKey;
+        uint32_t lastKey;
+        vtkIdType count;
+    };
+
+    vtkIdType m_count;
+    double m_min;
+    double m_max;
+    /** Occupied, disjoint bins, sorted by key */
+    std::vector<Bin> m_bins;
+};
+
+
+#include "ScalarHistogram.hpp"
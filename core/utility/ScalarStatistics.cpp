@@ -0,0 +1,144 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ScalarStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+ScalarStatistics::Accumulator::Accumulator()
+    : m_count{ 0 }
+    , m_sum{ 0.0 }
+    , m_sumOfSquares{ 0.0 }
+    , m_min{ std::numeric_limits<double>::max() }
+    , m_max{ std::numeric_limits<double>::lowest() }
+    , m_histogram{}
+{
+}
+
+void ScalarStatistics::Accumulator::add(double value)
+{
+    if (!std::isfinite(value))
+    {
+        return;
+    }
+
+    ++m_count;
+    m_sum += value;
+    m_sumOfSquares += value * value;
+    m_min = std::min(m_min, value);
+    m_max = std::max(m_max, value);
+    m_histogram.add(value);
+}
+
+void ScalarStatistics::Accumulator::merge(const Accumulator & other)
+{
+    if (other.m_count == 0)
+    {
+        return;
+    }
+
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_sumOfSquares += other.m_sumOfSquares;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_histogram.merge(other.m_histogram);
+}
+
+
+ScalarStatistics::ScalarStatistics()
+    : m_data{}
+    , m_histogram{}
+{
+}
+
+ScalarStatistics::ScalarStatistics(const Accumulator & accumulator)
+    : m_data{ accumulator }
+    , m_histogram{ accumulator.m_histogram }
+{
+}
+
+bool ScalarStatistics::isValid() const
+{
+    return m_data.m_count > 0;
+}
+
+vtkIdType ScalarStatistics::count() const
+{
+    return m_data.m_count;
+}
+
+double ScalarStatistics::minValue() const
+{
+    return isValid() ? m_data.m_min : std::numeric_limits<double>::quiet_NaN();
+}
+
+double ScalarStatistics::maxValue() const
+{
+    return isValid() ? m_data.m_max : std::numeric_limits<double>::quiet_NaN();
+}
+
+double ScalarStatistics::mean() const
+{
+    return isValid()
+        ? m_data.m_sum / static_cast<double>(m_data.m_count)
+        : std::numeric_limits<double>::quiet_NaN();
+}
+
+double ScalarStatistics::rootMeanSquare() const
+{
+    return isValid()
+        ? std::sqrt(m_data.m_sumOfSquares / static_cast<double>(m_data.m_count))
+        : std::numeric_limits<double>::quiet_NaN();
+}
+
+double ScalarStatistics::standardDeviation() const
+{
+    if (!isValid())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const auto m = mean();
+    const auto variance = m_data.m_sumOfSquares / static_cast<double>(m_data.m_count) - m * m;
+    return std::sqrt(std::max(0.0, variance));
+}
+
+double ScalarStatistics::percentile(double percent) const
+{
+    return m_histogram.percentile(percent);
+}
+
+double ScalarStatistics::median() const
+{
+    return percentile(50.0);
+}
+
+std::vector<vtkIdType> ScalarStatistics::histogram(int numBins) const
+{
+    return m_histogram.histogram(numBins);
+}
+
+double ScalarStatistics::relativeBinWidth()
+{
+    return ScalarHistogram::relativeBinWidth();
+}
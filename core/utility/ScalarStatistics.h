@@ -0,0 +1,104 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <vtkType.h>
+
+#include <core/core_api.h>
+#include <core/utility/ScalarHistogram.h>
+
+
+/**
+ * Summary statistics and an approximated value distribution of a set of scalar values.
+ *
+ * Values are collected by Accumulator instances that can be used per thread, e.g., with
+ * vtkSMPThreadLocal, in the same loop that produces the values. Accumulators are merged into a
+ * ScalarStatistics object afterwards, so that no additional pass over the data is required.
+ *
+ * Besides count, min, max, mean and RMS, each accumulator builds a ScalarHistogram, which does
+ * not require knowing the value range in advance. Percentiles (including the median) derived from
+ * this histogram have a relative error below relativeBinWidth(). Non-finite values are ignored.
+ */
+class CORE_API ScalarStatistics
+{
+public:
+    class CORE_API Accumulator
+    {
+    public:
+        Accumulator();
+
+        void add(double value);
+        void merge(const Accumulator & other);
+
+    private:
+        friend class ScalarStatistics;
+
+        vtkIdType m_count;
+        double m_sum;
+        double m_sumOfSquares;
+        double m_min;
+        double m_max;
+        ScalarHistogram::Accumulator m_histogram;
+    };
+
+    ScalarStatistics();
+    explicit ScalarStatistics(const Accumulator & accumulator);
+
+    /** Collect the statistics of all accumulators, e.g., of all threads. */
+    template<typename AccumulatorIterator>
+    static ScalarStatistics merge(AccumulatorIterator begin, AccumulatorIterator end);
+
+    bool isValid() const;
+
+    /** Number of finite values */
+    vtkIdType count() const;
+    double minValue() const;
+    double maxValue() const;
+    double mean() const;
+    double rootMeanSquare() const;
+    double standardDeviation() const;
+
+    /**
+     * Approximated percentile, with percent in [0, 100].
+     * @return NaN if there are no values.
+     */
+    double percentile(double percent) const;
+    /** Approximated median, same as percentile(50) */
+    double median() const;
+
+    /**
+     * Histogram with numBins equally sized bins in [minValue(), maxValue()].
+     * The histogram is derived from the value distribution, so that bin assignments are subject to
+     * the same approximation as the percentiles.
+     */
+    std::vector<vtkIdType> histogram(int numBins) const;
+
+    /** Upper bound of the relative error of percentiles/histogram bin assignments */
+    static double relativeBinWidth();
+
+private:
+    Accumulator m_data;
+    ScalarHistogram m_histogram;
+};
+
+
+#include "ScalarStatistics.hpp"
@@ -0,0 +1,391 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "UniformGridIndex2D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <vtkArrayDispatch.h>
+#include <vtkAssume.h>
+#include <vtkDataArray.h>
+#include <vtkDataArrayAccessor.h>
+#include <vtkSMPTools.h>
+
+#include <core/utility/vtkvectorhelper.h>
+
+
+namespace
+{
+
+/** Average number of entries per bin that the grid is sized for. */
+const vtkIdType entriesPerBin = 4;
+const vtkIdType maxNumBins = vtkIdType(1) << 24;
+
+struct PointBinsWorker
+{
+    vtkVector2d origin;
+    vtkVector2d binSizeInv;
+    vtkVector2i numBins;
+    std::vector<vtkIdType> & bins;
+
+    template <typename CoordinateArray>
+    void operator()(CoordinateArray * coordinates)
+    {
+        VTK_ASSUME(coordinates->GetNumberOfComponents() == 3);
+
+        const auto o = this->origin;
+        const auto s = this->binSizeInv;
+        const auto n = this->numBins;
+        auto & b = this->bins;
+
+        vtkSMPTools::For(0, coordinates->GetNumberOfTuples(),
+            [coordinates, o, s, n, &b] (vtkIdType begin, vtkIdType end)
+        {
+            vtkDataArrayAccessor<CoordinateArray> c(coordinates);
+            const auto toBin = [] (double f, int numBins)
+            {
+                // also handles NaN
+                return !(f >= 0.0) ? 0 : f >= numBins ? numBins - 1 : static_cast<int>(f);
+            };
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto x = toBin((static_cast<double>(c.Get(i, 0)) - o[0]) * s[0], n[0]);
+                const auto y = toBin((static_cast<double>(c.Get(i, 1)) - o[1]) * s[1], n[1]);
+                b[static_cast<size_t>(i)] = static_cast<vtkIdType>(y) * n[0] + x;
+            }
+        });
+    }
+};
+
+}
+
+
+UniformGridIndex2D::UniformGridIndex2D()
+    : m_origin{ 0.0, 0.0 }
+    , m_binSize{ 1.0, 1.0 }
+    , m_numBins{ 0, 0 }
+    , m_numEntries{ 0 }
+    , m_maxBoxSize{ 0.0, 0.0 }
+{
+}
+
+void UniformGridIndex2D::clear()
+{
+    m_numBins = { 0, 0 };
+    m_numEntries = 0;
+    m_maxBoxSize = { 0.0, 0.0 };
+    m_binOffsets = {};
+    m_ids = {};
+}
+
+bool UniformGridIndex2D::isEmpty() const
+{
+    return m_ids.empty();
+}
+
+vtkIdType UniformGridIndex2D::numberOfEntries() const
+{
+    return m_numEntries;
+}
+
+const vtkVector2d & UniformGridIndex2D::maximumBoxSize() const
+{
+    return m_maxBoxSize;
+}
+
+void UniformGridIndex2D::setupGrid(const double xRange[2], const double yRange[2], vtkIdType numEntries,
+    const vtkVector2d & minBinSize)
+{
+    const auto numBins = std::max(vtkIdType(1), std::min(maxNumBins, numEntries / entriesPerBin));
+    const double width = xRange[1] - xRange[0];
+    const double height = yRange[1] - yRange[0];
+
+    vtkIdType numX = 1, numY = 1;
+    if (width > 0.0 && height > 0.0)
+    {
+        numX = std::max(vtkIdType(1), static_cast<vtkIdType>(
+            std::ceil(std::sqrt(static_cast<double>(numBins) * width / height))));
+        numX = std::min(numX, numBins);
+        numY = std::max(vtkIdType(1), numBins / numX);
+    }
+    else if (width > 0.0)
+    {
+        numX = numBins;
+    }
+    else if (height > 0.0)
+    {
+        numY = numBins;
+    }
+
+    // Bins smaller than the indexed boxes would store most boxes multiple times.
+    if (minBinSize[0] > 0.0)
+    {
+        numX = std::min(numX, std::max(vtkIdType(1), static_cast<vtkIdType>(width / minBinSize[0])));
+    }
+    if (minBinSize[1] > 0.0)
+    {
+        numY = std::min(numY, std::max(vtkIdType(1), static_cast<vtkIdType>(height / minBinSize[1])));
+    }
+
+    m_origin = { xRange[0], yRange[0] };
+    m_numBins = { static_cast<int>(numX), static_cast<int>(numY) };
+    m_binSize = {
+        width > 0.0 ? width / static_cast<double>(numX) : 1.0,
+        height > 0.0 ? height / static_cast<double>(numY) : 1.0 };
+}
+
+void UniformGridIndex2D::buildForPoints(vtkDataArray & coordinates)
+{
+    clear();
+
+    const auto numPoints = coordinates.GetNumberOfTuples();
+    if (numPoints == 0 || coordinates.GetNumberOfComponents() != 3)
+    {
+        return;
+    }
+
+    double xRange[2], yRange[2];
+    coordinates.GetRange(xRange, 0);
+    coordinates.GetRange(yRange, 1);
+    if (!std::isfinite(xRange[0]) || !std::isfinite(xRange[1])
+        || !std::isfinite(yRange[0]) || !std::isfinite(yRange[1]))
+    {
+        xRange[0] = xRange[1] = yRange[0] = yRange[1] = 0.0;
+    }
+
+    setupGrid(xRange, yRange, numPoints);
+
+    std::vector<vtkIdType> pointBins(static_cast<size_t>(numPoints));
+    PointBinsWorker worker{ m_origin,
+        { 1.0 / m_binSize[0], 1.0 / m_binSize[1] },
+        m_numBins,
+        pointBins };
+    if (!vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>::Execute(&coordinates, worker))
+    {
+        worker(&coordinates);
+    }
+
+    // counting sort of the point ids by their bins
+    const auto numBins = static_cast<size_t>(m_numBins[0]) * static_cast<size_t>(m_numBins[1]);
+    m_binOffsets.assign(numBins + 1u, 0);
+    for (const auto bin : pointBins)
+    {
+        ++m_binOffsets[static_cast<size_t>(bin) + 1u];
+    }
+    for (size_t i = 1; i <= numBins; ++i)
+    {
+        m_binOffsets[i] += m_binOffsets[i - 1];
+    }
+
+    m_ids.resize(static_cast<size_t>(numPoints));
+    std::vector<vtkIdType> insertPositions(m_binOffsets.begin(), m_binOffsets.end() - 1);
+    for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+        m_ids[static_cast<size_t>(insertPositions[static_cast<size_t>(pointBins[static_cast<size_t>(i)])]++)] = i;
+    }
+
+    m_numEntries = numPoints;
+}
+
+void UniformGridIndex2D::buildForBoxes(const std::vector<double> & bounds)
+{
+    clear();
+
+    const auto numBoxes = static_cast<vtkIdType>(bounds.size() / 4u);
+    if (numBoxes == 0)
+    {
+        return;
+    }
+
+    double xRange[2] = { std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+    double yRange[2] = { xRange[0], xRange[1] };
+    vtkVector2d boxSizeSum{ 0.0, 0.0 };
+    vtkIdType numValidBoxes = 0;
+    for (vtkIdType i = 0; i < numBoxes; ++i)
+    {
+        const double * box = &bounds[static_cast<size_t>(4 * i)];
+        if (!std::isfinite(box[0]) || !std::isfinite(box[1])
+            || !std::isfinite(box[2]) || !std::isfinite(box[3]))
+        {
+            continue;
+        }
+        xRange[0] = std::min(xRange[0], box[0]);
+        xRange[1] = std::max(xRange[1], box[1]);
+        yRange[0] = std::min(yRange[0], box[2]);
+        yRange[1] = std::max(yRange[1], box[3]);
+        boxSizeSum[0] += box[1] - box[0];
+        boxSizeSum[1] += box[3] - box[2];
+        m_maxBoxSize[0] = std::max(m_maxBoxSize[0], box[1] - box[0]);
+        m_maxBoxSize[1] = std::max(m_maxBoxSize[1], box[3] - box[2]);
+        ++numValidBoxes;
+    }
+    if (numValidBoxes == 0)
+    {
+        xRange[0] = xRange[1] = yRange[0] = yRange[1] = 0.0;
+    }
+
+    const auto meanBoxSize = numValidBoxes == 0 ? vtkVector2d(0.0, 0.0) : vtkVector2d(
+        boxSizeSum[0] / static_cast<double>(numValidBoxes),
+        boxSizeSum[1] / static_cast<double>(numValidBoxes));
+    setupGrid(xRange, yRange, numBoxes, meanBoxSize);
+
+    // column and row ranges of the bins overlapped by each box
+    std::vector<vtkVector4i> binRanges(static_cast<size_t>(numBoxes));
+    vtkSMPTools::For(0, numBoxes, [this, &bounds, &binRanges] (vtkIdType begin, vtkIdType end)
+    {
+        for (auto i = begin; i < end; ++i)
+        {
+            const double * box = &bounds[static_cast<size_t>(4 * i)];
+            const auto lower = binIndex({ box[0], box[2] });
+            const auto upper = binIndex({ box[1], box[3] });
+            binRanges[static_cast<size_t>(i)] = { lower[0], upper[0], lower[1], upper[1] };
+        }
+    });
+
+    // counting sort of the box ids by all of their bins
+    const auto numBins = static_cast<size_t>(m_numBins[0]) * static_cast<size_t>(m_numBins[1]);
+    const auto forEachBin = [this] (const vtkVector4i & range, const auto & function)
+    {
+        for (int y = range[2]; y <= range[3]; ++y)
+        {
+            const auto rowStart = static_cast<size_t>(y) * static_cast<size_t>(m_numBins[0]);
+            for (int x = range[0]; x <= range[1]; ++x)
+            {
+                function(rowStart + static_cast<size_t>(x));
+            }
+        }
+    };
+
+    m_binOffsets.assign(numBins + 1u, 0);
+    for (const auto & range : binRanges)
+    {
+        forEachBin(range, [this] (size_t bin) { ++m_binOffsets[bin + 1u]; });
+    }
+    for (size_t i = 1; i <= numBins; ++i)
+    {
+        m_binOffsets[i] += m_binOffsets[i - 1];
+    }
+
+    m_ids.resize(static_cast<size_t>(m_binOffsets.back()));
+    std::vector<vtkIdType> insertPositions(m_binOffsets.begin(), m_binOffsets.end() - 1);
+    for (vtkIdType i = 0; i < numBoxes; ++i)
+    {
+        forEachBin(binRanges[static_cast<size_t>(i)], [this, &insertPositions, i] (size_t bin)
+        {
+            m_ids[static_cast<size_t>(insertPositions[bin]++)] = i;
+        });
+    }
+
+    m_numEntries = numBoxes;
+}
+
+vtkVector2i UniformGridIndex2D::binIndex(const vtkVector2d & position) const
+{
+    vtkVector2i index;
+    for (int i = 0; i < 2; ++i)
+    {
+        const auto f = (position[i] - m_origin[i]) / m_binSize[i];
+        index[i] = !(f >= 0.0) ? 0 : f >= m_numBins[i] ? m_numBins[i] - 1 : static_cast<int>(f);
+    }
+    return index;
+}
+
+vtkIdType UniformGridIndex2D::queryCorridor(const vtkVector2d & A, const vtkVector2d & B,
+    double halfWidth, std::vector<vtkIdType> & ids) const
+{
+    if (isEmpty())
+    {
+        return 0;
+    }
+
+    // Corners of the corridor rectangle, slightly enlarged to be robust against round-off.
+    const auto AB = B - A;
+    const auto length = AB.Norm();
+    const auto margin = 1.e-6 * std::max(length, halfWidth);
+    const auto direction = length > 0.0 ? vtkVector2d(AB[0] / length, AB[1] / length) : vtkVector2d(1.0, 0.0);
+    const auto along = vtkVector2d(direction[0] * margin, direction[1] * margin);
+    const auto w = halfWidth + margin;
+    const auto normal = vtkVector2d(-direction[1] * w, direction[0] * w);
+
+    const vtkVector<double, 2> corners[4] = {
+        A - along + normal,
+        B + along + normal,
+        B + along - normal,
+        A - along - normal
+    };
+
+    double yMin = corners[0][1], yMax = corners[0][1];
+    for (const auto & c : corners)
+    {
+        yMin = std::min(yMin, c[1]);
+        yMax = std::max(yMax, c[1]);
+    }
+
+    const auto firstRow = binIndex({ m_origin[0], yMin })[1];
+    const auto lastRow = binIndex({ m_origin[0], yMax })[1];
+
+    const auto numIdsBefore = ids.size();
+
+    for (int row = firstRow; row <= lastRow; ++row)
+    {
+        // Horizontal extent of the corridor within the row. The outer rows also contain entries
+        // beyond the grid bounds.
+        const double y0 = row == 0 ? -std::numeric_limits<double>::infinity()
+            : m_origin[1] + row * m_binSize[1];
+        const double y1 = row == m_numBins[1] - 1 ? std::numeric_limits<double>::infinity()
+            : m_origin[1] + (row + 1) * m_binSize[1];
+
+        double xMin = std::numeric_limits<double>::infinity();
+        double xMax = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto & p = corners[i];
+            const auto & q = corners[(i + 1) % 4];
+            if (p[1] >= y0 && p[1] <= y1)
+            {
+                xMin = std::min(xMin, p[0]);
+                xMax = std::max(xMax, p[0]);
+            }
+            for (const double y : { y0, y1 })
+            {
+                if ((p[1] - y) * (q[1] - y) < 0.0)
+                {
+                    const auto x = p[0] + (y - p[1]) * (q[0] - p[0]) / (q[1] - p[1]);
+                    xMin = std::min(xMin, x);
+                    xMax = std::max(xMax, x);
+                }
+            }
+        }
+        if (xMin > xMax)
+        {
+            continue;
+        }
+
+        const auto firstColumn = binIndex({ xMin, m_origin[1] })[0];
+        const auto lastColumn = binIndex({ xMax, m_origin[1] })[0];
+        const auto rowStart = static_cast<size_t>(row) * static_cast<size_t>(m_numBins[0]);
+
+        ids.insert(ids.end(),
+            m_ids.begin() + m_binOffsets[rowStart + static_cast<size_t>(firstColumn)],
+            m_ids.begin() + m_binOffsets[rowStart + static_cast<size_t>(lastColumn) + 1u]);
+    }
+
+    return static_cast<vtkIdType>(ids.size() - numIdsBefore);
+}
@@ -0,0 +1,86 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <vtkType.h>
+#include <vtkVector.h>
+
+#include <core/core_api.h>
+
+
+class vtkDataArray;
+
+
+/**
+ * Uniform grid of bins over XY coordinates, for spatial queries on large point sets or meshes.
+ *
+ * Entry ids are stored bin by bin in a single array (counting sort), in ascending order within
+ * each bin. The grid is sized for a few entries per bin on average. Bounding boxes (e.g., of cells)
+ * are stored in every bin that they overlap.
+ * The index is built once, queries only visit the bins that overlap the queried region.
+ */
+class CORE_API UniformGridIndex2D
+{
+public:
+    UniformGridIndex2D();
+
+    /**
+     * Build the index for the XY coordinates of points.
+     * @param coordinates array of 3-component point coordinates, e.g., vtkPoints::GetData()
+     */
+    void buildForPoints(vtkDataArray & coordinates);
+    /**
+     * Build the index for XY bounding boxes.
+     * @param bounds (xMin, xMax, yMin, yMax) for each box, e.g., from vtkDataSet::GetCellBounds
+     */
+    void buildForBoxes(const std::vector<double> & bounds);
+    void clear();
+
+    bool isEmpty() const;
+    vtkIdType numberOfEntries() const;
+    /** Largest width and height of the indexed boxes, zero for points. */
+    const vtkVector2d & maximumBoxSize() const;
+
+    /**
+     * Append ids of all entries in bins that overlap the corridor around the line segment A-B.
+     * The corridor is the rectangle within halfWidth of the segment. Entries may be located
+     * outside of the corridor, but all entries inside of the corridor are returned. Boxes that
+     * overlap multiple bins of the corridor are appended multiple times.
+     * @return the number of appended ids
+     */
+    vtkIdType queryCorridor(const vtkVector2d & A, const vtkVector2d & B, double halfWidth,
+        std::vector<vtkIdType> & ids) const;
+
+private:
+    void setupGrid(const double xRange[2], const double yRange[2], vtkIdType numEntries,
+        const vtkVector2d & minBinSize = vtkVector2d(0.0, 0.0));
+    vtkVector2i binIndex(const vtkVector2d & position) const;
+
+private:
+    vtkVector2d m_origin;
+    vtkVector2d m_binSize;
+    vtkVector2i m_numBins;
+    vtkIdType m_numEntries;
+    vtkVector2d m_maxBoxSize;
+    /** Offsets of each bin's ids in m_ids, with an additional entry for the end. */
+    std::vector<vtkIdType> m_binOffsets;
+    std::vector<vtkIdType> m_ids;
+};
@@ -30,20 +30,29 @@
 #include <QFileInfo>
 #include <QFutureWatcher>
 #include <QGridLayout>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QMimeData>
 #include <QtConcurrent/QtConcurrentRun>
 
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
 #include <core/ApplicationSettings.h>
 #include <core/config.h>
 #include <core/DataSetHandler.h>
 #include <core/RuntimeInfo.h>
 #include <core/data_objects/CoordinateTransformableDataObject.h>
+#include <core/data_objects/ImageDataObject.h>
+#include <core/data_objects/PolyDataObject.h>
+#include <core/filters/DEMToAdaptiveTerrainMesh.h>
+#include <core/filters/GeographicTransformationFilter.h>
 #include <core/io/Exporter.h>
 #include <core/io/io_helper.h>
 #include <core/io/Loader.h>
 #include <core/rendered_data/RenderedData.h>
 #include <core/ThirdParty/dark_fusion_style.hpp>
+#include <core/utility/PipelineOutputCache.h>
 #include <core/utility/qthelper.h>
 
 #include <gui/AboutProjectDialog.h>
@@ -125,7 +134,11 @@ MainWindow::MainWindow()
         AboutProjectDialog().exec();
     });
     connect(m_ui->actionAbout_Qt, &QAction::triggered, [this] () { QMessageBox::aboutQt(this); });
+    connect(m_ui->actionDiagnostics, &QAction::triggered, [this] () {
+        QMessageBox::information(this, "Diagnostics", PipelineOutputCache::instance().statisticsString());
+    });
     connect(m_ui->actionApply_Digital_Elevation_Model, &QAction::triggered, this, &MainWindow::showDEMWidget);
+    connect(m_ui->actionCreate_Adaptive_Terrain_Mesh, &QAction::triggered, this, &MainWindow::dialog_createAdaptiveTerrainMesh);
     connect(m_ui->actionAdjust_Coordinate_System, &QAction::triggered, [this] ()
     {
         auto && selection = m_dataBrowser->selectedDataSets();
@@ -207,6 +220,12 @@ MainWindow::MainWindow()
     m_ui->menuViews->insertAction(m_ui->actionReset_Window_Layout, m_rendererConfigWidget->toggleViewAction());
 
     connect(m_ui->actionDark_Style, &QAction::triggered, this, &MainWindow::setDarkFusionStyle);
+    connect(m_ui->actionFast_Coordinate_Transformations, &QAction::triggered, [] (bool enabled)
+    {
+        GeographicTransformationFilter::SetDefaultProjectionMethod(enabled
+            ? GeographicTransformationFilter::ProjectionFast
+            : GeographicTransformationFilter::ProjectionExact);
+    });
 
     restoreSettings();
 
@@ -524,6 +543,74 @@ void MainWindow::showDEMWidget()
     dockWidget->show();
 }
 
+void MainWindow::dialog_createAdaptiveTerrainMesh()
+{
+    const QString title = "Adaptive Terrain Mesh";
+
+    ImageDataObject * dem = nullptr;
+    for (auto dataObject : m_dataBrowser->selectedDataSets())
+    {
+        if ((dem = dynamic_cast<ImageDataObject *>(dataObject)))
+        {
+            break;
+        }
+    }
+    if (!dem)
+    {
+        QMessageBox::information(this, title,
+            "Please select a Digital Elevation Model (image data) in the data browser, first!");
+        return;
+    }
+
+    bool ok = false;
+    const auto maxError = QInputDialog::getDouble(this, title,
+        "Maximum vertical error (in elevation units):", 1.0, 0.0, 1.0e9, 3, &ok);
+    if (!ok)
+    {
+        return;
+    }
+    const bool computeNormals = QMessageBox::question(this, title,
+        "Compute point normals for smooth shading?") == QMessageBox::Yes;
+
+    // Triangulate in a worker thread, on a snapshot of the DEM, so that the GUI stays responsive
+    // and the DEM may be modified or deleted in the meantime.
+    vtkSmartPointer<vtkDataSet> input;
+    input.TakeReference(dem->processedOutputDataSet()->NewInstance());
+    input->DeepCopy(dem->processedOutputDataSet());
+
+    const auto name = dem->name() + " (Terrain Mesh)";
+    const auto coordinateSystem = dem->coordinateSystem();
+
+    auto watcher = new QFutureWatcher<vtkSmartPointer<vtkPolyData>>(this);
+    connect(watcher, &QFutureWatcher<vtkSmartPointer<vtkPolyData>>::finished,
+        [this, watcher, title, name, coordinateSystem] ()
+    {
+        watcher->deleteLater();
+
+        auto terrain = watcher->result();
+        if (!terrain || terrain->GetNumberOfCells() == 0)
+        {
+            QMessageBox::warning(this, title, "Could not create a terrain mesh from the selected data set.");
+            return;
+        }
+
+        auto newData = std::make_unique<PolyDataObject>(name, *terrain);
+        newData->specifyCoordinateSystem(coordinateSystem);
+        m_dataSetHandler->takeData(std::move(newData));
+    });
+
+    watcher->setFuture(QtConcurrent::run([input, maxError, computeNormals] ()
+    {
+        auto filter = vtkSmartPointer<DEMToAdaptiveTerrainMesh>::New();
+        filter->SetInputData(input);
+        filter->SetMaximumError(maxError);
+        filter->SetComputeNormals(computeNormals);
+        filter->Update();
+
+        return vtkSmartPointer<vtkPolyData>(filter->GetOutput());
+    }));
+}
+
 void MainWindow::tabbedDockWidgetToFront(QDockWidget * widget)
 {
     // http://qt-project.org/faq/answer/how_can_i_check_which_tab_is_the_current_one_in_a_tabbed_qdockwidget
@@ -693,6 +780,13 @@ void MainWindow::restoreSettings()
     m_lastExportFolder = settings.value("lastExportFolder").toString();
     m_recentFileListMaxEntries = std::max(0, settings.value("recentFileListMaxEntries", 15).toInt());
     prependRecentFiles(settings.value("recentFileList").toStringList());
+    PipelineOutputCache::instance().setMemoryBudget(settings.value("transformedDataCacheBudgetMiB",
+        PipelineOutputCache::instance().memoryBudget() / 1024u).toULongLong() * 1024u);
+    const bool fastTransformations = settings.value("fastCoordinateTransformations", false).toBool();
+    m_ui->actionFast_Coordinate_Transformations->setChecked(fastTransformations);
+    GeographicTransformationFilter::SetDefaultProjectionMethod(fastTransformations
+        ? GeographicTransformationFilter::ProjectionFast
+        : GeographicTransformationFilter::ProjectionExact);
 }
 
 void MainWindow::storeSettings()
@@ -702,6 +796,10 @@ void MainWindow::storeSettings()
     settings.setValue("lastExportFolder", m_lastExportFolder);
     settings.setValue("recentFileListMaxEntries", m_recentFileListMaxEntries);
     settings.setValue("recentFileList", m_recentFileList);
+    settings.setValue("transformedDataCacheBudgetMiB",
+        static_cast<qulonglong>(PipelineOutputCache::instance().memoryBudget() / 1024u));
+    settings.setValue("fastCoordinateTransformations",
+        m_ui->actionFast_Coordinate_Transformations->isChecked());
 }
 
 void MainWindow::restoreUiState()
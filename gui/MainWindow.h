@@ -89,6 +89,7 @@ private:
     void addTableView(TableView * tableView, QDockWidget * dockTabifyPartner = nullptr);
 
     void showDEMWidget();
+    void dialog_createAdaptiveTerrainMesh();
     void dialog_exportDataSet();
     void dialog_exportToCSV();
     QStringList dialog_inputFileName();
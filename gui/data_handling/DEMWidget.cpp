@@ -33,6 +33,7 @@
 #include <core/color_mapping/ColorMapping.h>
 #include <core/data_objects/ImageDataObject.h>
 #include <core/data_objects/PolyDataObject.h>
+#include <core/filters/DEMRepairFilter.h>
 #include <core/filters/DEMToTopographyMesh.h>
 #include <core/rendered_data/RenderedPolyData.h>
 #include <core/rendered_data/RenderedImageData.h>
@@ -56,6 +57,7 @@ DEMWidget::DEMWidget(DataMapping & dataMapping, AbstractRenderView * previewRend
     , m_demUnitDecimalExponent{ 0 }
     , m_meshParametersInvalid{ true }
     , m_previewRebuildRequired{ true }
+    , m_demRepairFilter{ vtkSmartPointer<DEMRepairFilter>::New() }
     , m_demToTopoFilter{ vtkSmartPointer<DEMToTopographyMesh>::New() }
     , m_previewRenderer{ previewRenderer }
     , m_dataPreview{ nullptr }
@@ -162,6 +164,24 @@ DEMWidget::DEMWidget(DataMapping & dataMapping, AbstractRenderView * previewRend
         updatePreview();
     });
 
+    applyDEMRepairSettings();
+
+    const auto updateForChangedRepairSettings = [this] ()
+    {
+        applyDEMRepairSettings();
+
+        if (m_dataPreview && m_previewRenderer)
+        {
+            updatePipeline();
+            m_previewRenderer->render();
+        }
+    };
+    connect(m_ui->demRepairCombo, comboIndexChangedSignal, updateForChangedRepairSettings);
+    connect(m_ui->demSpikesCheckBox, &QAbstractButton::toggled, updateForChangedRepairSettings);
+    connect(m_ui->demNoDataCheckBox, &QAbstractButton::toggled, updateForChangedRepairSettings);
+    connect(m_ui->demSpikeThresholdSpinBox, &QAbstractSpinBox::editingFinished, updateForChangedRepairSettings);
+    connect(m_ui->demNoDataSpinBox, &QAbstractSpinBox::editingFinished, updateForChangedRepairSettings);
+
     connect(m_ui->radiusMatchingButton, &QAbstractButton::clicked, [this] ()
     {
         matchTopoMeshRadius();
@@ -597,6 +617,7 @@ void DEMWidget::setupPipeline()
 
     m_meshPipelineStart = cleanupMeshAttributes;
 
+    m_demToTopoFilter->SetInputConnection(0, m_demRepairFilter->GetOutputPort());
     m_demToTopoFilter->SetInputConnection(1, cleanupMeshAttributes->GetOutputPort());
 
     m_cleanupOutputMeshAttributes = createMeshCleanupFilter();
@@ -792,11 +813,11 @@ void DEMWidget::setPipelineInputs()
 
     if (auto transformedDEMPort = dem->coordinateTransformedOutputPort(targetCoordsDEMSpec()))
     {
-        m_demToTopoFilter->SetInputConnection(transformedDEMPort);
+        m_demRepairFilter->SetInputConnection(transformedDEMPort);
     }
     else    // DEM doesn't support any transformations
     {
-        m_demToTopoFilter->SetInputDataObject(dem->dataSet());
+        m_demRepairFilter->SetInputDataObject(dem->dataSet());
     }
 
     m_meshPipelineStart->SetInputDataObject(topo->dataSet());
@@ -939,6 +960,29 @@ void DEMWidget::updatePreview()
     updatePreviewRendererContents();
 }
 
+void DEMWidget::applyDEMRepairSettings()
+{
+    // The repair filter passes the input elevations if no detection is enabled.
+    const int fillIndex = m_ui->demRepairCombo->currentIndex();
+    const bool repair = fillIndex > 0;
+
+    m_demRepairFilter->SetDetectNaN(repair);
+    m_demRepairFilter->SetDetectSpikes(repair && m_ui->demSpikesCheckBox->isChecked());
+    m_demRepairFilter->SetSpikeThreshold(m_ui->demSpikeThresholdSpinBox->value());
+    m_demRepairFilter->SetDetectNoDataValue(repair && m_ui->demNoDataCheckBox->isChecked());
+    m_demRepairFilter->SetNoDataValue(m_ui->demNoDataSpinBox->value());
+    if (repair)
+    {
+        m_demRepairFilter->SetFill(static_cast<DEMRepairFilter::FillStrategy>(
+            DEMRepairFilter::FillDirectionalMean + fillIndex - 1));
+    }
+
+    m_ui->demSpikesCheckBox->setEnabled(repair);
+    m_ui->demSpikeThresholdSpinBox->setEnabled(repair);
+    m_ui->demNoDataCheckBox->setEnabled(repair);
+    m_ui->demNoDataSpinBox->setEnabled(repair);
+}
+
 void DEMWidget::applyUIChanges()
 {
     const auto blockers = uiSignalBlockers();
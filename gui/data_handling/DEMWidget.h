@@ -39,6 +39,7 @@ class DataMapping;
 class DataObject;
 class DataSetFilter;
 class DataSetHandler;
+class DEMRepairFilter;
 class DEMToTopographyMesh;
 class ImageDataObject;
 class PolyDataObject;
@@ -127,6 +128,8 @@ private:
     void releasePreviewData();
 
     void applyUIChanges();
+    /** Pass spike/void detection and fill settings to the DEM repair filter. */
+    void applyDEMRepairSettings();
 
     std::vector<QSignalBlocker> uiSignalBlockers();
 
@@ -152,6 +155,7 @@ private:
     bool m_previewRebuildRequired;
 
     vtkSmartPointer<vtkAlgorithm> m_meshPipelineStart;
+    vtkSmartPointer<DEMRepairFilter> m_demRepairFilter;
     vtkSmartPointer<DEMToTopographyMesh> m_demToTopoFilter;
     vtkSmartPointer<vtkPassArrays> m_cleanupOutputMeshAttributes;
 
@@ -33,6 +33,7 @@
 #include <core/data_objects/ImageDataObject.h>
 #include <core/data_objects/DataProfile2DDataObject.h>
 #include <core/data_objects/VectorGrid3DDataObject.h>
+#include <core/utility/DataArrayRanges.h>
 #include <core/utility/DataExtent.h>
 #include <core/utility/qthelper.h>
 #include <core/utility/vtkvectorhelper.h>
@@ -494,10 +495,10 @@ QVariant DataBrowserTableModel::data_attributeVector(int row, int column, int ro
     case s_colValueRange:
     {
         QString ranges;
-        std::array<double, 2> range;
+        const auto arrayRanges = DataArrayRanges::of(*dataArray);
         for (int c = 0; c < numComponents; ++c)
         {
-            dataArray->GetRange(range.data(), c);
+            const auto & range = arrayRanges.componentRange(c);
             ranges += componentName(c, numComponents) + ": " + QString::number(range[0]) + "; " + QString::number(range[1]) + ", ";
         }
         ranges.remove(ranges.length() - 2, 2);
@@ -18,15 +18,18 @@
 
 #include "RenderViewStrategy2D.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
 #include <QAction>
 #include <QDockWidget>
+#include <QFutureWatcher>
 #include <QIcon>
 #include <QLayout>
 #include <QSet>
 #include <QToolBar>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <vtkAlgorithmOutput.h>
 #include <vtkCamera.h>
@@ -46,7 +49,9 @@
 #include <core/color_mapping/ColorMappingData.h>
 #include <core/context2D_data/DataProfile2DContextPlot.h>
 #include <core/data_objects/DataProfile2DDataObject.h>
+#include <core/data_objects/ImageDataObject.h>
 #include <core/rendered_data/RenderedData.h>
+#include <core/utility/PipelineOutputCache.h>
 #include <core/utility/qthelper.h>
 #include <core/utility/vtkvectorhelper.h>
 #include <gui/DataMapping.h>
@@ -70,13 +75,21 @@ RenderViewStrategy2D::RenderViewStrategy2D(RendererImplementationBase3D & contex
     , m_profilePlotAction{ nullptr }
     , m_profilePlotAcceptAction{ nullptr }
     , m_profilePlotAbortAction{ nullptr }
+    , m_spaceTimeProfileAction{ nullptr }
     , m_previewRenderer{ nullptr }
     , m_pausePointsUpdate{ false }
+    , m_profileUpdateWatcher{ std::make_unique<QFutureWatcher<void>>() }
+    // time budget of 30 ms for preview profiles while dragging the line
+    , m_profileUpdateScheduler{ 30, 1.0 / 64.0 }
 {
+    connect(m_profileUpdateWatcher.get(), &QFutureWatcher<void>::finished,
+        this, &RenderViewStrategy2D::handleProfileUpdateFinished);
 }
 
 RenderViewStrategy2D::~RenderViewStrategy2D()
 {
+    waitForProfileUpdate();
+
     if (m_previewRenderer && !m_previewProfiles.empty())
     {
         QList<DataObject *> objects;
@@ -139,8 +152,12 @@ void RenderViewStrategy2D::initialize()
     m_profilePlotAbortAction = new QAction(QIcon(":/icons/no"), "", nullptr);
     connect(m_profilePlotAbortAction, &QAction::triggered, this, &RenderViewStrategy2D::abortProfilePlot);
     m_profilePlotAbortAction->setVisible(false);
+    m_spaceTimeProfileAction = new QAction(QIcon(":/icons/graph_line"), "create space-time profile", nullptr);
+    connect(m_spaceTimeProfileAction, &QAction::triggered, this, &RenderViewStrategy2D::createSpaceTimeProfiles);
+    m_spaceTimeProfileAction->setVisible(false);
 
-    m_actions << m_profilePlotAction << m_profilePlotAcceptAction << m_profilePlotAbortAction;
+    m_actions << m_profilePlotAction << m_profilePlotAcceptAction << m_profilePlotAbortAction
+        << m_spaceTimeProfileAction;
 
     m_state = State::notPlotting;
 }
@@ -215,6 +232,8 @@ void RenderViewStrategy2D::startProfilePlot()
 {
     assert(m_state == State::notPlotting || m_state == State::plotting);
 
+    waitForProfileUpdate();
+
     if (m_state == State::plotting)
     {
         // restart plotting
@@ -389,19 +408,34 @@ void RenderViewStrategy2D::startProfilePlot()
         addLineObservation(m_lineWidget->GetLineRepresentation()->GetLineHandleRepresentation());
         addLineObservation(m_lineWidget->GetLineRepresentation()->GetPoint1Representation());
         addLineObservation(m_lineWidget->GetLineRepresentation()->GetPoint2Representation());
+
+        m_observerTags.emplace(m_lineWidget.Get(), m_lineWidget->AddObserver(
+            vtkCommand::StartInteractionEvent, this, &RenderViewStrategy2D::lineInteractionStarted));
+        m_observerTags.emplace(m_lineWidget.Get(), m_lineWidget->AddObserver(
+            vtkCommand::EndInteractionEvent, this, &RenderViewStrategy2D::lineInteractionEnded));
     }
 
     m_state = State::plotting;
     m_profilePlotAcceptAction->setVisible(true);
     m_profilePlotAbortAction->setVisible(true);
+
+    const bool supportsSpaceTime = std::any_of(m_previewProfiles.begin(), m_previewProfiles.end(),
+        [] (const std::unique_ptr<DataObject> & profile)
+    {
+        return static_cast<DataProfile2DDataObject *>(profile.get())->supportsSpaceTimeProfile();
+    });
+    m_spaceTimeProfileAction->setVisible(true);
+    m_spaceTimeProfileAction->setEnabled(supportsSpaceTime);
 }
 
 void RenderViewStrategy2D::acceptProfilePlot()
 {
     assert(m_state == State::plotting);
+    completeProfileUpdate();
     m_state = State::accepting;
     m_profilePlotAcceptAction->setVisible(false);
     m_profilePlotAbortAction->setVisible(false);
+    m_spaceTimeProfileAction->setVisible(false);
 
     dataMapping().dataSetHandler().takeData(std::move(m_previewProfiles));
     m_previewProfiles.clear();
@@ -421,6 +455,7 @@ void RenderViewStrategy2D::acceptProfilePlot()
 void RenderViewStrategy2D::abortProfilePlot()
 {
     assert(m_state == State::plotting || m_state == State::plotSetup);
+    completeProfileUpdate();
     clearProfilePlots();
 
     if (m_previewRenderer)
@@ -440,9 +475,41 @@ void RenderViewStrategy2D::abortProfilePlot()
     m_state = State::notPlotting;
     m_profilePlotAcceptAction->setVisible(false);
     m_profilePlotAbortAction->setVisible(false);
+    m_spaceTimeProfileAction->setVisible(false);
     m_profilePlotAction->setEnabled(true);
 }
 
+void RenderViewStrategy2D::createSpaceTimeProfiles()
+{
+    assert(m_state == State::plotting);
+    completeProfileUpdate();
+
+    std::vector<std::unique_ptr<DataObject>> spaceTimeProfiles;
+
+    for (auto && profile : m_previewProfiles)
+    {
+        auto & profileData = static_cast<DataProfile2DDataObject &>(*profile);
+        if (!profileData.supportsSpaceTimeProfile())
+        {
+            continue;
+        }
+
+        auto image = profileData.createSpaceTimeProfile();
+        if (!image)
+        {
+            continue;
+        }
+
+        spaceTimeProfiles.push_back(std::make_unique<ImageDataObject>(
+            profileData.name() + " (space-time)", *image));
+    }
+
+    if (!spaceTimeProfiles.empty())
+    {
+        dataMapping().dataSetHandler().takeData(std::move(spaceTimeProfiles));
+    }
+}
+
 AbstractRenderView * RenderViewStrategy2D::plotPreviewRenderer()
 {
     return m_previewRenderer;
@@ -456,6 +523,7 @@ QString RenderViewStrategy2D::defaultInteractorStyle() const
 void RenderViewStrategy2D::clearProfilePlots()
 {
     assert(m_state == State::plotSetup || m_state == State::plotting);
+    waitForProfileUpdate();
     auto oldProfiles = std::move(m_previewProfiles);
     auto oldInputs = std::move(m_activeInputData);
 
@@ -483,18 +551,127 @@ void RenderViewStrategy2D::lineMoved()
         return;
     }
 
+    // While setting up the plot, the profiles are not yet shown, so just pass the points.
+    if (m_state != State::plotting)
+    {
+        applyLinePoints(1.0);
+        return;
+    }
+
+    m_profileUpdateScheduler.requestUpdate();
+    startProfileUpdate();
+}
+
+void RenderViewStrategy2D::applyLinePoints(double samplingResolution)
+{
     vtkVector3d point1, point2;
     m_lineWidget->GetLineRepresentation()->GetPoint1WorldPosition(point1.GetData());
     m_lineWidget->GetLineRepresentation()->GetPoint2WorldPosition(point2.GetData());
 
     for (auto && profile : m_previewProfiles)
     {
-        static_cast<DataProfile2DDataObject *>(profile.get())->setProfileLinePoints(
-            convertTo<2>(point1), 
+        auto & profileData = static_cast<DataProfile2DDataObject &>(*profile);
+        profileData.setSamplingResolution(samplingResolution);
+        profileData.setProfileLinePoints(
+            convertTo<2>(point1),
             convertTo<2>(point2));
     }
 }
 
+void RenderViewStrategy2D::lineInteractionStarted()
+{
+    m_profileUpdateScheduler.setInteractive(true);
+}
+
+void RenderViewStrategy2D::lineInteractionEnded()
+{
+    m_profileUpdateScheduler.setInteractive(false);
+
+    if (m_state != State::plotting)
+    {
+        return;
+    }
+
+    // replace the previews by full resolution profiles
+    m_profileUpdateScheduler.requestUpdate();
+    startProfileUpdate();
+}
+
+void RenderViewStrategy2D::startProfileUpdate()
+{
+    assert(m_state == State::plotting);
+
+    // Running computations cannot be interrupted. Their results are replaced as soon as possible
+    // by the profiles for the latest line points, all intermediate positions are dropped.
+    double resolution = 1.0;
+    if (!m_profileUpdateScheduler.startUpdate(resolution))
+    {
+        return;
+    }
+    assert(!m_profileUpdateWatcher->isRunning() && m_profileUpdateDeferrals.empty());
+
+    // Signals of the profiles are emitted when the computation finished. Until then, the preview
+    // renderer keeps showing the previous results.
+    std::vector<DataProfile2DDataObject *> profiles;
+    for (auto && profile : m_previewProfiles)
+    {
+        m_profileUpdateDeferrals.emplace_back(*profile);
+        profiles.push_back(static_cast<DataProfile2DDataObject *>(profile.get()));
+    }
+
+    applyLinePoints(resolution);
+
+    m_profileUpdateTimer.start();
+    m_profileUpdateWatcher->setFuture(QtConcurrent::run([profiles] ()
+    {
+        // The profile pipelines read cached transformed outputs, which must not be released
+        // in the application thread meanwhile.
+        const PipelineOutputCache::ScopedEvictionSuspension evictionSuspension;
+        for (auto profile : profiles)
+        {
+            profile->computeProfile();
+        }
+    }));
+}
+
+void RenderViewStrategy2D::handleProfileUpdateFinished()
+{
+    // adapts the preview resolution so that updates keep up with the line interaction
+    m_profileUpdateScheduler.finishUpdate(m_profileUpdateTimer.elapsed());
+
+    // executes the deferred events, so that the preview renderer shows the new profiles
+    m_profileUpdateDeferrals.clear();
+
+    if (m_state == State::plotting)
+    {
+        startProfileUpdate();
+    }
+}
+
+void RenderViewStrategy2D::waitForProfileUpdate()
+{
+    m_profileUpdateWatcher->waitForFinished();
+    m_profileUpdateDeferrals.clear();
+    m_profileUpdateScheduler.reset();
+}
+
+void RenderViewStrategy2D::completeProfileUpdate()
+{
+    waitForProfileUpdate();
+
+    if (m_state != State::plotting)
+    {
+        return;
+    }
+
+    // Replace decimated previews and apply the latest line points, if their update was pending.
+    applyLinePoints(1.0);
+    for (auto && profile : m_previewProfiles)
+    {
+        static_cast<DataProfile2DDataObject *>(profile.get())->computeProfile();
+    }
+}
+
 void RenderViewStrategy2D::updateAutomaticPlots()
 {
     // don't check here, if the user of this class explicitly set the inputs
@@ -520,6 +697,8 @@ void RenderViewStrategy2D::updateForViewCoordinateSystemChange(const CoordinateS
         return;
     }
 
+    waitForProfileUpdate();
+
     m_pausePointsUpdate = true;
 
     auto bounds = m_context.dataBounds(0);
@@ -527,11 +706,11 @@ void RenderViewStrategy2D::updateForViewCoordinateSystemChange(const CoordinateS
     auto repr = m_lineWidget->GetRepresentation();
     repr->PlaceWidget(bounds.data());
 
-    m_pausePointsUpdate = false;
-    lineMoved();
-
     for (auto && profile : m_previewProfiles)
     {
         static_cast<DataProfile2DDataObject *>(profile.get())->setPointsCoordinateSystem(spec);
     }
+
+    m_pausePointsUpdate = false;
+    lineMoved();
 }
@@ -19,13 +19,19 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 
+#include <QElapsedTimer>
+
 #include <core/CoordinateSystems_fwd.h>
+#include <core/data_objects/DataObject.h>
+#include <core/utility/ProgressiveUpdateScheduler.h>
 #include <gui/data_view/RenderViewStrategy.h>
 
 
 class QAction;
+template<typename T> class QFutureWatcher;
 class vtkObject;
 class vtkLineWidget2;
 
@@ -53,6 +59,8 @@ public:
     void startProfilePlot();
     void acceptProfilePlot();
     void abortProfilePlot();
+    /** Export the distance × time matrices of the current profiles of temporal point data. */
+    void createSpaceTimeProfiles();
 
     /** @return the render view that is created to visualize the profile plot.
       * This is nullptr, if no plot has been started, no valid input data is available, or a
@@ -71,6 +79,23 @@ private:
     /** Delete current plots, but do not change the GUI state */
     void clearProfilePlots();
     void lineMoved();
+    /** Set the current line points and the sampling resolution on all preview profiles. */
+    void applyLinePoints(double samplingResolution);
+    void lineInteractionStarted();
+    void lineInteractionEnded();
+    /**
+     * Compute the preview profiles for the latest line points on a worker thread, if no
+     * computation is running. Otherwise, the latest points are processed when it finished.
+     */
+    void startProfileUpdate();
+    void handleProfileUpdateFinished();
+    /** Block until a running profile computation finished and release the profiles' events. */
+    void waitForProfileUpdate();
+    /**
+     * Wait for a running profile computation, and compute the full resolution profiles for the
+     * latest line points in this thread, including a pending update that was not started yet.
+     */
+    void completeProfileUpdate();
     void updateAutomaticPlots();
     void updateForViewCoordinateSystemChange(const CoordinateSystemSpecification & spec);
 
@@ -86,6 +111,7 @@ private:
     QAction * m_profilePlotAction;
     QAction * m_profilePlotAcceptAction;
     QAction * m_profilePlotAbortAction;
+    QAction * m_spaceTimeProfileAction;
     QList<QAction *> m_actions;
     std::vector<std::unique_ptr<DataObject>> m_previewProfiles;
     AbstractRenderView * m_previewRenderer;
@@ -98,6 +124,13 @@ private:
     std::multimap<vtkSmartPointer<vtkObject>, unsigned long> m_observerTags;
     bool m_pausePointsUpdate;
 
+    // Progressive profile updates: decimated previews while dragging the line, computed on a
+    // worker thread within a time budget, full resolution when the line is released.
+    std::unique_ptr<QFutureWatcher<void>> m_profileUpdateWatcher;
+    ProgressiveUpdateScheduler m_profileUpdateScheduler;
+    std::vector<ScopedEventDeferral> m_profileUpdateDeferrals;
+    QElapsedTimer m_profileUpdateTimer;
+
 private:
     Q_DISABLE_COPY(RenderViewStrategy2D)
 };
@@ -60,12 +60,16 @@ ResidualVerificationView::ResidualVerificationView(DataMapping & dataMapping, in
     , m_modelUnitDecimalExponent{ 0 }
     , m_updateWatcher{ std::make_unique<QFutureWatcher<void>>() }
     , m_inResidualUpdate{ false }
+    , m_colorsByProjectedAttributes{ { true, true } }
+    , m_inVisualizationUpdate{ false }
     , m_deferringVisualizationUpdate{ false }
     , m_destructorCalled{ false }
 {
     m_residualHelper->setGeometrySource(m_residualGeometrySource == InputData::observation
         ? DataSetResidualHelper::InputData::Observation
         : DataSetResidualHelper::InputData::Model);
+    // By default, observation and model sub-views are colored by the projected displacements.
+    m_residualHelper->setProjectedAttributesEnabled(true);
 
     connect(m_updateWatcher.get(), &QFutureWatcher<void>::finished,
         this, &ResidualVerificationView::handleUpdateFinished);
@@ -350,6 +354,11 @@ ResidualVerificationView::InputData ResidualVerificationView::residualGeometrySo
     return m_residualGeometrySource;
 }
 
+const ScalarStatistics & ResidualVerificationView::residualStatistics() const
+{
+    return m_residualStatistics;
+}
+
 void ResidualVerificationView::waitForResidualUpdate()
 {
     if (!m_updateWatcher->isStarted())
@@ -387,6 +396,10 @@ void ResidualVerificationView::setDataHelper(
 
     setInputDataInternal(subViewIndex, dataObject);
 
+    // New input data is colored by its line of sight displacements again.
+    m_colorsByProjectedAttributes[subViewIndex] = true;
+    m_residualHelper->setProjectedAttributesEnabled(true);
+
     auto scalars = std::make_pair(QString(), IndexType::invalid);
     if (dataObject)
     {
@@ -704,11 +717,58 @@ void ResidualVerificationView::updateVisualizationForSubView(unsigned int subVie
         auto newVisPtr = newVis.get();
         m_visualizations[subViewIndex] = std::move(newVis);
         implementation().addContent(newVisPtr, subViewIndex);
+
+        if (subViewIndex != residualIndex)
+        {
+            connect(&newVisPtr->colorMapping(), &ColorMapping::currentScalarsChanged,
+                this, [this, subViewIndex] () { updateProjectedAttributesUsage(subViewIndex); });
+        }
     }
 
     resetFriendlyName();
 }
 
+void ResidualVerificationView::updateProjectedAttributesUsage(unsigned int subViewIndex)
+{
+    assert(subViewIndex != residualIndex);
+
+    // Only consider color mapping changes triggered by the user.
+    if (m_inVisualizationUpdate || !m_visualizations[subViewIndex])
+    {
+        return;
+    }
+
+    const auto & losScalarsName = subViewIndex == observationIndex
+        ? m_residualHelper->losObservationScalarsName()
+        : m_residualHelper->losModelScalarsName();
+
+    m_colorsByProjectedAttributes[subViewIndex] =
+        m_visualizations[subViewIndex]->colorMapping().currentScalarsName() == losScalarsName;
+
+    const bool enableProjection = std::any_of(
+        m_colorsByProjectedAttributes.begin(), m_colorsByProjectedAttributes.end(),
+        [] (bool colorsByProjection) { return colorsByProjection; });
+
+    if (enableProjection == m_residualHelper->projectedAttributesEnabled())
+    {
+        return;
+    }
+
+    // The residual helper must not be modified while the residual is computed.
+    if (m_inResidualUpdate)
+    {
+        waitForResidualUpdate();
+    }
+
+    m_residualHelper->setProjectedAttributesEnabled(enableProjection);
+
+    // Projected attributes are created when updating the residual.
+    if (enableProjection)
+    {
+        updateResidualAsync();
+    }
+}
+
 void ResidualVerificationView::updateResidualAsync()
 {
     assert(QThread::currentThread() == this->thread());
@@ -778,6 +838,9 @@ void ResidualVerificationView::handleUpdateFinished()
 
     m_eventDeferrals.clear();
 
+    m_residualStatistics = m_residualHelper->residualStatistics();
+    emit residualStatisticsChanged();
+
     updateGuiAfterDataChange();
 
     toolBar()->setEnabled(true);
@@ -860,6 +923,9 @@ void ResidualVerificationView::updateVisualizations()
 
     m_deferringVisualizationUpdate = false;
 
+    const bool wasInVisualizationUpdate = m_inVisualizationUpdate;
+    m_inVisualizationUpdate = true;
+
     for (unsigned int i = 0; i < numberOfSubViews(); ++i)
     {
         if (!dataAt(i) || !m_visualizations[i])
@@ -867,6 +933,12 @@ void ResidualVerificationView::updateVisualizations()
             continue;
         }
 
+        // Keep scalars that the user selected instead of the line of sight displacements.
+        if (i != residualIndex && !m_colorsByProjectedAttributes[i])
+        {
+            continue;
+        }
+
         const auto attributeName = i == 0
             ? m_residualHelper->losObservationScalarsName()
             : (i == 1
@@ -885,6 +957,8 @@ void ResidualVerificationView::updateVisualizations()
         }
     }
 
+    m_inVisualizationUpdate = wasInVisualizationUpdate;
+
     updateGuiSelection();
 
     QList<DataObject *> validInputData;
@@ -25,6 +25,7 @@
 #include <vtkVector.h>
 
 #include <core/data_objects/DataObject.h>
+#include <core/utility/ScalarStatistics.h>
 #include <gui/data_view/AbstractRenderView.h>
 
 
@@ -84,6 +85,12 @@ public:
     void setResidualGeometrySource(InputData geometrySource);
     InputData residualGeometrySource() const;
 
+    /**
+     * Statistics (RMS, mean, percentiles, histogram) of the current residual.
+     * These are computed along with the residual values, see residualStatisticsChanged().
+     */
+    const ScalarStatistics & residualStatistics() const;
+
     /** Blocks until current residual computation finished. */
     void waitForResidualUpdate();
 
@@ -129,6 +136,7 @@ signals:
     void residualGeometrySourceChanged(InputData geometrySource);
     void lineOfSightChanged(double incidenceAngleDegrees, double satelliteHeadingDegrees);
     void unitDecimalExponentsChanged(int observationExponent, int modelExponent);
+    void residualStatisticsChanged();
 
 private:
     enum : unsigned int
@@ -146,6 +154,11 @@ private:
     void setInputDataInternal(unsigned int subViewIndex, DataObject * newData);
     void setResidualDataInternal(std::unique_ptr<DataObject> newResidual);
     void updateVisualizationForSubView(unsigned int subViewIndex, DataObject * newData);
+    /**
+     * Enable line of sight projected attributes only while the observation or model sub-view
+     * is colored by them. Called when the color mapping of a sub-view changes.
+     */
+    void updateProjectedAttributesUsage(unsigned int subViewIndex);
 
     void updateResidualAsync();
     void handleUpdateFinished();
@@ -180,6 +193,7 @@ private:
 
     std::array<std::unique_ptr<AbstractVisualizedData>, numberOfViews> m_visualizations;
     vtkSmartPointer<vtkLookupTable> m_residualGradient;
+    ScalarStatistics m_residualStatistics;
 
     std::unique_ptr<QFutureWatcher<void>> m_updateWatcher;
     bool m_inResidualUpdate;
@@ -187,6 +201,9 @@ private:
     std::unique_ptr<DataObject> m_residual;
     std::unique_ptr<DataObject> m_oldResidualToDeleteAfterUpdate;
     std::vector<std::unique_ptr<AbstractVisualizedData>> m_visToDeleteAfterUpdate;
+    /** Whether the observation/model sub-views are colored by line of sight displacements */
+    std::array<bool, 2> m_colorsByProjectedAttributes;
+    bool m_inVisualizationUpdate;
     bool m_deferringVisualizationUpdate;
     bool m_destructorCalled;
 
@@ -30,11 +30,13 @@
 #include <vtkAlgorithm.h>
 #include <vtkAlgorithmOutput.h>
 #include <vtkCellArray.h>
+#include <vtkCellData.h>
 #include <vtkDataSet.h>
 #include <vtkDiskSource.h>
 #include <vtkIdTypeArray.h>
 #include <vtkImageData.h>
 #include <vtkMath.h>
+#include <vtkPointData.h>
 #include <vtkPoints.h>
 #include <vtkPropAssembly.h>
 #include <vtkProperty.h>
@@ -49,11 +51,30 @@
 #include <core/AbstractVisualizedData.h>
 #include <core/OpenGLDriverFeatures.h>
 #include <core/types.h>
+#include <core/filters/GeographicTransformationFilter.h>
 
 
 namespace
 {
 
+/**
+ * Selections refer to the data object's ids. Images resampled to the view's coordinate system
+ * provide the original ids, see GeographicTransformationFilter::ImageTransformResample.
+ * @return the id in the processed data set, or -1 if the selected id is not represented there.
+ */
+vtkIdType processedIndex(vtkDataSet & processedDataSet, const vtkIdType index, const IndexType indexType)
+{
+    auto attributes = indexType == IndexType::cells
+        ? static_cast<vtkDataSetAttributes *>(processedDataSet.GetCellData())
+        : static_cast<vtkDataSetAttributes *>(processedDataSet.GetPointData());
+    auto originalIds = vtkIdTypeArray::SafeDownCast(attributes->GetAbstractArray(
+        indexType == IndexType::cells
+        ? GeographicTransformationFilter::OriginalCellIdsArrayName()
+        : GeographicTransformationFilter::OriginalPointIdsArrayName()));
+
+    return originalIds ? originalIds->LookupValue(index) : index;
+}
+
 class HighlighterImpl
 {
 public:
@@ -535,7 +556,11 @@ void Highlighter::highlightPoints()
         return;
     }
 
-    const vtkIdType index = m_selection.indices.front();
+    const vtkIdType index = processedIndex(*dataSet, m_selection.indices.front(), IndexType::points);
+    if (index < 0)
+    {
+        return;
+    }
     vtkVector3d point;
     dataSet->GetPoint(index, point.GetData());
     m_impl->highlightPoint2D(point);
@@ -553,7 +578,11 @@ void Highlighter::highlightCells()
         return;
     }
 
-    const auto index = m_selection.indices.front();
+    const auto index = processedIndex(*dataSet, m_selection.indices.front(), IndexType::cells);
+    if (index < 0)
+    {
+        return;
+    }
 
     // extract picked triangle and create highlighting geometry
     // create two shifted polygons to work around occlusion
@@ -26,6 +26,7 @@
 #include <vtkActor.h>
 #include <vtkCellData.h>
 #include <vtkCellPicker.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImageSlice.h>
 #include <vtkImageMapper3D.h>
 #include <vtkInformation.h>
@@ -45,8 +46,12 @@
 #include <core/color_mapping/ColorMapping.h>
 #include <core/color_mapping/ColorMappingData.h>
 #include <core/data_objects/DataObject.h>
+#include <core/filters/GeographicTransformationFilter.h>
+#include <core/filters/ImagePyramidFilter.h>
 #include <core/rendered_data/RenderedData.h>
 #include <core/utility/DataExtent.h>
+#include <core/utility/GeographicTransformationUtil.h>
+#include <core/utility/ImagePyramidSlice.h>
 #include <core/utility/types_utils.h>
 
 
@@ -63,13 +68,19 @@ public:
     }
 
     void appendPolyDataInfo(QTextStream & stream, vtkPolyData & polyData, const QString & coordsUnit);
-    void appendGenericPositionInfo(QTextStream & stream, vtkDataSet & dataSet, const QString & coordsUnit);
+    /** @param pickedIndex Index of the picked point or cell in dataSet */
+    void appendGenericPositionInfo(QTextStream & stream, vtkDataSet & dataSet, vtkIdType pickedIndex,
+        const QString & coordsUnit);
     static void appendPositionInfo(QTextStream & stream,
         vtkIdType index, const vtkVector3d & position,
         const QString & indexPrefix, const QString & coordinatePrefix,
         const QString & valueSuffix);
+    /** For data sets in metric coordinates with known reference point: append latitude/longitude. */
+    void appendGeographicPositionInfo(QTextStream & stream,
+        vtkDataSet & dataSet, const vtkVector3d & position);
 
-    void appendScalarInfo(QTextStream & stream, const ColorMappingData & colorData);
+    /** @param pickedIndex Index of the picked point or cell in the pickedScalarArray */
+    void appendScalarInfo(QTextStream & stream, const ColorMappingData & colorData, vtkIdType pickedIndex);
 
 
     vtkSmartPointer<vtkPropPicker> propPicker;
@@ -80,6 +91,9 @@ public:
     VisualizationSelection pickedObjectInfo;
     vtkWeakPointer<vtkDataArray> pickedScalarArray;
 
+    /** Prepared once per source coordinate system, reused for subsequent picks. */
+    GeographicTransformationUtil toGeographic;
+
     void operator=(const Picker_private &) = delete;
 };
 
@@ -214,13 +228,44 @@ void Picker::pick(const vtkVector2i & clickPosXY, vtkRenderer & renderer)
         return;
     }
 
-    if (d_ptr->pickedObjectInfo.indexType == IndexType::cells)
+    vtkDataSet * pickedDataSet = activePicker->GetDataSet();
+    vtkIdType pickedIndex = d_ptr->pickedObjectInfo.indexType == IndexType::cells
+        ? d_ptr->cellPicker->GetCellId()
+        : d_ptr->pointPicker->GetPointId();
+
+    // Rendered images may be a reduced level of detail. Map the picked index to the full
+    // resolution image, which has the same structure as the data object's data set.
+    auto pyramidSlice = ImagePyramidSlice::SafeDownCast(imageSlice);
+    if (auto pyramid = pyramidSlice ? pyramidSlice->GetPyramid() : nullptr)
     {
-        d_ptr->pickedObjectInfo.setIndex(d_ptr->cellPicker->GetCellId());
+        if (auto fullResolution = vtkDataSet::SafeDownCast(pyramid->GetInputDataObject(0, 0)))
+        {
+            pickedDataSet = fullResolution;
+            pickedIndex = d_ptr->pickedObjectInfo.indexType == IndexType::cells
+                ? pyramid->ComputeInputCellId(pickedIndex)
+                : pyramid->ComputeInputPointId(pickedIndex);
+        }
     }
-    else
+
+    // Images resampled to the view's coordinate system don't have the structure of the data
+    // object's data set. Their original ids refer to it.
+    vtkIdType selectedIndex = pickedIndex;
+    if (imageSlice && pickedIndex >= 0)
     {
-        d_ptr->pickedObjectInfo.setIndex(d_ptr->pointPicker->GetPointId());
+        const IndexType_util location(d_ptr->pickedObjectInfo.indexType);
+        const auto originalIdsName = d_ptr->pickedObjectInfo.indexType == IndexType::cells
+            ? GeographicTransformationFilter::OriginalCellIdsArrayName()
+            : GeographicTransformationFilter::OriginalPointIdsArrayName();
+        if (auto originalIds = vtkIdTypeArray::SafeDownCast(
+            location.extractArray(*pickedDataSet, originalIdsName)))
+        {
+            selectedIndex = originalIds->GetValue(pickedIndex);
+        }
+    }
+
+    if (selectedIndex >= 0)
+    {
+        d_ptr->pickedObjectInfo.setIndex(selectedIndex);
     }
 
     if (d_ptr->pickedObjectInfo.isIndexListEmpty())
@@ -234,7 +279,7 @@ void Picker::pick(const vtkVector2i & clickPosXY, vtkRenderer & renderer)
     // object type specific picking
     // ----------------------------
 
-    auto & dataSet = *activePicker->GetDataSet();
+    auto & dataSet = *pickedDataSet;
     auto polyData = vtkPolyData::SafeDownCast(&dataSet);
     const bool isPolyData = polyData != nullptr;
     QString coordsUnit;
@@ -262,17 +307,21 @@ void Picker::pick(const vtkVector2i & clickPosXY, vtkRenderer & renderer)
     }
     else // point based data sets: images, volumes, volume slices, glyphs
     {
-        d_ptr->appendGenericPositionInfo(stream, dataSet, coordsUnit);
+        d_ptr->appendGenericPositionInfo(stream, dataSet, pickedIndex, coordsUnit);
     }
 
     if (!d_ptr->pickedObjectInfo.isIndexListEmpty() && colorMapping.isEnabled())
     {
-        d_ptr->pickedScalarArray = IndexType_util(d_ptr->pickedObjectInfo.indexType).extractArray(
-            dataSet, colorMappingData.scalarsName(visualization));
+        // Read the values from the picked data set, which is indexed by the picked index. For
+        // images, this is the full resolution input of the level of detail pyramid. It may be
+        // resampled, so that its ids differ from the data object's ids.
+        const auto scalarsName = colorMappingData.scalarsName(visualization);
+        const IndexType_util location(d_ptr->pickedObjectInfo.indexType);
+        d_ptr->pickedScalarArray = location.extractArray(dataSet, scalarsName);
 
         if (d_ptr->pickedScalarArray)
         {
-            d_ptr->appendScalarInfo(stream, colorMappingData);
+            d_ptr->appendScalarInfo(stream, colorMappingData, pickedIndex);
         }
     }
 
@@ -337,13 +386,14 @@ void Picker_private::appendPolyDataInfo(QTextStream & stream, vtkPolyData & poly
     }
 
     appendPositionInfo(stream, pickedIndex, position, indexPrefix, coordinatePrefix, coordsUnit);
+    appendGeographicPositionInfo(stream, polyData, position);
 }
 
 void Picker_private::appendGenericPositionInfo(QTextStream & stream,
     vtkDataSet & dataSet,
+    const vtkIdType pickedIndex,
     const QString & coordsUnit)
 {
-    const auto pickedIndex = pickedObjectInfo.indices.front();
     vtkVector3d position;
     QString indexPrefix, coordinatePrefix;
 
@@ -361,7 +411,9 @@ void Picker_private::appendGenericPositionInfo(QTextStream & stream,
         coordinatePrefix = "Centroid";
     }
 
-    appendPositionInfo(stream, pickedIndex, position, indexPrefix, coordinatePrefix, coordsUnit);
+    appendPositionInfo(stream, pickedObjectInfo.indices.front(), position,
+        indexPrefix, coordinatePrefix, coordsUnit);
+    appendGeographicPositionInfo(stream, dataSet, position);
 }
 
 void Picker_private::appendPositionInfo(QTextStream & stream,
@@ -385,13 +437,41 @@ void Picker_private::appendPositionInfo(QTextStream & stream,
         << coordinateIndent << "Z = " << position[2] << valueSuffix;
 }
 
-void Picker_private::appendScalarInfo(QTextStream & stream, const ColorMappingData & colorData)
+void Picker_private::appendGeographicPositionInfo(QTextStream & stream,
+    vtkDataSet & dataSet, const vtkVector3d & position)
+{
+    const auto spec = ReferencedCoordinateSystemSpecification::fromFieldData(*dataSet.GetFieldData());
+    if (spec.type == CoordinateSystemType::geographic || !spec.isReferencePointValid())
+    {
+        return;
+    }
+
+    toGeographic.setSourceSystem(spec);
+    toGeographic.setTargetSystem(CoordinateSystemSpecification(
+        CoordinateSystemType::geographic, spec.geographicSystem, spec.globalMetricSystem, {}));
+
+    bool success = false;
+    const auto latLong = toGeographic.transformPoint(position, &success);
+    if (!success)
+    {
+        return;
+    }
+
+    const auto realNumberPrecision = stream.realNumberPrecision();
+    stream.setRealNumberPrecision(7);
+    stream
+        << endl << "Latitude = " << latLong[1] << QChar(0x00B0)
+        << endl << "Longitude = " << latLong[0] << QChar(0x00B0);
+    stream.setRealNumberPrecision(realNumberPrecision);
+}
+
+void Picker_private::appendScalarInfo(QTextStream & stream, const ColorMappingData & colorData,
+    const vtkIdType pickedIndex)
 {
-    assert(pickedScalarArray && !pickedObjectInfo.isIndexListEmpty());
+    assert(pickedScalarArray && pickedIndex >= 0);
     auto & scalars = *pickedScalarArray;
-    const auto index = pickedObjectInfo.indices.front();
     auto tuple = std::vector<double>(scalars.GetNumberOfComponents());
-    scalars.GetTuple(index, tuple.data());
+    scalars.GetTuple(pickedIndex, tuple.data());
 
     auto unitStr = QString::fromUtf8(scalars.GetInformation()->Get(vtkDataArray::UNITS_LABEL()));
     if (!unitStr.isEmpty())
@@ -20,15 +20,19 @@
 #include "ui_ColorMappingChooser.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <limits>
 #include <iterator>
+#include <utility>
 
 #include <QColorDialog>
 #include <QDir>
 #include <QDebug>
 #include <QDialog>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <vtkCommand.h>
 #include <vtkLookupTable.h>
@@ -48,12 +52,24 @@
 #include <gui/data_view/AbstractRenderView.h>
 
 
+namespace
+{
+
+/** Lower/upper percentiles selectable as automatic min/max values */
+const std::array<std::pair<double, double>, 4> autoRangePercentiles = { {
+    { 0.0, 100.0 }, { 1.0, 99.0 }, { 2.0, 98.0 }, { 5.0, 95.0 }
+} };
+
+}
+
+
 ColorMappingChooser::ColorMappingChooser(QWidget * parent, Qt::WindowFlags flags)
     : QDockWidget(parent, flags)
     , m_ui{ std::make_unique<Ui_ColorMappingChooser>() }
     , m_renderView{ nullptr }
     , m_mapping{ nullptr }
     , m_inAdjustLegendPosition{ false }
+    , m_gradientPreloadWatcher{ std::make_unique<QFutureWatcher<void>>() }
 {
     m_ui->setupUi(this);
 
@@ -69,11 +85,20 @@ ColorMappingChooser::ColorMappingChooser(QWidget * parent, Qt::WindowFlags flags
     m_ui->legendPositionComboBox->setItemData(4, ColorBarRepresentation::posUserDefined);
     m_ui->legendPositionComboBox->setCurrentIndex(4);
 
+    for (const auto & percentiles : autoRangePercentiles)
+    {
+        m_ui->autoRangeComboBox->addItem(percentiles.first <= 0.0
+            ? QString("data range")
+            : QString::number(percentiles.first) + "% - " + QString::number(percentiles.second) + "%");
+    }
+
     rebuildGui();
 }
 
 ColorMappingChooser::~ColorMappingChooser()
 {
+    m_gradientPreloadWatcher->waitForFinished();
+
     setCurrentRenderView(nullptr);
 }
 
@@ -272,6 +297,23 @@ void ColorMappingChooser::guiResetMaxToData()
     m_ui->maxValueSpinBox->setValue(m_mapping->currentScalars().dataMaxValue());
 }
 
+void ColorMappingChooser::guiAutoRangeChanged(int index)
+{
+    assert(m_mapping);
+
+    if (index < 0 || index >= static_cast<int>(autoRangePercentiles.size()))
+    {
+        return;
+    }
+
+    const auto & percentiles = autoRangePercentiles[static_cast<size_t>(index)];
+    m_mapping->currentScalars().setAutoPercentiles(percentiles.first, percentiles.second);
+
+    updateGuiValueRanges();
+
+    emit renderSetupChanged();
+}
+
 void ColorMappingChooser::guiLegendPositionChanged()
 {
     assert(m_mapping);
@@ -365,20 +407,37 @@ void ColorMappingChooser::updateNanColorButtonStyle(const unsigned char color[4]
 
 void ColorMappingChooser::loadGradientImages()
 {
-    const auto & gradients = GradientResourceManager::instance().gradients();
-
     auto & gradientComboBox = *m_ui->gradientComboBox;
 
-    // load the files and add them to the combobox
+    // add the gradient names now, decoding the images is done in a background thread
     QSignalBlocker signalBlocker(gradientComboBox);
 
-    for (auto && gradient : gradients)
+    for (const auto & gradientName : GradientResourceManager::instance().gradientNames())
     {
-        gradientComboBox.addItem(gradient.second.pixmap, "");
-        gradientComboBox.setItemData(gradientComboBox.count() - 1, gradient.first);
+        gradientComboBox.addItem(QIcon(), "");
+        gradientComboBox.setItemData(gradientComboBox.count() - 1, gradientName);
     }
 
-    gradientComboBox.setIconSize(gradients.begin()->second.pixmap.size());
+    gradientComboBox.setIconSize(GradientResourceManager::previewSize());
+
+    connect(m_gradientPreloadWatcher.get(), &QFutureWatcher<void>::finished,
+        this, &ColorMappingChooser::updateGradientImages);
+
+    m_gradientPreloadWatcher->setFuture(QtConcurrent::run([] ()
+    {
+        GradientResourceManager::instance().preloadGradients();
+    }));
+}
+
+void ColorMappingChooser::updateGradientImages()
+{
+    auto & gradientComboBox = *m_ui->gradientComboBox;
+    auto & manager = GradientResourceManager::instance();
+
+    for (int i = 0; i < gradientComboBox.count(); ++i)
+    {
+        gradientComboBox.setItemIcon(i, manager.gradient(gradientComboBox.itemData(i).toString()).pixmap);
+    }
 }
 
 void ColorMappingChooser::checkRemovedData(const QList<AbstractVisualizedData *> & content)
@@ -572,6 +631,7 @@ void ColorMappingChooser::setupGuiConnections()
     m_guiConnections.emplace_back(connect(m_ui->maxValueSpinBox, dSpinBoxValueChanged, this, &ColorMappingChooser::guiMaxValueChanged));
     m_guiConnections.emplace_back(connect(m_ui->minLabel, &QLabel::linkActivated, this, &ColorMappingChooser::guiResetMinToData));
     m_guiConnections.emplace_back(connect(m_ui->maxLabel, &QLabel::linkActivated, this, &ColorMappingChooser::guiResetMaxToData));
+    m_guiConnections.emplace_back(connect(m_ui->autoRangeComboBox, comboBoxIndexChanged, this, &ColorMappingChooser::guiAutoRangeChanged));
     m_guiConnections.emplace_back(connect(m_ui->gradientComboBox, &QComboBox::currentTextChanged, this, &ColorMappingChooser::guiGradientSelectionChanged));
     m_guiConnections.emplace_back(connect(m_ui->nanColorButton, &QAbstractButton::pressed, this, &ColorMappingChooser::guiSelectNanColor));
     m_guiConnections.emplace_back(connect(m_ui->legendPositionComboBox, comboBoxIndexChanged, this, &ColorMappingChooser::guiLegendPositionChanged));
@@ -676,8 +736,10 @@ void ColorMappingChooser::updateGuiValueRanges()
     std::vector<QString> componentNames;
     double min = 0, max = 0;
     double currentMin = 0, currentMax = 0;
+    int autoRangeIndex = 0;
 
     bool enableRangeGui = false;
+    bool enableAutoRangeGui = false;
 
     if (m_mapping && m_mapping->scalarsAvailable())
     {
@@ -694,6 +756,13 @@ void ColorMappingChooser::updateGuiValueRanges()
 
         // assume that the mapping does not use scalar values/ranges, if it has useless min/max values
         enableRangeGui = min != max;
+        enableAutoRangeGui = enableRangeGui && scalars.providesDataHistograms();
+
+        const auto autoIt = std::find(autoRangePercentiles.begin(), autoRangePercentiles.end(),
+            std::make_pair(scalars.lowerAutoPercentile(), scalars.upperAutoPercentile()));
+        autoRangeIndex = autoIt != autoRangePercentiles.end()
+            ? static_cast<int>(autoIt - autoRangePercentiles.begin())
+            : -1;
     }
 
     // around 100 steps to scroll through the full range, but step only on one digit
@@ -726,6 +795,7 @@ void ColorMappingChooser::updateGuiValueRanges()
     m_ui->maxValueSpinBox->setSingleStep(step);
     m_ui->maxValueSpinBox->setDecimals(decimals);
     m_ui->maxValueSpinBox->setValue(currentMax);
+    m_ui->autoRangeComboBox->setCurrentIndex(autoRangeIndex);
 
     m_ui->componentLabel->setText("component (" + QString::number(componentNames.size()) + ")");
     QString resetLink = enableRangeGui ? "resetToData" : "";
@@ -735,6 +805,7 @@ void ColorMappingChooser::updateGuiValueRanges()
     m_ui->componentComboBox->setEnabled(componentNames.size() > 1);
     m_ui->minValueSpinBox->setEnabled(enableRangeGui);
     m_ui->maxValueSpinBox->setEnabled(enableRangeGui);
+    m_ui->autoRangeComboBox->setEnabled(enableAutoRangeGui);
 
 
     if (m_mapping)
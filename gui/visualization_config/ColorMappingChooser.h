@@ -30,6 +30,7 @@
 #include <gui/gui_api.h>
 
 
+template<typename T> class QFutureWatcher;
 class vtkContext2DScalarBarActor;
 class vtkLookupTable;
 class vtkObject;
@@ -67,6 +68,7 @@ private:
     void guiMaxValueChanged(double value);
     void guiResetMinToData();
     void guiResetMaxToData();
+    void guiAutoRangeChanged(int index);
     void guiSelectNanColor();
     void guiLegendPositionChanged();
     void guiLegendTitleChanged();
@@ -89,7 +91,9 @@ private:
     void updateNanColorButtonStyle(const QColor & color);
     void updateNanColorButtonStyle(const unsigned char color[4]);
 
+    /** Add all gradients to the combo box and load their preview images in the background */
     void loadGradientImages();
+    void updateGradientImages();
 
     /** remove data from the UI if we currently hold it */
     void checkRemovedData(const QList<AbstractVisualizedData *> & content);
@@ -114,6 +118,8 @@ private:
     std::vector<QMetaObject::Connection> m_guiConnections;
     QMetaObject::Connection m_dataMinMaxChangedConnection;
 
+    std::unique_ptr<QFutureWatcher<void>> m_gradientPreloadWatcher;
+
 private:
     Q_DISABLE_COPY(ColorMappingChooser)
 };
@@ -19,12 +19,18 @@
 #include "ResidualViewConfigWidget.h"
 #include "ui_ResidualViewConfigWidget.h"
 
+#include <algorithm>
+
+#include <QPainter>
+#include <QPixmap>
+
 #include <core/data_objects/ImageDataObject.h>
 #include <core/data_objects/PolyDataObject.h>
 
 #include <core/DataSetHandler.h>
 #include <core/utility/mathhelper.h>
 #include <core/utility/qthelper.h>
+#include <core/utility/ScalarStatistics.h>
 #include <gui/data_view/ResidualVerificationView.h>
 #include <gui/data_view/RendererImplementationResidual.h>
 
@@ -54,6 +60,7 @@ void ResidualViewConfigWidget::setCurrentView(ResidualVerificationView * view)
     {
         m_ui->observationCombo->clear();
         m_ui->modelCombo->clear();
+        updateStatistics();
         return;
     }
 
@@ -182,7 +189,11 @@ void ResidualViewConfigWidget::setCurrentView(ResidualVerificationView * view)
 
     m_viewConnects.emplace_back(connect(m_ui->updateButton, &QAbstractButton::pressed, view, &ResidualVerificationView::updateResidual));
 
+    m_viewConnects.emplace_back(connect(view, &ResidualVerificationView::residualStatisticsChanged,
+        this, &ResidualViewConfigWidget::updateStatistics));
+
     updateComboBoxes();
+    updateStatistics();
 }
 
 void ResidualViewConfigWidget::updateComboBoxes()
@@ -263,3 +274,49 @@ void ResidualViewConfigWidget::updateModelFromUi(int index)
     auto dataObject = variantToDataObjectPtr(m_ui->modelCombo->itemData(index));
     m_currentView->setModelData(dataObject);
 }
+
+void ResidualViewConfigWidget::updateStatistics()
+{
+    const auto statistics = m_currentView ? m_currentView->residualStatistics() : ScalarStatistics();
+
+    if (!statistics.isValid())
+    {
+        m_ui->statisticsLabel->setText("No residual");
+        m_ui->histogramLabel->clear();
+        return;
+    }
+
+    const auto num = [] (double value) { return QString::number(value, 'g', 5); };
+
+    m_ui->statisticsLabel->setText(
+        "RMS: " + num(statistics.rootMeanSquare())
+        + "\nMean: " + num(statistics.mean())
+        + "    Std. Dev.: " + num(statistics.standardDeviation())
+        + "\nMedian (approx.): " + num(statistics.median())
+        + "\n5% / 95%: " + num(statistics.percentile(5)) + " / " + num(statistics.percentile(95))
+        + "\nMin / Max: " + num(statistics.minValue()) + " / " + num(statistics.maxValue())
+        + "\nValues: " + QString::number(statistics.count()));
+
+    const int numBins = 64;
+    const auto bins = statistics.histogram(numBins);
+    const auto maxCount = *std::max_element(bins.begin(), bins.end());
+
+    const QSize size(std::max(numBins, m_ui->histogramLabel->width() - 4), m_ui->histogramLabel->minimumHeight());
+    QPixmap pixmap(size);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    const auto binWidth = static_cast<double>(size.width()) / numBins;
+    const QColor barColor = palette().color(QPalette::Highlight);
+    for (int i = 0; i < numBins; ++i)
+    {
+        const auto height = maxCount > 0
+            ? static_cast<double>(bins[static_cast<size_t>(i)]) / maxCount * size.height()
+            : 0.0;
+        painter.fillRect(QRectF(i * binWidth, size.height() - height, binWidth, height), barColor);
+    }
+    painter.end();
+
+    m_ui->histogramLabel->setPixmap(pixmap);
+    m_ui->histogramLabel->setToolTip(QString("Residual histogram: %1 bins in [%2, %3]")
+        .arg(numBins).arg(num(statistics.minValue())).arg(num(statistics.maxValue())));
+}
@@ -44,6 +44,8 @@ private:
     void updateObservationFromUi(int index);
     void updateModelFromUi(int index);
 
+    void updateStatistics();
+
 private:
     std::unique_ptr<Ui_ResidualViewConfigWidget> m_ui;
 
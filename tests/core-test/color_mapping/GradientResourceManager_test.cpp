@@ -0,0 +1,210 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+
+#include <vtkLookupTable.h>
+
+#include <core/color_mapping/GradientLookupTableCache.h>
+#include <core/color_mapping/GradientResourceManager.h>
+
+#include "TestEnvironment.h"
+
+
+class GradientResourceManager_test : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        TestEnvironment::createTestDir();
+    }
+    void TearDown() override
+    {
+        TestEnvironment::clearTestDir();
+    }
+
+    static QString gradientsDir()
+    {
+        return QDir(TestEnvironment::testDirPath()).filePath("gradients");
+    }
+    static QString cacheDir()
+    {
+        return QDir(TestEnvironment::testDirPath()).filePath("gradients_cache");
+    }
+    static QString cacheFileName()
+    {
+        return QDir(cacheDir()).filePath("gradient.png.lut");
+    }
+
+    static GradientLookupTableCache::Entry testEntry()
+    {
+        GradientLookupTableCache::Entry entry;
+        entry.fileSize = 1234;
+        entry.lastModified = QDateTime::fromMSecsSinceEpoch(1500000000000);
+        entry.colors = {
+            255, 0, 0, 255,
+            0, 255, 0, 255,
+            0, 0, 255, 128 };
+        entry.preview = QImage(GradientResourceManager::previewSize(), QImage::Format_RGBA8888);
+        entry.preview.fill(Qt::red);
+        return entry;
+    }
+
+    /** Gradient image with red, green, and blue pixels */
+    static QString writeGradientImage()
+    {
+        QDir().mkpath(gradientsDir());
+        QImage image(3, 1, QImage::Format_RGB32);
+        image.setPixel(0, 0, qRgb(255, 0, 0));
+        image.setPixel(1, 0, qRgb(0, 255, 0));
+        image.setPixel(2, 0, qRgb(0, 0, 255));
+        const auto fileName = QDir(gradientsDir()).filePath("gradient.png");
+        image.save(fileName);
+        return fileName;
+    }
+
+    static void expectLookupTableColors(vtkLookupTable & lut, const std::vector<unsigned char> & colors)
+    {
+        ASSERT_EQ(static_cast<vtkIdType>(colors.size() / 4u), lut.GetNumberOfTableValues());
+        for (vtkIdType i = 0; i < lut.GetNumberOfTableValues(); ++i)
+        {
+            double rgba[4];
+            lut.GetTableValue(i, rgba);
+            for (int c = 0; c < 4; ++c)
+            {
+                ASSERT_DOUBLE_EQ(colors[static_cast<size_t>(i) * 4u + static_cast<size_t>(c)] / 255.0, rgba[c]);
+            }
+        }
+    }
+};
+
+
+TEST_F(GradientResourceManager_test, CacheRoundTrip)
+{
+    const auto written = testEntry();
+    ASSERT_TRUE(GradientLookupTableCache::write(cacheFileName(), written));
+
+    auto entry = testEntry();
+    entry.colors.clear();
+    entry.preview = {};
+    ASSERT_TRUE(GradientLookupTableCache::read(cacheFileName(), GradientResourceManager::previewSize(), entry));
+
+    ASSERT_EQ(written.colors, entry.colors);
+    ASSERT_EQ(written.preview, entry.preview);
+}
+
+TEST_F(GradientResourceManager_test, CacheInvalidatedByFileSizeOrModification)
+{
+    ASSERT_TRUE(GradientLookupTableCache::write(cacheFileName(), testEntry()));
+
+    auto resized = testEntry();
+    resized.fileSize += 1;
+    resized.colors.clear();
+    ASSERT_FALSE(GradientLookupTableCache::read(cacheFileName(), GradientResourceManager::previewSize(), resized));
+    ASSERT_TRUE(resized.colors.empty());
+
+    auto modified = testEntry();
+    modified.lastModified = modified.lastModified.addSecs(1);
+    modified.colors.clear();
+    ASSERT_FALSE(GradientLookupTableCache::read(cacheFileName(), GradientResourceManager::previewSize(), modified));
+    ASSERT_TRUE(modified.colors.empty());
+}
+
+TEST_F(GradientResourceManager_test, CacheRejectsCorruptFile)
+{
+    ASSERT_TRUE(GradientLookupTableCache::write(cacheFileName(), testEntry()));
+
+    auto entry = testEntry();
+    entry.colors.clear();
+
+    // truncated within the preview image
+    {
+        QFile file(cacheFileName());
+        ASSERT_TRUE(file.resize(file.size() - 10));
+    }
+    ASSERT_FALSE(GradientLookupTableCache::read(cacheFileName(), GradientResourceManager::previewSize(), entry));
+    ASSERT_TRUE(entry.colors.empty());
+
+    {
+        QFile file(cacheFileName());
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(QByteArray(200, '\x5A'));
+    }
+    ASSERT_FALSE(GradientLookupTableCache::read(cacheFileName(), GradientResourceManager::previewSize(), entry));
+    ASSERT_TRUE(entry.colors.empty());
+}
+
+TEST_F(GradientResourceManager_test, LookupTableReadFromCache)
+{
+    const auto imageFileName = writeGradientImage();
+
+    {
+        GradientResourceManager manager(gradientsDir(), cacheDir());
+        ASSERT_TRUE(manager.gradientNames().contains("gradient"));
+        expectLookupTableColors(*manager.gradient("gradient").lookupTable, {
+            255, 0, 0, 255,
+            0, 255, 0, 255,
+            0, 0, 255, 255 });
+    }
+    ASSERT_TRUE(QFileInfo(cacheFileName()).exists());
+
+    // Replace the cached colors, which are valid for the current image file.
+    auto cached = testEntry();
+    const QFileInfo imageInfo(imageFileName);
+    cached.fileSize = imageInfo.size();
+    cached.lastModified = imageInfo.lastModified();
+    ASSERT_TRUE(GradientLookupTableCache::write(cacheFileName(), cached));
+
+    GradientResourceManager manager(gradientsDir(), cacheDir());
+    expectLookupTableColors(*manager.gradient("gradient").lookupTable, cached.colors);
+}
+
+TEST_F(GradientResourceManager_test, FallsBackToImageOnCorruptCache)
+{
+    const auto imageFileName = writeGradientImage();
+
+    QDir().mkpath(cacheDir());
+    {
+        QFile file(cacheFileName());
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(200, '\x5A'));
+    }
+
+    const std::vector<unsigned char> imageColors = {
+        255, 0, 0, 255,
+        0, 255, 0, 255,
+        0, 0, 255, 255 };
+
+    GradientResourceManager manager(gradientsDir(), cacheDir());
+    expectLookupTableColors(*manager.gradient("gradient").lookupTable, imageColors);
+
+    // The corrupt file is replaced by a valid cache entry.
+    GradientLookupTableCache::Entry entry;
+    const QFileInfo imageInfo(imageFileName);
+    entry.fileSize = imageInfo.size();
+    entry.lastModified = imageInfo.lastModified();
+    ASSERT_TRUE(GradientLookupTableCache::read(cacheFileName(), GradientResourceManager::previewSize(), entry));
+    ASSERT_EQ(imageColors, entry.colors);
+}
@@ -192,3 +192,104 @@ TEST_F(DataProfile2DDataObject_test, PlotIrregularPointCloudFromGlobalMetric)
         ASSERT_EQ(double(i + 1), plotScalars->GetComponent(i, 0));
     }
 }
+
+TEST_F(DataProfile2DDataObject_test, DecimatedSwathProfileWithDeferredEvents)
+{
+    std::vector<vtkVector3d> coords;
+    for (int i = 0; i < 20; ++i)
+    {
+        coords.push_back({ 0.5 * i, 0.0, 0.0 });
+    }
+    auto pointPolyData = genPointPolyData(coords);
+    auto scalars = vtkSmartPointer<vtkFloatArray>::New();
+    scalars->SetName("Values");
+    scalars->SetNumberOfValues(20);
+    scalars->Fill(1.0);
+    pointPolyData->GetPointData()->SetScalars(scalars);
+
+    PointCloudDataObject pointCloud("Point Cloud", *pointPolyData);
+    DataProfile2DDataObject plot("Plot", pointCloud, "Values", IndexType::points, 0);
+    ASSERT_TRUE(plot.isValid());
+    plot.setProfileLinePoints({ 0.0, 0.0 }, { 9.5, 0.0 });
+    plot.setSwathWidth(1.0);
+    plot.setNumberOfSwathBins(10);
+
+    ASSERT_TRUE(plot.processedOutputDataSet());
+    ASSERT_EQ(10, plot.processedOutputDataSet()->GetNumberOfPoints());
+
+    int numDataChanged = 0;
+    QObject::connect(&plot, &DataObject::dataChanged, [&numDataChanged] () { ++numDataChanged; });
+
+    {
+        ScopedEventDeferral deferral(plot);
+        plot.setSamplingResolution(0.5);
+        ASSERT_EQ(0, numDataChanged);
+        ASSERT_TRUE(plot.computeProfile());
+        ASSERT_EQ(0, numDataChanged);
+        // Consumers of the processed output keep the previous profile meanwhile.
+        ASSERT_EQ(10, plot.processedOutputDataSet()->GetNumberOfPoints());
+    }
+    ASSERT_EQ(1, numDataChanged);
+
+    // The configured number of bins is kept, only the computed profile is decimated.
+    ASSERT_EQ(10, plot.numberOfSwathBins());
+    auto output = plot.processedOutputDataSet();
+    ASSERT_TRUE(output);
+    ASSERT_EQ(5, output->GetNumberOfPoints());
+}
+
+TEST_F(DataProfile2DDataObject_test, SwathSettingsAppliedAfterDeferredEvents)
+{
+    std::vector<vtkVector3d> coords;
+    for (int i = 0; i < 20; ++i)
+    {
+        coords.push_back({ 0.5 * i, 0.0, 0.0 });
+    }
+    auto pointPolyData = genPointPolyData(coords);
+    auto scalars = vtkSmartPointer<vtkFloatArray>::New();
+    scalars->SetName("Values");
+    scalars->SetNumberOfValues(20);
+    scalars->Fill(1.0);
+    pointPolyData->GetPointData()->SetScalars(scalars);
+
+    PointCloudDataObject pointCloud("Point Cloud", *pointPolyData);
+    DataProfile2DDataObject plot("Plot", pointCloud, "Values", IndexType::points, 0);
+    ASSERT_TRUE(plot.isValid());
+    plot.setProfileLinePoints({ 0.0, 0.0 }, { 9.5, 0.0 });
+    plot.setSwathWidth(1.0);
+    plot.setNumberOfSwathBins(10);
+
+    const auto numOutputPoints = [&plot] () -> vtkIdType
+    {
+        if (!plot.computeProfile())
+        {
+            return -1;
+        }
+        auto output = vtkPolyData::SafeDownCast(
+            plot.processedOutputPort()->GetProducer()->GetOutputDataObject(0));
+        return output ? output->GetNumberOfPoints() : -1;
+    };
+
+    ASSERT_EQ(10, numOutputPoints());
+
+    int numDataChanged = 0;
+    QObject::connect(&plot, &DataObject::dataChanged, [&numDataChanged] () { ++numDataChanged; });
+
+    {
+        // as while a profile is computed on a worker thread
+        ScopedEventDeferral deferral(plot);
+        plot.setNumberOfSwathBins(4);
+        plot.setSwathWidth(2.0);
+        plot.setNumberOfSwathBins(5);
+
+        ASSERT_EQ(5, plot.numberOfSwathBins());
+        ASSERT_EQ(2.0, plot.swathWidth());
+        // the pipeline is not modified until the events are executed
+        ASSERT_EQ(10, numOutputPoints());
+        ASSERT_EQ(0, numDataChanged);
+    }
+
+    // only the latest settings are applied
+    ASSERT_EQ(1, numDataChanged);
+    ASSERT_EQ(5, numOutputPoints());
+}
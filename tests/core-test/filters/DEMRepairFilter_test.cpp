@@ -0,0 +1,194 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkShortArray.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/DEMRepairFilter.h>
+
+
+class DEMRepairFilter_test : public ::testing::Test
+{
+public:
+    static const int nx = 40;
+    static const int ny = 30;
+
+    static double planeElevation(int x, int y)
+    {
+        return 100.0 + 2.0 * x - 3.0 * y;
+    }
+
+    static vtkSmartPointer<vtkImageData> generatePlaneDEM()
+    {
+        auto image = vtkSmartPointer<vtkImageData>::New();
+        image->SetExtent(0, nx - 1, 0, ny - 1, 0, 0);
+
+        auto elevations = vtkSmartPointer<vtkFloatArray>::New();
+        elevations->SetName("elevations");
+        elevations->SetNumberOfValues(image->GetNumberOfPoints());
+        for (int y = 0; y < ny; ++y)
+        {
+            for (int x = 0; x < nx; ++x)
+            {
+                elevations->SetValue(x + y * nx, static_cast<float>(planeElevation(x, y)));
+            }
+        }
+
+        image->GetPointData()->SetScalars(elevations);
+
+        return image;
+    }
+
+    static void setValue(vtkImageData & image, int x, int y, double value)
+    {
+        image.GetPointData()->GetScalars()->SetComponent(x + y * nx, 0, value);
+    }
+
+    static double value(vtkImageData & image, int x, int y)
+    {
+        return image.GetPointData()->GetScalars()->GetComponent(x + y * nx, 0);
+    }
+};
+
+TEST_F(DEMRepairFilter_test, FillsSpikeWithDirectionalMean)
+{
+    auto dem = generatePlaneDEM();
+    setValue(*dem, 10, 10, 9000.0);
+
+    auto filter = vtkSmartPointer<DEMRepairFilter>::New();
+    filter->SetInputData(dem);
+    filter->DetectSpikesOn();
+    filter->SetSpikeThreshold(6000.0);
+    filter->Update();
+
+    auto output = filter->GetOutput();
+    ASSERT_EQ(1, filter->GetNumberOfDetectedValues());
+    ASSERT_EQ(0, filter->GetNumberOfUnfilledValues());
+    ASSERT_FLOAT_EQ(static_cast<float>(planeElevation(10, 10)), static_cast<float>(value(*output, 10, 10)));
+    ASSERT_EQ(9000.0, value(*dem, 10, 10));
+}
+
+TEST_F(DEMRepairFilter_test, DetectsNoDataValues)
+{
+    auto dem = vtkSmartPointer<vtkImageData>::New();
+    dem->SetExtent(0, 4, 0, 0, 0, 0);
+    auto elevations = vtkSmartPointer<vtkShortArray>::New();
+    elevations->SetNumberOfValues(5);
+    elevations->SetValue(0, 10);
+    elevations->SetValue(1, -32768);
+    elevations->SetValue(2, -32768);
+    elevations->SetValue(3, -32768);
+    elevations->SetValue(4, 21);
+    dem->GetPointData()->SetScalars(elevations);
+
+    auto filter = vtkSmartPointer<DEMRepairFilter>::New();
+    filter->SetInputData(dem);
+    filter->DetectNoDataValueOn();
+    filter->Update();
+
+    auto output = filter->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_EQ(3, filter->GetNumberOfDetectedValues());
+    for (int i = 1; i < 4; ++i)
+    {
+        // rounded mean of the left and right values
+        ASSERT_EQ(16, output->GetComponent(i, 0));
+    }
+}
+
+TEST_F(DEMRepairFilter_test, DiffusionReproducesPlane)
+{
+    auto dem = generatePlaneDEM();
+    for (int y = 5; y < 20; ++y)
+    {
+        for (int x = 8; x < 30; ++x)
+        {
+            setValue(*dem, x, y, std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+
+    auto filter = vtkSmartPointer<DEMRepairFilter>::New();
+    filter->SetInputData(dem);
+    filter->SetFill(DEMRepairFilter::FillDiffusion);
+    filter->SetNumberOfIterations(500);
+    filter->Update();
+
+    auto output = filter->GetOutput();
+    ASSERT_EQ(15 * 22, filter->GetNumberOfDetectedValues());
+    for (int y = 5; y < 20; ++y)
+    {
+        for (int x = 8; x < 30; ++x)
+        {
+            ASSERT_NEAR(planeElevation(x, y), value(*output, x, y), 1e-2);
+        }
+    }
+}
+
+TEST_F(DEMRepairFilter_test, InverseDistanceLimitedToSearchRadius)
+{
+    auto dem = generatePlaneDEM();
+    for (int y = 0; y < ny; ++y)
+    {
+        for (int x = 10; x < 30; ++x)
+        {
+            setValue(*dem, x, y, std::numeric_limits<double>::quiet_NaN());
+        }
+    }
+
+    auto filter = vtkSmartPointer<DEMRepairFilter>::New();
+    filter->SetInputData(dem);
+    filter->SetFill(DEMRepairFilter::FillInverseDistance);
+    filter->SetSearchRadius(5);
+    filter->Update();
+
+    auto output = filter->GetOutput();
+    ASSERT_EQ(20 * ny, filter->GetNumberOfDetectedValues());
+    // columns 15 to 24 are not within the search radius of valid values
+    ASSERT_EQ(10 * ny, filter->GetNumberOfUnfilledValues());
+    ASSERT_FALSE(std::isnan(value(*output, 14, 3)));
+    ASSERT_TRUE(std::isnan(value(*output, 15, 3)));
+    ASSERT_TRUE(std::isnan(value(*output, 24, 3)));
+    ASSERT_FALSE(std::isnan(value(*output, 25, 3)));
+}
+
+TEST_F(DEMRepairFilter_test, PassesInputIfDetectionDisabled)
+{
+    auto dem = generatePlaneDEM();
+    setValue(*dem, 10, 10, std::numeric_limits<double>::quiet_NaN());
+    setValue(*dem, 20, 10, 9000.0);
+
+    auto filter = vtkSmartPointer<DEMRepairFilter>::New();
+    filter->SetInputData(dem);
+    filter->DetectNaNOff();
+    filter->DetectNoDataValueOff();
+    filter->DetectSpikesOff();
+    filter->Update();
+
+    auto output = filter->GetOutput();
+    ASSERT_EQ(0, filter->GetNumberOfDetectedValues());
+    ASSERT_EQ(dem->GetPointData()->GetScalars(), output->GetPointData()->GetScalars());
+    ASSERT_TRUE(std::isnan(value(*output, 10, 10)));
+    ASSERT_EQ(9000.0, value(*output, 20, 10));
+}
@@ -0,0 +1,158 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <vtkAssignAttribute.h>
+#include <vtkExecutive.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <core/filters/DEMApplyShadingToColors.h>
+#include <core/filters/DEMImageNormals.h>
+#include <core/filters/DEMShadedColorsFilter.h>
+#include <core/filters/DEMShadingFilter.h>
+
+
+class DEMShadedColorsFilter_test : public ::testing::Test
+{
+public:
+    vtkSmartPointer<vtkImageData> dem;
+
+    void SetUp() override
+    {
+        dem = vtkSmartPointer<vtkImageData>::New();
+        dem->SetExtent(0, 6, 0, 4, 0, 0);
+        dem->SetSpacing(0.1, 0.2, 1.0);
+        dem->AllocateScalars(VTK_FLOAT, 1);
+        auto elevations = dem->GetPointData()->GetScalars();
+        elevations->SetName("Elevations");
+
+        auto colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+        colors->SetName("Colors");
+        colors->SetNumberOfComponents(4);
+        colors->SetNumberOfTuples(dem->GetNumberOfPoints());
+        dem->GetPointData()->AddArray(colors);
+
+        for (vtkIdType i = 0; i < dem->GetNumberOfPoints(); ++i)
+        {
+            elevations->SetComponent(i, 0, 1000.0 * std::sin(0.7 * static_cast<double>(i)));
+            for (int c = 0; c < 4; ++c)
+            {
+                colors->SetComponent(i, c, static_cast<double>((i * 37 + c * 71) % 256));
+            }
+        }
+    }
+
+    /** Reference result of the separate DEMImageNormals/DEMShadingFilter/DEMApplyShadingToColors */
+    vtkSmartPointer<vtkImageData> referenceChain()
+    {
+        auto normals = vtkSmartPointer<DEMImageNormals>::New();
+        normals->SetInputData(dem);
+        auto shading = vtkSmartPointer<DEMShadingFilter>::New();
+        shading->SetInputConnection(normals->GetOutputPort());
+        auto assignColors = vtkSmartPointer<vtkAssignAttribute>::New();
+        assignColors->SetInputConnection(shading->GetOutputPort());
+        assignColors->Assign("Colors", vtkDataSetAttributes::SCALARS, vtkAssignAttribute::POINT_DATA);
+        auto applyShading = vtkSmartPointer<DEMApplyShadingToColors>::New();
+        applyShading->SetInputConnection(assignColors->GetOutputPort());
+        applyShading->Update();
+        return applyShading->GetOutput();
+    }
+};
+
+TEST_F(DEMShadedColorsFilter_test, MatchesFilterChain)
+{
+    auto reference = referenceChain();
+    auto referenceColors = reference->GetPointData()->GetScalars();
+    ASSERT_TRUE(referenceColors);
+
+    auto filter = vtkSmartPointer<DEMShadedColorsFilter>::New();
+    filter->SetInputData(dem);
+    filter->SetColorsArrayName("Colors");
+    filter->OutputNormalsOn();
+    filter->OutputLightnessOn();
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+
+    auto & pointData = *filter->GetOutput()->GetPointData();
+    auto colors = pointData.GetScalars();
+    ASSERT_TRUE(colors);
+    ASSERT_STREQ("Colors/Shading", colors->GetName());
+    ASSERT_EQ(VTK_UNSIGNED_CHAR, colors->GetDataType());
+    ASSERT_EQ(referenceColors->GetNumberOfTuples(), colors->GetNumberOfTuples());
+    ASSERT_EQ(4, colors->GetNumberOfComponents());
+
+    auto normals = pointData.GetNormals();
+    auto referenceNormals = reference->GetPointData()->GetNormals();
+    ASSERT_TRUE(normals);
+    auto lightness = pointData.GetArray("Lightness");
+    auto referenceLightness = reference->GetPointData()->GetArray("Lightness");
+    ASSERT_TRUE(lightness);
+
+    for (vtkIdType i = 0; i < colors->GetNumberOfTuples(); ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            ASSERT_EQ(referenceColors->GetComponent(i, c), colors->GetComponent(i, c));
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            ASSERT_FLOAT_EQ(
+                static_cast<float>(referenceNormals->GetComponent(i, c)),
+                static_cast<float>(normals->GetComponent(i, c)));
+        }
+        ASSERT_FLOAT_EQ(
+            static_cast<float>(referenceLightness->GetComponent(i, 0)),
+            static_cast<float>(lightness->GetComponent(i, 0)));
+    }
+}
+
+TEST_F(DEMShadedColorsFilter_test, IntermediatesOnlyOnDemand)
+{
+    auto filter = vtkSmartPointer<DEMShadedColorsFilter>::New();
+    filter->SetInputData(dem);
+    filter->SetColorsArrayName("Colors");
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+
+    auto & pointData = *filter->GetOutput()->GetPointData();
+    ASSERT_EQ(nullptr, pointData.GetNormals());
+    ASSERT_EQ(nullptr, pointData.GetArray("Lightness"));
+    ASSERT_TRUE(pointData.GetArray("Elevations"));
+}
+
+TEST_F(DEMShadedColorsFilter_test, LightnessWithoutColors)
+{
+    auto filter = vtkSmartPointer<DEMShadedColorsFilter>::New();
+    filter->SetInputData(dem);
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+
+    auto lightness = filter->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_TRUE(lightness);
+    ASSERT_STREQ("Lightness", lightness->GetName());
+    ASSERT_EQ(1, lightness->GetNumberOfComponents());
+
+    for (vtkIdType i = 0; i < lightness->GetNumberOfTuples(); ++i)
+    {
+        const auto value = lightness->GetComponent(i, 0);
+        ASSERT_LE(filter->GetAmbient(), value);
+        ASSERT_GE(1.0, value);
+    }
+}
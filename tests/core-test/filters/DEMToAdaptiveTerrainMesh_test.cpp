@@ -0,0 +1,212 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdList.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/DEMToAdaptiveTerrainMesh.h>
+
+
+class DEMToAdaptiveTerrainMesh_test : public ::testing::Test
+{
+public:
+    template<typename Function>
+    static vtkSmartPointer<vtkImageData> generateDEM(int nx, int ny, Function && elevation)
+    {
+        auto image = vtkSmartPointer<vtkImageData>::New();
+        image->SetExtent(0, nx - 1, 0, ny - 1, 0, 0);
+        image->SetOrigin(10, 20, 0);
+        image->SetSpacing(0.5, 0.25, 1);
+
+        auto elevations = vtkSmartPointer<vtkFloatArray>::New();
+        elevations->SetName("elevations");
+        elevations->SetNumberOfValues(image->GetNumberOfPoints());
+
+        for (int y = 0; y < ny; ++y)
+        {
+            for (int x = 0; x < nx; ++x)
+            {
+                elevations->SetValue(x + y * nx, static_cast<float>(elevation(x, y)));
+            }
+        }
+
+        image->GetPointData()->SetScalars(elevations);
+
+        return image;
+    }
+
+    static double roughElevation(int x, int y)
+    {
+        return 3.0 * std::sin(0.3 * x) + 2.0 * std::cos(0.2 * y) + 0.1 * ((x * 7 + y * 13) % 5);
+    }
+
+    /** Maximum deviation of DEM samples from the triangles covering them. */
+    static double maximumError(vtkImageData & dem, vtkPolyData & mesh)
+    {
+        double error = 0.0;
+        auto ids = vtkSmartPointer<vtkIdList>::New();
+        auto polys = mesh.GetPolys();
+        polys->InitTraversal();
+        while (polys->GetNextCell(ids))
+        {
+            double p[3][3];
+            for (int i = 0; i < 3; ++i)
+            {
+                mesh.GetPoint(ids->GetId(i), p[i]);
+            }
+            const auto area2 = (p[1][0] - p[0][0]) * (p[2][1] - p[0][1])
+                - (p[1][1] - p[0][1]) * (p[2][0] - p[0][0]);
+
+            for (vtkIdType i = 0; i < dem.GetNumberOfPoints(); ++i)
+            {
+                double s[3];
+                dem.GetPoint(i, s);
+                const auto w0 = ((p[1][0] - s[0]) * (p[2][1] - s[1]) - (p[1][1] - s[1]) * (p[2][0] - s[0])) / area2;
+                const auto w1 = ((p[2][0] - s[0]) * (p[0][1] - s[1]) - (p[2][1] - s[1]) * (p[0][0] - s[0])) / area2;
+                const auto w2 = 1.0 - w0 - w1;
+                if (w0 < -1e-9 || w1 < -1e-9 || w2 < -1e-9)
+                {
+                    continue;
+                }
+                const auto z = w0 * p[0][2] + w1 * p[1][2] + w2 * p[2][2];
+                const auto sample = dem.GetPointData()->GetScalars()->GetComponent(i, 0);
+                error = std::max(error, std::abs(z - sample));
+            }
+        }
+        return error;
+    }
+};
+
+TEST_F(DEMToAdaptiveTerrainMesh_test, PlanarDEMWithFewTriangles)
+{
+    auto dem = generateDEM(33, 33, [] (int x, int y) { return 0.5 * x - 0.25 * y; });
+
+    auto filter = vtkSmartPointer<DEMToAdaptiveTerrainMesh>::New();
+    filter->SetInputData(dem);
+    filter->SetMaximumError(0.001);
+    filter->Update();
+
+    auto mesh = filter->GetOutput();
+    ASSERT_EQ(2, mesh->GetNumberOfCells());
+    ASSERT_EQ(4, mesh->GetNumberOfPoints());
+
+    double bounds[6], demBounds[6];
+    mesh->GetBounds(bounds);
+    dem->GetBounds(demBounds);
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_DOUBLE_EQ(demBounds[i], bounds[i]);
+    }
+}
+
+TEST_F(DEMToAdaptiveTerrainMesh_test, RespectsMaximumError)
+{
+    auto dem = generateDEM(45, 37, roughElevation);
+
+    auto filter = vtkSmartPointer<DEMToAdaptiveTerrainMesh>::New();
+    filter->SetInputData(dem);
+    filter->SetTileSize(16);
+    filter->SetMaximumError(0.5);
+    filter->Update();
+
+    auto mesh = filter->GetOutput();
+    ASSERT_GT(mesh->GetNumberOfCells(), 0);
+    ASSERT_LT(mesh->GetNumberOfCells(), 2 * 44 * 36);
+    ASSERT_LE(maximumError(*dem, *mesh), 0.5 + 1e-5);
+}
+
+TEST_F(DEMToAdaptiveTerrainMesh_test, RespectsMaximumErrorWithDefaultTileSize)
+{
+    // larger than a single default tile (257 samples)
+    auto dem = generateDEM(300, 280, roughElevation);
+
+    auto filter = vtkSmartPointer<DEMToAdaptiveTerrainMesh>::New();
+    filter->SetInputData(dem);
+    filter->SetMaximumError(0.5);
+    filter->Update();
+
+    auto mesh = filter->GetOutput();
+    ASSERT_GT(mesh->GetNumberOfCells(), 0);
+    ASSERT_LT(mesh->GetNumberOfCells(), 2 * 299 * 279);
+    ASSERT_LE(maximumError(*dem, *mesh), 0.5 + 1e-5);
+}
+
+TEST_F(DEMToAdaptiveTerrainMesh_test, CoversDEMWithPartialTiles)
+{
+    auto dem = generateDEM(45, 37, roughElevation);
+
+    auto filter = vtkSmartPointer<DEMToAdaptiveTerrainMesh>::New();
+    filter->SetInputData(dem);
+    filter->SetTileSize(16);
+    filter->SetMaximumError(1.0);
+    filter->Update();
+
+    auto mesh = filter->GetOutput();
+    double area = 0.0;
+    auto ids = vtkSmartPointer<vtkIdList>::New();
+    auto polys = mesh->GetPolys();
+    polys->InitTraversal();
+    while (polys->GetNextCell(ids))
+    {
+        double p[3][3];
+        for (int i = 0; i < 3; ++i)
+        {
+            mesh->GetPoint(ids->GetId(i), p[i]);
+        }
+        const auto area2 = (p[1][0] - p[0][0]) * (p[2][1] - p[0][1])
+            - (p[1][1] - p[0][1]) * (p[2][0] - p[0][0]);
+        // counter-clockwise
+        ASSERT_GT(area2, 0.0);
+        area += 0.5 * area2;
+    }
+
+    ASSERT_NEAR(44 * 0.5 * 36 * 0.25, area, 1e-9);
+}
+
+TEST_F(DEMToAdaptiveTerrainMesh_test, NormalsOnlyOnDemand)
+{
+    auto dem = generateDEM(17, 17, roughElevation);
+
+    auto filter = vtkSmartPointer<DEMToAdaptiveTerrainMesh>::New();
+    filter->SetInputData(dem);
+    filter->Update();
+
+    ASSERT_EQ(nullptr, filter->GetOutput()->GetPointData()->GetNormals());
+    ASSERT_NE(nullptr, filter->GetOutput()->GetPointData()->GetScalars());
+
+    filter->ComputeNormalsOn();
+    filter->Update();
+
+    auto normals = filter->GetOutput()->GetPointData()->GetNormals();
+    ASSERT_NE(nullptr, normals);
+    ASSERT_EQ(filter->GetOutput()->GetNumberOfPoints(), normals->GetNumberOfTuples());
+    for (vtkIdType i = 0; i < normals->GetNumberOfTuples(); ++i)
+    {
+        ASSERT_GT(normals->GetComponent(i, 2), 0.0);
+    }
+}
@@ -210,3 +210,46 @@ TEST_F(DEMToTopographyMesh_test, DEMToLocal_CorrectMeshBounds)
     ASSERT_DOUBLE_EQ(localDEMBounds.extractDimension(0)[1], transformedMeshBounds.extractDimension(0)[1]);
     ASSERT_NEAR(inMeshRatio, outMeshRation, 0.000000016);
 }
+
+TEST_F(DEMToTopographyMesh_test, InterpolatesElevationsBilinearly)
+{
+    auto dem = generateDEM();
+    dem->SetOrigin(-1.5, -2.5, 0);
+    dem->SetSpacing(0.5, 0.25, 1);
+    auto elevations = dem->GetPointData()->GetScalars();
+    // planar DEM: elevation = 2x - 3y, exactly reproduced by bilinear interpolation
+    for (vtkIdType i = 0; i < dem->GetNumberOfPoints(); ++i)
+    {
+        vtkVector3d point;
+        dem->GetPoint(i, point.GetData());
+        elevations->SetComponent(i, 0, 2.0 * point[0] - 3.0 * point[1]);
+    }
+
+    auto mesh = generateMesh();
+
+    auto filter = vtkSmartPointer<DEMToTopographyMesh>::New();
+    filter->SetInputDEM(dem);
+    filter->SetInputMeshTemplate(mesh);
+    filter->SetParametersToMatching();
+    filter->SetElevationScaleFactor(0.5);
+
+    ASSERT_EQ(1, filter->GetExecutive()->Update());
+    auto topoOnDEM = filter->GetOutputTopoMeshOnDEM();
+    auto topography = filter->GetOutputTopography();
+    ASSERT_EQ(mesh->GetNumberOfPoints(), topoOnDEM->GetNumberOfPoints());
+    ASSERT_EQ(mesh->GetNumberOfCells(), topoOnDEM->GetNumberOfCells());
+
+    const auto shift = filter->GetTopographyShiftXY();
+
+    for (vtkIdType i = 0; i < topoOnDEM->GetNumberOfPoints(); ++i)
+    {
+        vtkVector3d point, centeredPoint;
+        topoOnDEM->GetPoint(i, point.GetData());
+        topography->GetPoint(i, centeredPoint.GetData());
+
+        ASSERT_NEAR(0.5 * (2.0 * point[0] - 3.0 * point[1]), point[2], 1.e-5);
+        ASSERT_NEAR(point[0] - shift[0], centeredPoint[0], 1.e-5);
+        ASSERT_NEAR(point[1] - shift[1], centeredPoint[1], 1.e-5);
+        ASSERT_EQ(point[2], centeredPoint[2]);
+    }
+}
@@ -19,9 +19,13 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <cmath>
+#include <vector>
 
+#include <vtkCellData.h>
 #include <vtkExecutive.h>
 #include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkImageData.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
@@ -33,11 +37,42 @@
 #include <core/utility/vtkvectorhelper.h>
 
 #include <core/utility/GeographicTransformationUtil.h>
+#include <core/utility/KruegerTransverseMercator.h>
 
 
 class GeographicTransformationFilter_test : public ::testing::Test
 {
 public:
+    static const ReferencedCoordinateSystemSpecification & largeExtentGeoSpec()
+    {
+        static const auto spec = ReferencedCoordinateSystemSpecification(
+            CoordinateSystemType::geographic, "WGS 84", "UTM", {}, { 45.0, 9.0 });
+        return spec;
+    }
+
+    /**
+     * Image covering a whole UTM zone: origin/spacing adjustment is not sufficient here.
+     * The latitude is stored as point attribute, which is exactly reproduced by bilinear
+     * interpolation.
+     */
+    static vtkSmartPointer<vtkImageData> generateLargeExtentDEM()
+    {
+        auto dem = vtkSmartPointer<vtkImageData>::New();
+        dem->SetExtent(0, 60, 0, 40, 0, 0);
+        dem->SetOrigin(6.0, 43.0, 0.0);
+        dem->SetSpacing(0.1, 0.1, 1.0);
+        largeExtentGeoSpec().writeToFieldData(*dem->GetFieldData());
+        auto latitudes = vtkSmartPointer<vtkFloatArray>::New();
+        latitudes->SetName("latitude");
+        latitudes->SetNumberOfValues(dem->GetNumberOfPoints());
+        for (vtkIdType i = 0; i < dem->GetNumberOfPoints(); ++i)
+        {
+            latitudes->SetValue(i, static_cast<float>(dem->GetPoint(i)[1]));
+        }
+        dem->GetPointData()->SetScalars(latitudes);
+        return dem;
+    }
+
     static const DataBounds & dataBounds_WGS84()
     {
         static const auto bounds =
@@ -153,6 +188,38 @@ public:
         return poly;
     }
 
+    /** Point cloud spread over the data bounds, large enough for parallel transformation. */
+    static vtkSmartPointer<vtkPolyData> generatePointCloud(const CoordinateSystemType type,
+        const vtkIdType numPoints)
+    {
+        auto spec = type == CoordinateSystemType::geographic ? dataSpec_WGS84()
+            : (type == CoordinateSystemType::metricGlobal ? dataSpec_WGS84_UTM()
+                : dataSpec_WGS84_UTM_local());
+        auto bounds = type == CoordinateSystemType::geographic
+            ? dataBounds_WGS84()
+            : (type == CoordinateSystemType::metricGlobal ? dataBounds_WGS84_UTM()
+                : dataBounds_WGS84_UTM_local());
+
+        const auto min = bounds.min();
+        const auto size = bounds.componentSize();
+
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetDataTypeToDouble();
+        points->SetNumberOfPoints(numPoints);
+        for (vtkIdType i = 0; i < numPoints; ++i)
+        {
+            const double t = static_cast<double>(i) / static_cast<double>(numPoints - 1);
+            points->SetPoint(i,
+                min[0] + size[0] * t,
+                min[1] + size[1] * std::fmod(t * 97.0, 1.0),
+                min[2] + size[2] * std::fmod(t * 13.0, 1.0));
+        }
+        poly->SetPoints(points);
+        spec.writeToFieldData(*poly->GetFieldData());
+
+        return poly;
+    }
 };
 
 TEST_F(GeographicTransformationFilter_test, ImageGeoToLocal)
@@ -272,3 +339,347 @@ TEST_F(GeographicTransformationFilter_test, PolyLocalToGeo)
         ASSERT_NEAR(dataBounds_WGS84()[i], bounds[i], 5.e-8);
     }
 }
+
+TEST_F(GeographicTransformationFilter_test, ParallelProjectionMatchesSerial)
+{
+    for (const auto sourceType : { CoordinateSystemType::geographic, CoordinateSystemType::metricLocal })
+    {
+        const auto targetSpec = sourceType == CoordinateSystemType::geographic
+            ? dataSpec_WGS84_UTM_local()
+            : dataSpec_WGS84();
+        auto points = generatePointCloud(sourceType, 100000);
+
+        auto serial = vtkSmartPointer<GeographicTransformationFilter>::New();
+        serial->ParallelProjectionOff();
+        serial->SetInputData(points);
+        serial->SetTargetCoordinateSystem(targetSpec);
+        ASSERT_TRUE(serial->GetExecutive()->Update());
+
+        auto parallel = vtkSmartPointer<GeographicTransformationFilter>::New();
+        ASSERT_TRUE(parallel->GetParallelProjection());
+        parallel->SetInputData(points);
+        parallel->SetTargetCoordinateSystem(targetSpec);
+        ASSERT_TRUE(parallel->GetExecutive()->Update());
+
+        auto serialPoints = vtkPolyData::SafeDownCast(serial->GetOutput())->GetPoints();
+        auto parallelPoints = vtkPolyData::SafeDownCast(parallel->GetOutput())->GetPoints();
+        ASSERT_EQ(serialPoints->GetNumberOfPoints(), parallelPoints->GetNumberOfPoints());
+        for (vtkIdType i = 0; i < serialPoints->GetNumberOfPoints(); ++i)
+        {
+            const auto s = vtkVector3d(serialPoints->GetPoint(i));
+            const auto p = vtkVector3d(parallelPoints->GetPoint(i));
+            ASSERT_EQ(s, p) << "Point " << i;
+        }
+    }
+}
+
+TEST_F(GeographicTransformationFilter_test, FastProjectionMatchesExact)
+{
+    for (const auto sourceType : { CoordinateSystemType::geographic, CoordinateSystemType::metricLocal })
+    {
+        const bool toGeographic = sourceType != CoordinateSystemType::geographic;
+        const auto targetSpec = toGeographic ? dataSpec_WGS84() : dataSpec_WGS84_UTM_local();
+        // documented accuracy of the fast projection, or roughly 1 mm in degrees
+        const double tolerance = toGeographic ? 1e-8 : KruegerTransverseMercator::maximumError();
+        auto points = generatePointCloud(sourceType, 10000);
+
+        auto exact = vtkSmartPointer<GeographicTransformationFilter>::New();
+        exact->SetProjection(GeographicTransformationFilter::ProjectionExact);
+        exact->SetInputData(points);
+        exact->SetTargetCoordinateSystem(targetSpec);
+        ASSERT_TRUE(exact->GetExecutive()->Update());
+
+        auto fast = vtkSmartPointer<GeographicTransformationFilter>::New();
+        fast->SetProjection(GeographicTransformationFilter::ProjectionFast);
+        fast->SetInputData(points);
+        fast->SetTargetCoordinateSystem(targetSpec);
+        ASSERT_TRUE(fast->GetExecutive()->Update());
+
+        auto exactPoints = vtkPolyData::SafeDownCast(exact->GetOutput())->GetPoints();
+        auto fastPoints = vtkPolyData::SafeDownCast(fast->GetOutput())->GetPoints();
+        ASSERT_EQ(exactPoints->GetNumberOfPoints(), fastPoints->GetNumberOfPoints());
+        for (vtkIdType i = 0; i < exactPoints->GetNumberOfPoints(); ++i)
+        {
+            const auto e = vtkVector3d(exactPoints->GetPoint(i));
+            const auto f = vtkVector3d(fastPoints->GetPoint(i));
+            ASSERT_NEAR(e[0], f[0], tolerance) << "Point " << i;
+            ASSERT_NEAR(e[1], f[1], tolerance) << "Point " << i;
+            ASSERT_EQ(e[2], f[2]) << "Point " << i;
+        }
+    }
+}
+
+TEST_F(GeographicTransformationFilter_test, DefaultProjectionMethodModifiesFilter)
+{
+    const auto previousDefault = GeographicTransformationFilter::GetDefaultProjectionMethod();
+
+    auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
+    ASSERT_EQ(GeographicTransformationFilter::ProjectionDefault, filter->GetProjection());
+    GeographicTransformationFilter::SetDefaultProjectionMethod(GeographicTransformationFilter::ProjectionExact);
+    const auto mTime = filter->GetMTime();
+
+    GeographicTransformationFilter::SetDefaultProjectionMethod(GeographicTransformationFilter::ProjectionFast);
+    ASSERT_EQ(GeographicTransformationFilter::ProjectionFast, filter->GetEffectiveProjectionMethod());
+    ASSERT_GT(filter->GetMTime(), mTime);
+
+    GeographicTransformationFilter::SetDefaultProjectionMethod(previousDefault);
+}
+
+TEST_F(GeographicTransformationFilter_test, TransformationUtilMatchesFilter)
+{
+    for (const auto sourceType : {
+        CoordinateSystemType::geographic, CoordinateSystemType::metricGlobal, CoordinateSystemType::metricLocal })
+    {
+        const auto sourceSpec = sourceType == CoordinateSystemType::geographic ? dataSpec_WGS84()
+            : (sourceType == CoordinateSystemType::metricGlobal ? dataSpec_WGS84_UTM()
+                : dataSpec_WGS84_UTM_local());
+        for (const auto & targetSpec : {
+            dataSpec_WGS84(), dataSpec_WGS84_UTM(), dataSpec_WGS84_UTM_local() })
+        {
+            auto poly = generatePointCloud(sourceType, 100);
+
+            auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
+            filter->SetInputData(poly);
+            filter->SetTargetCoordinateSystem(targetSpec);
+            ASSERT_TRUE(filter->GetExecutive()->Update());
+            auto filterPoints = vtkPolyData::SafeDownCast(filter->GetOutput())->GetPoints();
+
+            const GeographicTransformationUtil util(sourceSpec, targetSpec);
+            ASSERT_TRUE(util.isTransformationSupported());
+            std::vector<vtkVector3d> points(static_cast<size_t>(poly->GetNumberOfPoints()));
+            for (vtkIdType i = 0; i < poly->GetNumberOfPoints(); ++i)
+            {
+                poly->GetPoint(i, points[static_cast<size_t>(i)].GetData());
+            }
+            ASSERT_TRUE(util.transformPoints(points));
+
+            for (vtkIdType i = 0; i < poly->GetNumberOfPoints(); ++i)
+            {
+                const auto expected = vtkVector3d(filterPoints->GetPoint(i));
+                const auto & actual = points[static_cast<size_t>(i)];
+                for (int c = 0; c < 3; ++c)
+                {
+                    ASSERT_NEAR(expected[c], actual[c], std::abs(expected[c]) * 1e-12 + 1e-9)
+                        << "Point " << i << ", component " << c;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(GeographicTransformationFilter_test, TransformationUtilMatchesFilterForSourceUnits)
+{
+    for (const auto sourceType : { CoordinateSystemType::metricGlobal, CoordinateSystemType::metricLocal })
+    {
+        auto sourceSpec = sourceType == CoordinateSystemType::metricGlobal
+            ? dataSpec_WGS84_UTM() : dataSpec_WGS84_UTM_local();
+        sourceSpec.unitOfMeasurement = "km";
+
+        // Same points as in meters, so that the geographic result must not change.
+        auto referencePoly = generatePointCloud(sourceType, 100);
+        auto poly = generatePointCloud(sourceType, 100);
+        sourceSpec.writeToFieldData(*poly->GetFieldData());
+        auto polyPoints = poly->GetPoints();
+        for (vtkIdType i = 0; i < polyPoints->GetNumberOfPoints(); ++i)
+        {
+            auto point = vtkVector3d(polyPoints->GetPoint(i)) * 0.001;
+            polyPoints->SetPoint(i, point.GetData());
+        }
+
+        auto referenceFilter = vtkSmartPointer<GeographicTransformationFilter>::New();
+        referenceFilter->SetInputData(referencePoly);
+        referenceFilter->SetTargetCoordinateSystem(dataSpec_WGS84());
+        ASSERT_TRUE(referenceFilter->GetExecutive()->Update());
+        auto referencePoints = vtkPolyData::SafeDownCast(referenceFilter->GetOutput())->GetPoints();
+
+        auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
+        filter->SetInputData(poly);
+        filter->SetTargetCoordinateSystem(dataSpec_WGS84());
+        ASSERT_TRUE(filter->GetExecutive()->Update());
+        auto filterPoints = vtkPolyData::SafeDownCast(filter->GetOutput())->GetPoints();
+
+        const GeographicTransformationUtil util(sourceSpec, dataSpec_WGS84());
+        std::vector<vtkVector3d> points(static_cast<size_t>(poly->GetNumberOfPoints()));
+        for (vtkIdType i = 0; i < poly->GetNumberOfPoints(); ++i)
+        {
+            poly->GetPoint(i, points[static_cast<size_t>(i)].GetData());
+        }
+        ASSERT_TRUE(util.transformPoints(points));
+
+        for (vtkIdType i = 0; i < poly->GetNumberOfPoints(); ++i)
+        {
+            const auto reference = vtkVector3d(referencePoints->GetPoint(i));
+            const auto fromFilter = vtkVector3d(filterPoints->GetPoint(i));
+            const auto & fromUtil = points[static_cast<size_t>(i)];
+            for (int c = 0; c < 2; ++c)
+            {
+                ASSERT_NEAR(reference[c], fromFilter[c], 1e-9) << "Point " << i << ", component " << c;
+                ASSERT_NEAR(fromFilter[c], fromUtil[c], 1e-9) << "Point " << i << ", component " << c;
+            }
+            ASSERT_EQ(fromFilter[2], fromUtil[2]) << "Point " << i;
+        }
+    }
+}
+
+TEST_F(GeographicTransformationFilter_test, TransformationUtilKeepsPointsOnFailure)
+{
+    const auto previousDefault = GeographicTransformationFilter::GetDefaultProjectionMethod();
+    GeographicTransformationFilter::SetDefaultProjectionMethod(GeographicTransformationFilter::ProjectionExact);
+
+    const GeographicTransformationUtil util(dataSpec_WGS84(), dataSpec_WGS84_UTM_local());
+    ASSERT_TRUE(util.isTransformationSupported());
+
+    // The latitude of the second point is out of range.
+    const std::vector<vtkVector3d> sourcePoints = {
+        vtkVector3d(-64.69, 32.357, 300.0), vtkVector3d(-64.69, 100.0, 300.0) };
+    auto points = sourcePoints;
+    const bool success = util.transformPoints(points);
+
+    GeographicTransformationFilter::SetDefaultProjectionMethod(previousDefault);
+
+    ASSERT_FALSE(success);
+    ASSERT_EQ(sourcePoints, points);
+}
+
+TEST_F(GeographicTransformationFilter_test, ImageResampleForLargeExtent)
+{
+    const auto & geoSpec = largeExtentGeoSpec();
+    auto dem = generateLargeExtentDEM();
+    auto latitudes = dem->GetPointData()->GetScalars();
+
+    auto targetSpec = dataSpec_WGS84_UTM();
+
+    auto affineFilter = vtkSmartPointer<GeographicTransformationFilter>::New();
+    affineFilter->SetInputData(dem);
+    affineFilter->SetTargetCoordinateSystem(targetSpec);
+    ASSERT_EQ(GeographicTransformationFilter::ImageTransformAffine, affineFilter->GetImageTransform());
+    ASSERT_TRUE(affineFilter->GetExecutive()->Update());
+    auto affineImage = vtkImageData::SafeDownCast(affineFilter->GetOutput());
+    ASSERT_TRUE(affineImage);
+    ASSERT_EQ(latitudes, affineImage->GetPointData()->GetScalars());
+
+    auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
+    filter->SetInputData(dem);
+    filter->SetTargetCoordinateSystem(targetSpec);
+    filter->SetImageTransform(GeographicTransformationFilter::ImageTransformAutomatic);
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto image = vtkImageData::SafeDownCast(filter->GetOutput());
+    ASSERT_TRUE(image);
+    ASSERT_EQ(dem->GetNumberOfPoints(), image->GetNumberOfPoints());
+    auto resampled = image->GetPointData()->GetScalars();
+    ASSERT_TRUE(resampled);
+    ASSERT_NE(latitudes, resampled);
+    ASSERT_STREQ("latitude", resampled->GetName());
+
+    const GeographicTransformationUtil toGeographic(
+        ReferencedCoordinateSystemSpecification(targetSpec, geoSpec.referencePointLatLong),
+        geoSpec);
+    vtkIdType numInside = 0;
+    for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+        const double value = resampled->GetTuple1(i);
+        if (std::isnan(value))
+        {
+            continue;
+        }
+        ++numInside;
+        bool success = false;
+        const auto geoPoint = toGeographic.transformPoint(vtkVector3d(image->GetPoint(i)), &success);
+        ASSERT_TRUE(success);
+        ASSERT_NEAR(geoPoint[1], value, 1e-4) << "Point " << i;
+    }
+    ASSERT_GT(numInside, image->GetNumberOfPoints() / 2);
+}
+
+TEST_F(GeographicTransformationFilter_test, ImageResampleMapsOriginalIds)
+{
+    const auto & geoSpec = largeExtentGeoSpec();
+    auto dem = generateLargeExtentDEM();
+    const auto targetSpec = dataSpec_WGS84_UTM();
+
+    auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
+    filter->SetInputData(dem);
+    filter->SetTargetCoordinateSystem(targetSpec);
+    filter->SetImageTransform(GeographicTransformationFilter::ImageTransformResample);
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto image = vtkImageData::SafeDownCast(filter->GetOutput());
+    ASSERT_TRUE(image);
+
+    auto resampled = image->GetPointData()->GetScalars();
+    auto pointIds = vtkIdTypeArray::SafeDownCast(image->GetPointData()->GetAbstractArray(
+        GeographicTransformationFilter::OriginalPointIdsArrayName()));
+    auto cellIds = vtkIdTypeArray::SafeDownCast(image->GetCellData()->GetAbstractArray(
+        GeographicTransformationFilter::OriginalCellIdsArrayName()));
+    ASSERT_TRUE(resampled);
+    ASSERT_TRUE(pointIds);
+    ASSERT_TRUE(cellIds);
+    ASSERT_EQ(image->GetNumberOfPoints(), pointIds->GetNumberOfTuples());
+    ASSERT_EQ(image->GetNumberOfCells(), cellIds->GetNumberOfTuples());
+
+    const GeographicTransformationUtil toGeographic(
+        ReferencedCoordinateSystemSpecification(targetSpec, geoSpec.referencePointLatLong),
+        geoSpec);
+    // Points are mapped to the nearest input point, within half of the input spacing.
+    const double maxPointDistance = 0.05 + 1e-6;
+    vtkIdType numMappedPoints = 0;
+    for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+        const auto originalId = pointIds->GetValue(i);
+        ASSERT_EQ(std::isnan(resampled->GetTuple1(i)), originalId < 0) << "Point " << i;
+        if (originalId < 0)
+        {
+            continue;
+        }
+        ++numMappedPoints;
+        ASSERT_LT(originalId, dem->GetNumberOfPoints());
+        bool success = false;
+        const auto geoPoint = toGeographic.transformPoint(vtkVector3d(image->GetPoint(i)), &success);
+        ASSERT_TRUE(success);
+        const auto originalPoint = vtkVector3d(dem->GetPoint(originalId));
+        ASSERT_LE(std::abs(geoPoint[0] - originalPoint[0]), maxPointDistance) << "Point " << i;
+        ASSERT_LE(std::abs(geoPoint[1] - originalPoint[1]), maxPointDistance) << "Point " << i;
+    }
+    ASSERT_GT(numMappedPoints, image->GetNumberOfPoints() / 2);
+
+    // Cells are mapped to the input cell that contains their center.
+    vtkIdType numMappedCells = 0;
+    for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+    {
+        const auto originalId = cellIds->GetValue(i);
+        if (originalId < 0)
+        {
+            continue;
+        }
+        ++numMappedCells;
+        ASSERT_LT(originalId, dem->GetNumberOfCells());
+        DataBounds cellBounds;
+        image->GetCellBounds(i, cellBounds.data());
+        bool success = false;
+        const auto geoCenter = toGeographic.transformPoint(cellBounds.center(), &success);
+        ASSERT_TRUE(success);
+        DataBounds originalBounds;
+        dem->GetCellBounds(originalId, originalBounds.data());
+        for (int a = 0; a < 2; ++a)
+        {
+            ASSERT_GE(geoCenter[a], originalBounds[2 * a] - 1e-6) << "Cell " << i;
+            ASSERT_LE(geoCenter[a], originalBounds[2 * a + 1] + 1e-6) << "Cell " << i;
+        }
+    }
+    ASSERT_GT(numMappedCells, image->GetNumberOfCells() / 2);
+}
+
+TEST_F(GeographicTransformationFilter_test, ImageKeepsAffineWithinTolerance)
+{
+    auto dem = generateDEM(CoordinateSystemType::geographic);
+
+    auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
+    filter->SetInputData(dem);
+    filter->SetTargetCoordinateSystem(dataSpec_WGS84_UTM_local());
+    filter->SetImageTransform(GeographicTransformationFilter::ImageTransformAutomatic);
+    filter->SetImageAffineTolerance(1.0);
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+
+    auto image = vtkImageData::SafeDownCast(filter->GetOutput());
+    ASSERT_TRUE(image);
+    ASSERT_EQ(dem->GetPointData()->GetScalars(), image->GetPointData()->GetScalars());
+}
@@ -0,0 +1,160 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <vtkCellArray.h>
+#include <vtkExecutive.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/ImageLineProbeFilter.h>
+
+
+class ImageLineProbeFilter_test : public ::testing::Test
+{
+public:
+    /** 4x3 image with values x + 2y, so that bilinear interpolation is exact. */
+    static vtkSmartPointer<vtkImageData> createImage(double spacing = 1.0)
+    {
+        auto image = vtkSmartPointer<vtkImageData>::New();
+        image->SetExtent(0, 3, 0, 2, 0, 0);
+        image->SetSpacing(spacing, spacing, 1.0);
+        auto scalars = vtkSmartPointer<vtkFloatArray>::New();
+        scalars->SetName("values");
+        scalars->SetNumberOfValues(image->GetNumberOfPoints());
+        for (int y = 0; y < 3; ++y)
+        {
+            for (int x = 0; x < 4; ++x)
+            {
+                scalars->SetValue(x + y * 4, static_cast<float>(x + 2 * y));
+            }
+        }
+        image->GetPointData()->SetScalars(scalars);
+        return image;
+    }
+
+    static vtkSmartPointer<ImageLineProbeFilter> createFilter(vtkImageData & image,
+        const vtkVector2d & start, const vtkVector2d & end)
+    {
+        auto filter = vtkSmartPointer<ImageLineProbeFilter>::New();
+        filter->SetInputData(&image);
+        filter->SetStartPoint(start);
+        filter->SetEndPoint(end);
+        return filter;
+    }
+};
+
+
+TEST_F(ImageLineProbeFilter_test, SamplesAtPixelSpacing)
+{
+    auto image = createImage(0.5);
+    auto filter = createFilter(*image, { 0.0, 0.0 }, { 1.5, 0.0 });
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto output = filter->GetOutput();
+    ASSERT_EQ(4, output->GetNumberOfPoints());
+    ASSERT_EQ(1, output->GetNumberOfLines());
+
+    auto scalars = output->GetPointData()->GetScalars();
+    ASSERT_TRUE(scalars);
+    ASSERT_STREQ("values", scalars->GetName());
+    for (vtkIdType i = 0; i < 4; ++i)
+    {
+        ASSERT_DOUBLE_EQ(0.5 * i, output->GetPoint(i)[0]);
+        ASSERT_DOUBLE_EQ(static_cast<double>(i), scalars->GetTuple1(i));
+    }
+}
+
+TEST_F(ImageLineProbeFilter_test, BilinearInterpolation)
+{
+    auto image = createImage();
+    auto filter = createFilter(*image, { 0.0, 0.0 }, { 3.0, 2.0 });
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto output = filter->GetOutput();
+    ASSERT_EQ(4, output->GetNumberOfPoints());
+
+    auto scalars = output->GetPointData()->GetScalars();
+    for (vtkIdType i = 0; i < 4; ++i)
+    {
+        const double t = i / 3.0;
+        ASSERT_NEAR(3.0 * t + 2.0 * (2.0 * t), scalars->GetTuple1(i), 1e-5);
+    }
+}
+
+TEST_F(ImageLineProbeFilter_test, PropagateNaN)
+{
+    auto image = createImage();
+    image->GetPointData()->GetScalars()->SetTuple1(1, std::numeric_limits<double>::quiet_NaN());
+    auto filter = createFilter(*image, { 0.0, 0.0 }, { 3.0, 0.0 });
+    filter->SetSamplesPerPixel(2.0);
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto scalars = filter->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_EQ(7, scalars->GetNumberOfTuples());
+
+    // samples at x = 0, 0.5, ..., 3; only samples next to pixel 1 are affected
+    ASSERT_DOUBLE_EQ(0.0, scalars->GetTuple1(0));
+    ASSERT_TRUE(std::isnan(scalars->GetTuple1(1)));
+    ASSERT_TRUE(std::isnan(scalars->GetTuple1(2)));
+    ASSERT_TRUE(std::isnan(scalars->GetTuple1(3)));
+    ASSERT_DOUBLE_EQ(2.0, scalars->GetTuple1(4));
+    ASSERT_DOUBLE_EQ(2.5, scalars->GetTuple1(5));
+    ASSERT_DOUBLE_EQ(3.0, scalars->GetTuple1(6));
+}
+
+TEST_F(ImageLineProbeFilter_test, OutsideOfImageIsNaN)
+{
+    auto image = createImage();
+    auto filter = createFilter(*image, { -1.0, 1.0 }, { 3.0, 1.0 });
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto scalars = filter->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_EQ(5, scalars->GetNumberOfTuples());
+
+    ASSERT_TRUE(std::isnan(scalars->GetTuple1(0)));
+    for (vtkIdType i = 1; i < 5; ++i)
+    {
+        ASSERT_DOUBLE_EQ(static_cast<double>(i - 1) + 2.0, scalars->GetTuple1(i));
+    }
+}
+
+TEST_F(ImageLineProbeFilter_test, IntegerScalarsInterpolatedToDouble)
+{
+    auto image = createImage();
+    auto intScalars = vtkSmartPointer<vtkIntArray>::New();
+    intScalars->DeepCopy(image->GetPointData()->GetScalars());
+    intScalars->SetName("ints");
+    image->GetPointData()->SetScalars(intScalars);
+
+    auto filter = createFilter(*image, { 0.0, 0.0 }, { 1.0, 0.0 });
+    filter->SetSamplesPerPixel(2.0);
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto scalars = filter->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_EQ(VTK_DOUBLE, scalars->GetDataType());
+    ASSERT_DOUBLE_EQ(0.5, scalars->GetTuple1(1));
+}
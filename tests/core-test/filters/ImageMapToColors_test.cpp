@@ -0,0 +1,136 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <core/filters/ImageMapToColors.h>
+
+
+class ImageMapToColors_test : public ::testing::Test
+{
+public:
+    template<typename ArrayT>
+    static vtkSmartPointer<vtkImageData> createRandomImage(int numComponents)
+    {
+        auto image = vtkSmartPointer<vtkImageData>::New();
+        image->SetExtent(0, 99, 0, 49, 0, 0);
+
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<double> distribution(-20.0, 120.0);
+
+        auto scalars = vtkSmartPointer<ArrayT>::New();
+        scalars->SetNumberOfComponents(numComponents);
+        scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+        for (vtkIdType i = 0; i < scalars->GetNumberOfValues(); ++i)
+        {
+            scalars->SetValue(i, distribution(generator));
+        }
+        scalars->SetValue(0, std::numeric_limits<double>::quiet_NaN());
+        scalars->SetValue(1, 0.0);
+        scalars->SetValue(2, 100.0);
+        image->GetPointData()->SetScalars(scalars);
+
+        return image;
+    }
+
+    static vtkSmartPointer<vtkLookupTable> createLookupTable()
+    {
+        auto lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetNumberOfTableValues(256);
+        lut->SetHueRange(0.0, 0.7);
+        lut->SetAlphaRange(0.5, 1.0);
+        lut->SetNanColor(1.0, 0.0, 1.0, 1.0);
+        lut->SetTableRange(0.0, 100.0);
+        lut->Build();
+        return lut;
+    }
+
+    static vtkSmartPointer<vtkUnsignedCharArray> mapColors(vtkImageData * image,
+        vtkLookupTable * lut, bool quantized, int component = 0)
+    {
+        auto filter = vtkSmartPointer<ImageMapToColors>::New();
+        filter->SetInputData(image);
+        filter->SetLookupTable(lut);
+        filter->SetOutputFormatToRGBA();
+        filter->SetActiveComponent(component);
+        filter->SetQuantizedMapping(quantized);
+        filter->Update();
+
+        return vtkUnsignedCharArray::SafeDownCast(filter->GetOutput()->GetPointData()->GetScalars());
+    }
+
+    static void assertEqualColors(vtkUnsignedCharArray & expected, vtkUnsignedCharArray & actual)
+    {
+        ASSERT_EQ(4, actual.GetNumberOfComponents());
+        ASSERT_EQ(expected.GetNumberOfValues(), actual.GetNumberOfValues());
+        for (vtkIdType i = 0; i < expected.GetNumberOfValues(); ++i)
+        {
+            ASSERT_EQ(expected.GetValue(i), actual.GetValue(i)) << "value " << i;
+        }
+    }
+};
+
+
+TEST_F(ImageMapToColors_test, QuantizedEqualsLookupTableFloat)
+{
+    auto image = createRandomImage<vtkFloatArray>(1);
+    auto lut = createLookupTable();
+
+    auto expected = mapColors(image, lut, false);
+    auto actual = mapColors(image, lut, true);
+    ASSERT_TRUE(expected && actual);
+    assertEqualColors(*expected, *actual);
+}
+
+TEST_F(ImageMapToColors_test, QuantizedEqualsLookupTableDoubleComponent)
+{
+    auto image = createRandomImage<vtkDoubleArray>(3);
+    auto lut = createLookupTable();
+    lut->UseBelowRangeColorOn();
+    lut->SetBelowRangeColor(0.0, 0.0, 0.0, 1.0);
+    lut->UseAboveRangeColorOn();
+    lut->SetAboveRangeColor(1.0, 1.0, 1.0, 1.0);
+
+    auto expected = mapColors(image, lut, false, 2);
+    auto actual = mapColors(image, lut, true, 2);
+    ASSERT_TRUE(expected && actual);
+    assertEqualColors(*expected, *actual);
+}
+
+TEST_F(ImageMapToColors_test, NanColor)
+{
+    auto image = createRandomImage<vtkFloatArray>(1);
+    auto lut = createLookupTable();
+
+    auto colors = mapColors(image, lut, true);
+    ASSERT_EQ(255, colors->GetValue(0));
+    ASSERT_EQ(0, colors->GetValue(1));
+    ASSERT_EQ(255, colors->GetValue(2));
+    ASSERT_EQ(255, colors->GetValue(3));
+}
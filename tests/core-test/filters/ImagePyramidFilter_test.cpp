@@ -0,0 +1,213 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/ImagePyramidFilter.h>
+#include <core/utility/DataExtent.h>
+
+
+class ImagePyramidFilter_test : public ::testing::Test
+{
+public:
+    static vtkSmartPointer<vtkImageData> createImage(int dimX, int dimY)
+    {
+        auto image = vtkSmartPointer<vtkImageData>::New();
+        image->SetExtent(0, dimX - 1, 0, dimY - 1, 0, 0);
+        image->SetOrigin(10.0, 20.0, 0.0);
+        image->SetSpacing(0.5, 0.25, 1.0);
+        image->AllocateScalars(VTK_FLOAT, 1);
+        auto scalars = image->GetPointData()->GetScalars();
+        scalars->SetName("Scalars");
+        for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+        {
+            scalars->SetComponent(i, 0, static_cast<double>(i));
+        }
+
+        return image;
+    }
+};
+
+TEST_F(ImagePyramidFilter_test, PassesSmallImages)
+{
+    auto image = createImage(4, 3);
+    auto pyramid = vtkSmartPointer<ImagePyramidFilter>::New();
+    pyramid->SetInputData(image);
+    pyramid->SetTileSize(4);
+    pyramid->SetViewParameters(100.0, nullptr);
+    pyramid->Update();
+
+    ASSERT_EQ(1, pyramid->GetNumberOfLevels());
+    ASSERT_EQ(0, pyramid->GetLevel());
+    ASSERT_EQ(image->GetPointData()->GetScalars(),
+        pyramid->GetOutput()->GetPointData()->GetScalars());
+}
+
+TEST_F(ImagePyramidFilter_test, AveragesPixelBlocks)
+{
+    auto image = createImage(5, 4);
+    auto scalars = image->GetPointData()->GetScalars();
+    scalars->SetComponent(1, 0, std::numeric_limits<double>::quiet_NaN());
+
+    auto pyramid = vtkSmartPointer<ImagePyramidFilter>::New();
+    pyramid->SetInputData(image);
+    pyramid->SetTileSize(2);
+    // Select level 1: pixel size 0.5 x 1.0
+    pyramid->SetViewParameters(0.6, nullptr);
+    pyramid->Update();
+
+    ASSERT_EQ(3, pyramid->GetNumberOfLevels());
+    ASSERT_EQ(1, pyramid->GetLevel());
+
+    auto output = pyramid->GetOutput();
+    ASSERT_EQ(ImageExtent({ 0, 2, 0, 1, 0, 0 }), ImageExtent(output->GetExtent()));
+    ASSERT_DOUBLE_EQ(1.0, output->GetSpacing()[0]);
+    ASSERT_DOUBLE_EQ(0.5, output->GetSpacing()[1]);
+    ASSERT_DOUBLE_EQ(10.25, output->GetOrigin()[0]);
+    ASSERT_DOUBLE_EQ(20.125, output->GetOrigin()[1]);
+
+    auto levelScalars = output->GetPointData()->GetScalars();
+    ASSERT_TRUE(levelScalars);
+    ASSERT_STREQ("Scalars", levelScalars->GetName());
+    // NaN at index 1 is ignored: (0 + 5 + 6) / 3
+    ASSERT_FLOAT_EQ(11.f / 3.f, static_cast<float>(levelScalars->GetComponent(0, 0)));
+    // (2 + 3 + 7 + 8) / 4
+    ASSERT_FLOAT_EQ(5.f, static_cast<float>(levelScalars->GetComponent(1, 0)));
+    // Last column only covers one input column: (4 + 9) / 2
+    ASSERT_FLOAT_EQ(6.5f, static_cast<float>(levelScalars->GetComponent(2, 0)));
+    // (10 + 11 + 15 + 16) / 4
+    ASSERT_FLOAT_EQ(13.f, static_cast<float>(levelScalars->GetComponent(3, 0)));
+}
+
+TEST_F(ImagePyramidFilter_test, ExtractsVisibleTiles)
+{
+    auto image = createImage(16, 16);
+
+    auto pyramid = vtkSmartPointer<ImagePyramidFilter>::New();
+    pyramid->SetInputData(image);
+    pyramid->SetTileSize(4);
+    // Full resolution, x index range [5, 6], y index range [1, 2]
+    const double visibleBounds[4] = { 12.6, 13.0, 20.3, 20.5 };
+    pyramid->SetViewParameters(0.1, visibleBounds);
+    pyramid->Update();
+
+    ASSERT_EQ(0, pyramid->GetLevel());
+
+    auto output = pyramid->GetOutput();
+    ASSERT_EQ(ImageExtent({ 4, 7, 0, 3, 0, 0 }), ImageExtent(output->GetExtent()));
+    ASSERT_DOUBLE_EQ(10.0, output->GetOrigin()[0]);
+
+    auto scalars = output->GetPointData()->GetScalars();
+    for (int y = 0; y <= 3; ++y)
+    {
+        for (int x = 4; x <= 7; ++x)
+        {
+            int ijk[3] = { x, y, 0 };
+            const auto idx = output->ComputePointId(ijk);
+            ASSERT_EQ(static_cast<double>(x + 16 * y), scalars->GetComponent(idx, 0));
+        }
+    }
+
+    const auto mTime = pyramid->GetMTime();
+    // Same tiles: no need to update
+    const double movedBounds[4] = { 12.1, 13.5, 20.0, 20.7 };
+    pyramid->SetViewParameters(0.1, movedBounds);
+    ASSERT_EQ(mTime, pyramid->GetMTime());
+}
+
+TEST_F(ImagePyramidFilter_test, AveragesPixelBlocksOfShiftedExtent)
+{
+    auto image = createImage(5, 4);
+    image->SetExtent(3, 7, 2, 5, 0, 0);
+
+    auto pyramid = vtkSmartPointer<ImagePyramidFilter>::New();
+    pyramid->SetInputData(image);
+    pyramid->SetTileSize(2);
+    pyramid->SetViewParameters(0.6, nullptr);
+    pyramid->Update();
+
+    ASSERT_EQ(1, pyramid->GetLevel());
+
+    auto output = pyramid->GetOutput();
+    ASSERT_EQ(ImageExtent({ 0, 2, 0, 1, 0, 0 }), ImageExtent(output->GetExtent()));
+    ASSERT_DOUBLE_EQ(11.75, output->GetOrigin()[0]);
+    ASSERT_DOUBLE_EQ(20.625, output->GetOrigin()[1]);
+
+    auto levelScalars = output->GetPointData()->GetScalars();
+    // (0 + 1 + 5 + 6) / 4
+    ASSERT_FLOAT_EQ(3.f, static_cast<float>(levelScalars->GetComponent(0, 0)));
+    // (12 + 13 + 17 + 18) / 4
+    ASSERT_FLOAT_EQ(15.f, static_cast<float>(levelScalars->GetComponent(4, 0)));
+}
+
+TEST_F(ImagePyramidFilter_test, MapsOutputIdsToInput)
+{
+    auto image = createImage(5, 4);
+
+    auto pyramid = vtkSmartPointer<ImagePyramidFilter>::New();
+    pyramid->SetInputData(image);
+    pyramid->SetTileSize(2);
+    pyramid->SetViewParameters(0.6, nullptr);
+    pyramid->Update();
+
+    ASSERT_EQ(1, pyramid->GetLevel());
+    // Level point (1, 1) covers input points (2..3, 2..3)
+    ASSERT_EQ(2 + 2 * 5, pyramid->ComputeInputPointId(1 + 1 * 3));
+    // Level point (2, 0) only covers input points (4, 0..1)
+    ASSERT_EQ(4, pyramid->ComputeInputPointId(2));
+    // Level cell (1, 0) is centered in input cell (3, 1)
+    ASSERT_EQ(3 + 1 * 4, pyramid->ComputeInputCellId(1));
+    ASSERT_EQ(-1, pyramid->ComputeInputPointId(6));
+    ASSERT_EQ(-1, pyramid->ComputeInputCellId(-1));
+
+    // Full resolution, reduced to visible tiles
+    auto largeImage = createImage(16, 16);
+    pyramid->SetInputData(largeImage);
+    pyramid->SetTileSize(4);
+    const double visibleBounds[4] = { 12.6, 13.0, 20.3, 20.5 };
+    pyramid->SetViewParameters(0.1, visibleBounds);
+    pyramid->Update();
+
+    ASSERT_EQ(0, pyramid->GetLevel());
+    ASSERT_EQ(ImageExtent({ 4, 7, 0, 3, 0, 0 }), ImageExtent(pyramid->GetOutput()->GetExtent()));
+    // Output point (5, 1)
+    ASSERT_EQ(5 + 1 * 16, pyramid->ComputeInputPointId(1 + 1 * 4));
+}
+
+TEST_F(ImagePyramidFilter_test, WholeBoundsOfInput)
+{
+    auto image = createImage(16, 16);
+
+    auto pyramid = vtkSmartPointer<ImagePyramidFilter>::New();
+    pyramid->SetInputData(image);
+    pyramid->SetTileSize(4);
+    pyramid->SetViewParameters(10.0, nullptr);
+    pyramid->Update();
+
+    ASSERT_EQ(2, pyramid->GetLevel());
+
+    DataBounds bounds;
+    ASSERT_TRUE(pyramid->GetWholeBounds(bounds.data()));
+    ASSERT_EQ(DataBounds(image->GetBounds()), bounds);
+}
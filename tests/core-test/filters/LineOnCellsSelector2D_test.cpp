@@ -0,0 +1,192 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include <vtkCellArray.h>
+#include <vtkCellCenters.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSelection.h>
+#include <vtkSelectionNode.h>
+#include <vtkSmartPointer.h>
+#include <vtkStructuredGrid.h>
+
+#include <core/filters/LineOnCellsSelector2D.h>
+#include <core/utility/vtkvectorhelper.h>
+
+
+class LineOnCellsSelector2D_test : public ::testing::Test
+{
+public:
+    /** Triangulated regular grid with spacing 1, with slightly displaced points. */
+    static vtkSmartPointer<vtkPolyData> generateTriangleMesh(int nx, int ny)
+    {
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetDataTypeToDouble();
+        points->SetNumberOfPoints(nx * ny);
+        for (int y = 0; y < ny; ++y)
+        {
+            for (int x = 0; x < nx; ++x)
+            {
+                const int i = x + y * nx;
+                points->SetPoint(i, x + 0.2 * std::sin(i * 1.7), y + 0.2 * std::cos(i * 2.3), 0.0);
+            }
+        }
+
+        auto triangles = vtkSmartPointer<vtkCellArray>::New();
+        for (int y = 0; y < ny - 1; ++y)
+        {
+            for (int x = 0; x < nx - 1; ++x)
+            {
+                const vtkIdType p0 = x + y * nx;
+                const vtkIdType lower[3] = { p0, p0 + 1, p0 + nx + 1 };
+                const vtkIdType upper[3] = { p0, p0 + nx + 1, p0 + nx };
+                triangles->InsertNextCell(3, lower);
+                triangles->InsertNextCell(3, upper);
+            }
+        }
+
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        poly->SetPoints(points);
+        poly->SetPolys(triangles);
+
+        return poly;
+    }
+
+    /** Cells with points on both sides of the line and with their centroid within the segment */
+    static std::vector<vtkIdType> expectedCells(vtkDataSet & mesh,
+        const vtkVector2d & A, const vtkVector2d & B)
+    {
+        const auto AB = B - A;
+        const auto normal = vtkVector2d(AB[1], -AB[0]);
+        std::vector<vtkIdType> cells;
+        auto pointIds = vtkSmartPointer<vtkIdList>::New();
+        for (vtkIdType cellId = 0; cellId < mesh.GetNumberOfCells(); ++cellId)
+        {
+            mesh.GetCellPoints(cellId, pointIds);
+            bool positive = false, negative = false;
+            vtkVector2d centroid(0.0, 0.0);
+            for (vtkIdType i = 0; i < pointIds->GetNumberOfIds(); ++i)
+            {
+                double point[3];
+                mesh.GetPoint(pointIds->GetId(i), point);
+                const vtkVector2d P(point[0], point[1]);
+                const double side = (P - A).Dot(normal);
+                positive = positive || side >= 0;
+                negative = negative || side < 0;
+                centroid[0] += P[0] / pointIds->GetNumberOfIds();
+                centroid[1] += P[1] / pointIds->GetNumberOfIds();
+            }
+            const double t = (centroid - A).Dot(AB) / AB.SquaredNorm();
+            if (positive && negative && t >= 0 && t <= 1)
+            {
+                cells.push_back(cellId);
+            }
+        }
+        return cells;
+    }
+
+    static std::vector<vtkIdType> selectedCells(LineOnCellsSelector2D & selector)
+    {
+        selector.Update(0);
+        auto ids = vtkIdTypeArray::SafeDownCast(selector.GetOutput()->GetNode(0)->GetSelectionList());
+        return std::vector<vtkIdType>(ids->GetPointer(0), ids->GetPointer(0) + ids->GetNumberOfValues());
+    }
+};
+
+TEST_F(LineOnCellsSelector2D_test, SelectsCellsAlongLine)
+{
+    auto mesh = generateTriangleMesh(40, 30);
+    auto centers = vtkSmartPointer<vtkCellCenters>::New();
+    centers->SetInputData(mesh);
+
+    auto selector = vtkSmartPointer<LineOnCellsSelector2D>::New();
+    selector->SetSorting(LineOnCellsSelector2D::SortNone);
+    selector->SetInputData(mesh);
+    selector->SetCellCentersConnection(centers->GetOutputPort());
+
+    const vtkVector2d lines[3][2] = {
+        { { 2.3, 3.1 }, { 35.7, 22.9 } },
+        { { 30.2, 1.5 }, { 4.4, 1.5 } },
+        { { 10.5, 28.0 }, { 10.5, -5.0 } }
+    };
+
+    for (const auto & line : lines)
+    {
+        selector->SetStartPoint(line[0]);
+        selector->SetEndPoint(line[1]);
+
+        const auto expected = expectedCells(*mesh, line[0], line[1]);
+        ASSERT_FALSE(expected.empty());
+        ASSERT_EQ(expected, selectedCells(*selector));
+    }
+}
+
+TEST_F(LineOnCellsSelector2D_test, UpdatesForModifiedCells)
+{
+    auto mesh = generateTriangleMesh(20, 20);
+    auto centers = vtkSmartPointer<vtkCellCenters>::New();
+    centers->SetInputData(mesh);
+
+    auto selector = vtkSmartPointer<LineOnCellsSelector2D>::New();
+    selector->SetInputData(mesh);
+    selector->SetCellCentersConnection(centers->GetOutputPort());
+    selector->SetStartPoint({ 102.5, 5.5 });
+    selector->SetEndPoint({ 112.5, 8.5 });
+
+    ASSERT_TRUE(selectedCells(*selector).empty());
+
+    auto & points = *mesh->GetPoints();
+    for (vtkIdType i = 0; i < points.GetNumberOfPoints(); ++i)
+    {
+        double point[3];
+        points.GetPoint(i, point);
+        points.SetPoint(i, point[0] + 100.0, point[1], point[2]);
+    }
+    points.Modified();
+
+    const auto expected = expectedCells(*mesh, { 102.5, 5.5 }, { 112.5, 8.5 });
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected, selectedCells(*selector));
+}
+
+TEST_F(LineOnCellsSelector2D_test, SelectsCellsOfStructuredGrid)
+{
+    auto grid = vtkSmartPointer<vtkStructuredGrid>::New();
+    grid->SetDimensions(40, 30, 1);
+    grid->SetPoints(generateTriangleMesh(40, 30)->GetPoints());
+    auto centers = vtkSmartPointer<vtkCellCenters>::New();
+    centers->SetInputData(grid);
+
+    auto selector = vtkSmartPointer<LineOnCellsSelector2D>::New();
+    selector->SetSorting(LineOnCellsSelector2D::SortNone);
+    selector->SetInputData(grid);
+    selector->SetCellCentersConnection(centers->GetOutputPort());
+    selector->SetStartPoint({ 2.3, 3.1 });
+    selector->SetEndPoint({ 35.7, 22.9 });
+
+    const auto expected = expectedCells(*grid, { 2.3, 3.1 }, { 35.7, 22.9 });
+    ASSERT_FALSE(expected.empty());
+    ASSERT_EQ(expected, selectedCells(*selector));
+}
@@ -0,0 +1,245 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSelection.h>
+#include <vtkSelectionNode.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/LineOnPointsSelector2D.h>
+#include <core/utility/GridSpacingEstimateCache.h>
+
+
+class LineOnPointsSelector2D_test : public ::testing::Test
+{
+public:
+    /** Regular grid of points with spacing 1, starting at the origin. */
+    static vtkSmartPointer<vtkPolyData> generateGridPoints(int nx, int ny)
+    {
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetDataTypeToDouble();
+        points->SetNumberOfPoints(nx * ny);
+        for (int y = 0; y < ny; ++y)
+        {
+            for (int x = 0; x < nx; ++x)
+            {
+                points->SetPoint(x + y * nx, x, y, 0.0);
+            }
+        }
+
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        poly->SetPoints(points);
+
+        return poly;
+    }
+
+    static vtkIdTypeArray * selectedIds(LineOnPointsSelector2D & selector)
+    {
+        selector.Update(0);
+        auto node = selector.GetOutput()->GetNode(0);
+        return node ? vtkIdTypeArray::SafeDownCast(node->GetSelectionList()) : nullptr;
+    }
+};
+
+TEST_F(LineOnPointsSelector2D_test, SelectsPointsAlongLine)
+{
+    const int nx = 60;
+    auto points = generateGridPoints(nx, 40);
+
+    auto selector = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    selector->SetInputData(points);
+    selector->SetStartPoint({ 5.0, 10.0 });
+    selector->SetEndPoint({ 20.0, 10.0 });
+
+    auto ids = selectedIds(*selector);
+    ASSERT_TRUE(ids);
+    ASSERT_EQ(16, ids->GetNumberOfValues());
+    for (vtkIdType i = 0; i < ids->GetNumberOfValues(); ++i)
+    {
+        ASSERT_EQ(5 + i + 10 * nx, ids->GetValue(i));
+    }
+
+    selector->Update(1);
+    auto extracted = selector->GetExtractedPoints();
+    ASSERT_EQ(16, extracted->GetNumberOfPoints());
+    ASSERT_TRUE(extracted->GetPointData()->GetArray("PositionOnLine"));
+    ASSERT_DOUBLE_EQ(5.0, extracted->GetPoint(0)[0]);
+    ASSERT_DOUBLE_EQ(20.0, extracted->GetPoint(15)[0]);
+}
+
+TEST_F(LineOnPointsSelector2D_test, SortsExtractedPointsAlongLine)
+{
+    auto points = generateGridPoints(30, 30);
+
+    auto selector = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    selector->SetInputData(points);
+    selector->SetStartPoint({ 25.0, 25.0 });
+    selector->SetEndPoint({ 3.0, 3.0 });
+    selector->Update(1);
+
+    auto extracted = selector->GetExtractedPoints();
+    ASSERT_EQ(23, extracted->GetNumberOfPoints());
+    for (vtkIdType i = 0; i < extracted->GetNumberOfPoints(); ++i)
+    {
+        ASSERT_DOUBLE_EQ(25.0 - i, extracted->GetPoint(i)[0]);
+        ASSERT_DOUBLE_EQ(25.0 - i, extracted->GetPoint(i)[1]);
+    }
+}
+
+TEST_F(LineOnPointsSelector2D_test, UpdatesForModifiedPoints)
+{
+    auto points = generateGridPoints(20, 20);
+
+    auto selector = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    selector->SetInputData(points);
+    selector->SetStartPoint({ 2.0, 5.0 });
+    selector->SetEndPoint({ 12.0, 5.0 });
+
+    ASSERT_EQ(11, selectedIds(*selector)->GetNumberOfValues());
+
+    auto & coordinates = *points->GetPoints();
+    for (vtkIdType i = 0; i < coordinates.GetNumberOfPoints(); ++i)
+    {
+        double point[3];
+        coordinates.GetPoint(i, point);
+        coordinates.SetPoint(i, point[0] + 100.0, point[1], point[2]);
+    }
+    coordinates.Modified();
+
+    ASSERT_EQ(0, selectedIds(*selector)->GetNumberOfValues());
+
+    selector->SetStartPoint({ 102.0, 5.0 });
+    selector->SetEndPoint({ 112.0, 5.0 });
+
+    ASSERT_EQ(11, selectedIds(*selector)->GetNumberOfValues());
+}
+
+TEST_F(LineOnPointsSelector2D_test, SampledGridSpacingWithinConfidenceInterval)
+{
+    auto points = generateGridPoints(200, 200);
+    auto & coordinates = *points->GetPoints();
+    for (vtkIdType i = 0; i < coordinates.GetNumberOfPoints(); ++i)
+    {
+        double point[3];
+        coordinates.GetPoint(i, point);
+        // deterministic jitter of up to +-0.1
+        coordinates.SetPoint(i, point[0] + 0.1 * std::sin(i * 12.9898), point[1] + 0.1 * std::cos(i * 78.233), 0.0);
+    }
+    coordinates.Modified();
+
+    auto exact = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    exact->SetInputData(points);
+    exact->SampleGridSpacingOff();
+    exact->SetStartPoint({ 0.0, 0.0 });
+    exact->SetEndPoint({ 10.0, 0.0 });
+    exact->Update(0);
+
+    const double exactSpacing = exact->GetApproxGridSpacing();
+    ASSERT_EQ(exactSpacing, exact->GetGridSpacingConfidenceInterval()[0]);
+    ASSERT_EQ(exactSpacing, exact->GetGridSpacingConfidenceInterval()[1]);
+
+    auto sampled = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    sampled->SetInputData(points);
+    sampled->SampleGridSpacingOn();
+    sampled->SetGridSpacingSampleSize(1000);
+    sampled->SetGridSpacingRelativeError(0.01);
+    sampled->SetStartPoint({ 0.0, 0.0 });
+    sampled->SetEndPoint({ 10.0, 0.0 });
+    sampled->Update(0);
+
+    const double sampledSpacing = sampled->GetApproxGridSpacing();
+    const auto interval = sampled->GetGridSpacingConfidenceInterval();
+    ASSERT_LT(interval[0], interval[1]);
+    ASSERT_LE(interval[0], sampledSpacing);
+    ASSERT_GE(interval[1], sampledSpacing);
+    ASSERT_LE(0.5 * (interval[1] - interval[0]), 0.01 * sampledSpacing);
+    ASSERT_NEAR(exactSpacing, sampledSpacing, 0.02 * exactSpacing);
+}
+
+TEST_F(LineOnPointsSelector2D_test, GridSpacingCacheLeavesInputUnmodified)
+{
+    auto points = generateGridPoints(50, 50);
+    auto & coordinates = *points->GetPoints()->GetData();
+    const auto coordinatesMTime = coordinates.GetMTime();
+
+    auto selector = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    selector->SetInputData(points);
+    selector->SetStartPoint({ 0.0, 0.0 });
+    selector->SetEndPoint({ 10.0, 0.0 });
+    selector->Update(0);
+    ASSERT_DOUBLE_EQ(1.0, selector->GetApproxGridSpacing());
+
+    ASSERT_FALSE(coordinates.HasInformation());
+    ASSERT_EQ(coordinatesMTime, coordinates.GetMTime());
+
+    // The estimate is updated for modified points.
+    for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+        double point[3];
+        points->GetPoint(i, point);
+        points->GetPoints()->SetPoint(i, 2.0 * point[0], 2.0 * point[1], 0.0);
+    }
+    points->GetPoints()->Modified();
+    selector->Update(0);
+    ASSERT_DOUBLE_EQ(2.0, selector->GetApproxGridSpacing());
+}
+
+TEST_F(LineOnPointsSelector2D_test, SharesGridSpacingCache)
+{
+    auto points = generateGridPoints(50, 50);
+
+    auto selector = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    selector->SetInputData(points);
+    selector->SetStartPoint({ 0.0, 0.0 });
+    selector->SetEndPoint({ 10.0, 0.0 });
+    selector->Update(0);
+    ASSERT_DOUBLE_EQ(1.0, selector->GetApproxGridSpacing());
+
+    GridSpacingEstimateCache::Estimate estimate;
+    ASSERT_TRUE(selector->GetGridSpacingCache()->find(points->GetPoints()->GetMTime(), estimate));
+    ASSERT_DOUBLE_EQ(1.0, estimate.spacing);
+
+    // Another selector on the same points reuses the estimate, instead of computing it again.
+    estimate.spacing = 1.5;
+    estimate.confidenceInterval = { 1.5, 1.5 };
+    selector->GetGridSpacingCache()->store(points->GetPoints()->GetMTime(), estimate);
+
+    auto other = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    other->SetGridSpacingCache(selector->GetGridSpacingCache());
+    other->SetInputData(points);
+    other->SetStartPoint({ 0.0, 10.0 });
+    other->SetEndPoint({ 10.0, 10.0 });
+    other->Update(0);
+    ASSERT_DOUBLE_EQ(1.5, other->GetApproxGridSpacing());
+
+    // Separate caches by default
+    auto separate = vtkSmartPointer<LineOnPointsSelector2D>::New();
+    separate->SetInputData(points);
+    separate->SetStartPoint({ 0.0, 10.0 });
+    separate->SetEndPoint({ 10.0, 10.0 });
+    separate->Update(0);
+    ASSERT_DOUBLE_EQ(1.0, separate->GetApproxGridSpacing());
+}
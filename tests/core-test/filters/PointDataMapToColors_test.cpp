@@ -0,0 +1,171 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkLookupTable.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <core/filters/PointDataMapToColors.h>
+
+
+class PointDataMapToColors_test : public ::testing::Test
+{
+public:
+    template<typename ArrayT>
+    static vtkSmartPointer<vtkPolyData> createRandomPointCloud(int numComponents)
+    {
+        const vtkIdType numPoints = 5000;
+
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<double> distribution(-20.0, 120.0);
+
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetNumberOfPoints(numPoints);
+        for (vtkIdType i = 0; i < numPoints; ++i)
+        {
+            points->SetPoint(i, distribution(generator), distribution(generator), 0.0);
+        }
+
+        auto scalars = vtkSmartPointer<ArrayT>::New();
+        scalars->SetName("values");
+        scalars->SetNumberOfComponents(numComponents);
+        scalars->SetNumberOfTuples(numPoints);
+        for (vtkIdType i = 0; i < scalars->GetNumberOfValues(); ++i)
+        {
+            scalars->SetValue(i, distribution(generator));
+        }
+        scalars->SetValue(0, std::numeric_limits<double>::quiet_NaN());
+        scalars->SetValue(1, 0.0);
+        scalars->SetValue(2, 100.0);
+
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        poly->SetPoints(points);
+        poly->GetPointData()->AddArray(scalars);
+
+        return poly;
+    }
+
+    static vtkSmartPointer<vtkLookupTable> createLookupTable()
+    {
+        auto lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetNumberOfTableValues(256);
+        lut->SetHueRange(0.0, 0.7);
+        lut->SetAlphaRange(0.5, 1.0);
+        lut->SetNanColor(1.0, 0.0, 1.0, 1.0);
+        lut->SetTableRange(0.0, 100.0);
+        lut->Build();
+        return lut;
+    }
+
+    static vtkSmartPointer<vtkUnsignedCharArray> mapColors(vtkPolyData * poly,
+        vtkLookupTable * lut, bool quantized)
+    {
+        auto filter = vtkSmartPointer<PointDataMapToColors>::New();
+        filter->SetInputData(poly);
+        filter->SetLookupTable(lut);
+        filter->SetScalarsArrayName("values");
+        filter->SetQuantizedMapping(quantized);
+        filter->Update();
+
+        return vtkUnsignedCharArray::SafeDownCast(filter->GetOutput()->GetPointData()->GetArray(
+            filter->GetColorsArrayName().c_str()));
+    }
+
+    static void assertEqualColors(vtkUnsignedCharArray & expected, vtkUnsignedCharArray & actual)
+    {
+        ASSERT_EQ(4, actual.GetNumberOfComponents());
+        ASSERT_EQ(expected.GetNumberOfValues(), actual.GetNumberOfValues());
+        for (vtkIdType i = 0; i < expected.GetNumberOfValues(); ++i)
+        {
+            ASSERT_EQ(expected.GetValue(i), actual.GetValue(i)) << "value " << i;
+        }
+    }
+};
+
+
+TEST_F(PointDataMapToColors_test, QuantizedEqualsLookupTableFloat)
+{
+    auto poly = createRandomPointCloud<vtkFloatArray>(1);
+    auto lut = createLookupTable();
+
+    auto expected = mapColors(poly, lut, false);
+    auto actual = mapColors(poly, lut, true);
+    ASSERT_TRUE(expected && actual);
+    assertEqualColors(*expected, *actual);
+}
+
+TEST_F(PointDataMapToColors_test, QuantizedEqualsLookupTableDoubleComponent)
+{
+    auto poly = createRandomPointCloud<vtkDoubleArray>(3);
+    auto lut = createLookupTable();
+    lut->SetVectorModeToComponent();
+    lut->SetVectorComponent(2);
+    lut->UseBelowRangeColorOn();
+    lut->SetBelowRangeColor(0.0, 0.0, 0.0, 1.0);
+    lut->UseAboveRangeColorOn();
+    lut->SetAboveRangeColor(1.0, 1.0, 1.0, 1.0);
+
+    auto expected = mapColors(poly, lut, false);
+    auto actual = mapColors(poly, lut, true);
+    ASSERT_TRUE(expected && actual);
+    assertEqualColors(*expected, *actual);
+}
+
+TEST_F(PointDataMapToColors_test, NanColor)
+{
+    auto poly = createRandomPointCloud<vtkFloatArray>(1);
+    auto lut = createLookupTable();
+
+    auto colors = mapColors(poly, lut, true);
+    ASSERT_TRUE(colors);
+    ASSERT_EQ(255, colors->GetValue(0));
+    ASSERT_EQ(0, colors->GetValue(1));
+    ASSERT_EQ(255, colors->GetValue(2));
+    ASSERT_EQ(255, colors->GetValue(3));
+}
+
+TEST_F(PointDataMapToColors_test, UpdatesOnLookupTableRangeChange)
+{
+    auto poly = createRandomPointCloud<vtkFloatArray>(1);
+    auto lut = createLookupTable();
+
+    auto filter = vtkSmartPointer<PointDataMapToColors>::New();
+    filter->SetInputData(poly);
+    filter->SetLookupTable(lut);
+    filter->SetScalarsArrayName("values");
+    filter->Update();
+
+    lut->SetTableRange(50.0, 100.0);
+    filter->Update();
+
+    auto colors = vtkUnsignedCharArray::SafeDownCast(filter->GetOutput()->GetPointData()->GetArray(
+        filter->GetColorsArrayName().c_str()));
+    ASSERT_TRUE(colors);
+    auto expected = mapColors(poly, lut, false);
+    assertEqualColors(*expected, *colors);
+}
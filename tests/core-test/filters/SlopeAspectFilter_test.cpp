@@ -0,0 +1,242 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <core/CoordinateSystems.h>
+#include <core/data_objects/DataObject.h>
+#include <core/filters/SlopeAspectFilter.h>
+#include <core/utility/DataArrayRanges.h>
+#include <core/utility/DataExtent.h>
+
+
+class SlopeAspectFilter_test : public ::testing::Test
+{
+public:
+    /** Plane rising towards east: z = x * tan(45deg) */
+    static vtkSmartPointer<vtkImageData> createInclinedImage()
+    {
+        auto image = vtkSmartPointer<vtkImageData>::New();
+        image->SetExtent(0, 4, 0, 3, 0, 0);
+        image->SetSpacing(2.0, 2.0, 1.0);
+
+        auto elevations = vtkSmartPointer<vtkFloatArray>::New();
+        elevations->SetName("elevations");
+        elevations->SetNumberOfValues(image->GetNumberOfPoints());
+        for (int y = 0; y < 4; ++y)
+        {
+            for (int x = 0; x < 5; ++x)
+            {
+                elevations->SetValue(y * 5 + x, static_cast<float>(x * 2.0));
+            }
+        }
+        image->GetPointData()->SetScalars(elevations);
+
+        return image;
+    }
+};
+
+
+TEST_F(SlopeAspectFilter_test, ImageGradients)
+{
+    auto filter = vtkSmartPointer<SlopeAspectFilter>::New();
+    filter->SetInputData(createInclinedImage());
+    filter->Update();
+
+    auto pointData = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetPointData();
+    auto slopes = pointData->GetScalars();
+    ASSERT_TRUE(slopes);
+    ASSERT_STREQ(SlopeAspectFilter::SlopeArrayName(), slopes->GetName());
+    auto aspects = pointData->GetArray(SlopeAspectFilter::AspectArrayName());
+    ASSERT_TRUE(aspects);
+    // elevations are still passed
+    ASSERT_TRUE(pointData->GetArray("elevations"));
+
+    for (vtkIdType i = 0; i < slopes->GetNumberOfTuples(); ++i)
+    {
+        ASSERT_NEAR(45.0, slopes->GetComponent(i, 0), 1e-4);
+        // facing west
+        ASSERT_NEAR(270.0, aspects->GetComponent(i, 0), 1e-4);
+    }
+
+    ASSERT_TRUE(slopes->GetInformation()->Get(DataObject::ARRAY_IS_AUXILIARY()));
+    const auto ranges = DataArrayRanges::of(*slopes);
+    ASSERT_NEAR(45.0, ranges.componentRange(0)[0], 1e-4);
+    ASSERT_NEAR(45.0, ranges.componentRange(0)[1], 1e-4);
+    ASSERT_FALSE(ranges.hasHistograms());
+    ASSERT_EQ(slopes->GetNumberOfTuples(), DataArrayRanges::of(*slopes, true).componentHistogram(0).count());
+}
+
+TEST_F(SlopeAspectFilter_test, CachedUntilElevationsModified)
+{
+    auto image = createInclinedImage();
+    auto filter = vtkSmartPointer<SlopeAspectFilter>::New();
+    filter->SetInputData(image);
+    filter->Update();
+    auto slopes = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetPointData()->GetScalars();
+
+    auto otherFilter = vtkSmartPointer<SlopeAspectFilter>::New();
+    otherFilter->SetInputData(image);
+    otherFilter->Update();
+    ASSERT_EQ(slopes,
+        vtkDataSet::SafeDownCast(otherFilter->GetOutputDataObject(0))->GetPointData()->GetScalars());
+
+    auto elevations = vtkFloatArray::SafeDownCast(image->GetPointData()->GetScalars());
+    for (vtkIdType i = 0; i < elevations->GetNumberOfValues(); ++i)
+    {
+        elevations->SetValue(i, 1.0f);
+    }
+    elevations->Modified();
+    filter->Update();
+
+    auto newSlopes = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetPointData()->GetScalars();
+    ASSERT_NE(slopes, newSlopes);
+    ASSERT_DOUBLE_EQ(0.0, newSlopes->GetComponent(0, 0));
+    ASSERT_TRUE(std::isnan(vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetPointData()
+        ->GetArray(SlopeAspectFilter::AspectArrayName())->GetComponent(0, 0)));
+}
+
+TEST_F(SlopeAspectFilter_test, MetricSpacingConvertedToMeters)
+{
+    // spacing of 2 m, elevation increments of 2 m
+    auto image = createInclinedImage();
+    image->SetSpacing(0.002, 0.002, 1.0);
+    CoordinateSystemSpecification(CoordinateSystemType::metricGlobal, "WGS 84", "UTM", "km")
+        .writeToFieldData(*image->GetFieldData());
+
+    auto filter = vtkSmartPointer<SlopeAspectFilter>::New();
+    filter->SetInputData(image);
+    filter->Update();
+
+    auto slopes = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetPointData()->GetScalars();
+    ASSERT_TRUE(slopes);
+    ASSERT_STREQ(SlopeAspectFilter::SlopeArrayName(), slopes->GetName());
+    for (vtkIdType i = 0; i < slopes->GetNumberOfTuples(); ++i)
+    {
+        ASSERT_NEAR(45.0, slopes->GetComponent(i, 0), 1e-4);
+    }
+}
+
+TEST_F(SlopeAspectFilter_test, GeographicSpacingConvertedToMeters)
+{
+    const double metersPerDegree = vtkMath::Pi() / 180.0 * 6378137.0;
+    const double spacingDegrees = 0.001;
+    const double latitude = 60.0;
+
+    // Rising towards east, 45 degrees at 60 degrees north, where a degree of longitude spans half
+    // of a degree of latitude.
+    auto image = createInclinedImage();
+    image->SetOrigin(10.0, latitude, 0.0);
+    image->SetSpacing(spacingDegrees, spacingDegrees, 1.0);
+    auto elevations = vtkFloatArray::SafeDownCast(image->GetPointData()->GetScalars());
+    for (int y = 0; y < 4; ++y)
+    {
+        for (int x = 0; x < 5; ++x)
+        {
+            elevations->SetValue(y * 5 + x, static_cast<float>(x * spacingDegrees * metersPerDegree * 0.5));
+        }
+    }
+    CoordinateSystemSpecification(CoordinateSystemType::geographic, "WGS 84", "", "")
+        .writeToFieldData(*image->GetFieldData());
+
+    auto filter = vtkSmartPointer<SlopeAspectFilter>::New();
+    filter->SetInputData(image);
+    filter->Update();
+
+    auto pointData = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetPointData();
+    auto slopes = pointData->GetScalars();
+    auto aspects = pointData->GetArray(SlopeAspectFilter::AspectArrayName());
+    ASSERT_TRUE(slopes && aspects);
+    ASSERT_STREQ(SlopeAspectFilter::SlopeArrayName(), slopes->GetName());
+    for (vtkIdType i = 0; i < slopes->GetNumberOfTuples(); ++i)
+    {
+        // the rows span a few meters only
+        ASSERT_NEAR(45.0, slopes->GetComponent(i, 0), 1e-2);
+        ASSERT_NEAR(270.0, aspects->GetComponent(i, 0), 1e-2);
+    }
+}
+
+TEST_F(SlopeAspectFilter_test, SkipsUnsupportedCoordinateSystems)
+{
+    auto image = createInclinedImage();
+    CoordinateSystemSpecification(CoordinateSystemType::other, "WGS 84", "custom", "m")
+        .writeToFieldData(*image->GetFieldData());
+
+    auto filter = vtkSmartPointer<SlopeAspectFilter>::New();
+    filter->SetInputData(image);
+    filter->Update();
+
+    auto pointData = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetPointData();
+    ASSERT_FALSE(pointData->GetArray(SlopeAspectFilter::SlopeArrayName()));
+    ASSERT_STREQ("elevations", pointData->GetScalars()->GetName());
+}
+
+TEST_F(SlopeAspectFilter_test, PolyDataCellNormals)
+{
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->InsertNextPoint(0, 0, 0);
+    points->InsertNextPoint(1, 0, 0);
+    points->InsertNextPoint(0, 1, 0);
+    auto triangles = vtkSmartPointer<vtkCellArray>::New();
+    const vtkIdType ids[3] = { 0, 1, 2 };
+    triangles->InsertNextCell(3, ids);
+    triangles->InsertNextCell(3, ids);
+
+    // flat, and inclined by 60 degrees facing north
+    auto normals = vtkSmartPointer<vtkFloatArray>::New();
+    normals->SetName("Normals");
+    normals->SetNumberOfComponents(3);
+    normals->InsertNextTuple3(0.0, 0.0, 1.0);
+    normals->InsertNextTuple3(0.0, std::sin(vtkMath::RadiansFromDegrees(60.0)),
+        std::cos(vtkMath::RadiansFromDegrees(60.0)));
+
+    auto poly = vtkSmartPointer<vtkPolyData>::New();
+    poly->SetPoints(points);
+    poly->SetPolys(triangles);
+    poly->GetCellData()->SetNormals(normals);
+
+    auto filter = vtkSmartPointer<SlopeAspectFilter>::New();
+    filter->SetInputData(poly);
+    filter->Update();
+
+    auto cellData = vtkDataSet::SafeDownCast(filter->GetOutputDataObject(0))->GetCellData();
+    auto slopes = cellData->GetScalars();
+    auto aspects = cellData->GetArray(SlopeAspectFilter::AspectArrayName());
+    ASSERT_TRUE(slopes && aspects);
+    ASSERT_NEAR(0.0, slopes->GetComponent(0, 0), 1e-4);
+    ASSERT_TRUE(std::isnan(aspects->GetComponent(0, 0)));
+    ASSERT_NEAR(60.0, slopes->GetComponent(1, 0), 1e-4);
+    ASSERT_NEAR(0.0, aspects->GetComponent(1, 0), 1e-4);
+
+    const auto ranges = DataArrayRanges::of(*slopes);
+    ASSERT_NEAR(0.0, ranges.componentRange(0)[0], 1e-4);
+    ASSERT_NEAR(60.0, ranges.componentRange(0)[1], 1e-4);
+}
@@ -0,0 +1,197 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <vtkDoubleArray.h>
+#include <vtkExecutive.h>
+#include <vtkFieldData.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSelection.h>
+#include <vtkSelectionNode.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/SpaceTimeProfileFilter.h>
+#include <core/filters/TemporalDataSource.h>
+
+
+class SpaceTimeProfileFilter_test : public ::testing::Test
+{
+public:
+    static const char * attributeName()
+    {
+        static const char * const name = "deformation";
+        return name;
+    }
+
+    static const std::vector<double> & timeSteps()
+    {
+        static const std::vector<double> ts = { 1.0, 2.0, 3.0 };
+        return ts;
+    }
+
+    /** Points on the x-axis, the last one is beyond the profile line [0, 1]. */
+    static vtkSmartPointer<vtkPolyData> createPoints()
+    {
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->InsertNextPoint(0.1, 0.0, 0.0);
+        points->InsertNextPoint(0.3, 0.0, 0.0);
+        points->InsertNextPoint(0.6, 0.0, 0.0);
+        points->InsertNextPoint(2.0, 0.0, 0.0);
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        poly->SetPoints(points);
+        return poly;
+    }
+
+    /** Value of point i at time step t: 10 * t + i */
+    static vtkSmartPointer<TemporalDataSource> createSource(vtkPolyData & poly)
+    {
+        auto temporalSource = vtkSmartPointer<TemporalDataSource>::New();
+        temporalSource->SetInputDataObject(&poly);
+        const auto id = temporalSource->AddTemporalAttribute(
+            TemporalDataSource::POINT_DATA, attributeName());
+
+        for (size_t t = 0; t < timeSteps().size(); ++t)
+        {
+            auto data = vtkSmartPointer<vtkFloatArray>::New();
+            data->SetNumberOfValues(poly.GetNumberOfPoints());
+            for (vtkIdType i = 0; i < poly.GetNumberOfPoints(); ++i)
+            {
+                data->SetValue(i, static_cast<float>(10 * t + i));
+            }
+            temporalSource->SetTemporalAttributeTimeStep(
+                TemporalDataSource::POINT_DATA, id, timeSteps()[t], data);
+        }
+
+        return temporalSource;
+    }
+
+    static vtkSmartPointer<vtkSelection> createSelection(vtkIdType numPoints)
+    {
+        auto ids = vtkSmartPointer<vtkIdTypeArray>::New();
+        ids->SetNumberOfValues(numPoints);
+        for (vtkIdType i = 0; i < numPoints; ++i)
+        {
+            ids->SetValue(i, i);
+        }
+        auto node = vtkSmartPointer<vtkSelectionNode>::New();
+        node->SetFieldType(vtkSelectionNode::POINT);
+        node->SetContentType(vtkSelectionNode::INDICES);
+        node->SetSelectionList(ids);
+        auto selection = vtkSmartPointer<vtkSelection>::New();
+        selection->AddNode(node);
+        return selection;
+    }
+
+    static vtkSmartPointer<SpaceTimeProfileFilter> createFilter(
+        vtkPolyData & poly, TemporalDataSource & source, int numBins)
+    {
+        auto filter = vtkSmartPointer<SpaceTimeProfileFilter>::New();
+        filter->SetInputDataObject(0, &poly);
+        filter->SetInputDataObject(1, createSelection(poly.GetNumberOfPoints()));
+        filter->SetTemporalDataSource(&source);
+        filter->SetAttributeName(attributeName());
+        filter->SetStartPoint({ 0.0, 0.0 });
+        filter->SetEndPoint({ 1.0, 0.0 });
+        filter->SetNumberOfBins(numBins);
+        return filter;
+    }
+};
+
+
+TEST_F(SpaceTimeProfileFilter_test, MatrixDimensions)
+{
+    auto poly = createPoints();
+    auto source = createSource(*poly);
+    auto filter = createFilter(*poly, *source, 4);
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto image = filter->GetOutput();
+
+    int dimensions[3];
+    image->GetDimensions(dimensions);
+    ASSERT_EQ(4, dimensions[0]);
+    ASSERT_EQ(static_cast<int>(timeSteps().size()), dimensions[1]);
+    ASSERT_EQ(1, dimensions[2]);
+    ASSERT_DOUBLE_EQ(0.25, image->GetSpacing()[0]);
+    ASSERT_DOUBLE_EQ(0.125, image->GetOrigin()[0]);
+
+    auto outTimeSteps = vtkDoubleArray::SafeDownCast(
+        image->GetFieldData()->GetArray("TimeSteps"));
+    ASSERT_TRUE(outTimeSteps);
+    ASSERT_EQ(static_cast<vtkIdType>(timeSteps().size()), outTimeSteps->GetNumberOfValues());
+    for (size_t t = 0; t < timeSteps().size(); ++t)
+    {
+        ASSERT_EQ(timeSteps()[t], outTimeSteps->GetValue(static_cast<vtkIdType>(t)));
+    }
+}
+
+TEST_F(SpaceTimeProfileFilter_test, BinValuesOfAllTimeSteps)
+{
+    auto poly = createPoints();
+    auto source = createSource(*poly);
+    auto filter = createFilter(*poly, *source, 2);
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto values = filter->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_TRUE(values);
+    ASSERT_STREQ(attributeName(), values->GetName());
+
+    for (int t = 0; t < static_cast<int>(timeSteps().size()); ++t)
+    {
+        // bin 0: points 0 and 1, bin 1: point 2, point 3 is not on the line
+        ASSERT_DOUBLE_EQ(10.0 * t + 0.5, values->GetTuple1(t * 2 + 0));
+        ASSERT_DOUBLE_EQ(10.0 * t + 2.0, values->GetTuple1(t * 2 + 1));
+    }
+}
+
+TEST_F(SpaceTimeProfileFilter_test, EmptyBinsAreNaN)
+{
+    auto poly = createPoints();
+    auto source = createSource(*poly);
+    auto filter = createFilter(*poly, *source, 4);
+
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+    auto values = filter->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_TRUE(values);
+
+    for (int t = 0; t < static_cast<int>(timeSteps().size()); ++t)
+    {
+        ASSERT_DOUBLE_EQ(10.0 * t + 0.0, values->GetTuple1(t * 4 + 0));
+        ASSERT_DOUBLE_EQ(10.0 * t + 1.0, values->GetTuple1(t * 4 + 1));
+        ASSERT_DOUBLE_EQ(10.0 * t + 2.0, values->GetTuple1(t * 4 + 2));
+        ASSERT_TRUE(std::isnan(values->GetTuple1(t * 4 + 3)));
+    }
+}
+
+TEST_F(SpaceTimeProfileFilter_test, UnknownAttributeFails)
+{
+    auto poly = createPoints();
+    auto source = createSource(*poly);
+    auto filter = createFilter(*poly, *source, 4);
+    filter->SetAttributeName("unknown");
+
+    ASSERT_FALSE(filter->GetExecutive()->Update());
+}
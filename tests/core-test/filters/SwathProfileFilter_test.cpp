@@ -0,0 +1,212 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/SwathProfileFilter.h>
+
+
+class SwathProfileFilter_test : public ::testing::Test
+{
+public:
+    /** Points on a regular grid with spacing 1, with x-coordinates as scalars */
+    static vtkSmartPointer<vtkPolyData> generateGridPoints(int nx, int ny)
+    {
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetNumberOfPoints(nx * ny);
+        auto scalars = vtkSmartPointer<vtkFloatArray>::New();
+        scalars->SetName("Scalars");
+        scalars->SetNumberOfValues(nx * ny);
+        for (int y = 0; y < ny; ++y)
+        {
+            for (int x = 0; x < nx; ++x)
+            {
+                points->SetPoint(x + y * nx, x, y, 0.0);
+                scalars->SetValue(x + y * nx, static_cast<float>(x));
+            }
+        }
+
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        poly->SetPoints(points);
+        poly->GetPointData()->SetScalars(scalars);
+
+        return poly;
+    }
+
+    static double statistic(SwathProfileFilter & filter, SwathProfileFilter::Statistic s, vtkIdType bin)
+    {
+        auto array = filter.GetOutput()->GetPointData()->GetArray(
+            SwathProfileFilter::StatisticArrayName("Scalars", s).c_str());
+        return array ? array->GetComponent(bin, 0) : std::numeric_limits<double>::quiet_NaN();
+    }
+};
+
+TEST_F(SwathProfileFilter_test, BinStatisticsOnPoints)
+{
+    auto points = generateGridPoints(100, 50);
+
+    auto swath = vtkSmartPointer<SwathProfileFilter>::New();
+    swath->SetInputData(points);
+    swath->SetStartPoint({ 10.0, 25.0 });
+    swath->SetEndPoint({ 30.0, 25.0 });
+    swath->SetWidth(4.1);
+    swath->SetNumberOfBins(4);
+    swath->Update();
+
+    auto output = swath->GetOutput();
+    ASSERT_EQ(4, output->GetNumberOfPoints());
+    ASSERT_DOUBLE_EQ(12.5, output->GetPoint(0)[0]);
+    ASSERT_DOUBLE_EQ(27.5, output->GetPoint(3)[0]);
+    ASSERT_EQ(output->GetPointData()->GetScalars(),
+        output->GetPointData()->GetArray("Scalars"));
+
+    // first bin: x in [10, 15), five rows
+    ASSERT_EQ(25, statistic(*swath, SwathProfileFilter::Count, 0));
+    ASSERT_DOUBLE_EQ(12.0, statistic(*swath, SwathProfileFilter::Mean, 0));
+    ASSERT_DOUBLE_EQ(12.0, statistic(*swath, SwathProfileFilter::Median, 0));
+    ASSERT_DOUBLE_EQ(10.0, statistic(*swath, SwathProfileFilter::Minimum, 0));
+    ASSERT_DOUBLE_EQ(14.0, statistic(*swath, SwathProfileFilter::Maximum, 0));
+    ASSERT_NEAR(std::sqrt(2.0), statistic(*swath, SwathProfileFilter::StandardDeviation, 0), 1e-12);
+
+    // last bin includes the end point: x in [25, 30]
+    ASSERT_EQ(30, statistic(*swath, SwathProfileFilter::Count, 3));
+    ASSERT_DOUBLE_EQ(27.5, statistic(*swath, SwathProfileFilter::Mean, 3));
+    ASSERT_DOUBLE_EQ(27.5, statistic(*swath, SwathProfileFilter::Median, 3));
+    ASSERT_DOUBLE_EQ(25.0, statistic(*swath, SwathProfileFilter::Minimum, 3));
+    ASSERT_DOUBLE_EQ(30.0, statistic(*swath, SwathProfileFilter::Maximum, 3));
+}
+
+TEST_F(SwathProfileFilter_test, BinStatisticsOnImage)
+{
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetExtent(0, 99, 0, 49, 0, 0);
+    auto scalars = vtkSmartPointer<vtkDoubleArray>::New();
+    scalars->SetName("Scalars");
+    scalars->SetNumberOfValues(image->GetNumberOfPoints());
+    for (vtkIdType i = 0; i < scalars->GetNumberOfValues(); ++i)
+    {
+        scalars->SetValue(i, static_cast<double>(i / 100));   // y-coordinate
+    }
+    // invalid values are ignored
+    scalars->SetValue(12 + 25 * 100, std::numeric_limits<double>::quiet_NaN());
+    image->GetPointData()->SetScalars(scalars);
+
+    auto swath = vtkSmartPointer<SwathProfileFilter>::New();
+    swath->SetInputData(image);
+    swath->SetStartPoint({ 10.0, 25.0 });
+    swath->SetEndPoint({ 30.0, 25.0 });
+    swath->SetWidth(4.1);
+    swath->SetNumberOfBins(4);
+    swath->Update();
+
+    ASSERT_EQ(24, statistic(*swath, SwathProfileFilter::Count, 0));
+    ASSERT_EQ(25, statistic(*swath, SwathProfileFilter::Count, 1));
+    for (vtkIdType bin = 1; bin < 4; ++bin)
+    {
+        ASSERT_DOUBLE_EQ(25.0, statistic(*swath, SwathProfileFilter::Mean, bin));
+        ASSERT_DOUBLE_EQ(25.0, statistic(*swath, SwathProfileFilter::Median, bin));
+        ASSERT_DOUBLE_EQ(23.0, statistic(*swath, SwathProfileFilter::Minimum, bin));
+        ASSERT_DOUBLE_EQ(27.0, statistic(*swath, SwathProfileFilter::Maximum, bin));
+        ASSERT_NEAR(std::sqrt(2.0), statistic(*swath, SwathProfileFilter::StandardDeviation, bin), 1e-12);
+    }
+}
+
+TEST_F(SwathProfileFilter_test, EmptyBinsAreNaN)
+{
+    auto points = generateGridPoints(20, 20);
+
+    auto swath = vtkSmartPointer<SwathProfileFilter>::New();
+    swath->SetInputData(points);
+    swath->SetStartPoint({ 10.0, 10.0 });
+    swath->SetEndPoint({ 40.0, 10.0 });
+    swath->SetWidth(1.0);
+    swath->SetNumberOfBins(3);
+    swath->Update();
+
+    ASSERT_EQ(10, statistic(*swath, SwathProfileFilter::Count, 0));
+    ASSERT_EQ(0, statistic(*swath, SwathProfileFilter::Count, 2));
+    ASSERT_TRUE(std::isnan(statistic(*swath, SwathProfileFilter::Mean, 2)));
+    ASSERT_TRUE(std::isnan(statistic(*swath, SwathProfileFilter::Median, 2)));
+}
+
+TEST_F(SwathProfileFilter_test, DiagonalSwathOnImageMatchesPoints)
+{
+    const int nx = 100, ny = 80;
+    auto points = generateGridPoints(nx, ny);
+
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetExtent(0, nx - 1, 0, ny - 1, 0, 0);
+    image->GetPointData()->SetScalars(points->GetPointData()->GetScalars());
+
+    auto createSwath = [] (vtkDataSet * input)
+    {
+        auto swath = vtkSmartPointer<SwathProfileFilter>::New();
+        swath->SetInputData(input);
+        swath->SetStartPoint({ 5.5, 3.2 });
+        swath->SetEndPoint({ 90.3, 75.1 });
+        swath->SetWidth(3.7);
+        swath->SetNumberOfBins(7);
+        swath->Update();
+        return swath;
+    };
+
+    auto pointsSwath = createSwath(points);
+    auto imageSwath = createSwath(image);
+
+    for (vtkIdType bin = 0; bin < 7; ++bin)
+    {
+        ASSERT_EQ(statistic(*pointsSwath, SwathProfileFilter::Count, bin),
+            statistic(*imageSwath, SwathProfileFilter::Count, bin)) << "Bin " << bin;
+        ASSERT_DOUBLE_EQ(statistic(*pointsSwath, SwathProfileFilter::Mean, bin),
+            statistic(*imageSwath, SwathProfileFilter::Mean, bin)) << "Bin " << bin;
+    }
+}
+
+TEST_F(SwathProfileFilter_test, SwathOutsideOfImage)
+{
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetExtent(0, 9, 0, 9, 0, 0);
+    auto scalars = vtkSmartPointer<vtkDoubleArray>::New();
+    scalars->SetName("Scalars");
+    scalars->SetNumberOfValues(image->GetNumberOfPoints());
+    scalars->FillComponent(0, 1.0);
+    image->GetPointData()->SetScalars(scalars);
+
+    auto swath = vtkSmartPointer<SwathProfileFilter>::New();
+    swath->SetInputData(image);
+    swath->SetStartPoint({ 1.e200, -1.e200 });
+    swath->SetEndPoint({ 2.e200, -1.e200 });
+    swath->SetWidth(1.0);
+    swath->SetNumberOfBins(2);
+    swath->Update();
+
+    ASSERT_EQ(0, statistic(*swath, SwathProfileFilter::Count, 0));
+    ASSERT_EQ(0, statistic(*swath, SwathProfileFilter::Count, 1));
+}
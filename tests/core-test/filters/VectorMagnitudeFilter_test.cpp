@@ -0,0 +1,137 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <core/filters/VectorMagnitudeFilter.h>
+#include <core/utility/DataArrayRanges.h>
+#include <core/utility/DataExtent.h>
+#include <core/utility/DataExtent_print.h>
+
+
+class VectorMagnitudeFilter_test : public ::testing::Test
+{
+public:
+    static vtkSmartPointer<vtkPolyData> createPolyData()
+    {
+        auto vectors = vtkSmartPointer<vtkFloatArray>::New();
+        vectors->SetName("vectors");
+        vectors->SetNumberOfComponents(3);
+        vectors->InsertNextTuple3(3.0, 4.0, 0.0);
+        vectors->InsertNextTuple3(0.0, 0.0, -2.0);
+        vectors->InsertNextTuple3(std::numeric_limits<float>::quiet_NaN(), 0.0, 0.0);
+
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        poly->GetPointData()->AddArray(vectors);
+
+        return poly;
+    }
+};
+
+
+TEST_F(VectorMagnitudeFilter_test, MagnitudesAsScalars)
+{
+    auto filter = vtkSmartPointer<VectorMagnitudeFilter>::New();
+    filter->SetInputData(createPolyData());
+    filter->SetArrayName("vectors");
+    filter->Update();
+
+    auto output = filter->GetOutput();
+    auto magnitudes = output->GetPointData()->GetScalars();
+    ASSERT_TRUE(magnitudes);
+    ASSERT_STREQ("vectors Magnitude", magnitudes->GetName());
+    ASSERT_EQ(VTK_FLOAT, magnitudes->GetDataType());
+    ASSERT_EQ(3, magnitudes->GetNumberOfTuples());
+    ASSERT_FLOAT_EQ(5.0f, static_cast<float>(magnitudes->GetComponent(0, 0)));
+    ASSERT_FLOAT_EQ(2.0f, static_cast<float>(magnitudes->GetComponent(1, 0)));
+    ASSERT_TRUE(std::isnan(magnitudes->GetComponent(2, 0)));
+    // input arrays are passed
+    ASSERT_TRUE(output->GetPointData()->GetArray("vectors"));
+}
+
+TEST_F(VectorMagnitudeFilter_test, RangesComputedWithMagnitudes)
+{
+    auto poly = createPolyData();
+    auto & vectors = *poly->GetPointData()->GetArray("vectors");
+
+    auto magnitudes = VectorMagnitudeFilter::Magnitudes(vectors);
+    ASSERT_TRUE(magnitudes->GetInformation()->Has(DataArrayRanges::RANGES()));
+
+    const auto ranges = DataArrayRanges::of(*magnitudes);
+    ASSERT_EQ(ValueRange<>({ 2.0, 5.0 }), ranges.componentRange(0));
+    // histograms on request only
+    ASSERT_FALSE(ranges.hasHistograms());
+    ASSERT_EQ(2, DataArrayRanges::of(*magnitudes, true).componentHistogram(0).count());
+}
+
+TEST_F(VectorMagnitudeFilter_test, SharedUntilVectorsModified)
+{
+    auto poly = createPolyData();
+    auto & vectors = *poly->GetPointData()->GetArray("vectors");
+
+    auto filter1 = vtkSmartPointer<VectorMagnitudeFilter>::New();
+    filter1->SetInputData(poly);
+    filter1->SetArrayName("vectors");
+    filter1->Update();
+    auto filter2 = vtkSmartPointer<VectorMagnitudeFilter>::New();
+    filter2->SetInputData(poly);
+    filter2->SetArrayName("vectors");
+    filter2->Update();
+
+    auto magnitudes = filter1->GetOutput()->GetPointData()->GetScalars();
+    ASSERT_EQ(magnitudes, filter2->GetOutput()->GetPointData()->GetScalars());
+
+    vectors.SetComponent(1, 2, 1.0);
+    vectors.Modified();
+
+    auto newMagnitudes = VectorMagnitudeFilter::Magnitudes(vectors);
+    ASSERT_NE(magnitudes, newMagnitudes.Get());
+    ASSERT_FLOAT_EQ(1.0f, static_cast<float>(newMagnitudes->GetComponent(1, 0)));
+}
+
+TEST_F(VectorMagnitudeFilter_test, DoubleMagnitudesForIntegerVectors)
+{
+    auto vectors = vtkSmartPointer<vtkIntArray>::New();
+    vectors->SetName("cellVectors");
+    vectors->SetNumberOfComponents(3);
+    vectors->InsertNextTuple3(1, 2, 2);
+
+    auto poly = vtkSmartPointer<vtkPolyData>::New();
+    poly->GetCellData()->AddArray(vectors);
+
+    auto filter = vtkSmartPointer<VectorMagnitudeFilter>::New();
+    filter->SetInputData(poly);
+    filter->SetAttributeLocation(IndexType::cells);
+    filter->SetArrayName("cellVectors");
+    filter->Update();
+
+    auto magnitudes = filter->GetOutput()->GetCellData()->GetScalars();
+    ASSERT_TRUE(magnitudes);
+    ASSERT_EQ(VTK_DOUBLE, magnitudes->GetDataType());
+    ASSERT_DOUBLE_EQ(3.0, magnitudes->GetComponent(0, 0));
+}
@@ -0,0 +1,139 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include <vtkFloatArray.h>
+#include <vtkInformation.h>
+#include <vtkIntArray.h>
+#include <vtkSmartPointer.h>
+
+#include <core/utility/DataArrayRanges.h>
+#include <core/utility/DataExtent_print.h>
+
+
+TEST(DataArrayRanges_test, ComponentAndMagnitudeRanges)
+{
+    auto array = vtkSmartPointer<vtkFloatArray>::New();
+    array->SetNumberOfComponents(2);
+    array->InsertNextTuple2(3.0, -4.0);
+    array->InsertNextTuple2(-1.0, 0.0);
+    array->InsertNextTuple2(2.0, 1.0);
+
+    const auto ranges = DataArrayRanges::of(*array);
+    ASSERT_EQ(2, ranges.numberOfComponents());
+    ASSERT_EQ(ValueRange<>({ -1.0, 3.0 }), ranges.componentRange(0));
+    ASSERT_EQ(ValueRange<>({ -4.0, 1.0 }), ranges.componentRange(1));
+    ASSERT_DOUBLE_EQ(1.0, ranges.magnitudeRange()[0]);
+    ASSERT_DOUBLE_EQ(5.0, ranges.magnitudeRange()[1]);
+    ASSERT_EQ(ranges.magnitudeRange(), ranges.range(-1));
+}
+
+TEST(DataArrayRanges_test, IgnoreNonFiniteValues)
+{
+    auto array = vtkSmartPointer<vtkFloatArray>::New();
+    array->SetNumberOfComponents(2);
+    array->InsertNextTuple2(std::numeric_limits<double>::quiet_NaN(), 10.0);
+    array->InsertNextTuple2(1.0, std::numeric_limits<double>::infinity());
+    array->InsertNextTuple2(2.0, 0.0);
+
+    const auto ranges = DataArrayRanges::of(*array);
+    ASSERT_EQ(ValueRange<>({ 1.0, 2.0 }), ranges.componentRange(0));
+    ASSERT_EQ(ValueRange<>({ 0.0, 10.0 }), ranges.componentRange(1));
+    // only the last tuple is finite in all components
+    ASSERT_EQ(ValueRange<>({ 2.0, 2.0 }), ranges.magnitudeRange());
+}
+
+TEST(DataArrayRanges_test, ComponentAndMagnitudeHistograms)
+{
+    auto array = vtkSmartPointer<vtkFloatArray>::New();
+    array->SetNumberOfComponents(2);
+    for (int i = 0; i < 101; ++i)
+    {
+        array->InsertNextTuple2(i, std::numeric_limits<double>::quiet_NaN());
+    }
+    array->InsertNextTuple2(3.0, 4.0);
+
+    const auto ranges = DataArrayRanges::of(*array, true);
+    ASSERT_TRUE(ranges.hasHistograms());
+    ASSERT_EQ(102, ranges.componentHistogram(0).count());
+    ASSERT_NEAR(50.0, ranges.componentHistogram(0).percentile(50.0), 1.0);
+    ASSERT_EQ(1, ranges.componentHistogram(1).count());
+    ASSERT_EQ(1, ranges.magnitudeHistogram().count());
+    ASSERT_DOUBLE_EQ(5.0, ranges.histogram(-1).percentile(50.0));
+}
+
+TEST(DataArrayRanges_test, EmptyRangeForInvalidComponent)
+{
+    auto array = vtkSmartPointer<vtkFloatArray>::New();
+    array->InsertNextValue(std::numeric_limits<float>::quiet_NaN());
+
+    const auto ranges = DataArrayRanges::of(*array);
+    ASSERT_TRUE(ranges.componentRange(0).isEmpty());
+    ASSERT_TRUE(ranges.magnitudeRange().isEmpty());
+}
+
+TEST(DataArrayRanges_test, CachedUntilModified)
+{
+    auto array = vtkSmartPointer<vtkIntArray>::New();
+    array->InsertNextValue(1);
+    array->InsertNextValue(5);
+
+    ASSERT_EQ(ValueRange<>({ 1.0, 5.0 }), DataArrayRanges::of(*array).componentRange(0));
+    ASSERT_TRUE(array->GetInformation()->Has(DataArrayRanges::RANGES()));
+    ASSERT_FALSE(array->GetInformation()->Has(DataArrayRanges::HISTOGRAMS()));
+    DataArrayRanges::of(*array, true);
+    ASSERT_TRUE(array->GetInformation()->Has(DataArrayRanges::HISTOGRAMS()));
+
+    // Values changed without Modified(): the cached ranges are still used.
+    array->SetValue(1, 7);
+    ASSERT_EQ(ValueRange<>({ 1.0, 5.0 }), DataArrayRanges::of(*array).componentRange(0));
+
+    array->Modified();
+    ASSERT_EQ(ValueRange<>({ 1.0, 7.0 }), DataArrayRanges::of(*array).componentRange(0));
+}
+
+TEST(DataArrayRanges_test, HistogramsOnlyOnRequest)
+{
+    auto array = vtkSmartPointer<vtkFloatArray>::New();
+    for (int i = 0; i < 100; ++i)
+    {
+        array->InsertNextValue(static_cast<float>(i));
+    }
+
+    const auto ranges = DataArrayRanges::of(*array);
+    ASSERT_EQ(ValueRange<>({ 0.0, 99.0 }), ranges.componentRange(0));
+    ASSERT_FALSE(ranges.hasHistograms());
+    ASSERT_TRUE(ranges.componentHistogram(0).isEmpty());
+    ASSERT_TRUE(ranges.magnitudeHistogram().isEmpty());
+
+    // computed for cached ranges without histograms
+    const auto withHistograms = DataArrayRanges::of(*array, true);
+    ASSERT_TRUE(withHistograms.hasHistograms());
+    ASSERT_EQ(100, withHistograms.componentHistogram(0).count());
+
+    // cached histograms are also passed to callers that don't require them
+    ASSERT_TRUE(DataArrayRanges::of(*array).hasHistograms());
+
+    array->SetValue(0, -1.0f);
+    array->Modified();
+    ASSERT_FALSE(DataArrayRanges::of(*array).hasHistograms());
+}
@@ -0,0 +1,140 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+
+#include <vtkCellData.h>
+#include <vtkFloatArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+
+#include <core/data_objects/PolyDataObject.h>
+#include <core/utility/DataSetResidualHelper.h>
+#include <core/utility/mathhelper.h>
+
+
+class DataSetResidualHelper_test : public ::testing::Test
+{
+public:
+    static std::unique_ptr<PolyDataObject> genPolyData(const QString & name, int numComponents)
+    {
+        auto poly = vtkSmartPointer<vtkPolyData>::New();
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->InsertNextPoint(0, 0, 0);
+        points->InsertNextPoint(0, 1, 0);
+        points->InsertNextPoint(1, 1, 0);
+        points->InsertNextPoint(1, 0, 0);
+        poly->SetPoints(points);
+        std::array<vtkIdType, 3> pointIds0 = { 0, 1, 2 };
+        std::array<vtkIdType, 3> pointIds1 = { 0, 2, 3 };
+        poly->Allocate(2);
+        poly->InsertNextCell(VTK_TRIANGLE, 3, pointIds0.data());
+        poly->InsertNextCell(VTK_TRIANGLE, 3, pointIds1.data());
+
+        auto scalars = vtkSmartPointer<vtkFloatArray>::New();
+        scalars->SetName(name.toUtf8().data());
+        scalars->SetNumberOfComponents(numComponents);
+        scalars->SetNumberOfTuples(poly->GetNumberOfCells());
+        for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+        {
+            for (int c = 0; c < numComponents; ++c)
+            {
+                scalars->SetTypedComponent(i, c, static_cast<float>(i + 1) * static_cast<float>(c + 1));
+            }
+        }
+        poly->GetCellData()->SetScalars(scalars);
+
+        return std::make_unique<PolyDataObject>(name, *poly);
+    }
+};
+
+
+TEST_F(DataSetResidualHelper_test, FusedProjectionMatchesProjectedScalars)
+{
+    auto observation = genPolyData("observation", 3);
+    auto model = genPolyData("model", 1);
+
+    const double incidence = 35.0, heading = 190.0;
+    const double observationScale = 1.0, modelScale = 0.01;
+
+    DataSetResidualHelper helper;
+    helper.setObservationDataObject(observation.get());
+    helper.setObservationScalars("observation", IndexType::cells);
+    helper.setObservationScalarsScale(observationScale);
+    helper.setModelDataObject(model.get());
+    helper.setModelScalars("model", IndexType::cells);
+    helper.setModelScalarsScale(modelScale);
+    helper.setDeformationLineOfSight(incidence, heading);
+
+    ASSERT_TRUE(helper.updateResidual());
+    auto residualObject = helper.residualDataObject();
+    ASSERT_TRUE(residualObject);
+    auto residual = residualObject->dataSet()->GetCellData()->GetScalars();
+    ASSERT_TRUE(residual);
+    ASSERT_EQ(2, residual->GetNumberOfTuples());
+
+    const auto los = mathhelper::satelliteAnglesToLOSVector(incidence, heading).Normalized();
+    auto observationValues = observation->dataSet()->GetCellData()->GetArray("observation");
+    auto modelValues = model->dataSet()->GetCellData()->GetArray("model");
+    for (vtkIdType i = 0; i < residual->GetNumberOfTuples(); ++i)
+    {
+        double observationLos = 0.0;
+        for (int c = 0; c < 3; ++c)
+        {
+            observationLos += observationValues->GetComponent(i, c) * los[c];
+        }
+        const double expected = observationLos * observationScale
+            - modelValues->GetComponent(i, 0) * modelScale;
+        ASSERT_NEAR(expected, residual->GetComponent(i, 0), 1.e-5);
+    }
+
+    const auto & statistics = helper.residualStatistics();
+    ASSERT_EQ(residual->GetNumberOfTuples(), statistics.count());
+    ASSERT_NEAR(residual->GetRange()[0], statistics.minValue(), 1.e-5);
+    ASSERT_NEAR(residual->GetRange()[1], statistics.maxValue(), 1.e-5);
+    ASSERT_NEAR(0.5 * (residual->GetComponent(0, 0) + residual->GetComponent(1, 0)), statistics.mean(), 1.e-5);
+}
+
+TEST_F(DataSetResidualHelper_test, ProjectedAttributesOnlyOnDemand)
+{
+    auto observation = genPolyData("observation", 3);
+    auto model = genPolyData("model", 3);
+
+    DataSetResidualHelper helper;
+    helper.setObservationDataObject(observation.get());
+    helper.setObservationScalars("observation", IndexType::cells);
+    helper.setModelDataObject(model.get());
+    helper.setModelScalars("model", IndexType::cells);
+    helper.setDeformationLineOfSight(20.0, 10.0);
+
+    const auto numArraysBefore = observation->dataSet()->GetCellData()->GetNumberOfArrays();
+
+    ASSERT_FALSE(helper.projectedAttributesEnabled());
+    ASSERT_TRUE(helper.updateResidual());
+    ASSERT_EQ(numArraysBefore, observation->dataSet()->GetCellData()->GetNumberOfArrays());
+    ASSERT_EQ(QString("observation"), helper.losObservationScalarsName());
+
+    helper.setProjectedAttributesEnabled(true);
+    ASSERT_TRUE(helper.updateResidual());
+    ASSERT_EQ(numArraysBefore + 1, observation->dataSet()->GetCellData()->GetNumberOfArrays());
+    ASSERT_TRUE(observation->dataSet()->GetCellData()->GetArray(
+        helper.losObservationScalarsName().toUtf8().data()));
+}
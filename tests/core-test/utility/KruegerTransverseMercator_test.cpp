@@ -0,0 +1,83 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <core/utility/KruegerTransverseMercator.h>
+
+
+TEST(KruegerTransverseMercator_test, KnownPointNorthern)
+{
+    // Reference values computed with PROJ.4: +proj=utm +zone=20 +ellps=WGS84
+    const KruegerTransverseMercator utm(20, true);
+    double easting, northing;
+    utm.forward(-64.6935425, 32.357145, easting, northing);
+    ASSERT_NEAR(340649.0374, easting, 1e-3);
+    ASSERT_NEAR(3581284.2702, northing, 1e-3);
+}
+
+TEST(KruegerTransverseMercator_test, CentralMeridianSouthern)
+{
+    const KruegerTransverseMercator utm(33, false);
+    double easting, northing;
+    utm.forward(15.0, 0.0, easting, northing);
+    ASSERT_NEAR(500000.0, easting, 1e-6);
+    ASSERT_NEAR(10000000.0, northing, 1e-6);
+}
+
+TEST(KruegerTransverseMercator_test, RoundTrip)
+{
+    for (const bool northern : { true, false })
+    {
+        const KruegerTransverseMercator utm(32, northern);
+        const double latitudeSign = northern ? 1.0 : -1.0;
+
+        std::vector<double> lon, lat;
+        for (double dLon = -4.0; dLon <= 4.0; dLon += 0.5)
+        {
+            for (double absLat = 0.0; absLat <= 80.0; absLat += 2.5)
+            {
+                lon.push_back(9.0 + dLon);
+                lat.push_back(latitudeSign * absLat);
+            }
+        }
+
+        std::vector<double> x(lon.size()), y(lon.size());
+        utm.forward(lon.data(), lat.data(), x.data(), y.data(), lon.size());
+        for (size_t i = 0; i < lon.size(); ++i)
+        {
+            double scalarX, scalarY;
+            utm.forward(lon[i], lat[i], scalarX, scalarY);
+            ASSERT_DOUBLE_EQ(scalarX, x[i]);
+            ASSERT_DOUBLE_EQ(scalarY, y[i]);
+        }
+
+        // In-place inverse
+        utm.inverse(x.data(), y.data(), x.data(), y.data(), x.size());
+
+        // 1e-9 degrees are roughly 0.1 mm
+        for (size_t i = 0; i < lon.size(); ++i)
+        {
+            ASSERT_NEAR(lon[i], x[i], 1e-9) << "lon " << lon[i] << " lat " << lat[i];
+            ASSERT_NEAR(lat[i], y[i], 1e-9) << "lon " << lon[i] << " lat " << lat[i];
+        }
+    }
+}
@@ -0,0 +1,246 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <QCoreApplication>
+
+#include <vtkExecutive.h>
+#include <vtkPassThrough.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTransform.h>
+#include <vtkTransformFilter.h>
+
+#include <core/utility/PipelineOutputCache.h>
+
+
+class PipelineOutputCache_test : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        auto & cache = PipelineOutputCache::instance();
+        m_previousBudget = cache.memoryBudget();
+        cache.resetStatistics();
+
+        m_source = vtkSmartPointer<vtkPolyData>::New();
+        auto points = vtkSmartPointer<vtkPoints>::New();
+        points->SetDataTypeToDouble();
+        points->SetNumberOfPoints(numPoints());
+        for (vtkIdType i = 0; i < numPoints(); ++i)
+        {
+            points->SetPoint(i, static_cast<double>(i), 0.0, 0.0);
+        }
+        m_source->SetPoints(points);
+    }
+
+    void TearDown() override
+    {
+        PipelineOutputCache::instance().setMemoryBudget(m_previousBudget);
+    }
+
+    /** Filter that creates a copy of the input points. */
+    vtkSmartPointer<vtkTransformFilter> createCopyingFilter()
+    {
+        auto filter = vtkSmartPointer<vtkTransformFilter>::New();
+        filter->SetTransform(vtkSmartPointer<vtkTransform>::New());
+        filter->SetInputData(m_source);
+        return filter;
+    }
+
+    static vtkIdType outputPoints(vtkAlgorithm & algorithm)
+    {
+        return vtkPolyData::SafeDownCast(algorithm.GetOutputDataObject(0))->GetNumberOfPoints();
+    }
+
+    static vtkIdType numPoints()
+    {
+        return 100000;
+    }
+    /** Size of the output points of a single filter, rounded up */
+    static std::uint64_t pointsKiB()
+    {
+        return static_cast<std::uint64_t>(numPoints()) * 3u * sizeof(double) / 1024u + 1u;
+    }
+
+    std::uint64_t m_previousBudget;
+    vtkSmartPointer<vtkPolyData> m_source;
+};
+
+
+TEST_F(PipelineOutputCache_test, AccountsCopiedCoordinates)
+{
+    auto & cache = PipelineOutputCache::instance();
+    auto filter = createCopyingFilter();
+    cache.add(*filter);
+    ASSERT_TRUE(filter->GetExecutive()->Update());
+
+    const auto stats = cache.statistics();
+    ASSERT_GE(stats.memoryKiB, pointsKiB() - 1);
+    ASSERT_EQ(1u, stats.numCachedOutputs);
+}
+
+TEST_F(PipelineOutputCache_test, SharedCoordinatesAreNotAccounted)
+{
+    auto & cache = PipelineOutputCache::instance();
+    const auto memoryBefore = cache.statistics().memoryKiB;
+    auto passThrough = vtkSmartPointer<vtkPassThrough>::New();
+    passThrough->SetInputData(m_source);
+    cache.add(*passThrough);
+    ASSERT_TRUE(passThrough->GetExecutive()->Update());
+
+    ASSERT_EQ(memoryBefore, cache.statistics().memoryKiB);
+}
+
+TEST_F(PipelineOutputCache_test, EvictsLeastRecentlyUsed)
+{
+    auto & cache = PipelineOutputCache::instance();
+    cache.setMemoryBudget(cache.statistics().memoryKiB + pointsKiB() * 3 / 2);
+
+    auto first = createCopyingFilter();
+    auto second = createCopyingFilter();
+    cache.add(*first);
+    cache.add(*second);
+
+    ASSERT_TRUE(first->GetExecutive()->Update());
+    ASSERT_EQ(numPoints(), outputPoints(*first));
+    ASSERT_TRUE(second->GetExecutive()->Update());
+    ASSERT_EQ(numPoints(), outputPoints(*second));
+
+    // Outputs are released in the application thread's event loop.
+    ASSERT_EQ(numPoints(), outputPoints(*first));
+    QCoreApplication::processEvents();
+
+    // Releasing the first output was required to meet the budget.
+    ASSERT_EQ(0, outputPoints(*first));
+    ASSERT_EQ(1u, cache.statistics().evictions);
+
+    cache.access(*second);
+    cache.access(*first);
+    ASSERT_EQ(1u, cache.statistics().hits);
+    ASSERT_EQ(1u, cache.statistics().misses);
+
+    // The pipeline recomputes released outputs on demand.
+    ASSERT_TRUE(first->GetExecutive()->Update());
+    QCoreApplication::processEvents();
+    ASSERT_EQ(numPoints(), outputPoints(*first));
+    ASSERT_EQ(0, outputPoints(*second));
+}
+
+TEST_F(PipelineOutputCache_test, KeepsOutputsReferencedByConsumers)
+{
+    auto & cache = PipelineOutputCache::instance();
+    cache.setMemoryBudget(cache.statistics().memoryKiB + pointsKiB() * 3 / 2);
+    const auto evictionsBefore = cache.statistics().evictions;
+
+    auto first = createCopyingFilter();
+    auto second = createCopyingFilter();
+    cache.add(*first);
+    cache.add(*second);
+
+    ASSERT_TRUE(first->GetExecutive()->Update());
+    vtkSmartPointer<vtkDataObject> heldOutput = first->GetOutputDataObject(0);
+    ASSERT_TRUE(second->GetExecutive()->Update());
+    QCoreApplication::processEvents();
+
+    ASSERT_EQ(numPoints(), outputPoints(*first));
+    ASSERT_EQ(numPoints(), outputPoints(*second));
+    ASSERT_EQ(evictionsBefore, cache.statistics().evictions);
+
+    // Once released by the consumer, the output is evicted on the next execution.
+    heldOutput = nullptr;
+    second->Modified();
+    ASSERT_TRUE(second->GetExecutive()->Update());
+    QCoreApplication::processEvents();
+
+    ASSERT_EQ(0, outputPoints(*first));
+    ASSERT_EQ(numPoints(), outputPoints(*second));
+    ASSERT_EQ(evictionsBefore + 1, cache.statistics().evictions);
+}
+
+TEST_F(PipelineOutputCache_test, KeepsOutputsWithPointsSharedByConsumers)
+{
+    auto & cache = PipelineOutputCache::instance();
+    cache.setMemoryBudget(cache.statistics().memoryKiB + pointsKiB() * 3 / 2);
+    const auto evictionsBefore = cache.statistics().evictions;
+
+    auto first = createCopyingFilter();
+    auto second = createCopyingFilter();
+    cache.add(*first);
+    cache.add(*second);
+
+    ASSERT_TRUE(first->GetExecutive()->Update());
+    auto consumerCopy = vtkSmartPointer<vtkPolyData>::New();
+    consumerCopy->ShallowCopy(first->GetOutputDataObject(0));
+    const auto memoryBefore = cache.statistics().memoryKiB;
+    ASSERT_TRUE(second->GetExecutive()->Update());
+    QCoreApplication::processEvents();
+
+    ASSERT_EQ(numPoints(), outputPoints(*first));
+    ASSERT_EQ(numPoints(), consumerCopy->GetNumberOfPoints());
+    ASSERT_EQ(evictionsBefore, cache.statistics().evictions);
+    ASSERT_GE(cache.statistics().memoryKiB, memoryBefore + pointsKiB() - 1);
+}
+
+TEST_F(PipelineOutputCache_test, SuspendsEviction)
+{
+    auto & cache = PipelineOutputCache::instance();
+    cache.setMemoryBudget(cache.statistics().memoryKiB + pointsKiB() * 3 / 2);
+    const auto evictionsBefore = cache.statistics().evictions;
+
+    auto first = createCopyingFilter();
+    auto second = createCopyingFilter();
+    cache.add(*first);
+    cache.add(*second);
+
+    {
+        const PipelineOutputCache::ScopedEvictionSuspension suspension;
+        ASSERT_TRUE(first->GetExecutive()->Update());
+        ASSERT_TRUE(second->GetExecutive()->Update());
+        QCoreApplication::processEvents();
+
+        ASSERT_EQ(numPoints(), outputPoints(*first));
+        ASSERT_EQ(evictionsBefore, cache.statistics().evictions);
+    }
+
+    // Skipped evictions are scheduled when the suspension ends.
+    QCoreApplication::processEvents();
+    ASSERT_EQ(0, outputPoints(*first));
+    ASSERT_EQ(numPoints(), outputPoints(*second));
+    ASSERT_EQ(evictionsBefore + 1, cache.statistics().evictions);
+}
+
+TEST_F(PipelineOutputCache_test, RemovesDeletedAlgorithms)
+{
+    auto & cache = PipelineOutputCache::instance();
+    const auto before = cache.statistics();
+    {
+        auto filter = createCopyingFilter();
+        cache.add(*filter);
+        ASSERT_TRUE(filter->GetExecutive()->Update());
+        ASSERT_EQ(before.numAlgorithms + 1, cache.statistics().numAlgorithms);
+    }
+    const auto after = cache.statistics();
+    ASSERT_EQ(before.numAlgorithms, after.numAlgorithms);
+    ASSERT_EQ(before.memoryKiB, after.memoryKiB);
+}
@@ -0,0 +1,121 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <core/utility/ProgressiveUpdateScheduler.h>
+
+
+TEST(ProgressiveUpdateScheduler_test, MergesRequestsWhileUpdateRuns)
+{
+    ProgressiveUpdateScheduler scheduler;
+    double resolution = 0.0;
+
+    ASSERT_FALSE(scheduler.startUpdate(resolution));
+
+    scheduler.requestUpdate();
+    ASSERT_TRUE(scheduler.startUpdate(resolution));
+    ASSERT_EQ(1.0, resolution);
+    ASSERT_TRUE(scheduler.isUpdateRunning());
+
+    // intermediate requests are merged into a single update
+    for (int i = 0; i < 5; ++i)
+    {
+        scheduler.requestUpdate();
+        ASSERT_FALSE(scheduler.startUpdate(resolution));
+    }
+    ASSERT_TRUE(scheduler.isUpdatePending());
+
+    scheduler.finishUpdate(10);
+    ASSERT_TRUE(scheduler.startUpdate(resolution));
+    ASSERT_FALSE(scheduler.isUpdatePending());
+    scheduler.finishUpdate(10);
+
+    ASSERT_FALSE(scheduler.startUpdate(resolution));
+    ASSERT_FALSE(scheduler.isUpdateRunning());
+}
+
+TEST(ProgressiveUpdateScheduler_test, ResetDropsPendingUpdates)
+{
+    ProgressiveUpdateScheduler scheduler;
+    double resolution = 0.0;
+
+    scheduler.requestUpdate();
+    ASSERT_TRUE(scheduler.startUpdate(resolution));
+    scheduler.requestUpdate();
+
+    scheduler.reset();
+    ASSERT_FALSE(scheduler.isUpdatePending());
+    ASSERT_FALSE(scheduler.isUpdateRunning());
+    ASSERT_FALSE(scheduler.startUpdate(resolution));
+
+    // late notification of the update that was waited for
+    scheduler.finishUpdate(10);
+    ASSERT_FALSE(scheduler.isUpdateRunning());
+}
+
+TEST(ProgressiveUpdateScheduler_test, AdaptsPreviewResolutionToTimeBudget)
+{
+    ProgressiveUpdateScheduler scheduler(40, 0.25);
+    double resolution = 0.0;
+    scheduler.setInteractive(true);
+
+    const auto runUpdate = [&scheduler, &resolution] (std::int64_t elapsedMs)
+    {
+        scheduler.requestUpdate();
+        EXPECT_TRUE(scheduler.startUpdate(resolution));
+        scheduler.finishUpdate(elapsedMs);
+        return resolution;
+    };
+
+    ASSERT_EQ(1.0, runUpdate(100));
+    ASSERT_EQ(0.5, runUpdate(100));
+    ASSERT_EQ(0.25, runUpdate(100));
+    // limited to the minimal resolution
+    ASSERT_EQ(0.25, runUpdate(100));
+    ASSERT_EQ(0.25, scheduler.previewResolution());
+
+    // within the budget: keep the resolution
+    ASSERT_EQ(0.25, runUpdate(20));
+    ASSERT_EQ(0.25, scheduler.previewResolution());
+
+    // far below the budget: increase the resolution
+    ASSERT_EQ(0.25, runUpdate(5));
+    ASSERT_EQ(0.5, scheduler.previewResolution());
+
+    // full resolution after the interaction, without changing the preview resolution
+    scheduler.setInteractive(false);
+    ASSERT_EQ(1.0, runUpdate(1000));
+    ASSERT_EQ(0.5, scheduler.previewResolution());
+}
+
+TEST(ProgressiveUpdateScheduler_test, FullResolutionUpdateDoesNotAdaptPreviews)
+{
+    ProgressiveUpdateScheduler scheduler(40, 0.25);
+    double resolution = 0.0;
+
+    // started before the interaction, finished during it
+    scheduler.requestUpdate();
+    ASSERT_TRUE(scheduler.startUpdate(resolution));
+    ASSERT_EQ(1.0, resolution);
+    scheduler.setInteractive(true);
+    scheduler.finishUpdate(1000);
+
+    ASSERT_EQ(1.0, scheduler.previewResolution());
+}
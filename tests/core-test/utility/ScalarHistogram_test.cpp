@@ -0,0 +1,148 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <core/utility/ScalarHistogram.h>
+
+
+TEST(ScalarHistogram_test, EmptyHistogram)
+{
+    ScalarHistogram::Accumulator accumulator;
+    accumulator.add(std::numeric_limits<double>::quiet_NaN());
+    accumulator.add(std::numeric_limits<double>::infinity());
+    const ScalarHistogram histogram(accumulator);
+
+    ASSERT_TRUE(histogram.isEmpty());
+    ASSERT_EQ(0, histogram.count());
+    ASSERT_TRUE(std::isnan(histogram.percentile(50.0)));
+}
+
+TEST(ScalarHistogram_test, PercentilesOfNarrowRange)
+{
+    // Values with a small range relative to their magnitude would share a single bin of a
+    // histogram based on the exponent and few mantissa bits only.
+    std::mt19937 generator(42);
+    std::normal_distribution<double> distribution(1000.0, 2.0);
+
+    std::vector<double> values(10000);
+    std::generate(values.begin(), values.end(), [&] () { return distribution(generator); });
+
+    // Simulate thread local accumulators
+    std::vector<ScalarHistogram::Accumulator> accumulators(4);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        accumulators[i % accumulators.size()].add(values[i]);
+    }
+    const auto histogram = ScalarHistogram::merge(accumulators.begin(), accumulators.end());
+
+    std::sort(values.begin(), values.end());
+
+    ASSERT_EQ(static_cast<vtkIdType>(values.size()), histogram.count());
+    ASSERT_DOUBLE_EQ(values.front(), histogram.percentile(0.0));
+    ASSERT_DOUBLE_EQ(values.back(), histogram.percentile(100.0));
+    for (const double percent : { 2.0, 25.0, 50.0, 75.0, 98.0 })
+    {
+        const auto index = static_cast<size_t>(percent * 0.01 * (values.size() - 1));
+        const auto expected = values[index];
+        const auto tolerance = std::abs(expected) * ScalarHistogram::relativeBinWidth()
+            + std::abs(values[index + 1] - values[index - 1]);
+        ASSERT_NEAR(expected, histogram.percentile(percent), tolerance) << percent << "%";
+    }
+}
+
+TEST(ScalarHistogram_test, AddHistograms)
+{
+    ScalarHistogram::Accumulator negative, positive;
+    for (int i = 1; i <= 100; ++i)
+    {
+        negative.add(-i);
+        positive.add(i);
+    }
+
+    ScalarHistogram histogram(negative);
+    histogram.add(ScalarHistogram(positive));
+
+    ASSERT_EQ(200, histogram.count());
+    ASSERT_DOUBLE_EQ(-100.0, histogram.minValue());
+    ASSERT_DOUBLE_EQ(100.0, histogram.maxValue());
+    ASSERT_NEAR(0.0, histogram.percentile(50.0), 1.0);
+    ASSERT_NEAR(-96.0, histogram.percentile(2.0), 1.0);
+    ASSERT_NEAR(96.0, histogram.percentile(98.0), 1.0);
+}
+
+TEST(ScalarHistogram_test, HistogramInSubrange)
+{
+    ScalarHistogram::Accumulator accumulator;
+    for (int i = 0; i < 100; ++i)
+    {
+        accumulator.add(i + 0.5);
+    }
+    const ScalarHistogram histogram(accumulator);
+
+    const auto fullHistogram = histogram.histogram(10);
+    ASSERT_EQ(10u, fullHistogram.size());
+    ASSERT_EQ(histogram.count(), std::accumulate(fullHistogram.begin(), fullHistogram.end(), vtkIdType(0)));
+
+    const auto subHistogram = histogram.histogram(5, 0.0, 50.0);
+    ASSERT_EQ(std::vector<vtkIdType>(5, 10), subHistogram);
+}
+
+TEST(ScalarHistogram_test, LimitsRefinedBins)
+{
+    // Values in many more coarse bins than are refined, spanning many orders of magnitude
+    std::vector<double> values;
+    for (int exponent = -20; exponent < 20; ++exponent)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            values.push_back(std::ldexp(1.0 + i / 64.0 + 1.0 / 256.0, exponent));
+        }
+    }
+    ASSERT_GT(values.size(), 2 * ScalarHistogram::maxRefinedBins());
+
+    std::vector<ScalarHistogram::Accumulator> accumulators(2);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        accumulators[i % accumulators.size()].add(values[i]);
+    }
+    // refined bins of one accumulator are not refined in the other one
+    accumulators.front().merge(accumulators.back());
+    const ScalarHistogram histogram(accumulators.front());
+
+    ASSERT_EQ(static_cast<vtkIdType>(values.size()), histogram.count());
+    ASSERT_DOUBLE_EQ(values.front(), histogram.percentile(0.0));
+    ASSERT_DOUBLE_EQ(values.back(), histogram.percentile(100.0));
+    const auto binned = histogram.histogram(4, values.front(), values.back());
+    ASSERT_EQ(histogram.count(), std::accumulate(binned.begin(), binned.end(), vtkIdType(0)));
+
+    for (const double percent : { 10.0, 50.0, 90.0 })
+    {
+        const auto index = static_cast<size_t>(percent * 0.01 * (values.size() - 1));
+        const auto expected = values[index];
+        ASSERT_NEAR(expected, histogram.percentile(percent),
+            std::abs(expected) * ScalarHistogram::coarseRelativeBinWidth()) << percent << "%";
+    }
+}
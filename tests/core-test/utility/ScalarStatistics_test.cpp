@@ -0,0 +1,92 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <core/utility/ScalarStatistics.h>
+
+
+TEST(ScalarStatistics_test, EmptyIsInvalid)
+{
+    ScalarStatistics::Accumulator accumulator;
+    accumulator.add(std::numeric_limits<double>::quiet_NaN());
+    const ScalarStatistics statistics(accumulator);
+
+    ASSERT_FALSE(statistics.isValid());
+    ASSERT_EQ(0, statistics.count());
+    ASSERT_TRUE(std::isnan(statistics.median()));
+}
+
+TEST(ScalarStatistics_test, SummaryValues)
+{
+    ScalarStatistics::Accumulator accumulator;
+    const std::vector<double> values = { -2.0, 1.0, 3.0, 4.0 };
+    for (auto v : values)
+    {
+        accumulator.add(v);
+    }
+    const ScalarStatistics statistics(accumulator);
+
+    ASSERT_EQ(4, statistics.count());
+    ASSERT_DOUBLE_EQ(-2.0, statistics.minValue());
+    ASSERT_DOUBLE_EQ(4.0, statistics.maxValue());
+    ASSERT_DOUBLE_EQ(1.5, statistics.mean());
+    ASSERT_DOUBLE_EQ(std::sqrt(30.0 / 4.0), statistics.rootMeanSquare());
+}
+
+TEST(ScalarStatistics_test, MergedPercentilesWithinBound)
+{
+    std::mt19937 generator(42);
+    std::normal_distribution<double> distribution(0.5, 2.0);
+
+    std::vector<double> values(10000);
+    std::generate(values.begin(), values.end(), [&] () { return distribution(generator); });
+
+    // Simulate thread local accumulators
+    std::vector<ScalarStatistics::Accumulator> accumulators(4);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        accumulators[i % accumulators.size()].add(values[i]);
+    }
+    const auto statistics = ScalarStatistics::merge(accumulators.begin(), accumulators.end());
+
+    std::sort(values.begin(), values.end());
+
+    ASSERT_EQ(static_cast<vtkIdType>(values.size()), statistics.count());
+    for (const double percent : { 2.0, 25.0, 50.0, 75.0, 98.0 })
+    {
+        const auto index = static_cast<size_t>(percent * 0.01 * (values.size() - 1));
+        const auto expected = values[index];
+        // Bin width relative to the value, plus neighboring values for the rank approximation
+        const auto tolerance = std::abs(expected) * ScalarStatistics::relativeBinWidth()
+            + std::abs(values[index + 1] - values[index - 1]);
+        ASSERT_NEAR(expected, statistics.percentile(percent), tolerance) << percent << "%";
+    }
+
+    const auto histogram = statistics.histogram(20);
+    ASSERT_EQ(20u, histogram.size());
+    ASSERT_EQ(statistics.count(), std::accumulate(histogram.begin(), histogram.end(), vtkIdType(0)));
+}
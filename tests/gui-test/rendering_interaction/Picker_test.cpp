@@ -33,11 +33,15 @@
 #include <vtkRenderWindow.h>
 #include <vtkVector.h>
 
+#include <core/CoordinateSystems.h>
 #include <core/types.h>
 #include <core/color_mapping/ColorMapping.h>
 #include <core/data_objects/ImageDataObject.h>
 #include <core/data_objects/PolyDataObject.h>
+#include <core/filters/ImagePyramidFilter.h>
 #include <core/rendered_data/RenderedData.h>
+#include <core/utility/GeographicTransformationUtil.h>
+#include <core/utility/ImagePyramidSlice.h>
 #include <core/utility/vtkvectorhelper.h>
 
 #include <gui/rendering_interaction/Picker.h>
@@ -109,6 +113,50 @@ public:
             vtkVector2d(0.99, 0.66)));
     }
 
+    /** Image that is rendered with a downsampled level of detail when viewed as a whole */
+    void setupAddLargeImageData(const QString & name = "Large Image")
+    {
+        dataObject = genImageData(name, largeImageExtent());
+        renderedData = dataObject->createRendered();
+        renderedData->colorMapping();   // initialize
+
+        addViewProps();
+    }
+
+    /** Look at the large image, so that a screen pixel covers 4x4 image pixels. */
+    void lookAtLargeImageData(const vtkVector2d & focalPoint)
+    {
+        auto & cam = *ren->GetActiveCamera();
+
+        cam.ParallelProjectionOn();
+        cam.SetViewUp(0, 1, 0);
+        cam.SetFocalPoint(focalPoint[0], focalPoint[1], 0);
+        cam.SetPosition(focalPoint[0], focalPoint[1], 1000);
+        cam.SetParallelScale(0.5 * 4.0 * renWinSize[1]);
+        ren->ResetCameraClippingRange();
+        ren->Render();
+    }
+
+    static const std::array<int, 6> & largeImageExtent()
+    {
+        static const std::array<int, 6> extent = { 100, 1123, 50, 1073, 0, 0 };
+        return extent;
+    }
+
+    ImagePyramidFilter * pyramid()
+    {
+        auto viewProps = renderedData->viewProps();
+        viewProps->InitTraversal();
+        while (auto prop = viewProps->GetNextProp())
+        {
+            if (auto slice = ImagePyramidSlice::SafeDownCast(prop))
+            {
+                return slice->GetPyramid();
+            }
+        }
+        return nullptr;
+    }
+
     void addViewProps()
     {
         auto viewProps = renderedData->viewProps();
@@ -157,10 +205,11 @@ public:
         return std::make_unique<PolyDataObject>(name, *poly);
     }
 
-    static std::unique_ptr<ImageDataObject> genImageData(const QString & name = "Image")
+    static std::unique_ptr<ImageDataObject> genImageData(const QString & name = "Image",
+        const std::array<int, 6> & extent = { { 0, 2, 0, 3, 0, 0 } })
     {
         auto image = vtkSmartPointer<vtkImageData>::New();
-        image->SetExtent(0, 2, 0, 3, 0, 0);
+        image->SetExtent(extent.data());
 
         auto scalars = vtkSmartPointer<vtkFloatArray>::New();
         scalars->SetNumberOfTuples(image->GetNumberOfPoints());
@@ -267,3 +316,97 @@ TEST_F(Picker_test, PickImageData_pickMappedScalarArray)
 
     ASSERT_EQ(scalars, picker.pickedScalarArray());
 }
+
+TEST_F(Picker_test, PickImageData_mapsDownsampledLevelToInput)
+{
+    const QString scalarsName = "Large Image";
+    setupAddLargeImageData(scalarsName);
+
+    // Level 2 of the pyramid has a spacing of 4 and its origin at (101.5, 51.5). Look at a level
+    // point, which is centered between the input points 612..615 and 562..565.
+    const auto focalPoint = vtkVector2d(101.5 + 4.0 * 128, 51.5 + 4.0 * 128);
+    lookAtLargeImageData(focalPoint);
+
+    ASSERT_TRUE(pyramid());
+    ASSERT_EQ(2, pyramid()->GetLevel());
+
+    auto picker = Picker();
+    picker.pick(convertTo<int>(convertTo<double>(renWinSize) * 0.5), *ren);
+
+    const auto & extent = largeImageExtent();
+    const vtkIdType dimX = extent[1] - extent[0] + 1;
+    const vtkIdType expectedIndex = (613 - extent[0]) + (563 - extent[2]) * dimX;
+
+    ASSERT_EQ(
+        VisualizationSelection(renderedData.get(), 0, IndexType::points, expectedIndex),
+        picker.pickedObjectInfo());
+
+    auto scalars = dataObject->dataSet()->GetPointData()->GetScalars();
+    ASSERT_EQ(scalars, picker.pickedScalarArray());
+    ASSERT_EQ(static_cast<double>(expectedIndex), scalars->GetTuple1(expectedIndex));
+}
+
+TEST_F(Picker_test, PickImageData_mapsResampledImageToInput)
+{
+    // Geographic image covering a whole UTM zone, which is resampled when rendered in UTM.
+    const auto geoSpec = ReferencedCoordinateSystemSpecification(
+        CoordinateSystemType::geographic, "WGS 84", "UTM", {}, { 45.0, 9.0 });
+    const auto utmSpec = CoordinateSystemSpecification(
+        CoordinateSystemType::metricGlobal, "WGS 84", "UTM", "m");
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetExtent(0, 60, 0, 40, 0, 0);
+    image->SetOrigin(6.0, 43.0, 0.0);
+    image->SetSpacing(0.1, 0.1, 1.0);
+    auto scalars = vtkSmartPointer<vtkFloatArray>::New();
+    scalars->SetName("Geographic Image");
+    scalars->SetNumberOfValues(image->GetNumberOfPoints());
+    scalars->Fill(1.0);
+    image->GetPointData()->SetScalars(scalars);
+    auto imageObject = std::make_unique<ImageDataObject>("Geographic Image", *image);
+    ASSERT_TRUE(imageObject->specifyCoordinateSystem(geoSpec));
+    dataObject = std::move(imageObject);
+
+    renderedData = dataObject->createRendered();
+    renderedData->setDefaultCoordinateSystem(utmSpec);
+    renderedData->colorMapping();   // initialize
+    addViewProps();
+
+    // Look at the UTM position of the input point at 9°E, 45°N, one pixel per kilometer.
+    const auto geoPoint = vtkVector3d(9.0, 45.0, 0.0);
+    const GeographicTransformationUtil toUTM(geoSpec, utmSpec);
+    bool success = false;
+    const auto utmPoint = toUTM.transformPoint(geoPoint, &success);
+    ASSERT_TRUE(success);
+
+    auto & cam = *ren->GetActiveCamera();
+    cam.ParallelProjectionOn();
+    cam.SetViewUp(0, 1, 0);
+    cam.SetFocalPoint(utmPoint[0], utmPoint[1], 0);
+    cam.SetPosition(utmPoint[0], utmPoint[1], 1000);
+    cam.SetParallelScale(0.5 * 1000.0 * renWinSize[1]);
+    ren->ResetCameraClippingRange();
+    ren->Render();
+
+    auto picker = Picker();
+    picker.pick(convertTo<int>(convertTo<double>(renWinSize) * 0.5), *ren);
+
+    const auto & selection = picker.pickedObjectInfo();
+    ASSERT_EQ(renderedData.get(), selection.visualization);
+    ASSERT_EQ(IndexType::points, selection.indexType);
+    ASSERT_FALSE(selection.isIndexListEmpty());
+
+    // The selected index refers to an input point next to the picked position, not to the
+    // resampled image.
+    const auto selectedIndex = selection.indices.front();
+    ASSERT_GE(selectedIndex, 0);
+    ASSERT_LT(selectedIndex, dataObject->dataSet()->GetNumberOfPoints());
+    const auto selectedPoint = vtkVector3d(dataObject->dataSet()->GetPoint(selectedIndex));
+    ASSERT_NEAR(geoPoint[0], selectedPoint[0], 0.15);
+    ASSERT_NEAR(geoPoint[1], selectedPoint[1], 0.15);
+
+    // Values are read at the picked index of the resampled image.
+    auto pickedScalars = picker.pickedScalarArray();
+    ASSERT_TRUE(pickedScalars);
+    ASSERT_NE(dataObject->dataSet()->GetPointData()->GetScalars(), pickedScalars);
+    ASSERT_EQ(dataObject->dataSet()->GetNumberOfPoints(), pickedScalars->GetNumberOfTuples());
+}
@@ -0,0 +1,170 @@
+/*
+ * GeohazardVis
+ * Copyright (C) 2017 Karsten Tausche <geodev@posteo.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * Benchmark for GeographicTransformationFilter: transforms point clouds with 1 M and 10 M points
+ * between geographic, UTM, and local metric coordinates, using the serial and the parallel
+ * PROJ.4 code path. Also verifies that both paths produce identical results.
+ *
+ * Usage: benchmark_GeographicTransformation [numPoints...]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <vtkExecutive.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <core/CoordinateSystems.h>
+#include <core/filters/GeographicTransformationFilter.h>
+
+
+namespace
+{
+
+const vtkVector2d referencePointLatLong = { 32.357145, -64.6935425 };
+
+ReferencedCoordinateSystemSpecification spec(CoordinateSystemType type)
+{
+    return ReferencedCoordinateSystemSpecification(type, "WGS 84", "UTM",
+        type == CoordinateSystemType::geographic ? "" : "m",
+        referencePointLatLong);
+}
+
+vtkSmartPointer<vtkPolyData> generateGeographicPoints(vtkIdType numPoints)
+{
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numPoints);
+    for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+        const double t = static_cast<double>(i) / static_cast<double>(numPoints);
+        points->SetPoint(i,
+            referencePointLatLong[1] - 0.5 + t,
+            referencePointLatLong[0] - 0.5 + std::fmod(t * 997.0, 1.0),
+            200.0 + std::fmod(t * 13.0, 1.0) * 300.0);
+    }
+
+    auto poly = vtkSmartPointer<vtkPolyData>::New();
+    poly->SetPoints(points);
+    spec(CoordinateSystemType::geographic).writeToFieldData(*poly->GetFieldData());
+    return poly;
+}
+
+struct Result
+{
+    double seconds;
+    vtkSmartPointer<vtkPoints> points;
+};
+
+Result run(vtkPolyData & input, CoordinateSystemType target, bool parallel)
+{
+    auto filter = vtkSmartPointer<GeographicTransformationFilter>::New();
+    filter->SetParallelProjection(parallel);
+    filter->SetInputData(&input);
+    filter->SetTargetCoordinateSystem(spec(target));
+
+    const auto start = std::chrono::steady_clock::now();
+    filter->GetExecutive()->Update();
+    const auto end = std::chrono::steady_clock::now();
+
+    Result result;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.points = vtkPolyData::SafeDownCast(filter->GetOutput())->GetPoints();
+    return result;
+}
+
+bool identical(vtkPoints & lhs, vtkPoints & rhs)
+{
+    const auto numPoints = lhs.GetNumberOfPoints();
+    if (numPoints != rhs.GetNumberOfPoints())
+    {
+        return false;
+    }
+    const auto l = static_cast<const double *>(lhs.GetVoidPointer(0));
+    const auto r = static_cast<const double *>(rhs.GetVoidPointer(0));
+    return std::memcmp(l, r, static_cast<size_t>(numPoints) * 3 * sizeof(double)) == 0;
+}
+
+}
+
+
+int main(int argc, char ** argv)
+{
+    std::vector<vtkIdType> sizes;
+    for (int i = 1; i < argc; ++i)
+    {
+        sizes.push_back(static_cast<vtkIdType>(std::atoll(argv[i])));
+    }
+    if (sizes.empty())
+    {
+        sizes = { 1000000, 10000000 };
+    }
+
+    const std::vector<std::pair<const char *, CoordinateSystemType>> targets = {
+        { "geographic -> UTM", CoordinateSystemType::metricGlobal },
+        { "geographic -> local", CoordinateSystemType::metricLocal },
+    };
+
+    bool allIdentical = true;
+
+    for (const auto numPoints : sizes)
+    {
+        auto geographic = generateGeographicPoints(numPoints);
+
+        for (const auto & target : targets)
+        {
+            const auto serial = run(*geographic, target.second, false);
+            const auto parallel = run(*geographic, target.second, true);
+            const bool same = identical(*serial.points, *parallel.points);
+            allIdentical = allIdentical && same;
+
+            std::cout << std::setw(10) << numPoints << " points, " << target.first << ": "
+                << "serial " << std::fixed << std::setprecision(3) << serial.seconds << " s, "
+                << "parallel " << parallel.seconds << " s, "
+                << "speedup " << std::setprecision(2) << serial.seconds / parallel.seconds
+                << (same ? "" : "  RESULTS DIFFER") << std::endl;
+        }
+
+        // Back transformation, starting from local coordinates
+        auto local = run(*geographic, CoordinateSystemType::metricLocal, true);
+        auto localPoly = vtkSmartPointer<vtkPolyData>::New();
+        localPoly->SetPoints(local.points);
+        spec(CoordinateSystemType::metricLocal).writeToFieldData(*localPoly->GetFieldData());
+
+        const auto serial = run(*localPoly, CoordinateSystemType::geographic, false);
+        const auto parallel = run(*localPoly, CoordinateSystemType::geographic, true);
+        const bool same = identical(*serial.points, *parallel.points);
+        allIdentical = allIdentical && same;
+        std::cout << std::setw(10) << numPoints << " points, local -> geographic: "
+            << "serial " << std::fixed << std::setprecision(3) << serial.seconds << " s, "
+            << "parallel " << parallel.seconds << " s, "
+            << "speedup " << std::setprecision(2) << serial.seconds / parallel.seconds
+            << (same ? "" : "  RESULTS DIFFER") << std::endl;
+    }
+
+    return allIdentical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
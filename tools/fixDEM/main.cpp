@@ -16,103 +16,125 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <cassert>
+/**
+ * Headless removal of spikes and voids in DEM files, using DEMRepairFilter.
+ *
+ * Usage: fixDEM [options] <input> <output>
+ * See fixDEM --help for detection and fill options.
+ */
 
-#include <QDebug>
-#include <QScopedPointer>
+#include <cstdlib>
+#include <iostream>
 
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <vtkExecutive.h>
 #include <vtkImageData.h>
+#include <vtkPointData.h>
 #include <vtkSmartPointer.h>
 
-#include <core/io/Loader.h>
-#include <core/io/Exporter.h>
 #include <core/data_objects/DataObject.h>
+#include <core/filters/DEMRepairFilter.h>
+#include <core/io/Exporter.h>
+#include <core/io/Loader.h>
 
 
-int main()
+int main(int argc, char ** argv)
 {
-    QString fileName{ "E:/Users/Karsten/Documents/Studium/GFZ/data/VTK XML data/Lazufre dem_90msrtm__raster.vti" };
-    QString exportFN{ "E:/Users/Karsten/Documents/Studium/GFZ/data/VTK XML data/Lazufre dem_90msrtm__raster_fixed.vti" };
-
-    auto data = Loader::readFile(fileName);
-
-    vtkSmartPointer<vtkImageData> image = vtkImageData::SafeDownCast(data->dataSet());
-
-    double threshold = 6000;
-
-    int extent[6];
-    image->GetExtent(extent);
-
-    for (int x = extent[0]; x < extent[1]; ++x)
-        for (int y = extent[2]; y < extent[3]; ++y)
-        {
-            double v = image->GetScalarComponentAsDouble(x, y, 0, 0);
-
-            if (v <= threshold)
-                continue;
-
-
-            unsigned num = 0;
-            double v_fixed = 0;
-            // to left
-            for (int i = x - 1; i >= extent[0]; --i)
-            {
-                double _v = image->GetScalarComponentAsDouble(i, y, 0, 0);
-                if (_v <= threshold)
-                {
-                    v_fixed += _v;
-                    ++num;
-                    break;
-                }
-            }
-            // to right
-            for (int i = x + 1; i <= extent[1]; ++i)
-            {
-                double _v = image->GetScalarComponentAsDouble(i, y, 0, 0);
-                if (_v <= threshold)
-                {
-                    v_fixed += _v;
-                    ++num;
-                    break;
-                }
-            }
-            // to top
-            for (int i = y - 1; i >= extent[2]; --i)
-            {
-                double _v = image->GetScalarComponentAsDouble(x, i, 0, 0);
-                if (_v <= threshold)
-                {
-                    v_fixed += _v;
-                    ++num;
-                    break;
-                }
-            }
-            // to bottom
-            for (int i = y + 1; i <= extent[3]; ++i)
-            {
-                double _v = image->GetScalarComponentAsDouble(x, i, 0, 0);
-                if (_v <= threshold)
-                {
-                    v_fixed += _v;
-                    ++num;
-                    break;
-                }
-            }
-
-            if (num == 0)
-            {
-                qDebug() << "Couldn't find a sourrounding value to fix " << x << " " << y;
-                continue;
-            }
-
-            v_fixed /= num;
-
-            image->SetScalarComponentFromDouble(x, y, 0, 0, v_fixed);
-
-            qDebug() << "Fixed " << x << " " << y << " to " << v_fixed;
-        }
-
-    qDebug() << Exporter::exportData(*data, exportFN);
-
-    return 0;
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("fixDEM");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Remove spikes and fill voids in Digital Elevation Models.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Input DEM file (image data)");
+    parser.addPositionalArgument("output", "Output file name");
+
+    const QCommandLineOption spikeThresholdOption("spike-threshold",
+        "Detect elevations above <value> as spikes.", "value");
+    const QCommandLineOption noDataOption("no-data",
+        "Detect elevations equal to <value> as voids.", "value");
+    const QCommandLineOption ignoreNaNOption("ignore-nan",
+        "Don't detect NaN values as voids.");
+    const QCommandLineOption fillOption("fill",
+        "Fill strategy: mean (directional mean, default), idw (inverse distance), or diffusion.",
+        "strategy", "mean");
+    const QCommandLineOption radiusOption("radius",
+        "Search radius in pixels for inverse distance filling (default: 8).", "pixels", "8");
+    const QCommandLineOption iterationsOption("iterations",
+        "Number of diffusion iterations (default: 100).", "count", "100");
+    parser.addOptions({ spikeThresholdOption, noDataOption, ignoreNaNOption,
+        fillOption, radiusOption, iterationsOption });
+
+    parser.process(app);
+
+    const auto positional = parser.positionalArguments();
+    if (positional.size() != 2)
+    {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    auto filter = vtkSmartPointer<DEMRepairFilter>::New();
+    filter->SetDetectNaN(!parser.isSet(ignoreNaNOption));
+    if (parser.isSet(spikeThresholdOption))
+    {
+        filter->DetectSpikesOn();
+        filter->SetSpikeThreshold(parser.value(spikeThresholdOption).toDouble());
+    }
+    if (parser.isSet(noDataOption))
+    {
+        filter->DetectNoDataValueOn();
+        filter->SetNoDataValue(parser.value(noDataOption).toDouble());
+    }
+
+    const auto fill = parser.value(fillOption);
+    if (fill == "mean")
+    {
+        filter->SetFill(DEMRepairFilter::FillDirectionalMean);
+    }
+    else if (fill == "idw")
+    {
+        filter->SetFill(DEMRepairFilter::FillInverseDistance);
+    }
+    else if (fill == "diffusion")
+    {
+        filter->SetFill(DEMRepairFilter::FillDiffusion);
+    }
+    else
+    {
+        std::cerr << "Unknown fill strategy: " << fill.toStdString() << std::endl;
+        return EXIT_FAILURE;
+    }
+    filter->SetSearchRadius(parser.value(radiusOption).toInt());
+    filter->SetNumberOfIterations(parser.value(iterationsOption).toInt());
+
+    auto data = Loader::readFile(positional[0]);
+    auto image = data ? vtkImageData::SafeDownCast(data->dataSet()) : nullptr;
+    if (!image)
+    {
+        std::cerr << "Could not read image data from " << positional[0].toStdString() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    filter->SetInputData(image);
+    if (!filter->GetExecutive()->Update())
+    {
+        std::cerr << "Could not process the DEM." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Detected values: " << filter->GetNumberOfDetectedValues()
+        << ", not filled: " << filter->GetNumberOfUnfilledValues() << std::endl;
+
+    // Keep the loaded data object (including its coordinate system), only replace the elevations.
+    image->GetPointData()->SetScalars(filter->GetOutput()->GetPointData()->GetScalars());
+
+    if (!Exporter::exportData(*data, positional[1]))
+    {
+        std::cerr << "Could not write " << positional[1].toStdString() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
 }